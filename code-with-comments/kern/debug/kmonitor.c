@@ -4,6 +4,12 @@
 #include <trap.h>
 #include <kmonitor.h>
 #include <kdebug.h>
+#include <pmm.h>
+#include <kmalloc.h>
+#include <proc.h>
+#include <shmem.h>
+#include <vmm.h>
+#include <ksm.h>
 
 /* *
  * Simple command-line kernel monitor useful for controlling the
@@ -21,6 +27,16 @@ static struct command commands[] = {
     {"help", "Display this list of commands.", mon_help},
     {"kerninfo", "Display information about the kernel.", mon_kerninfo},
     {"backtrace", "Print backtrace of stack frame.", mon_backtrace},
+    {"pgcache", "Display single page cache statistics.", mon_pgcache},
+    {"zeropool", "Display pre-zeroed page pool statistics.", mon_zeropool},
+    {"ptcache", "Display page directory/page table cache statistics.", mon_ptcache},
+    {"kstack", "Display kernel stack pool statistics.", mon_kstack},
+    {"shmem", "Display shared memory segment statistics.", mon_shmem},
+    {"faultaround", "Display fault-around statistics, or set the window limit.", mon_faultaround},
+    {"ksm", "Display same-page merging statistics, or set the pages scanned per wakeup.", mon_ksm},
+#if KMALLOC_PROFILE
+    {"kheap", "Display kernel heap statistics and top kmalloc sites.", mon_kheap},
+#endif
 };
 
 /* return if kernel is panic, in kern/debug/panic.c */
@@ -130,3 +146,139 @@ mon_backtrace(int argc, char **argv, struct trapframe *tf) {
     return 0;
 }
 
+
+/* *
+ * mon_pgcache - print hit/miss counters of the single page cache in
+ * kern/mm/pmm.c.
+ * */
+int
+mon_pgcache(int argc, char **argv, struct trapframe *tf) {
+    struct page_cache_stat stat;
+    page_cache_get_stat(&stat);
+    cprintf("page cache: %u cached, %u hit, %u miss, %u refill, %u drain\n",
+            stat.count, stat.hit, stat.miss, stat.refill, stat.drain);
+    cprintf("free pages: %u\n", nr_free_pages());
+    return 0;
+}
+
+/* *
+ * mon_zeropool - print size, watermarks and hit/miss counters of the
+ * pre-zeroed page pool in kern/mm/pmm.c.
+ * */
+int
+mon_zeropool(int argc, char **argv, struct trapframe *tf) {
+    struct zero_pool_stat stat;
+    zero_pool_get_stat(&stat);
+    cprintf("zero pool: %u/%u pages, low %u, peak %u\n",
+            stat.count, stat.high, stat.min_count, stat.max_count);
+    cprintf("           %u hit, %u miss, %u zeroed while idle\n",
+            stat.hit, stat.miss, stat.zeroed);
+    return 0;
+}
+
+/* *
+ * mon_ptcache - print hit/miss counters of the page directory and page
+ * table caches in kern/mm/pmm.c. Every pgdir hit is a fork/exec that
+ * skipped copying the kernel half of boot_pgdir, every page table hit is
+ * a get_pte that skipped zeroing a page.
+ * */
+int
+mon_ptcache(int argc, char **argv, struct trapframe *tf) {
+    struct pgtable_cache_stat stat;
+    pgtable_cache_get_stat(&stat);
+    cprintf("pgdir: %u cached, %u hit, %u miss\n",
+            stat.nr_pgdir, stat.pgdir_hit, stat.pgdir_miss);
+    cprintf("pt:    %u cached, %u hit, %u miss\n",
+            stat.nr_pt, stat.pt_hit, stat.pt_miss);
+    return 0;
+}
+
+/* *
+ * mon_kstack - print hit/miss counters of the kernel stack pool (kern/process/proc.c).
+ * */
+int
+mon_kstack(int argc, char **argv, struct trapframe *tf) {
+    struct kstack_pool_stat stat;
+    kstack_pool_get_stat(&stat);
+    cprintf("kstack: %u cached, %u in use, %u slots\n", stat.count, stat.nr_used, stat.nr_slots);
+    cprintf("        %u hit, %u miss, %u unmap\n", stat.hit, stat.miss, stat.unmap);
+    return 0;
+}
+
+/* *
+ * mon_shmem - print page counts and swap counters of shared memory segments (kern/mm/shmem.c).
+ * */
+int
+mon_shmem(int argc, char **argv, struct trapframe *tf) {
+    struct shmem_stat stat;
+    shmem_get_stat(&stat);
+    cprintf("shmem: %u segments, %u resident, %u swapped\n", stat.nr_shmem, stat.nr_resident, stat.nr_swapped);
+    cprintf("       %u swap out, %u swap in\n", stat.swap_out, stat.swap_in);
+    return 0;
+}
+
+/* *
+ * mon_faultaround - print fault-around counters (kern/mm/vmm.c). With an
+ * argument, set the window limit in pages first; 1 turns fault-around off.
+ * */
+int
+mon_faultaround(int argc, char **argv, struct trapframe *tf) {
+    struct fault_around_stat stat;
+    if (argc > 1) {
+        fault_around_set_max(strtol(argv[1], NULL, 0));
+    }
+    fault_around_get_stat(&stat);
+    cprintf("fault-around: window limit %u pages\n", stat.max);
+    cprintf("              %u faults mapped %u extra pages, %u used, %u unused\n",
+            stat.faults, stat.mapped, stat.used, stat.unused);
+    return 0;
+}
+
+/* *
+ * mon_ksm - print same-page merging counters (kern/mm/ksm.c). With an
+ * argument, set the number of pages scanned per wakeup first; 0 stops scanning.
+ * */
+int
+mon_ksm(int argc, char **argv, struct trapframe *tf) {
+    struct ksm_stat stat;
+    if (argc > 1) {
+        ksm_set_pages_per_scan(strtol(argv[1], NULL, 0));
+    }
+    ksm_get_stat(&stat);
+    cprintf("ksm: %u pages per scan, %u mms registered\n", stat.pages_per_scan, stat.nr_mm);
+    cprintf("     %u pages scanned in %u full scans\n", stat.pages_scanned, stat.full_scans);
+    cprintf("     %u shared pages mapped %u times, %u KB saved, %u pages merged into the zero page\n",
+            stat.pages_shared, stat.pages_sharing, stat.pages_saved * (PGSIZE / 1024), stat.zero_merged);
+    return 0;
+}
+
+#if KMALLOC_PROFILE
+#define KHEAP_MAX_CACHES        32
+#define KHEAP_TOP_SITES         10
+
+/* *
+ * mon_kheap - print per-cache counters of the kernel heap (kern/mm/kmalloc.c)
+ * and the kmalloc call sites with the most allocations.
+ * */
+int
+mon_kheap(int argc, char **argv, struct trapframe *tf) {
+    struct kmem_cache_stat stats[KHEAP_MAX_CACHES];
+    struct kmalloc_site sites[KHEAP_TOP_SITES];
+    int i, n = kmem_cache_get_stats(stats, KHEAP_MAX_CACHES);
+    cprintf("%-16s %6s %6s %8s %8s %8s %8s\n",
+            "cache", "size", "slabs", "allocs", "frees", "live", "high");
+    for (i = 0; i < n; i ++) {
+        cprintf("%-16s %6u %6u %8u %8u %8u %8u\n", stats[i].name, stats[i].objsize, stats[i].nr_slabs,
+                stats[i].allocs, stats[i].frees, stats[i].live_bytes, stats[i].high_bytes);
+    }
+    cprintf("allocated: %u bytes\n", kallocated());
+
+    n = kmalloc_top_sites(sites, KHEAP_TOP_SITES);
+    cprintf("top kmalloc sites:\n");
+    for (i = 0; i < n; i ++) {
+        cprintf("%8u allocs %8u bytes  ", sites[i].allocs, sites[i].bytes);
+        print_debuginfo(sites[i].caller - 1);
+    }
+    return 0;
+}
+#endif /* KMALLOC_PROFILE */
@@ -8,6 +8,14 @@ void kmonitor(struct trapframe *tf);
 int mon_help(int argc, char **argv, struct trapframe *tf);
 int mon_kerninfo(int argc, char **argv, struct trapframe *tf);
 int mon_backtrace(int argc, char **argv, struct trapframe *tf);
+int mon_pgcache(int argc, char **argv, struct trapframe *tf);
+int mon_zeropool(int argc, char **argv, struct trapframe *tf);
+int mon_ptcache(int argc, char **argv, struct trapframe *tf);
+int mon_kstack(int argc, char **argv, struct trapframe *tf);
+int mon_shmem(int argc, char **argv, struct trapframe *tf);
+int mon_faultaround(int argc, char **argv, struct trapframe *tf);
+int mon_ksm(int argc, char **argv, struct trapframe *tf);
+int mon_kheap(int argc, char **argv, struct trapframe *tf);
 int mon_continue(int argc, char **argv, struct trapframe *tf);
 int mon_step(int argc, char **argv, struct trapframe *tf);
 int mon_breakpoint(int argc, char **argv, struct trapframe *tf);
@@ -345,6 +345,19 @@ file_fstat(int fd, struct stat *stat) {
     return ret;
 }
 
+// file_getinode - 取 fd 对应的 inode 并增加其引用计数, 关闭文件后调用者仍可使用(如按需加载的可执行文件)
+int
+file_getinode(int fd, struct inode **node_store) {
+    int ret;
+    struct file *file;
+    if ((ret = fd2file(fd, &file)) != 0) {
+        return ret;
+    }
+    vop_ref_inc(file->node);
+    *node_store = file->node;
+    return 0;
+}
+
 // sync file
 int
 file_fsync(int fd) {
@@ -47,6 +47,7 @@ int file_write(int fd, void *base, size_t len, size_t *copied_store);
 int file_seek(int fd, off_t pos, int whence);
 int file_fstat(int fd, struct stat *stat);
 int file_fsync(int fd);
+int file_getinode(int fd, struct inode **node_store);
 int file_getdirentry(int fd, struct dirent *dirent);
 int file_dup(int fd1, int fd2);
 int file_pipe(int fd[]);
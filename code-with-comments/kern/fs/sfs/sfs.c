@@ -14,6 +14,7 @@ void
 sfs_init(void) {
     LOG("sfs_init:\n");
     int ret;
+    sfs_entry_cache_init();
     if ((ret = sfs_mount("disk0")) != 0) {
         panic("failed: sfs: sfs_mount: %e.\n", ret);
     }
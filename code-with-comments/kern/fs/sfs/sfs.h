@@ -122,6 +122,7 @@ struct fs;
 struct inode;
 
 void sfs_init(void);
+void sfs_entry_cache_init(void);
 int sfs_mount(const char *devname);
 
 void lock_sfs_fs(struct sfs_fs *sfs);
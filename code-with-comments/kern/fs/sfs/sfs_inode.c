@@ -16,6 +16,19 @@
 static const struct inode_ops sfs_node_dirops;  // dir operations
 static const struct inode_ops sfs_node_fileops; // file operations
 
+// 目录项缓冲区(struct sfs_disk_entry)的对象 cache
+static struct kmem_cache *sfs_entry_cachep;
+
+/*
+ * sfs_entry_cache_init - create the sfs_disk_entry cache, invoked by sfs_init
+ */
+void
+sfs_entry_cache_init(void) {
+    if ((sfs_entry_cachep = kmem_cache_create("sfs_disk_entry", sizeof(struct sfs_disk_entry), 0, NULL)) == NULL) {
+        panic("cannot create sfs_disk_entry cache.\n");
+    }
+}
+
 /*
  * lock_sin - lock the process of inode Rd/Wr
  */
@@ -451,7 +464,7 @@ static int
 sfs_dirent_search_nolock(struct sfs_fs *sfs, struct sfs_inode *sin, const char *name, uint32_t *ino_store, int *slot, int *empty_slot) {
     assert(strlen(name) <= SFS_MAX_FNAME_LEN);
     struct sfs_disk_entry *entry;
-    if ((entry = kmalloc(sizeof(struct sfs_disk_entry))) == NULL) {
+    if ((entry = kmem_cache_alloc(sfs_entry_cachep)) == NULL) {
         return -E_NO_MEM;
     }
 
@@ -475,7 +488,7 @@ sfs_dirent_search_nolock(struct sfs_fs *sfs, struct sfs_inode *sin, const char *
 #undef set_pvalue
     ret = -E_NOENT;
 out:
-    kfree(entry);
+    kmem_cache_free(sfs_entry_cachep, entry);
     return ret;
 }
 
@@ -752,7 +765,7 @@ sfs_fsync(struct inode *node) {
 static int
 sfs_namefile(struct inode *node, struct iobuf *iob) {
     struct sfs_disk_entry *entry;
-    if (iob->io_resid <= 2 || (entry = kmalloc(sizeof(struct sfs_disk_entry))) == NULL) {
+    if (iob->io_resid <= 2 || (entry = kmem_cache_alloc(sfs_entry_cachep)) == NULL) {
         return -E_NO_MEM;
     }
 
@@ -800,14 +813,14 @@ sfs_namefile(struct inode *node, struct iobuf *iob) {
     ptr = memmove(iob->io_base + 1, ptr, alen);
     ptr[-1] = '/', ptr[alen] = '\0';
     iobuf_skip(iob, alen);
-    kfree(entry);
+    kmem_cache_free(sfs_entry_cachep, entry);
     return 0;
 
 failed_nomem:
     ret = -E_NO_MEM;
 failed:
     vop_ref_dec(node);
-    kfree(entry);
+    kmem_cache_free(sfs_entry_cachep, entry);
     return ret;
 }
 
@@ -838,7 +851,7 @@ sfs_getdirentry_sub_nolock(struct sfs_fs *sfs, struct sfs_inode *sin, int slot,
 static int
 sfs_getdirentry(struct inode *node, struct iobuf *iob) {
     struct sfs_disk_entry *entry;
-    if ((entry = kmalloc(sizeof(struct sfs_disk_entry))) == NULL) {
+    if ((entry = kmem_cache_alloc(sfs_entry_cachep)) == NULL) {
         return -E_NO_MEM;
     }
 
@@ -848,11 +861,11 @@ sfs_getdirentry(struct inode *node, struct iobuf *iob) {
     int ret, slot;
     off_t offset = iob->io_offset;
     if (offset < 0 || offset % sfs_dentry_size != 0) {
-        kfree(entry);
+        kmem_cache_free(sfs_entry_cachep, entry);
         return -E_INVAL;
     }
     if ((slot = offset / sfs_dentry_size) > sin->din->blocks) {
-        kfree(entry);
+        kmem_cache_free(sfs_entry_cachep, entry);
         return -E_NOENT;
     }
     lock_sin(sin);
@@ -863,7 +876,7 @@ sfs_getdirentry(struct inode *node, struct iobuf *iob) {
     unlock_sin(sin);
     ret = iobuf_move(iob, entry->name, sfs_dentry_size, 1, NULL);
 out:
-    kfree(entry);
+    kmem_cache_free(sfs_entry_cachep, entry);
     return ret;
 }
 
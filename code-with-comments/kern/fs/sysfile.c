@@ -29,12 +29,9 @@ copy_path(char **to, const char *from) {
     if ((buffer = kmalloc(FS_MAX_FPATH_LEN + 1)) == NULL) {
         return -E_NO_MEM;
     }
-    lock_mm(mm);
     if (!copy_string(mm, buffer, from, FS_MAX_FPATH_LEN + 1)) {
-        unlock_mm(mm);
         goto failed_cleanup;
     }
-    unlock_mm(mm);
     *to = buffer;
     return 0;
 
@@ -95,18 +92,14 @@ sysfile_read(int fd, void *base, size_t len) {
         // 1. fd 读取到-->  buffer
         ret = file_read(fd, buffer, alen, &alen);
         if (alen != 0) {
-            lock_mm(mm);
-            {
-                //  2. buffer 复制到--> user addr
-                if (copy_to_user(mm, base, buffer, alen)) {
-                    assert(len >= alen);
-                    base += alen, len -= alen, copied += alen;
-                }
-                else if (ret == 0) {
-                    ret = -E_INVAL;
-                }
+            //  2. buffer 复制到--> user addr. 复制函数自己处理缺页与非法地址, 不必 lock_mm
+            if (copy_to_user(mm, base, buffer, alen)) {
+                assert(len >= alen);
+                base += alen, len -= alen, copied += alen;
+            }
+            else if (ret == 0) {
+                ret = -E_INVAL;
             }
-            unlock_mm(mm);
         }
         if (ret != 0 || alen == 0) {
             goto out;
@@ -142,13 +135,9 @@ sysfile_write(int fd, void *base, size_t len) {
         if ((alen = IOBUF_SIZE) > len) {
             alen = len;
         }
-        lock_mm(mm);
-        {
-            if (!copy_from_user(mm, buffer, base, alen, 0)) {
-                ret = -E_INVAL;
-            }
+        if (!copy_from_user(mm, buffer, base, alen, 0)) {
+            ret = -E_INVAL;
         }
-        unlock_mm(mm);
         if (ret == 0) {
             ret = file_write(fd, buffer, alen, &alen);
             if (alen != 0) {
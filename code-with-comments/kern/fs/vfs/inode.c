@@ -9,6 +9,20 @@
 #include <kmalloc.h>
 #include <kdebug.h>
 
+// inode 的对象 cache
+static struct kmem_cache *inode_cachep;
+
+/* *
+ * inode_cache_init - create the inode cache
+ * invoked by vfs_init
+ * */
+void
+inode_cache_init(void) {
+    if ((inode_cachep = kmem_cache_create("inode", sizeof(struct inode), 0, NULL)) == NULL) {
+        panic("cannot create inode cache.\n");
+    }
+}
+
 /* 
  * 分配一个 inode 结构,用于初始化指定类型的设备
  * 
@@ -17,7 +31,7 @@ struct inode *
 __alloc_inode(int type) {
     LOG("__alloc_inode: type = %d\n",type);
     struct inode *node;
-    if ((node = kmalloc(sizeof(struct inode))) != NULL) {
+    if ((node = kmem_cache_alloc(inode_cachep)) != NULL) {
         node->in_type = type;
     }
     return node;
@@ -43,7 +57,7 @@ void
 inode_kill(struct inode *node) {
     assert(inode_ref_count(node) == 0);
     assert(inode_open_count(node) == 0);
-    kfree(node);
+    kmem_cache_free(inode_cachep, node);
 }
 
 /* *
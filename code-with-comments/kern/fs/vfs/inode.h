@@ -84,6 +84,7 @@ struct inode {
 #define info2node(info, type)                                       \
     to_struct((info), struct inode, in_info.__##type##_info)
 
+void inode_cache_init(void);
 struct inode *__alloc_inode(int type);
 
 #define alloc_inode(type)                                           __alloc_inode(__in_type(type)) //创建 inode 时必须指定具体类型,用 __in_type 映射类型字符串与 id 的关系, 初始化in_type字段.
@@ -26,6 +26,7 @@ __alloc_fs(int type) {
 void
 vfs_init(void) {
     sem_init(&bootfs_sem, 1);
+    inode_cache_init();
     vfs_devlist_init();
 }
 
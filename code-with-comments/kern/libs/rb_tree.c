@@ -0,0 +1,319 @@
+#include <defs.h>
+#include <assert.h>
+#include <rb_tree.h>
+
+/* *
+ * 红黑树的性质:
+ *  1) 结点为红色或黑色, 根与空子树(NULL)为黑色;
+ *  2) 红色结点的子结点都是黑色;
+ *  3) 从任一结点到其下各空子树的路径上黑色结点数相同.
+ * 因此最长路径不超过最短路径的两倍, n 个结点的树高不超过 2log(n+1), 插入/删除/查找均为 O(log n).
+ * 插入和删除的调整参考 Introduction to Algorithms 第 13 章, 空子树为 NULL, 删除时需单独记录 x 的父结点.
+ * */
+
+#define rb_is_red(node)         ((node) != NULL && (node)->red)
+
+// 以 x 为轴左旋: x 的右子结点 y 取代 x, x 成为 y 的左子结点
+static void
+rb_rotate_left(rb_tree *tree, rb_node *x) {
+    rb_node *y = x->right;
+    x->right = y->left;
+    if (y->left != NULL) {
+        y->left->parent = x;
+    }
+    y->parent = x->parent;
+    if (x->parent == NULL) {
+        tree->root = y;
+    }
+    else if (x == x->parent->left) {
+        x->parent->left = y;
+    }
+    else {
+        x->parent->right = y;
+    }
+    y->left = x;
+    x->parent = y;
+}
+
+// 以 x 为轴右旋: x 的左子结点 y 取代 x, x 成为 y 的右子结点
+static void
+rb_rotate_right(rb_tree *tree, rb_node *x) {
+    rb_node *y = x->left;
+    x->left = y->right;
+    if (y->right != NULL) {
+        y->right->parent = x;
+    }
+    y->parent = x->parent;
+    if (x->parent == NULL) {
+        tree->root = y;
+    }
+    else if (x == x->parent->right) {
+        x->parent->right = y;
+    }
+    else {
+        x->parent->left = y;
+    }
+    y->right = x;
+    x->parent = y;
+}
+
+// 新插入的红色结点 x 可能与其父结点同为红色, 向上调整
+static void
+rb_insert_fixup(rb_tree *tree, rb_node *x) {
+    rb_node *parent, *gparent, *uncle;
+    while ((parent = x->parent) != NULL && parent->red) {
+        gparent = parent->parent;   // 父结点是红色, 不是根, 祖父结点一定存在
+        if (parent == gparent->left) {
+            uncle = gparent->right;
+            if (rb_is_red(uncle)) {
+                parent->red = uncle->red = 0;
+                gparent->red = 1;
+                x = gparent;
+                continue ;
+            }
+            if (x == parent->right) {
+                rb_rotate_left(tree, parent);
+                x = parent;
+                parent = x->parent;
+            }
+            parent->red = 0;
+            gparent->red = 1;
+            rb_rotate_right(tree, gparent);
+        }
+        else {
+            uncle = gparent->left;
+            if (rb_is_red(uncle)) {
+                parent->red = uncle->red = 0;
+                gparent->red = 1;
+                x = gparent;
+                continue ;
+            }
+            if (x == parent->left) {
+                rb_rotate_right(tree, parent);
+                x = parent;
+                parent = x->parent;
+            }
+            parent->red = 0;
+            gparent->red = 1;
+            rb_rotate_left(tree, gparent);
+        }
+    }
+    tree->root->red = 0;
+}
+
+// rb_insert - 按 compare 的顺序插入 node
+void
+rb_insert(rb_tree *tree, rb_node *node, rb_compare_f compare) {
+    rb_node *parent = NULL, **link = &(tree->root);
+    while (*link != NULL) {
+        parent = *link;
+        link = (compare(node, parent) < 0) ? &(parent->left) : &(parent->right);
+    }
+    node->parent = parent;
+    node->left = node->right = NULL;
+    node->red = 1;
+    *link = node;
+    rb_insert_fixup(tree, node);
+}
+
+// 用以 v 为根的子树替换以 u 为根的子树
+static void
+rb_transplant(rb_tree *tree, rb_node *u, rb_node *v) {
+    if (u->parent == NULL) {
+        tree->root = v;
+    }
+    else if (u == u->parent->left) {
+        u->parent->left = v;
+    }
+    else {
+        u->parent->right = v;
+    }
+    if (v != NULL) {
+        v->parent = u->parent;
+    }
+}
+
+// 删除黑色结点后, x(可能为 NULL, 父结点为 parent)所在路径少了一个黑色结点, 向上调整
+static void
+rb_delete_fixup(rb_tree *tree, rb_node *x, rb_node *parent) {
+    rb_node *sibling;
+    while (x != tree->root && !rb_is_red(x)) {
+        if (x == parent->left) {
+            sibling = parent->right;    // x 一侧少一个黑色结点, 兄弟一侧至少有一个, 兄弟一定存在
+            if (sibling->red) {
+                sibling->red = 0;
+                parent->red = 1;
+                rb_rotate_left(tree, parent);
+                sibling = parent->right;
+            }
+            if (!rb_is_red(sibling->left) && !rb_is_red(sibling->right)) {
+                sibling->red = 1;
+                x = parent;
+                parent = x->parent;
+                continue ;
+            }
+            if (!rb_is_red(sibling->right)) {
+                sibling->left->red = 0;
+                sibling->red = 1;
+                rb_rotate_right(tree, sibling);
+                sibling = parent->right;
+            }
+            sibling->red = parent->red;
+            parent->red = 0;
+            sibling->right->red = 0;
+            rb_rotate_left(tree, parent);
+        }
+        else {
+            sibling = parent->left;
+            if (sibling->red) {
+                sibling->red = 0;
+                parent->red = 1;
+                rb_rotate_right(tree, parent);
+                sibling = parent->left;
+            }
+            if (!rb_is_red(sibling->left) && !rb_is_red(sibling->right)) {
+                sibling->red = 1;
+                x = parent;
+                parent = x->parent;
+                continue ;
+            }
+            if (!rb_is_red(sibling->left)) {
+                sibling->right->red = 0;
+                sibling->red = 1;
+                rb_rotate_left(tree, sibling);
+                sibling = parent->left;
+            }
+            sibling->red = parent->red;
+            parent->red = 0;
+            sibling->left->red = 0;
+            rb_rotate_right(tree, parent);
+        }
+        x = tree->root;
+    }
+    if (x != NULL) {
+        x->red = 0;
+    }
+}
+
+// rb_delete - 从树中删除 node
+void
+rb_delete(rb_tree *tree, rb_node *node) {
+    rb_node *x, *parent, *y = node;
+    bool removed_red = node->red;
+    if (node->left == NULL) {
+        x = node->right, parent = node->parent;
+        rb_transplant(tree, node, node->right);
+    }
+    else if (node->right == NULL) {
+        x = node->left, parent = node->parent;
+        rb_transplant(tree, node, node->left);
+    }
+    else {
+        // 有两个子结点: 用后继 y 顶替 node 的位置和颜色, 实际被移走的是 y
+        y = node->right;
+        while (y->left != NULL) {
+            y = y->left;
+        }
+        removed_red = y->red;
+        x = y->right;
+        if (y->parent == node) {
+            parent = y;
+        }
+        else {
+            parent = y->parent;
+            rb_transplant(tree, y, y->right);
+            y->right = node->right;
+            y->right->parent = y;
+        }
+        rb_transplant(tree, node, y);
+        y->left = node->left;
+        y->left->parent = y;
+        y->red = node->red;
+    }
+    if (!removed_red) {
+        rb_delete_fixup(tree, x, parent);
+    }
+}
+
+// rb_search - 查找 search(node, key) == 0 的结点, 没有则返回 NULL
+rb_node *
+rb_search(rb_tree *tree, rb_search_f search, void *key) {
+    rb_node *node = tree->root;
+    int r;
+    while (node != NULL && (r = search(node, key)) != 0) {
+        node = (r > 0) ? node->left : node->right;
+    }
+    return node;
+}
+
+// rb_first - 最小的结点
+rb_node *
+rb_first(rb_tree *tree) {
+    rb_node *node = tree->root;
+    if (node != NULL) {
+        while (node->left != NULL) {
+            node = node->left;
+        }
+    }
+    return node;
+}
+
+// rb_next - 中序遍历的后继
+rb_node *
+rb_next(rb_node *node) {
+    if (node->right != NULL) {
+        node = node->right;
+        while (node->left != NULL) {
+            node = node->left;
+        }
+        return node;
+    }
+    while (node->parent != NULL && node == node->parent->right) {
+        node = node->parent;
+    }
+    return node->parent;
+}
+
+// rb_prev - 中序遍历的前驱
+rb_node *
+rb_prev(rb_node *node) {
+    if (node->left != NULL) {
+        node = node->left;
+        while (node->right != NULL) {
+            node = node->right;
+        }
+        return node;
+    }
+    while (node->parent != NULL && node == node->parent->left) {
+        node = node->parent;
+    }
+    return node->parent;
+}
+
+static int
+rb_check_node(rb_node *node) {
+    if (node == NULL) {
+        return 1;
+    }
+    if (node->left != NULL) {
+        assert(node->left->parent == node);
+    }
+    if (node->right != NULL) {
+        assert(node->right->parent == node);
+    }
+    if (node->red) {
+        assert(!rb_is_red(node->left) && !rb_is_red(node->right));
+    }
+    int black_height = rb_check_node(node->left);
+    assert(black_height == rb_check_node(node->right));
+    return black_height + (node->red ? 0 : 1);
+}
+
+// rb_check - 校验红黑树的性质, 返回黑高
+int
+rb_check(rb_tree *tree) {
+    if (tree->root != NULL) {
+        assert(tree->root->parent == NULL && !tree->root->red);
+    }
+    return rb_check_node(tree->root);
+}
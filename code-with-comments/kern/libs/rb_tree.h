@@ -0,0 +1,46 @@
+#ifndef __KERN_LIBS_RB_TREE_H__
+#define __KERN_LIBS_RB_TREE_H__
+
+#include <defs.h>
+
+/**
+ * 红黑树
+ *
+ * 与 list_entry_t, skew_heap_entry_t 一样是侵入式的: rb_node 嵌入在数据结构中,
+ * 用 to_struct 取回外层结构, 插入/删除都不需要分配内存.
+ * 空子树用 NULL 表示, 不使用哨兵结点.
+ */
+typedef struct rb_node {
+    struct rb_node *parent, *left, *right;
+    bool red;
+} rb_node;
+
+typedef struct rb_tree {
+    rb_node *root;
+} rb_tree;
+
+// 插入时比较两个结点: a < b 返回负数, 相等返回 0, a > b 返回正数. 相等的结点插在右边
+typedef int (*rb_compare_f)(rb_node *a, rb_node *b);
+// 查找时比较结点与关键字: node < key 返回负数, 命中返回 0, node > key 返回正数
+typedef int (*rb_search_f)(rb_node *node, void *key);
+
+static inline void
+rb_tree_init(rb_tree *tree) {
+    tree->root = NULL;
+}
+
+static inline bool
+rb_tree_empty(rb_tree *tree) {
+    return tree->root == NULL;
+}
+
+void rb_insert(rb_tree *tree, rb_node *node, rb_compare_f compare);
+void rb_delete(rb_tree *tree, rb_node *node);
+rb_node *rb_search(rb_tree *tree, rb_search_f search, void *key);
+rb_node *rb_first(rb_tree *tree);
+rb_node *rb_next(rb_node *node);
+rb_node *rb_prev(rb_node *node);
+int rb_check(rb_tree *tree);
+
+#endif /* !__KERN_LIBS_RB_TREE_H__ */
+
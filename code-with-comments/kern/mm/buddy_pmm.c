@@ -0,0 +1,287 @@
+#include <pmm.h>
+#include <list.h>
+#include <string.h>
+#include <stdio.h>
+#include <buddy_pmm.h>
+#include <kdebug.h>
+
+/**
+ * "buddy system" 内存分配算法.
+ *
+ * 空闲内存被组织成大小为 2^order 页的块, 每个阶 order 维护一个 free list.
+ * 块的起始页号(ppn)总是 2^order 的整数倍, 所以块 ppn 的伙伴(buddy)就是 ppn ^ (1 << order),
+ * 不需要任何额外的索引结构即可直接定位.
+ *
+ * 分配 n 页:
+ *      1) 向上取整得到阶 order, 从 order 开始向上找到第一个非空的 free list;
+ *      2) 把找到的块逐级对半拆分, 高地址的一半挂回低一阶的 free list;
+ *      3) 若 n 不是 2 的幂, 把块尾部多余的页按对齐块归还, 保证 nr_free 精确.
+ * 释放 n 页:
+ *      把 [base, base + n) 切分为若干对齐块, 对每个块反复检查伙伴是否空闲且同阶,
+ *      是则摘下伙伴, 合并为高一阶的块, 直到伙伴不满足条件或到达 BUDDY_MAX_ORDER.
+ *
+ * 两个方向都只需 O(BUDDY_MAX_ORDER) 步, 与空闲块数量无关.
+ *
+ * 与 first fit 相同, 沿用 struct Page 的约定:
+ *      - 空闲块的首页设置 PG_property, property 记录此块的阶(而非页数);
+ *      - 空闲块的其他页及已分配页 property = 0, PG_property 清零.
+ * 伙伴是否为空闲块的首页, 只需检查 PageProperty(buddy) && buddy->property == order.
+ */
+
+static free_area_t buddy_area[BUDDY_MAX_ORDER + 1];
+static size_t buddy_nr_free;    // 所有阶的空闲页总数
+
+#define buddy_list(order) (buddy_area[(order)].free_list)
+#define buddy_nr(order) (buddy_area[(order)].nr_free)
+
+static void
+buddy_init(void) {
+    int order;
+    for (order = 0; order <= BUDDY_MAX_ORDER; order ++) {
+        list_init(&buddy_list(order));
+        buddy_nr(order) = 0;
+    }
+    buddy_nr_free = 0;
+}
+
+// 把对齐的块 [page, page + 2^order) 挂回 free list, 并尽可能与伙伴合并
+static void
+buddy_free_block(struct Page *page, unsigned int order) {
+    size_t ppn = page2ppn(page);
+    while (order < BUDDY_MAX_ORDER) {
+        size_t buddy_ppn = ppn ^ (1 << order);
+        if (buddy_ppn >= npage) {
+            break;
+        }
+        struct Page *buddy = pages + buddy_ppn;
+        if (!PageProperty(buddy) || buddy->property != order) {
+            break;
+        }
+        list_del(&(buddy->page_link));
+        buddy_nr(order) -= (1 << order);
+        ClearPageProperty(buddy);
+        buddy->property = 0;
+        ppn &= ~(1 << order);
+        order ++;
+    }
+    page = pages + ppn;
+    page->property = order;
+    SetPageProperty(page);
+    list_add(&buddy_list(order), &(page->page_link));
+    buddy_nr(order) += (1 << order);
+}
+
+// 把任意区间 [base, base + n) 切分为最大的对齐块逐个归还
+static void
+buddy_free_range(struct Page *base, size_t n) {
+    size_t ppn = page2ppn(base), end = ppn + n;
+    while (ppn < end) {
+        unsigned int order = 0;
+        while (order < BUDDY_MAX_ORDER
+               && (ppn & ((1 << (order + 1)) - 1)) == 0
+               && ppn + (1 << (order + 1)) <= end) {
+            order ++;
+        }
+        buddy_free_block(pages + ppn, order);
+        ppn += (1 << order);
+    }
+    buddy_nr_free += n;
+}
+
+static void
+buddy_init_memmap(struct Page *base, size_t n) {
+    assert(n > 0);
+    struct Page *p = base;
+    for (; p != base + n; p ++) {
+        assert(PageReserved(p));
+        p->flags = p->property = 0;
+        set_page_ref(p, 0);
+    }
+    buddy_free_range(base, n);
+    LOG_TAB("\tbuddy_init_memmap: 空闲空间管理\n");
+    LOG_TAB("\t\t已将一块连续地址空间加入伙伴系统,起始: 0x%08lx, page 数:%d.\n", base, n);
+    LOG_TAB("\t\t当前空闲 page 数:%d\n", buddy_nr_free);
+}
+
+static struct Page *
+buddy_alloc_pages(size_t n) {
+    assert(n > 0);
+    if (n > buddy_nr_free || n > (1 << BUDDY_MAX_ORDER)) {
+        return NULL;
+    }
+    unsigned int order = 0, cur;
+    while ((1 << order) < n) {
+        order ++;
+    }
+    for (cur = order; cur <= BUDDY_MAX_ORDER; cur ++) {
+        if (!list_empty(&buddy_list(cur))) {
+            break;
+        }
+    }
+    if (cur > BUDDY_MAX_ORDER) {
+        return NULL;
+    }
+    struct Page *page = le2page(list_next(&buddy_list(cur)), page_link);
+    list_del(&(page->page_link));
+    buddy_nr(cur) -= (1 << cur);
+    ClearPageProperty(page);
+    page->property = 0;
+    // 逐级拆分, 高地址的一半挂回低一阶
+    while (cur > order) {
+        cur --;
+        struct Page *half = page + (1 << cur);
+        half->property = cur;
+        SetPageProperty(half);
+        list_add(&buddy_list(cur), &(half->page_link));
+        buddy_nr(cur) += (1 << cur);
+    }
+    buddy_nr_free -= (1 << order);
+    // 非 2 的幂的请求: 归还尾部多余的页
+    if ((1 << order) > n) {
+        buddy_free_range(page + n, (1 << order) - n);
+    }
+    return page;
+}
+
+// 批量分配单页: 每次取不超过剩余需求的最大的块, 再拆成单页, 分配器只需进入 O(log n) 次
+static size_t
+buddy_alloc_pages_bulk(size_t n, struct Page **array) {
+    size_t got = 0, i;
+    unsigned int order = BUDDY_MAX_ORDER;
+    while (got < n) {
+        while ((1 << order) > n - got) {
+            order --;
+        }
+        struct Page *page;
+        while ((page = buddy_alloc_pages(1 << order)) == NULL && order > 0) {
+            order --;
+        }
+        if (page == NULL) {
+            break;
+        }
+        for (i = 0; i < (1 << order); i ++) {
+            array[got ++] = page + i;
+        }
+    }
+    return got;
+}
+
+static void
+buddy_free_pages(struct Page *base, size_t n) {
+    assert(n > 0);
+    struct Page *p = base;
+    for (; p != base + n; p ++) {
+        assert(!PageReserved(p) && !PageProperty(p));
+        p->flags = 0;
+        set_page_ref(p, 0);
+    }
+    buddy_free_range(base, n);
+}
+
+static size_t
+buddy_nr_free_pages(void) {
+    return buddy_nr_free;
+}
+
+static void
+buddy_check(void) {
+    int order, total = 0;
+    for (order = 0; order <= BUDDY_MAX_ORDER; order ++) {
+        list_entry_t *le = &buddy_list(order);
+        while ((le = list_next(le)) != &buddy_list(order)) {
+            struct Page *p = le2page(le, page_link);
+            assert(PageProperty(p) && p->property == order);
+            assert(page2ppn(p) % (1 << order) == 0);
+            total += (1 << order);
+        }
+    }
+    assert(total == nr_free_pages());
+
+    struct Page *p0, *p1, *p2;
+    assert((p0 = alloc_page()) != NULL);
+    assert((p1 = alloc_page()) != NULL);
+    assert((p2 = alloc_page()) != NULL);
+    assert(p0 != p1 && p0 != p2 && p1 != p2);
+    assert(page_ref(p0) == 0 && page_ref(p1) == 0 && page_ref(p2) == 0);
+    free_page(p0);
+    free_page(p1);
+    free_page(p2);
+
+    // 取一个 16 页的对齐块, 前 8 页作为测试场地, 后 8 页保持已分配, 以免与暂存的空闲块合并
+    struct Page *base = alloc_pages(16);
+    assert(base != NULL && page2ppn(base) % 16 == 0);
+    assert(!PageProperty(base));
+
+    free_area_t area_store[BUDDY_MAX_ORDER + 1];
+    size_t nr_free_store = buddy_nr_free;
+    for (order = 0; order <= BUDDY_MAX_ORDER; order ++) {
+        area_store[order] = buddy_area[order];
+    }
+    buddy_init();
+    assert(alloc_page() == NULL);
+
+    free_pages(base, 8);
+    assert(buddy_nr_free == 8);
+    assert(PageProperty(base) && base->property == 3);
+    assert(alloc_pages(9) == NULL);
+
+    // 拆分: 1 + 1 + 2 + 4
+    assert((p0 = alloc_page()) == base);
+    assert(PageProperty(base + 1) && base[1].property == 0);
+    assert(PageProperty(base + 2) && base[2].property == 1);
+    assert(PageProperty(base + 4) && base[4].property == 2);
+    assert((p1 = alloc_pages(2)) == base + 2);
+    assert((p2 = alloc_pages(4)) == base + 4);
+    assert(alloc_page() == base + 1);
+    assert(alloc_page() == NULL);
+    assert(buddy_nr_free == 0);
+
+    // 合并: 按伙伴逐级回到 8 页的块
+    free_page(base + 1);
+    free_page(p0);
+    assert(PageProperty(base) && base->property == 1);
+    free_pages(p1, 2);
+    assert(PageProperty(base) && base->property == 2);
+    free_pages(p2, 4);
+    assert(PageProperty(base) && base->property == 3);
+    assert(!PageProperty(base + 4));
+
+    // 非 2 的幂: 尾部多余的页被归还
+    assert((p0 = alloc_pages(3)) == base);
+    assert(PageProperty(base + 3) && base[3].property == 0);
+    assert(PageProperty(base + 4) && base[4].property == 2);
+    assert(buddy_nr_free == 5);
+    free_pages(p0, 3);
+    assert(PageProperty(base) && base->property == 3);
+    assert(buddy_nr_free == 8);
+
+    assert((p0 = alloc_pages(8)) == base);
+    assert(buddy_nr_free == 0);
+
+    for (order = 0; order <= BUDDY_MAX_ORDER; order ++) {
+        buddy_area[order] = area_store[order];
+    }
+    buddy_nr_free = nr_free_store;
+    free_pages(p0, 8);
+    free_pages(base + 8, 8);
+
+    for (order = 0; order <= BUDDY_MAX_ORDER; order ++) {
+        list_entry_t *le = &buddy_list(order);
+        while ((le = list_next(le)) != &buddy_list(order)) {
+            total -= (1 << order);
+        }
+    }
+    assert(total == 0);
+    LOG_TAB("%-20s%s\n","buddy_check()", ": succeed!");
+}
+
+const struct pmm_manager buddy_pmm_manager = {
+    .name = "buddy_pmm_manager",
+    .init = buddy_init,
+    .init_memmap = buddy_init_memmap,
+    .alloc_pages = buddy_alloc_pages,
+    .free_pages = buddy_free_pages,
+    .nr_free_pages = buddy_nr_free_pages,
+    .check = buddy_check,
+    .alloc_pages_bulk = buddy_alloc_pages_bulk,
+};
@@ -0,0 +1,11 @@
+#ifndef __KERN_MM_BUDDY_PMM_H__
+#define  __KERN_MM_BUDDY_PMM_H__
+
+#include <pmm.h>
+
+// 伙伴系统管理的最大块阶数: 最大块为 2^BUDDY_MAX_ORDER 页 = 4MB, 与 PTSIZE 一致
+#define BUDDY_MAX_ORDER         10
+
+extern const struct pmm_manager buddy_pmm_manager;
+#endif /* ! __KERN_MM_BUDDY_PMM_H__ */
+
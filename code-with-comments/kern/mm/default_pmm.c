@@ -154,6 +154,31 @@ default_alloc_pages(size_t n) {
     return page;
 }
 
+// 批量分配单页: 依次从 free list 头部的块切下所需的页, 一次遍历即可完成
+static size_t
+default_alloc_pages_bulk(size_t n, struct Page **array) {
+    size_t got = 0;
+    while (got < n && !list_empty(&free_list)) {
+        list_entry_t *le = list_next(&free_list);
+        struct Page *page = le2page(le, page_link);
+        size_t k = page->property;
+        if (k > n - got) {
+            k = n - got;
+            struct Page *p = page + k;
+            p->property = page->property - k;
+            SetPageProperty(p);
+            list_add_after(&(page->page_link), &(p->page_link));
+        }
+        list_del(le);
+        ClearPageProperty(page);
+        nr_free -= k;
+        while (k -- > 0) {
+            array[got ++] = page ++;
+        }
+    }
+    return got;
+}
+
 static void
 default_free_pages(struct Page *base, size_t n) {
     assert(n > 0);
@@ -323,4 +348,5 @@ const struct pmm_manager default_pmm_manager = {
     .free_pages = default_free_pages,
     .nr_free_pages = default_nr_free_pages,
     .check = default_check,
+    .alloc_pages_bulk = default_alloc_pages_bulk,
 };
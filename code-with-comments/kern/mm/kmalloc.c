@@ -5,43 +5,35 @@
 #include <kmalloc.h>
 #include <sync.h>
 #include <pmm.h>
+#include <error.h>
+#include <string.h>
 #include <kdebug.h>
 
 /*
- * SLOB Allocator: Simple List Of Blocks
+ * Slab 分配器
  *
- * Matt Mackall <mpm@selenic.com> 12/30/03
+ * 每种固定大小的内核对象(proc_struct, mm_struct, vma_struct, inode ...)拥有一个 kmem_cache,
+ * kmem_cache 由若干 slab 组成, 每个 slab 是 2^order 个连续页:
  *
- * How SLOB works:
+ *      +-------------+------------------+-----+-------+-------+-----+-------+
+ *      | struct slab | bufctl[0..num-1] | pad | obj 0 | obj 1 | ... | obj n |
+ *      +-------------+------------------+-----+-------+-------+-----+-------+
+ *      ^ slab 首页                             ^ s_mem, 按 align 对齐
  *
- * The core of SLOB is a traditional K&R style heap allocator, with
- * support for returning aligned objects. The granularity of this
- * allocator is 8 bytes on x86, though it's perhaps possible to reduce
- * this to 4 if it's deemed worth the effort. The slob heap is a
- * singly-linked list of pages from __get_free_page, grown on demand
- * and allocation from the heap is currently first-fit.
+ *      - bufctl[i] 记录对象 i 之后的下一个空闲对象下标, slab->free 为链表头, 分配与释放都是 O(1);
+ *        空闲链表不写入对象本身, 所以构造函数(ctor)初始化的内容在释放后仍然保留,
+ *        ctor 只在 slab 创建时对每个对象调用一次, 对象释放时应恢复到构造后的状态.
+ *      - slab 的每一页都设置 PG_slab, property 记录此页相对 slab 首页的偏移,
+ *        由对象地址即可找到所在的 slab, 释放时无需查找.
+ *      - 有空闲对象的 slab 挂在 slabs_partial 上, 分配总是取第一个, 对象集中在少数几个 slab 中;
+ *        完全分配的 slab 挂在 slabs_full 上; 完全空闲的 slab 立即归还 pmm (单页 slab 会进入单页缓存).
  *
- * Above this is an implementation of kmalloc/kfree. Blocks returned
- * from kmalloc are 8-byte aligned and prepended with a 8-byte header.
- * If kmalloc is asked for objects of PAGE_SIZE or larger, it calls
- * __get_free_pages directly so that it can return page-aligned blocks
- * and keeps a linked list of such pages and their orders. These
- * objects are detected in kfree() by their page alignment.
- *
- * SLAB is emulated on top of SLOB by simply calling constructors and
- * destructors for every SLAB allocation. Objects are returned with
- * the 8-byte alignment unless the SLAB_MUST_HWCACHE_ALIGN flag is
- * set, in which case the low-level allocator will fragment blocks to
- * create the proper alignment. Again, objects of page-size or greater
- * are allocated by calling __get_free_pages. As SLAB objects know
- * their size, no separate size bookkeeping is necessary and there is
- * essentially no allocation space overhead.
+ * kmalloc 建立在 16, 32, ..., 2048 字节的一组 kmem_cache 之上, 更大的请求直接分配连续页(bigblock).
+ * bigblock 的首页设置 PG_bigblock, property 记录其阶数, kfree/ksize 由地址直接得到大小, 无需查找.
  */
 
 
 //some helper
-#define spin_lock_irqsave(l, f) local_intr_save(f)
-#define spin_unlock_irqrestore(l, f) local_intr_restore(f)
 typedef unsigned int gfp_t;
 #ifndef PAGE_SIZE
 #define PAGE_SIZE PGSIZE
@@ -52,166 +44,530 @@ typedef unsigned int gfp_t;
 #endif
 
 #ifndef ALIGN
-#define ALIGN(addr,size)   (((addr)+(size)-1)&(~((size)-1))) 
+#define ALIGN(addr,size)   (((addr)+(size)-1)&(~((size)-1)))
 #endif
 
+#define SLAB_MAX_ORDER          3               // slab 最多 8 页
+#define SLAB_MIN_ALIGN          sizeof(long long)
 
-struct slob_block {
-	int units;
-	struct slob_block *next;
-};
-typedef struct slob_block slob_t;
+typedef uint16_t kmem_bufctl_t;
+#define BUFCTL_END              ((kmem_bufctl_t)-1)
 
-#define SLOB_UNIT sizeof(slob_t)
-#define SLOB_UNITS(size) (((size) + SLOB_UNIT - 1)/SLOB_UNIT)
-#define SLOB_ALIGN L1_CACHE_BYTES
+struct slab {
+	list_entry_t slab_link;         // 挂在所属 cache 的 slabs_partial/slabs_full 上
+	struct kmem_cache *cache;
+	void *s_mem;                    // 第一个对象的地址
+	size_t inuse;                   // 已分配的对象数
+	kmem_bufctl_t free;             // 第一个空闲对象的下标
+};
 
-struct bigblock {
-	int order;
-	void *pages;
-	struct bigblock *next;
+#define le2slab(le, member)                 \
+	to_struct((le), struct slab, member)
+#define slab_bufctl(slabp) ((kmem_bufctl_t *)((struct slab *)(slabp) + 1))
+
+struct kmem_cache {
+	list_entry_t slabs_full;
+	list_entry_t slabs_partial;
+	size_t objsize;                 // 按 align 取整后的对象大小
+	size_t num;                     // 每个 slab 的对象数
+	size_t order;                   // 每个 slab 2^order 页
+	size_t offset;                  // s_mem 相对 slab 首页的偏移
+	void (*ctor)(void *);
+	const char *name;
+	list_entry_t cache_link;        // 挂在 cache_list 上
+	size_t nr_slabs;                // 当前 slab 数
+	size_t nr_active;               // 当前已分配的对象数
+#if KMALLOC_PROFILE
+	size_t allocs;                  // 累计分配次数
+	size_t frees;                   // 累计释放次数
+	size_t high;                    // nr_active 的最高水位
+#endif
 };
-typedef struct bigblock bigblock_t;
 
-static slob_t arena = { .next = &arena, .units = 1 };
-static slob_t *slobfree = &arena;
-static bigblock_t *bigblocks;
+#define le2cache(le, member)                \
+	to_struct((le), struct kmem_cache, member)
 
+static list_entry_t cache_list;
+// kmem_cache 结构本身也由一个 kmem_cache 分配
+static struct kmem_cache cache_cache;
+
+#define KMALLOC_MIN_SHIFT       4
+#define KMALLOC_MAX_SIZE        2048
+#define KMALLOC_NR_CACHES       8               // 16, 32, ..., 2048
+
+static struct kmem_cache kmalloc_caches[KMALLOC_NR_CACHES];
+static const char *kmalloc_names[KMALLOC_NR_CACHES] = {
+	"size-16", "size-32", "size-64", "size-128",
+	"size-256", "size-512", "size-1024", "size-2048",
+};
 
-static void* __slob_get_free_pages(gfp_t gfp, int order)
+// bigblock 的统计: 当前页数总是维护(kallocated 需要), 其余仅在 KMALLOC_PROFILE 时维护
+static struct {
+	size_t nr_pages;
+#if KMALLOC_PROFILE
+	size_t allocs;
+	size_t frees;
+	size_t high;                    // nr_pages 的最高水位
+#endif
+} bigblock_stat;
+
+// 分配 2^order 页的 bigblock, 在首页记录阶数
+static void *
+bigblock_alloc(int order)
 {
-  struct Page * page = alloc_pages(1 << order);
-  if(!page)
-    return NULL;
-  return page2kva(page);
+	struct Page *page = alloc_pages(1 << order);
+	if (page == NULL)
+		return NULL;
+	SetPageBigBlock(page);
+	page->property = order;
+
+	bool intr_flag;
+	local_intr_save(intr_flag);
+	bigblock_stat.nr_pages += (1 << order);
+#if KMALLOC_PROFILE
+	bigblock_stat.allocs ++;
+	if (bigblock_stat.nr_pages > bigblock_stat.high)
+		bigblock_stat.high = bigblock_stat.nr_pages;
+#endif
+	local_intr_restore(intr_flag);
+	return page2kva(page);
 }
 
-#define __slob_get_free_page(gfp) __slob_get_free_pages(gfp, 0)
+static void
+bigblock_free(struct Page *page)
+{
+	int order = page->property;
+	ClearPageBigBlock(page);
+	page->property = 0;
+	free_pages(page, 1 << order);
+
+	bool intr_flag;
+	local_intr_save(intr_flag);
+	bigblock_stat.nr_pages -= (1 << order);
+#if KMALLOC_PROFILE
+	bigblock_stat.frees ++;
+#endif
+	local_intr_restore(intr_flag);
+}
 
-static inline void __slob_free_pages(unsigned long kva, int order)
+// 计算 2^order 页的 slab 能容纳的对象数及第一个对象的偏移
+static void
+kmem_cache_estimate(size_t order, size_t objsize, size_t align, size_t *num, size_t *offset)
 {
-  free_pages(kva2page(kva), 1 << order);
+	size_t total = (PGSIZE << order), n;
+	n = (total - sizeof(struct slab)) / (objsize + sizeof(kmem_bufctl_t));
+	while (n > 0 && ALIGN(sizeof(struct slab) + n * sizeof(kmem_bufctl_t), align) + n * objsize > total)
+		n --;
+	if (n >= BUFCTL_END)
+		n = BUFCTL_END - 1;
+	*num = n;
+	*offset = ALIGN(sizeof(struct slab) + n * sizeof(kmem_bufctl_t), align);
 }
 
-static void slob_free(void *b, int size);
+// 初始化 cachep: 选择使浪费不超过 1/8 的最小 slab 阶数
+static int
+kmem_cache_setup(struct kmem_cache *cachep, const char *name, size_t size, size_t align, void (*ctor)(void *))
+{
+	if (align < SLAB_MIN_ALIGN)
+		align = SLAB_MIN_ALIGN;
+	assert(size > 0 && (align & (align - 1)) == 0);
+
+	size_t objsize = ALIGN(size, align), order, num, offset;
+	for (order = 0; order <= SLAB_MAX_ORDER; order ++) {
+		kmem_cache_estimate(order, objsize, align, &num, &offset);
+		if (num != 0 && (((PGSIZE << order) - offset - num * objsize) * 8 <= (PGSIZE << order)))
+			break;
+	}
+	if (order > SLAB_MAX_ORDER) {
+		order = SLAB_MAX_ORDER;
+		kmem_cache_estimate(order, objsize, align, &num, &offset);
+	}
+	if (num == 0)
+		return -E_INVAL;
+
+	list_init(&(cachep->slabs_full));
+	list_init(&(cachep->slabs_partial));
+	cachep->objsize = objsize;
+	cachep->num = num;
+	cachep->order = order;
+	cachep->offset = offset;
+	cachep->ctor = ctor;
+	cachep->name = name;
+	cachep->nr_slabs = cachep->nr_active = 0;
+#if KMALLOC_PROFILE
+	cachep->allocs = cachep->frees = cachep->high = 0;
+#endif
+
+	bool intr_flag;
+	local_intr_save(intr_flag);
+	list_add_before(&cache_list, &(cachep->cache_link));
+	local_intr_restore(intr_flag);
+	return 0;
+}
 
-static void *slob_alloc(size_t size, gfp_t gfp, int align)
+// 为 cachep 新建一个 slab, 所有对象空闲, 已调用 ctor. 不持锁调用
+static struct slab *
+kmem_cache_grow(struct kmem_cache *cachep)
 {
-  assert( (size + SLOB_UNIT) < PAGE_SIZE );
-
-	slob_t *prev, *cur, *aligned = 0;
-	int delta = 0, units = SLOB_UNITS(size);
-	unsigned long flags;
-
-	spin_lock_irqsave(&slob_lock, flags);
-	prev = slobfree;
-	for (cur = prev->next; ; prev = cur, cur = cur->next) {
-		if (align) {
-			aligned = (slob_t *)ALIGN((unsigned long)cur, align);
-			delta = aligned - cur;
-		}
-		if (cur->units >= units + delta) { /* room enough? */
-			if (delta) { /* need to fragment head to align? */
-				aligned->units = cur->units - delta;
-				aligned->next = cur->next;
-				cur->next = aligned;
-				cur->units = delta;
-				prev = cur;
-				cur = aligned;
-			}
-
-			if (cur->units == units) /* exact fit? */
-				prev->next = cur->next; /* unlink */
-			else { /* fragment */
-				prev->next = cur + units;
-				prev->next->units = cur->units - units;
-				prev->next->next = cur->next;
-				cur->units = units;
-			}
-
-			slobfree = prev;
-			spin_unlock_irqrestore(&slob_lock, flags);
-			return cur;
-		}
-		if (cur == slobfree) {
-			spin_unlock_irqrestore(&slob_lock, flags);
+	struct Page *page = alloc_pages(1 << cachep->order);
+	if (page == NULL)
+		return NULL;
+
+	size_t i;
+	for (i = 0; i < (1 << cachep->order); i ++) {
+		SetPageSlab(page + i);
+		page[i].property = i;
+	}
 
-			if (size == PAGE_SIZE) /* trying to shrink arena? */
-				return 0;
+	struct slab *slabp = page2kva(page);
+	kmem_bufctl_t *bufctl = slab_bufctl(slabp);
+	slabp->cache = cachep;
+	slabp->s_mem = (char *)slabp + cachep->offset;
+	slabp->inuse = 0;
+	slabp->free = 0;
+	for (i = 0; i < cachep->num; i ++) {
+		bufctl[i] = i + 1;
+		if (cachep->ctor != NULL)
+			cachep->ctor((char *)slabp->s_mem + i * cachep->objsize);
+	}
+	bufctl[cachep->num - 1] = BUFCTL_END;
+	return slabp;
+}
 
-			cur = (slob_t *)__slob_get_free_page(gfp);
-			if (!cur)
-				return 0;
+// 把空闲的 slab 归还 pmm. 不持锁调用
+static void
+kmem_slab_destroy(struct kmem_cache *cachep, struct slab *slabp)
+{
+	struct Page *page = kva2page(slabp);
+	size_t i;
+	for (i = 0; i < (1 << cachep->order); i ++) {
+		ClearPageSlab(page + i);
+		page[i].property = 0;
+	}
+	free_pages(page, 1 << cachep->order);
+}
 
-			slob_free(cur, PAGE_SIZE);
-			spin_lock_irqsave(&slob_lock, flags);
-			cur = slobfree;
-		}
+// 由对象地址找到所在的 slab
+static inline struct slab *
+obj2slab(const void *objp)
+{
+	struct Page *page = kva2page((void *)objp);
+	assert(PageSlab(page));
+	return page2kva(page - page->property);
+}
+
+// kmem_cache_create - 创建一个大小为 size, 按 align 对齐的对象 cache. ctor 可为 NULL
+struct kmem_cache *
+kmem_cache_create(const char *name, size_t size, size_t align, void (*ctor)(void *))
+{
+	struct kmem_cache *cachep = kmem_cache_alloc(&cache_cache);
+	if (cachep == NULL)
+		return NULL;
+	if (kmem_cache_setup(cachep, name, size, align, ctor) != 0) {
+		kmem_cache_free(&cache_cache, cachep);
+		return NULL;
 	}
+	return cachep;
 }
 
-static void slob_free(void *block, int size)
+// kmem_cache_destroy - 销毁 cache, 其中的对象必须已全部释放
+void
+kmem_cache_destroy(struct kmem_cache *cachep)
 {
-	slob_t *cur, *b = (slob_t *)block;
-	unsigned long flags;
+	assert(cachep->nr_active == 0 && cachep->nr_slabs == 0);
+	bool intr_flag;
+	local_intr_save(intr_flag);
+	list_del(&(cachep->cache_link));
+	local_intr_restore(intr_flag);
+	kmem_cache_free(&cache_cache, cachep);
+}
 
-	if (!block)
-		return;
+// kmem_cache_alloc - 从 cachep 分配一个对象, O(1)
+void *
+kmem_cache_alloc(struct kmem_cache *cachep)
+{
+	struct slab *slabp;
+	bool intr_flag;
+
+	local_intr_save(intr_flag);
+	if (list_empty(&(cachep->slabs_partial))) {
+		// 分配页时可能触发换出, 不能关中断
+		local_intr_restore(intr_flag);
+		if ((slabp = kmem_cache_grow(cachep)) == NULL)
+			return NULL;
+		local_intr_save(intr_flag);
+		list_add(&(cachep->slabs_partial), &(slabp->slab_link));
+		cachep->nr_slabs ++;
+	}
+	slabp = le2slab(list_next(&(cachep->slabs_partial)), slab_link);
+	void *objp = (char *)slabp->s_mem + slabp->free * cachep->objsize;
+	slabp->free = slab_bufctl(slabp)[slabp->free];
+	slabp->inuse ++;
+	if (slabp->free == BUFCTL_END) {
+		list_del(&(slabp->slab_link));
+		list_add(&(cachep->slabs_full), &(slabp->slab_link));
+	}
+	cachep->nr_active ++;
+#if KMALLOC_PROFILE
+	cachep->allocs ++;
+	if (cachep->nr_active > cachep->high)
+		cachep->high = cachep->nr_active;
+#endif
+	local_intr_restore(intr_flag);
+	return objp;
+}
 
-	if (size)
-		b->units = SLOB_UNITS(size);
+// kmem_cache_free - 把对象归还 cachep, O(1). slab 完全空闲时归还 pmm
+void
+kmem_cache_free(struct kmem_cache *cachep, void *objp)
+{
+	struct slab *slabp = obj2slab(objp);
+	bool intr_flag;
 
-	/* Find reinsertion point */
-	spin_lock_irqsave(&slob_lock, flags);
-	for (cur = slobfree; !(b > cur && b < cur->next); cur = cur->next)
-		if (cur >= cur->next && (b > cur || b < cur->next))
-			break;
+	assert(slabp->cache == cachep);
+	size_t idx = ((char *)objp - (char *)slabp->s_mem) / cachep->objsize;
+	assert(idx < cachep->num && (char *)slabp->s_mem + idx * cachep->objsize == objp);
 
-	if (b + b->units == cur->next) {
-		b->units += cur->next->units;
-		b->next = cur->next->next;
-	} else
-		b->next = cur->next;
+	local_intr_save(intr_flag);
+	if (slabp->free == BUFCTL_END) {
+		list_del(&(slabp->slab_link));
+		list_add(&(cachep->slabs_partial), &(slabp->slab_link));
+	}
+	slab_bufctl(slabp)[idx] = slabp->free;
+	slabp->free = idx;
+	slabp->inuse --;
+	cachep->nr_active --;
+#if KMALLOC_PROFILE
+	cachep->frees ++;
+#endif
+	if (slabp->inuse == 0) {
+		list_del(&(slabp->slab_link));
+		cachep->nr_slabs --;
+	}
+	else {
+		slabp = NULL;
+	}
+	local_intr_restore(intr_flag);
 
-	if (cur + cur->units == b) {
-		cur->units += b->units;
-		cur->next = b->next;
-	} else
-		cur->next = b;
+	if (slabp != NULL)
+		kmem_slab_destroy(cachep, slabp);
+}
 
-	slobfree = cur;
+// kmem_cache_size - cachep 中对象的实际大小
+size_t
+kmem_cache_size(struct kmem_cache *cachep)
+{
+	return cachep->objsize;
+}
 
-	spin_unlock_irqrestore(&slob_lock, flags);
+static inline struct kmem_cache *
+kmalloc_cache(size_t size)
+{
+	int i = 0;
+	while ((1 << (KMALLOC_MIN_SHIFT + i)) < size)
+		i ++;
+	return &kmalloc_caches[i];
 }
 
+static int ctor_count;
 
+static void
+check_slab_ctor(void *objp)
+{
+	memset(objp, 0x5a, 3 * sizeof(int));
+	ctor_count ++;
+}
 
 void check_slab(void) {
-  LOG("check_slab() success\n");
+	size_t nr_free_store = nr_free_pages();
+	struct kmem_cache *cachep;
+	assert((cachep = kmem_cache_create("check", 3 * sizeof(int), 0, check_slab_ctor)) != NULL);
+	assert(cachep->num > 0 && cachep->objsize == 16);
+
+	// 分配超过一个 slab 的对象: ctor 在新建 slab 时对每个对象调用一次
+	size_t n = cachep->num + 1, i;
+	void **objs = kmalloc(n * sizeof(void *));
+	assert(objs != NULL);
+	ctor_count = 0;
+	for (i = 0; i < n; i ++) {
+		assert((objs[i] = kmem_cache_alloc(cachep)) != NULL);
+		assert(*(int *)objs[i] == 0x5a5a5a5a);
+		assert(obj2slab(objs[i])->cache == cachep);
+	}
+	assert(ctor_count == 2 * cachep->num);
+	assert(cachep->nr_slabs == 2 && cachep->nr_active == n);
+	assert(obj2slab(objs[0]) == obj2slab(objs[n - 2]) && obj2slab(objs[0]) != obj2slab(objs[n - 1]));
+
+	// 释放后立即复用同一个对象, 且不再调用 ctor
+	void *objp = objs[1];
+	kmem_cache_free(cachep, objp);
+	assert(kmem_cache_alloc(cachep) == objp && ctor_count == 2 * cachep->num);
+
+	for (i = 0; i < n; i ++)
+		kmem_cache_free(cachep, objs[i]);
+	assert(cachep->nr_slabs == 0 && cachep->nr_active == 0);
+	kmem_cache_destroy(cachep);
+
+	// kmalloc 的大小类, kallocated 按实际占用计算
+	size_t allocated_store = kallocated();
+	void *p0 = kmalloc(1), *p1 = kmalloc(100), *p2 = kmalloc(KMALLOC_MAX_SIZE), *p3 = kmalloc(KMALLOC_MAX_SIZE + 1);
+	assert(p0 != NULL && p1 != NULL && p2 != NULL && p3 != NULL);
+	assert(kallocated() == allocated_store + 16 + 128 + KMALLOC_MAX_SIZE + PGSIZE);
+	assert(ksize(p0) == 16 && ksize(p1) == 128 && ksize(p2) == KMALLOC_MAX_SIZE && ksize(p3) == PGSIZE);
+	assert(((uintptr_t)p1 % L1_CACHE_BYTES) == 0 && ((uintptr_t)p3 % PGSIZE) == 0);
+	kfree(p0), kfree(p1), kfree(p2), kfree(p3);
+
+	// bigblock: 阶数记录在首页
+	void *p4 = kmalloc(3 * PGSIZE);
+	assert(p4 != NULL && ksize(p4) == 4 * PGSIZE);
+	assert(PageBigBlock(kva2page(p4)) && kva2page(p4)->property == 2);
+	kfree(p4);
+	assert(!PageBigBlock(kva2page(p4)));
+
+	assert(kallocated() == allocated_store);
+	kfree(objs);
+	assert(nr_free_pages() == nr_free_store);
+	LOG_TAB("%-20s%s\n","check_slab()", ": succeed!");
 }
 
 void
 slab_init(void) {
-  LOG("use SLOB allocator\n");
-  check_slab();
+	LOG("use SLAB allocator\n");
+	list_init(&cache_list);
+	int ret = kmem_cache_setup(&cache_cache, "kmem_cache", sizeof(struct kmem_cache), 0, NULL);
+	assert(ret == 0);
+	int i;
+	for (i = 0; i < KMALLOC_NR_CACHES; i ++) {
+		size_t size = (1 << (KMALLOC_MIN_SHIFT + i));
+		ret = kmem_cache_setup(&kmalloc_caches[i], kmalloc_names[i], size,
+				(size < L1_CACHE_BYTES) ? size : L1_CACHE_BYTES, NULL);
+		assert(ret == 0);
+	}
+	check_slab();
 }
 
-inline void 
+inline void
 kmalloc_init(void) {
     slab_init();
     LOG("kmalloc_init() succeeded!\n");
 }
 
+// slab_allocated - 所有 kmem_cache 中已分配对象占用的字节数
 size_t
 slab_allocated(void) {
-  return 0;
+	size_t total = 0;
+	bool intr_flag;
+	local_intr_save(intr_flag);
+	{
+		list_entry_t *le = &cache_list;
+		while ((le = list_next(le)) != &cache_list) {
+			struct kmem_cache *cachep = le2cache(le, cache_link);
+			total += cachep->nr_active * cachep->objsize;
+		}
+	}
+	local_intr_restore(intr_flag);
+	return total;
 }
 
+// kallocated - 内核堆当前占用的字节数: slab 对象与 bigblock
+//            - 只计已分配的对象, 不计 cache 留着的空 slab. 常驻的 cache 和内核线程都在启动时创建,
+//              init_main 前后的比较不受它们影响(见 init_main)
 size_t
 kallocated(void) {
-   return slab_allocated();
+	return slab_allocated() + bigblock_stat.nr_pages * PGSIZE;
 }
 
+#if KMALLOC_PROFILE
+/*
+ * kmalloc 调用点统计: 以调用者返回地址为键的开放寻址哈希表.
+ * 表满后新的调用点只计入 sites_dropped.
+ */
+#define KMALLOC_NR_SITES        128
+
+static struct kmalloc_site kmalloc_sites[KMALLOC_NR_SITES];
+static size_t sites_dropped;
+
+static void
+kmalloc_record_site(uintptr_t caller, size_t size)
+{
+	size_t i, idx = (caller >> 2) % KMALLOC_NR_SITES;
+	bool intr_flag;
+	local_intr_save(intr_flag);
+	for (i = 0; i < KMALLOC_NR_SITES; i ++, idx = (idx + 1) % KMALLOC_NR_SITES) {
+		struct kmalloc_site *site = &kmalloc_sites[idx];
+		if (site->caller == caller || site->caller == 0) {
+			site->caller = caller;
+			site->allocs ++;
+			site->bytes += size;
+			break;
+		}
+	}
+	if (i == KMALLOC_NR_SITES)
+		sites_dropped ++;
+	local_intr_restore(intr_flag);
+}
+
+// kmem_cache_get_stats - 取至多 n 个 cache 的统计, 最后一项为 bigblock. 返回实际项数
+int
+kmem_cache_get_stats(struct kmem_cache_stat *stats, int n)
+{
+	int i = 0;
+	bool intr_flag;
+	local_intr_save(intr_flag);
+	{
+		list_entry_t *le = &cache_list;
+		while (i < n - 1 && (le = list_next(le)) != &cache_list) {
+			struct kmem_cache *cachep = le2cache(le, cache_link);
+			stats[i].name = cachep->name;
+			stats[i].objsize = cachep->objsize;
+			stats[i].nr_slabs = cachep->nr_slabs;
+			stats[i].allocs = cachep->allocs;
+			stats[i].frees = cachep->frees;
+			stats[i].live_bytes = cachep->nr_active * cachep->objsize;
+			stats[i].high_bytes = cachep->high * cachep->objsize;
+			i ++;
+		}
+		if (i < n) {
+			stats[i].name = "bigblock";
+			stats[i].objsize = 0;
+			stats[i].nr_slabs = bigblock_stat.nr_pages;
+			stats[i].allocs = bigblock_stat.allocs;
+			stats[i].frees = bigblock_stat.frees;
+			stats[i].live_bytes = bigblock_stat.nr_pages * PGSIZE;
+			stats[i].high_bytes = bigblock_stat.high * PGSIZE;
+			i ++;
+		}
+	}
+	local_intr_restore(intr_flag);
+	return i;
+}
+
+// kmalloc_top_sites - 按分配次数从多到少取前 n 个调用点. 返回实际个数
+int
+kmalloc_top_sites(struct kmalloc_site *sites, int n)
+{
+	int i, j, cnt = 0;
+	bool intr_flag;
+	local_intr_save(intr_flag);
+	for (i = 0; i < KMALLOC_NR_SITES; i ++) {
+		struct kmalloc_site *site = &kmalloc_sites[i];
+		if (site->caller == 0)
+			continue;
+		// 插入排序, 只保留前 n 个
+		for (j = cnt; j > 0 && sites[j - 1].allocs < site->allocs; j --)
+			if (j < n)
+				sites[j] = sites[j - 1];
+		if (j < n) {
+			sites[j] = *site;
+			if (cnt < n)
+				cnt ++;
+		}
+	}
+	local_intr_restore(intr_flag);
+	return cnt;
+}
+#endif /* KMALLOC_PROFILE */
+
 static int find_order(int size)
 {
 	int order = 0;
@@ -222,88 +578,59 @@ static int find_order(int size)
 
 static void *__kmalloc(size_t size, gfp_t gfp)
 {
-	slob_t *m;
-	bigblock_t *bb;
-	unsigned long flags;
-
-	if (size < PAGE_SIZE - SLOB_UNIT) {
-		m = slob_alloc(size + SLOB_UNIT, gfp, 0);
-		return m ? (void *)(m + 1) : 0;
-	}
-
-	bb = slob_alloc(sizeof(bigblock_t), gfp, 0);
-	if (!bb)
+	if (size == 0)
 		return 0;
 
-	bb->order = find_order(size);
-	bb->pages = (void *)__slob_get_free_pages(gfp, bb->order);
+	if (size <= KMALLOC_MAX_SIZE)
+		return kmem_cache_alloc(kmalloc_cache(size));
 
-	if (bb->pages) {
-		spin_lock_irqsave(&block_lock, flags);
-		bb->next = bigblocks;
-		bigblocks = bb;
-		spin_unlock_irqrestore(&block_lock, flags);
-		return bb->pages;
-	}
-
-	slob_free(bb, sizeof(bigblock_t));
-	return 0;
+	return bigblock_alloc(find_order(size));
 }
 
 void *
 kmalloc(size_t size)
 {
-  return __kmalloc(size, 0);
+	void *objp = __kmalloc(size, 0);
+#if KMALLOC_PROFILE
+	if (objp != NULL)
+		kmalloc_record_site((uintptr_t)__builtin_return_address(0), size);
+#endif
+	return objp;
 }
 
 
 void kfree(void *block)
 {
-	bigblock_t *bb, **last = &bigblocks;
-	unsigned long flags;
-
 	if (!block)
 		return;
 
-	if (!((unsigned long)block & (PAGE_SIZE-1))) {
-		/* might be on the big block list */
-		spin_lock_irqsave(&block_lock, flags);
-		for (bb = bigblocks; bb; last = &bb->next, bb = bb->next) {
-			if (bb->pages == block) {
-				*last = bb->next;
-				spin_unlock_irqrestore(&block_lock, flags);
-				__slob_free_pages((unsigned long)block, bb->order);
-				slob_free(bb, sizeof(bigblock_t));
-				return;
-			}
-		}
-		spin_unlock_irqrestore(&block_lock, flags);
+	struct Page *page = kva2page(block);
+	if (PageSlab(page)) {
+		struct slab *slabp = obj2slab(block);
+		kmem_cache_free(slabp->cache, block);
+		return;
+	}
+	if (!((unsigned long)block & (PAGE_SIZE-1)) && PageBigBlock(page)) {
+		bigblock_free(page);
+		return;
 	}
 
-	slob_free((slob_t *)block - 1, 0);
-	return;
+	panic("kfree: bad pointer %08lx.\n", block);
 }
 
 
 unsigned int ksize(const void *block)
 {
-	bigblock_t *bb;
-	unsigned long flags;
-
 	if (!block)
 		return 0;
 
-	if (!((unsigned long)block & (PAGE_SIZE-1))) {
-		spin_lock_irqsave(&block_lock, flags);
-		for (bb = bigblocks; bb; bb = bb->next)
-			if (bb->pages == block) {
-				spin_unlock_irqrestore(&slob_lock, flags);
-				return PAGE_SIZE << bb->order;
-			}
-		spin_unlock_irqrestore(&block_lock, flags);
-	}
+	struct Page *page = kva2page((void *)block);
+	if (PageSlab(page))
+		return obj2slab(block)->cache->objsize;
+	if (!((unsigned long)block & (PAGE_SIZE-1)) && PageBigBlock(page))
+		return PAGE_SIZE << page->property;
 
-	return ((slob_t *)block - 1)->units * SLOB_UNIT;
+	return 0;
 }
 
 
@@ -5,12 +5,49 @@
 
 #define KMALLOC_MAX_ORDER       10
 
+// 置 1 时统计每个 cache 的分配/释放次数与最高水位, 并按调用者地址统计 kmalloc (kmonitor 的 kheap 命令);
+// 置 0 (默认) 则这些统计全部编译掉, 只保留 kallocated 所需的当前用量.
+#define KMALLOC_PROFILE         0
+
 void kmalloc_init(void);
 
 void *kmalloc(size_t n);
 void kfree(void *objp);
+unsigned int ksize(const void *objp);
+
+struct kmem_cache;
+
+struct kmem_cache *kmem_cache_create(const char *name, size_t size, size_t align, void (*ctor)(void *));
+void kmem_cache_destroy(struct kmem_cache *cachep);
+void *kmem_cache_alloc(struct kmem_cache *cachep);
+void kmem_cache_free(struct kmem_cache *cachep, void *objp);
+size_t kmem_cache_size(struct kmem_cache *cachep);
+
+#if KMALLOC_PROFILE
+// 一个 kmem_cache (或 bigblock) 的统计
+struct kmem_cache_stat {
+    const char *name;
+    size_t objsize;         // 对象大小, bigblock 为 0
+    size_t nr_slabs;        // 当前 slab 数, bigblock 为当前页数
+    size_t allocs;          // 累计分配次数
+    size_t frees;           // 累计释放次数
+    size_t live_bytes;      // 当前占用字节数
+    size_t high_bytes;      // 占用字节数的最高水位
+};
+
+// 一个 kmalloc 调用点的统计
+struct kmalloc_site {
+    uintptr_t caller;       // 调用 kmalloc 的返回地址
+    size_t allocs;          // 累计分配次数
+    size_t bytes;           // 累计请求的字节数
+};
+
+int kmem_cache_get_stats(struct kmem_cache_stat *stats, int n);
+int kmalloc_top_sites(struct kmalloc_site *sites, int n);
+#endif /* KMALLOC_PROFILE */
 
 size_t kallocated(void);
+size_t slab_allocated(void);
 
 #endif /* !__KERN_MM_SLAB_H__ */
 
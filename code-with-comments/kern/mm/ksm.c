@@ -0,0 +1,426 @@
+#include <defs.h>
+#include <string.h>
+#include <assert.h>
+#include <stdio.h>
+#include <sync.h>
+#include <pmm.h>
+#include <vmm.h>
+#include <kmalloc.h>
+#include <kdebug.h>
+#include <rb_tree.h>
+#include <proc.h>
+#include <sched.h>
+#include <ksm.h>
+
+/* *
+ * 扫描顺序: 按 ksm_mm_list 的顺序逐个 mm, 每个 mm 内按地址逐个 vma(跳过共享内存和大页),
+ * 只看在内存中且只有一处引用的页; 已被共享的页(fork 写时复制, 零页, 稳定页)不用再合并.
+ * 扫描位置(ksm_cursor, ksm_addr)跨唤醒保留, 走完所有 mm 为一轮; ksm_cursor 指向表头时从第一个 mm 开始.
+ *
+ * 内核不可抢占, 扫描过程中不睡眠, 所以对页表项和页内容的检查与随后的合并之间不会插入写操作.
+ * 持有 mm_sem 的进程可能睡在 fork/mmap 的中途, 此时跳过它的 mm.
+ * */
+
+// 稳定树结点
+struct ksm_stable_node {
+    rb_node rb_link;
+    uint32_t checksum;
+    struct Page *page;      // 合并后的页, 树持有一个引用
+};
+
+// 不稳定树中的候选页: 记录的是页表位置, 命中时要确认它仍映射着同一页且内容相同
+struct ksm_rmap_item {
+    rb_node rb_link;
+    uint32_t checksum;
+    struct mm_struct *mm;
+    uintptr_t addr;
+    struct Page *page;
+};
+
+#define rbn2stable(node)        to_struct((node), struct ksm_stable_node, rb_link)
+#define rbn2rmap(node)          to_struct((node), struct ksm_rmap_item, rb_link)
+#define le2ksm_mm(le)           to_struct((le), struct mm_struct, ksm_link)
+
+static struct kmem_cache *stable_node_cachep, *rmap_item_cachep;
+static rb_tree ksm_stable_tree, ksm_unstable_tree;
+
+// 登记的 mm 与扫描位置
+static list_entry_t ksm_mm_list = { &ksm_mm_list, &ksm_mm_list };
+static list_entry_t *ksm_cursor = &ksm_mm_list;
+static uintptr_t ksm_addr;
+
+static size_t ksm_pages_per_scan = KSM_PAGES_PER_SCAN;
+static size_t nr_ksm_mm, nr_stable, ksm_pages_scanned, ksm_full_scans, ksm_zero_merged;
+
+// 页内容的校验和(FNV-1a, 按 32 位字), 同时判断是否全零
+static uint32_t
+ksm_checksum(struct Page *page, bool *zero_store) {
+    uint32_t *p = page2kva(page), sum = 2166136261u, bits = 0;
+    int i;
+    for (i = 0; i < PGSIZE / sizeof(uint32_t); i ++) {
+        sum = (sum ^ p[i]) * 16777619u;
+        bits |= p[i];
+    }
+    *zero_store = (bits == 0);
+    return sum;
+}
+
+static int
+ksm_page_compare(uint32_t checksum_a, struct Page *a, uint32_t checksum_b, struct Page *b) {
+    if (checksum_a != checksum_b) {
+        return (checksum_a < checksum_b) ? -1 : 1;
+    }
+    return (a == b) ? 0 : memcmp(page2kva(a), page2kva(b), PGSIZE);
+}
+
+// 稳定树按校验和排序, 校验和相同时按内容排序
+static int
+stable_compare(rb_node *a, rb_node *b) {
+    struct ksm_stable_node *na = rbn2stable(a), *nb = rbn2stable(b);
+    return ksm_page_compare(na->checksum, na->page, nb->checksum, nb->page);
+}
+
+// 查找稳定树时的关键字
+struct ksm_key {
+    uint32_t checksum;
+    struct Page *page;
+};
+
+static int
+stable_search(rb_node *node, void *key) {
+    struct ksm_stable_node *sn = rbn2stable(node);
+    struct ksm_key *k = key;
+    return ksm_page_compare(sn->checksum, sn->page, k->checksum, k->page);
+}
+
+// 不稳定树中的页内容随时可能变化, 只按校验和排序, 命中后再比较内容
+static int
+unstable_compare(rb_node *a, rb_node *b) {
+    uint32_t ca = rbn2rmap(a)->checksum, cb = rbn2rmap(b)->checksum;
+    return (ca == cb) ? 0 : ((ca < cb) ? -1 : 1);
+}
+
+static int
+unstable_search(rb_node *node, void *key) {
+    uint32_t c = rbn2rmap(node)->checksum, k = *(uint32_t *)key;
+    return (c == k) ? 0 : ((c < k) ? -1 : 1);
+}
+
+// 把 addr 处的映射换成只读地映射 kpage, 原来的页(只有这一处引用)随之释放
+static void
+ksm_replace(struct mm_struct *mm, uintptr_t addr, pte_t *ptep, struct Page *kpage) {
+    uint32_t perm = *ptep & (PTE_U | PTE_A | PTE_PREFAULT);
+    int ret = page_insert(mm->pgdir, kpage, addr, perm);
+    assert(ret == 0);   // 页表已存在, 不会分配内存
+}
+
+// 候选页仍映射在原处, 且没有被 fork 共享时才能作为合并的目标
+static pte_t *
+rmap_item_check(struct ksm_rmap_item *item) {
+    pte_t *ptep;
+    if (item->mm->pgdir == NULL || (ptep = get_pte(item->mm->pgdir, item->addr, 0)) == NULL) {
+        return NULL;
+    }
+    if (!(*ptep & PTE_P) || (*ptep & PTE_PS) || pte2page(*ptep) != item->page || page_ref(item->page) != 1) {
+        return NULL;
+    }
+    return ptep;
+}
+
+static void
+rmap_item_remove(struct ksm_rmap_item *item) {
+    rb_delete(&ksm_unstable_tree, &(item->rb_link));
+    kmem_cache_free(rmap_item_cachep, item);
+}
+
+// 在不稳定树中为 mm 的 addr 处的页找相同的页, 找到则两者合并为一个稳定页, 否则把它加入不稳定树
+static void
+ksm_merge_unstable(struct mm_struct *mm, uintptr_t addr, pte_t *ptep, struct Page *page, uint32_t checksum) {
+    struct ksm_rmap_item *item;
+    rb_node *node;
+    if ((node = rb_search(&ksm_unstable_tree, unstable_search, &checksum)) != NULL) {
+        item = rbn2rmap(node);
+        pte_t *iptep = rmap_item_check(item);
+        if (iptep == NULL) {
+            rmap_item_remove(item);
+        }
+        else if (item->page != page && memcmp(page2kva(item->page), page2kva(page), PGSIZE) == 0) {
+            struct ksm_stable_node *snode;
+            if ((snode = kmem_cache_alloc(stable_node_cachep)) == NULL) {
+                return ;
+            }
+            // 候选页成为稳定页: 原映射改为只读, 树持有一个引用, 之后的写都会复制
+            *iptep &= ~(PTE_W | PTE_D);
+            tlb_invalidate(item->mm->pgdir, item->addr);
+            snode->checksum = checksum;
+            snode->page = item->page;
+            page_ref_inc(snode->page);
+            rb_insert(&ksm_stable_tree, &(snode->rb_link), stable_compare);
+            nr_stable ++;
+            rmap_item_remove(item);
+            ksm_replace(mm, addr, ptep, snode->page);
+            return ;
+        }
+    }
+    if ((item = kmem_cache_alloc(rmap_item_cachep)) != NULL) {
+        item->checksum = checksum;
+        item->mm = mm, item->addr = addr, item->page = page;
+        rb_insert(&ksm_unstable_tree, &(item->rb_link), unstable_compare);
+    }
+}
+
+// ksm_scan_page - 扫描 mm 中 addr 处的页(页表项 ptep 在内存中)
+static void
+ksm_scan_page(struct mm_struct *mm, uintptr_t addr, pte_t *ptep) {
+    struct Page *page = pte2page(*ptep);
+    ksm_pages_scanned ++;
+    if (page_ref(page) != 1) {
+        return ;
+    }
+    // 上一轮之后写过: 内容还在变化, 合并了很快又要复制. 清除 PTE_D, 下一轮再看
+    if (*ptep & PTE_D) {
+        *ptep &= ~PTE_D;
+        tlb_invalidate(mm->pgdir, addr);
+        return ;
+    }
+
+    bool zero;
+    uint32_t checksum = ksm_checksum(page, &zero);
+    if (zero) {
+        ksm_replace(mm, addr, ptep, zero_page);
+        ksm_zero_merged ++;
+        return ;
+    }
+    struct ksm_key key = {checksum, page};
+    rb_node *node;
+    if ((node = rb_search(&ksm_stable_tree, stable_search, &key)) != NULL) {
+        ksm_replace(mm, addr, ptep, rbn2stable(node)->page);
+        return ;
+    }
+    ksm_merge_unstable(mm, addr, ptep, page, checksum);
+}
+
+// 释放不再被映射的稳定页(只剩树的引用)
+static void
+ksm_prune_stable(void) {
+    rb_node *node = rb_first(&ksm_stable_tree), *next;
+    for (; node != NULL; node = next) {
+        next = rb_next(node);
+        struct ksm_stable_node *snode = rbn2stable(node);
+        if (page_ref(snode->page) == 1) {
+            rb_delete(&ksm_stable_tree, node);
+            page_ref_dec(snode->page);
+            free_page(snode->page);
+            kmem_cache_free(stable_node_cachep, snode);
+            nr_stable --;
+        }
+    }
+}
+
+static void
+ksm_clear_unstable(void) {
+    rb_node *node;
+    while ((node = rb_first(&ksm_unstable_tree)) != NULL) {
+        rmap_item_remove(rbn2rmap(node));
+    }
+}
+
+// 一轮扫描结束: 不稳定树中的页到下一轮可能已经改变, 全部丢弃
+static void
+ksm_end_pass(void) {
+    ksm_clear_unstable();
+    ksm_prune_stable();
+    ksm_full_scans ++;
+}
+
+// 扫描下一个 mm, 走完所有 mm 时结束一轮
+static void
+ksm_next_mm(void) {
+    ksm_cursor = list_next(ksm_cursor);
+    ksm_addr = 0;
+    if (ksm_cursor == &ksm_mm_list) {
+        ksm_end_pass();
+        ksm_cursor = list_next(ksm_cursor);
+    }
+}
+
+// ksm_scan_mm - 从 ksm_addr 开始扫描 mm, 最多 n 页. 扫完整个 mm 时把 ksm_cursor 移到下一个 mm
+static size_t
+ksm_scan_mm(struct mm_struct *mm, size_t n) {
+    size_t scanned = 0;
+    list_entry_t *list = &(mm->mmap_list), *le = list;
+    while ((le = list_next(le)) != list) {
+        struct vma_struct *vma = le2vma(le, list_link);
+        if (vma->vm_end <= ksm_addr || vma->vm_shmem != NULL) {
+            continue;
+        }
+        uintptr_t addr = (ksm_addr > vma->vm_start) ? ksm_addr : vma->vm_start;
+        while (addr < vma->vm_end) {
+            if (scanned == n) {
+                ksm_addr = addr;
+                return scanned;
+            }
+            pte_t *ptep = get_pte(mm->pgdir, addr, 0);
+            if (ptep == NULL || (*ptep & PTE_PS)) {
+                addr = ROUNDDOWN(addr + PTSIZE, PTSIZE);
+                continue;
+            }
+            if (*ptep & PTE_P) {
+                ksm_scan_page(mm, addr, ptep);
+                scanned ++;
+            }
+            addr += PGSIZE;
+        }
+        ksm_addr = vma->vm_end;
+    }
+    ksm_next_mm();
+    return scanned;
+}
+
+/**
+ * ksm_scan - 从上次停下的位置继续扫描登记的 mm, 最多 n 页, 返回扫描的页数.
+ * 一次调用最多走完两轮, 避免所有 mm 都被锁住时空转.
+ */
+size_t
+ksm_scan(size_t n) {
+    size_t scanned = 0, full_scans = ksm_full_scans;
+    while (scanned < n && !list_empty(&ksm_mm_list) && ksm_full_scans - full_scans < 2) {
+        if (ksm_cursor == &ksm_mm_list) {
+            ksm_cursor = list_next(ksm_cursor);
+        }
+        struct mm_struct *mm = le2ksm_mm(ksm_cursor);
+        if (mm->pgdir == NULL || !try_down(&(mm->mm_sem))) {
+            ksm_next_mm();
+            continue;
+        }
+        scanned += ksm_scan_mm(mm, n - scanned);
+        up(&(mm->mm_sem));
+    }
+    return scanned;
+}
+
+static void
+ksm_wakeup(void) {
+    if (ksmproc != NULL && ksmproc->state == PROC_SLEEPING && ksmproc->wait_state == WT_KSM) {
+        wakeup_proc(ksmproc);
+    }
+}
+
+// ksm_register - 让 ksmproc 扫描 mm
+void
+ksm_register(struct mm_struct *mm) {
+    bool intr_flag;
+    local_intr_save(intr_flag);
+    {
+        if (!mm->ksm) {
+            mm->ksm = 1;
+            list_add_before(&ksm_mm_list, &(mm->ksm_link));
+            nr_ksm_mm ++;
+            ksm_wakeup();
+        }
+    }
+    local_intr_restore(intr_flag);
+}
+
+// ksm_unregister - 停止扫描 mm. 已合并的页保持共享, 直到被写时复制
+void
+ksm_unregister(struct mm_struct *mm) {
+    bool intr_flag;
+    local_intr_save(intr_flag);
+    if (mm->ksm) {
+        rb_node *node = rb_first(&ksm_unstable_tree), *next;
+        for (; node != NULL; node = next) {
+            next = rb_next(node);
+            if (rbn2rmap(node)->mm == mm) {
+                rmap_item_remove(rbn2rmap(node));
+            }
+        }
+        if (ksm_cursor == &(mm->ksm_link)) {
+            ksm_next_mm();
+        }
+        list_del(&(mm->ksm_link));
+        if (ksm_cursor == &(mm->ksm_link)) {
+            ksm_cursor = &ksm_mm_list;      // 它是唯一的 mm
+        }
+        mm->ksm = 0;
+        nr_ksm_mm --;
+    }
+    local_intr_restore(intr_flag);
+}
+
+// ksm_exit_mm - mm 销毁前调用. 没有登记的 mm 后 ksmproc 不再运行, 在此释放剩下的稳定页
+void
+ksm_exit_mm(struct mm_struct *mm) {
+    ksm_unregister(mm);
+    if (list_empty(&ksm_mm_list)) {
+        ksm_clear_unstable();
+        ksm_prune_stable();
+    }
+}
+
+// ksm_set_pages_per_scan - 设置每次唤醒扫描的页数, 0 关闭扫描
+void
+ksm_set_pages_per_scan(size_t n) {
+    ksm_pages_per_scan = n;
+    ksm_wakeup();
+}
+
+void
+ksm_get_stat(struct ksm_stat *stat) {
+    bool intr_flag;
+    local_intr_save(intr_flag);
+    {
+        stat->pages_per_scan = ksm_pages_per_scan;
+        stat->nr_mm = nr_ksm_mm;
+        stat->pages_scanned = ksm_pages_scanned;
+        stat->full_scans = ksm_full_scans;
+        stat->pages_shared = nr_stable;
+        stat->pages_sharing = stat->pages_saved = 0;
+        rb_node *node;
+        for (node = rb_first(&ksm_stable_tree); node != NULL; node = rb_next(node)) {
+            int ref = page_ref(rbn2stable(node)->page);
+            stat->pages_sharing += ref - 1;
+            if (ref > 2) {
+                stat->pages_saved += ref - 2;
+            }
+        }
+        stat->zero_merged = ksm_zero_merged;
+    }
+    local_intr_restore(intr_flag);
+}
+
+/**
+ * ksm_main - ksmproc 内核线程执行函数
+ * 有登记的 mm 时每次扫描 pages_per_scan 页后睡眠 KSM_SLEEP_TIME, 限制扫描占用的 CPU;
+ * 否则睡眠直到有 mm 登记或重新打开扫描.
+ */
+int
+ksm_main(void *arg) {
+    lab6_set_priority(1);
+    while (1) {
+        if (ksm_pages_per_scan != 0 && !list_empty(&ksm_mm_list)) {
+            ksm_scan(ksm_pages_per_scan);
+            do_sleep(KSM_SLEEP_TIME);
+            continue;
+        }
+        bool intr_flag;
+        local_intr_save(intr_flag);
+        {
+            current->state = PROC_SLEEPING;
+            current->wait_state = WT_KSM;
+        }
+        local_intr_restore(intr_flag);
+        schedule();
+    }
+    return 0;
+}
+
+void
+ksm_init(void) {
+    stable_node_cachep = kmem_cache_create("ksm_stable_node", sizeof(struct ksm_stable_node), 0, NULL);
+    rmap_item_cachep = kmem_cache_create("ksm_rmap_item", sizeof(struct ksm_rmap_item), 0, NULL);
+    assert(stable_node_cachep != NULL && rmap_item_cachep != NULL);
+    rb_tree_init(&ksm_stable_tree);
+    rb_tree_init(&ksm_unstable_tree);
+}
+
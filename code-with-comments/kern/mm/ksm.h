@@ -0,0 +1,42 @@
+#ifndef __KERN_MM_KSM_H__
+#define __KERN_MM_KSM_H__
+
+#include <defs.h>
+
+struct mm_struct;
+
+/**
+ * KSM(kernel samepage merging): 合并内容相同的匿名页.
+ *
+ * 登记过的 mm(SYS_ksm, fork 时继承)由内核线程 ksmproc 周期性地扫描, 每次最多扫描
+ * pages_per_scan 页. 内容相同的页合并为一个只读页, 之后的写由 do_pgfault 的写时复制处理.
+ *  - 稳定树: 已合并的页, 按校验和与内容排序. 树持有每页的一个引用, 所以合并页总是只读, 内容不会再变;
+ *  - 不稳定树: 本轮扫描中还没找到相同页的候选页, 按校验和排序. 内容可能已变, 命中后要重新校验, 每轮结束时清空.
+ * 上一轮扫描后写过(PTE_D)的页被认为还在变化, 只清除 PTE_D 不参与合并. 全零的页直接换成共享零页.
+ */
+#define KSM_PAGES_PER_SCAN      256     // 每次唤醒扫描的页数(默认值)
+#define KSM_SLEEP_TIME          1       // 两次扫描之间睡眠的时间
+
+// KSM 的统计信息
+struct ksm_stat {
+    size_t pages_per_scan;  // 每次唤醒扫描的页数, 0 表示关闭
+    size_t nr_mm;           // 登记的 mm 数
+    size_t pages_scanned;   // 累计扫描的页数
+    size_t full_scans;      // 完整扫描的轮数
+    size_t pages_shared;    // 稳定树中的页数
+    size_t pages_sharing;   // 映射稳定树中页的页表项数
+    size_t pages_saved;     // 合并省下的页数: 每个稳定页的映射数减一之和
+    size_t zero_merged;     // 累计换成共享零页的页数
+};
+
+void ksm_init(void);
+int ksm_main(void *arg);
+void ksm_register(struct mm_struct *mm);
+void ksm_unregister(struct mm_struct *mm);
+void ksm_exit_mm(struct mm_struct *mm);
+size_t ksm_scan(size_t n);
+void ksm_set_pages_per_scan(size_t n);
+void ksm_get_stat(struct ksm_stat *stat);
+
+#endif /* !__KERN_MM_KSM_H__ */
+
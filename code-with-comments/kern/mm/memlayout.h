@@ -41,7 +41,9 @@
  *                            |   Cur. Page Table (Kern, RW)    | RW/-- PTSIZE  = 4M, 拜 VPT 所赐,内容就是一级页表的内容
  *     VPT -----------------> +---------------------------------+ 0xFAC00000    = 4012M = 1003/1024 * 4096 自映射一级页表起始
  *                            |        Invalid Memory (*)       | --/--
- *     KERNTOP -------------> +---------------------------------+ 0xF8000000    = 3968M
+ *     KSTACKTOP -----------> +---------------------------------+ 0xF9000000
+ *                            |   Kernel Stacks (guard + stack) | RW/-- KSTACKAREA = 16M, 各进程的内核栈, 按需逐页映射
+ *     KSTACKBASE, KERNTOP -> +---------------------------------+ 0xF8000000    = 3968M
  *                            |                                 |
  *                            |    Remapped Physical Memory     | RW/-- KMEMSIZE = 896MB, ucore 最大支持的物理内存大小
  *                            |                                 |               <=  maxpa = min{maxpa, KMEMSIZE},实际管理的物理内存大小
@@ -83,6 +85,13 @@
 #define KSTACKPAGE          2                           // # of pages in kernel stack
 #define KSTACKSIZE          (KSTACKPAGE * PGSIZE)       // sizeof kernel stack
 
+/* 内核栈区: 进程的内核栈映射在 [KSTACKBASE, KSTACKTOP), 每个栈占一个槽, 槽底的 KSTACKGUARD 页不映射 */
+#define KSTACKBASE          KERNTOP
+#define KSTACKAREA          0x01000000                  // 16M, 4 个二级页表
+#define KSTACKTOP           (KSTACKBASE + KSTACKAREA)
+#define KSTACKGUARD         1                           // 每个内核栈下方的保护页数, 0 表示不设保护页
+#define KSTACKSLOT          ((KSTACKPAGE + KSTACKGUARD) * PGSIZE)
+
 #define USERTOP             0xB0000000
 #define USTACKTOP           USERTOP
 #define USTACKPAGE          256                         // # of pages in user stack
@@ -99,10 +108,10 @@
 (USERBASE <= (start) && (start) < (end) && (end) <= USERTOP)
 
 /**
- * 判断所给的地址区间是否属于内核区,即位于 KERNBASE 和 KERNTOP 之内.
+ * 判断所给的地址区间是否属于内核区,即位于 KERNBASE 和 KSTACKTOP 之内(内核线程的参数可能在其内核栈上).
  */ 
 #define KERN_ACCESS(start, end)                     \
-(KERNBASE <= (start) && (start) < (end) && (end) <= KERNTOP)
+(KERNBASE <= (start) && (start) < (end) && (end) <= KSTACKTOP)
 
 #ifndef __ASSEMBLER__
 
@@ -150,6 +159,7 @@ struct Page {
 /* Flags describing the status of a page frame */
 #define PG_reserved                 0       // the page descriptor is reserved for kernel or unusable
 #define PG_property                 1       // the member 'property' is valid
+#define PG_tail                     3       // last page of a free block, 'property' holds the block size (tlsf_pmm)
 
 #define SetPageReserved(page)       set_bit(PG_reserved, &((page)->flags)) // 标记为从不换出
 #define ClearPageReserved(page)     clear_bit(PG_reserved, &((page)->flags))
@@ -157,6 +167,9 @@ struct Page {
 #define SetPageProperty(page)       set_bit(PG_property, &((page)->flags))
 #define ClearPageProperty(page)     clear_bit(PG_property, &((page)->flags))
 #define PageProperty(page)          test_bit(PG_property, &((page)->flags))
+#define SetPageTail(page)           set_bit(PG_tail, &((page)->flags))
+#define ClearPageTail(page)         clear_bit(PG_tail, &((page)->flags))
+#define PageTail(page)              test_bit(PG_tail, &((page)->flags))
 
 // convert list entry to page
 #define le2page(le, member)                 \
@@ -169,10 +182,14 @@ typedef struct {
 } free_area_t;
 
 /* for slab style kmalloc */
-//#define PG_slab                     2       // page frame is included in a slab
-//#define SetPageSlab(page)           set_bit(PG_slab, &((page)->flags))
-//#define ClearPageSlab(page)         clear_bit(PG_slab, &((page)->flags))
-//#define PageSlab(page)              test_bit(PG_slab, &((page)->flags))
+#define PG_slab                     2       // page frame is included in a slab, 'property' holds the page index within the slab
+#define SetPageSlab(page)           set_bit(PG_slab, &((page)->flags))
+#define ClearPageSlab(page)         clear_bit(PG_slab, &((page)->flags))
+#define PageSlab(page)              test_bit(PG_slab, &((page)->flags))
+#define PG_bigblock                 4       // first page of a kmalloc big block, 'property' holds the block order
+#define SetPageBigBlock(page)       set_bit(PG_bigblock, &((page)->flags))
+#define ClearPageBigBlock(page)     clear_bit(PG_bigblock, &((page)->flags))
+#define PageBigBlock(page)          test_bit(PG_bigblock, &((page)->flags))
 
 #endif /* !__ASSEMBLER__ */
 
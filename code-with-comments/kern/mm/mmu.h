@@ -222,6 +222,7 @@ struct taskstate {
 // 取出页表项中的包含的地址部分.即取低高 20 位.注意取出的结果是物理地址.
 #define PTE_ADDR(pte)   ((uintptr_t)(pte) & ~0xFFF)
 #define PDE_ADDR(pde)   PTE_ADDR(pde)
+#define PDE_LARGE_ADDR(pde) ((uintptr_t)(pde) & ~(PTSIZE - 1))   // address in a 4MB (PTE_PS) page directory entry
 
 /* page directory and page table constants */
 #define NPDEENTRY       1024                    // 每个一级页表包含的项数,即一个一级页表维护 1024 * 4M = 4G
@@ -244,10 +245,12 @@ struct taskstate {
 #define PTE_A           0x020                   // Accessed
 #define PTE_D           0x040                   // Dirty
 #define PTE_PS          0x080                   // Page Size
+#define PTE_G           0x100                   // Global: not flushed from TLB on cr3 reload (needs CR4_PGE)
 #define PTE_MBZ         0x180                   // Bits must be zero
 #define PTE_AVAIL       0xE00                   // Available for software use
                                                 // The PTE_AVAIL bits aren't used by the kernel or interpreted by the
                                                 // hardware, so user processes are allowed to set them arbitrarily.
+#define PTE_PREFAULT    0x200                   // software: mapped ahead by fault-around (see do_pgfault)
 
 #define PTE_USER        (PTE_U | PTE_W | PTE_P)
 
@@ -265,6 +268,7 @@ struct taskstate {
 #define CR0_PG          0x80000000              // Paging
 
 #define CR4_PCE         0x00000100              // Performance counter enable
+#define CR4_PGE         0x00000080              // Page Global Enable
 #define CR4_MCE         0x00000040              // Machine Check Enable
 #define CR4_PSE         0x00000010              // Page Size Extensions
 #define CR4_DE          0x00000008              // Debugging Extensions
@@ -272,5 +276,9 @@ struct taskstate {
 #define CR4_PVI         0x00000002              // Protected-Mode Virtual Interrupts
 #define CR4_VME         0x00000001              // V86 Mode Extensions
 
+/* CPUID.1:EDX feature flags */
+#define CPUID_FEAT_PSE  0x00000008              // Page Size Extensions
+#define CPUID_FEAT_PGE  0x00002000              // Page Global Enable
+
 #endif /* !__KERN_MM_MMU_H__ */
 
@@ -6,11 +6,14 @@
 #include <memlayout.h>
 #include <pmm.h>
 #include <default_pmm.h>
+#include <buddy_pmm.h>
+#include <tlsf_pmm.h>
 #include <sync.h>
 #include <error.h>
 #include <swap.h>
 #include <vmm.h>
 #include <kmalloc.h>
+#include <shmem.h>
 #include <kdebug.h>
 
 /* *
@@ -49,6 +52,9 @@ pde_t *boot_pgdir = &__boot_pgdir;
 // boot-time 一级页表的物理地址
 uintptr_t boot_cr3;
 
+// 处理器支持且已开启 CR4.PSE: 内核直接映射区使用 4MB 大页
+static bool large_pages = 0;
+
 // physical memory management
 const struct pmm_manager *pmm_manager;
 
@@ -64,6 +70,9 @@ const struct pmm_manager *pmm_manager;
  * A second consequence is that the contents of the current page directory will
  * always available at virtual address PGADDR(PDX(VPT), PDX(VPT), 0), to which
  * vpd is set bellow.
+ *
+ * 注意: 设置了 PTE_PS 的一级页表项(4MB 大页)没有二级页表, 此时 vpt 中对应的 1024 项
+ * 实际是被当作页表解释的大页数据本身, 没有意义; 遍历 vpt 前需先检查 vpd 中的 PTE_PS.
  * */
 pte_t * const vpt = (pte_t *)VPT;
 pde_t * const vpd = (pde_t *)PGADDR(PDX(VPT), PDX(VPT), 0);
@@ -104,6 +113,10 @@ static struct pseudodesc gdt_pd = {
 };
 
 static void check_alloc_page(void);
+static void check_page_cache(void);
+static void check_zero_pool(void);
+static void check_pgtable_cache(void);
+static void check_alloc_pages_bulk(void);
 static void check_pgdir(void);
 static void check_boot_pgdir(void);
 
@@ -172,9 +185,13 @@ gdt_init(void) {
 }
 
 //init_pmm_manager - 配置一个内存管理器实例
+// 可选实例:
+//      default_pmm_manager : first fit, 分配/释放需遍历 free list
+//      buddy_pmm_manager   : 伙伴系统, 分配/释放 O(log n)
+//      tlsf_pmm_manager    : two-level segregated fit, 分配/释放最坏情况 O(1). 不论选用哪个, pmm_init 都运行 tlsf_check 与 first fit 对比最坏周期数
 static void
 init_pmm_manager(void) {
-    pmm_manager = &default_pmm_manager;
+    pmm_manager = &buddy_pmm_manager;
     pmm_manager->init();
     LOG_TAB("物理内存管理器实例- %s 初始化完毕.\n",pmm_manager->name);
 }
@@ -185,6 +202,455 @@ init_memmap(struct Page *base, size_t n) {
     pmm_manager->init_memmap(base, n);
 }
 
+/**
+ * 单页缓存(page cache), 位于 alloc_pages/free_pages 与 pmm_manager 之间.
+ *
+ * 绝大多数分配请求都是单页: 缺页(pgdir_alloc_page), 二级页表(get_pte), 换入(swap_in).
+ * 最近释放的单页暂存在 page_cache.list 中, 分配时直接弹出, 无需进入 pmm_manager.
+ *      - 热页(刚释放, 很可能仍在 cache 中)插入头部, 冷页插入尾部; 分配总是取头部.
+ *      - 缓存为空时从 pmm_manager 批量补充 PAGE_CACHE_BATCH 页(记为 miss);
+ *      - 缓存超过 PAGE_CACHE_HIGH 时从尾部批量归还 PAGE_CACHE_BATCH 页.
+ * 缓存中的页仍计入 nr_free_pages.
+ */
+#define PAGE_CACHE_HIGH         64
+#define PAGE_CACHE_BATCH        16
+
+static struct {
+    list_entry_t list;      // 头部为热页, 尾部为冷页
+    size_t count;           // 缓存页数
+    bool enabled;
+    struct page_cache_stat stat;
+} page_cache;
+
+// 从 pmm_manager 批量分配, 不支持批量接口的 pmm_manager 退化为逐页分配. 调用者需关中断
+static size_t
+pmm_manager_alloc_bulk(size_t n, struct Page **array) {
+    if (pmm_manager->alloc_pages_bulk != NULL) {
+        return pmm_manager->alloc_pages_bulk(n, array);
+    }
+    size_t i;
+    for (i = 0; i < n; i ++) {
+        if ((array[i] = pmm_manager->alloc_pages(1)) == NULL) {
+            break;
+        }
+    }
+    return i;
+}
+
+// 向 pmm_manager 释放 array 中的 n 个单页, 物理上连续的页合并为一次 free_pages. 调用者需关中断
+static void
+pmm_manager_free_bulk(struct Page **array, size_t n) {
+    size_t i = 0, run;
+    while (i < n) {
+        for (run = 1; i + run < n && array[i + run] == array[i] + run; run ++) {
+            /* empty */ ;
+        }
+        pmm_manager->free_pages(array[i], run);
+        i += run;
+    }
+}
+
+// 从 pmm_manager 批量补充(一次批量分配), 返回补充的页数. 调用者需关中断
+static size_t
+page_cache_refill(void) {
+    struct Page *array[PAGE_CACHE_BATCH];
+    size_t i, n = pmm_manager_alloc_bulk(PAGE_CACHE_BATCH, array);
+    for (i = 0; i < n; i ++) {
+        list_add_before(&(page_cache.list), &(array[i]->page_link));
+    }
+    page_cache.count += n;
+    page_cache.stat.refill ++;
+    return n;
+}
+
+// 从尾部(冷端)向 pmm_manager 归还至多 n 页, 每 PAGE_CACHE_BATCH 页一批. 调用者需关中断
+static void
+page_cache_shrink(size_t n) {
+    struct Page *array[PAGE_CACHE_BATCH];
+    while (n > 0 && page_cache.count > 0) {
+        size_t nr = 0;
+        while (nr < PAGE_CACHE_BATCH && n > 0 && page_cache.count > 0) {
+            list_entry_t *le = list_prev(&(page_cache.list));
+            list_del(le);
+            page_cache.count --;
+            array[nr ++] = le2page(le, page_link);
+            n --;
+        }
+        pmm_manager_free_bulk(array, nr);
+    }
+    page_cache.stat.drain ++;
+}
+
+static struct Page *
+page_cache_alloc(void) {
+    if (page_cache.count == 0) {
+        page_cache.stat.miss ++;
+        if (page_cache_refill() == 0) {
+            return NULL;
+        }
+    }
+    else {
+        page_cache.stat.hit ++;
+    }
+    list_entry_t *le = list_next(&(page_cache.list));
+    list_del(le);
+    page_cache.count --;
+    return le2page(le, page_link);
+}
+
+static void
+page_cache_free(struct Page *page, bool cold) {
+    assert(!PageReserved(page) && !PageProperty(page));
+    set_page_ref(page, 0);
+    if (cold) {
+        list_add_before(&(page_cache.list), &(page->page_link));
+    }
+    else {
+        list_add(&(page_cache.list), &(page->page_link));
+    }
+    page_cache.count ++;
+    if (page_cache.count > PAGE_CACHE_HIGH) {
+        page_cache_shrink(PAGE_CACHE_BATCH);
+    }
+}
+
+static void
+page_cache_init(void) {
+    list_init(&(page_cache.list));
+    page_cache.count = 0;
+    memset(&(page_cache.stat), 0, sizeof(page_cache.stat));
+    page_cache.enabled = 1;
+}
+
+// page_cache_drain - 把缓存中的所有页归还给 pmm_manager
+void
+page_cache_drain(void) {
+    bool intr_flag;
+    local_intr_save(intr_flag);
+    {
+        page_cache_shrink(page_cache.count);
+    }
+    local_intr_restore(intr_flag);
+}
+
+// page_cache_enable - 开关单页缓存, 关闭前先归还全部缓存页. 用于需要精确控制 pmm_manager 的测试
+void
+page_cache_enable(bool enable) {
+    if (!enable) {
+        page_cache_drain();
+    }
+    page_cache.enabled = enable;
+}
+
+void
+page_cache_get_stat(struct page_cache_stat *stat) {
+    *stat = page_cache.stat;
+    stat->count = page_cache.count;
+}
+
+/**
+ * 预清零页池(zero pool).
+ *
+ * 二级页表(get_pte)和匿名页缺页(do_pgfault)拿到的新页都必须先清零, 这一次 memset 发生在关键路径上.
+ * 清零本身与请求无关, 可以提前做: 内核线程 zeroproc 在 CPU 空闲时(cpu_idle 无进程可调度)
+ * 申请空闲页清零后放入 zero_pool, alloc_page_zeroed 直接取用, 池空时才退化为 alloc_page + memset.
+ *      - 池的目标页数为 ZERO_POOL_HIGH;
+ *      - 空闲页少于 ZERO_POOL_RESERVE 时不再填充, 避免与正常分配争抢内存;
+ *      - 内存耗尽时 alloc_pages 会先回收池中的页, 再考虑换出.
+ * 池中的页与单页缓存一样计入 nr_free_pages.
+ */
+#define ZERO_POOL_HIGH          64
+#define ZERO_POOL_RESERVE       256
+
+static struct {
+    list_entry_t list;
+    size_t count;
+    struct zero_pool_stat stat;
+} zero_pool;
+
+// 向 pmm_manager 归还池中至多 n 页. 调用者需关中断
+static void
+zero_pool_shrink(size_t n) {
+    while (n -- > 0 && zero_pool.count > 0) {
+        list_entry_t *le = list_next(&(zero_pool.list));
+        list_del(le);
+        zero_pool.count --;
+        pmm_manager->free_pages(le2page(le, page_link), 1);
+    }
+}
+
+static void
+zero_pool_init(void) {
+    list_init(&(zero_pool.list));
+    zero_pool.count = 0;
+    memset(&(zero_pool.stat), 0, sizeof(zero_pool.stat));
+    zero_pool.stat.high = ZERO_POOL_HIGH;
+    zero_pool.stat.min_count = ZERO_POOL_HIGH;
+}
+
+// zero_pool_need_fill - 池未满且空闲内存充足时返回真, 供 cpu_idle 决定是否唤醒 zeroproc
+bool
+zero_pool_need_fill(void) {
+    return zero_pool.count < ZERO_POOL_HIGH
+        && pmm_manager->nr_free_pages() + page_cache.count > ZERO_POOL_RESERVE;
+}
+
+// zero_pool_fill - 清零至多 n 页放入池中, 返回实际填充的页数. memset 期间开中断
+size_t
+zero_pool_fill(size_t n) {
+    size_t filled = 0;
+    bool intr_flag;
+    while (filled < n && zero_pool_need_fill()) {
+        struct Page *page = alloc_page();
+        if (page == NULL) {
+            break;
+        }
+        memset(page2kva(page), 0, PGSIZE);
+        local_intr_save(intr_flag);
+        {
+            list_add(&(zero_pool.list), &(page->page_link));
+            zero_pool.count ++;
+            zero_pool.stat.zeroed ++;
+            if (zero_pool.count > zero_pool.stat.max_count) {
+                zero_pool.stat.max_count = zero_pool.count;
+            }
+        }
+        local_intr_restore(intr_flag);
+        filled ++;
+    }
+    return filled;
+}
+
+// zero_pool_drain - 把池中的所有页归还给 pmm_manager
+void
+zero_pool_drain(void) {
+    bool intr_flag;
+    local_intr_save(intr_flag);
+    {
+        zero_pool_shrink(zero_pool.count);
+    }
+    local_intr_restore(intr_flag);
+}
+
+void
+zero_pool_get_stat(struct zero_pool_stat *stat) {
+    *stat = zero_pool.stat;
+    stat->count = zero_pool.count;
+}
+
+// alloc_page_zeroed - 分配一个内容全为 0 的页, 优先从预清零池中取
+struct Page *
+alloc_page_zeroed(void) {
+    struct Page *page = NULL;
+    bool intr_flag;
+    local_intr_save(intr_flag);
+    {
+        if (zero_pool.count > 0) {
+            list_entry_t *le = list_next(&(zero_pool.list));
+            list_del(le);
+            zero_pool.count --;
+            zero_pool.stat.hit ++;
+            if (zero_pool.count < zero_pool.stat.min_count) {
+                zero_pool.stat.min_count = zero_pool.count;
+            }
+            page = le2page(le, page_link);
+        }
+        else {
+            zero_pool.stat.miss ++;
+        }
+    }
+    local_intr_restore(intr_flag);
+
+    if (page == NULL && (page = alloc_page()) != NULL) {
+        memset(page2kva(page), 0, PGSIZE);
+    }
+    return page;
+}
+
+/**
+ * 共享零页(zero page).
+ *
+ * 匿名内存第一次被读时不必分配新页: do_pgfault 把它只读地映射到这一个全零页上,
+ * 到第一次写时再按写时复制的流程换成私有的清零页. 只读不写的大块稀疏内存因此几乎不占物理内存.
+ * zero_page 自己持有一个永不释放的引用, 映射着它的页表项总使 page_ref > 1,
+ * 所以写缺页总是走复制的分支, 解除映射也不会释放它. 它不进入换出管理器(见 swap_map_swappable).
+ */
+struct Page *zero_page;
+
+static void
+zero_page_init(void) {
+    if ((zero_page = alloc_page()) == NULL) {
+        panic("zero_page_init: no memory for the zero page.\n");
+    }
+    memset(page2kva(zero_page), 0, PGSIZE);
+    set_page_ref(zero_page, 1);
+}
+
+/**
+ * 页表页缓存(pgtable cache).
+ *
+ * 每个新进程都需要一个一级页表(setup_pgdir), 每次 get_pte(..., 1) 都需要一个全 0 的二级页表.
+ * 进程退出时释放的这两类页不还给 pmm_manager, 而是暂存下来直接复用:
+ *      - 一级页表: 内核部分(KERNBASE 以上, 含 VPT 自映射)保持填好, 复用时只清零用户部分的 3KB;
+ *        缓存为空时才分配新页并从 boot_pgdir 复制内核部分. pmm_init 之后 boot_pgdir 的内核部分不再变化,
+ *        所以缓存中的一级页表始终与其一致.
+ *      - 二级页表: 由 exit_range 放入. 调用者保证此前已对同一区域 unmap_range, 页表中所有项都已为 0,
+ *        复用时无需清零.
+ * 缓存中的页与单页缓存一样计入 nr_free_pages, 内存不足时由 alloc_pages 先行回收.
+ */
+#define PGDIR_CACHE_HIGH        8
+#define PT_CACHE_HIGH           32
+
+static struct {
+    list_entry_t pgdir_list;    // 内核部分已填好的一级页表
+    list_entry_t pt_list;       // 全 0 的二级页表
+    size_t nr_pgdir;
+    size_t nr_pt;
+    struct pgtable_cache_stat stat;
+} pgtable_cache;
+
+static inline size_t
+pgtable_cache_count(void) {
+    return pgtable_cache.nr_pgdir + pgtable_cache.nr_pt;
+}
+
+// 把缓存的页全部归还给 pmm_manager. 调用者需关中断
+static void
+pgtable_cache_shrink(void) {
+    list_entry_t *le;
+    while ((le = list_next(&(pgtable_cache.pgdir_list))) != &(pgtable_cache.pgdir_list)) {
+        list_del(le);
+        pmm_manager->free_pages(le2page(le, page_link), 1);
+    }
+    while ((le = list_next(&(pgtable_cache.pt_list))) != &(pgtable_cache.pt_list)) {
+        list_del(le);
+        pmm_manager->free_pages(le2page(le, page_link), 1);
+    }
+    pgtable_cache.nr_pgdir = pgtable_cache.nr_pt = 0;
+}
+
+static void
+pgtable_cache_init(void) {
+    list_init(&(pgtable_cache.pgdir_list));
+    list_init(&(pgtable_cache.pt_list));
+    pgtable_cache.nr_pgdir = pgtable_cache.nr_pt = 0;
+    memset(&(pgtable_cache.stat), 0, sizeof(pgtable_cache.stat));
+}
+
+// alloc_pgdir - 分配一个一级页表: 用户部分为 0, 内核部分与 boot_pgdir 相同, VPT 自映射指向自身
+pde_t *
+alloc_pgdir(void) {
+    struct Page *page = NULL;
+    bool intr_flag;
+    local_intr_save(intr_flag);
+    {
+        if (pgtable_cache.nr_pgdir > 0) {
+            list_entry_t *le = list_next(&(pgtable_cache.pgdir_list));
+            list_del(le);
+            pgtable_cache.nr_pgdir --;
+            pgtable_cache.stat.pgdir_hit ++;
+            page = le2page(le, page_link);
+        }
+        else {
+            pgtable_cache.stat.pgdir_miss ++;
+        }
+    }
+    local_intr_restore(intr_flag);
+
+    pde_t *pgdir;
+    if (page != NULL) {
+        pgdir = page2kva(page);
+        memset(pgdir, 0, PDX(KERNBASE) * sizeof(pde_t));
+        return pgdir;
+    }
+    if ((page = alloc_page_zeroed()) == NULL) {
+        return NULL;
+    }
+    pgdir = page2kva(page);
+    // 用户部分已为 0, 只需复制内核一级页表中 KERNBASE 以上的部分
+    memcpy(pgdir + PDX(KERNBASE), boot_pgdir + PDX(KERNBASE), (NPDEENTRY - PDX(KERNBASE)) * sizeof(pde_t));
+    pgdir[PDX(VPT)] = PADDR(pgdir) | PTE_P | PTE_W; // 自映射
+    return pgdir;
+}
+
+// free_pgdir - 释放 alloc_pgdir 分配的一级页表, 缓存未满时留待复用
+void
+free_pgdir(pde_t *pgdir) {
+    struct Page *page = kva2page(pgdir);
+    bool intr_flag;
+    local_intr_save(intr_flag);
+    {
+        if (pgtable_cache.nr_pgdir < PGDIR_CACHE_HIGH) {
+            set_page_ref(page, 0);
+            list_add(&(pgtable_cache.pgdir_list), &(page->page_link));
+            pgtable_cache.nr_pgdir ++;
+            page = NULL;
+        }
+    }
+    local_intr_restore(intr_flag);
+    if (page != NULL) {
+        free_page(page);
+    }
+}
+
+// 分配一个全 0 的二级页表, 优先复用缓存
+static struct Page *
+alloc_pt(void) {
+    struct Page *page = NULL;
+    bool intr_flag;
+    local_intr_save(intr_flag);
+    {
+        if (pgtable_cache.nr_pt > 0) {
+            list_entry_t *le = list_next(&(pgtable_cache.pt_list));
+            list_del(le);
+            pgtable_cache.nr_pt --;
+            pgtable_cache.stat.pt_hit ++;
+            page = le2page(le, page_link);
+        }
+        else {
+            pgtable_cache.stat.pt_miss ++;
+        }
+    }
+    local_intr_restore(intr_flag);
+    return (page != NULL) ? page : alloc_page_zeroed();
+}
+
+// 缓存一个所有项均为 0 的二级页表, 缓存已满时返回 0, 由调用者释放
+static bool
+cache_free_pt(struct Page *page) {
+    bool cached = 0;
+    bool intr_flag;
+    local_intr_save(intr_flag);
+    {
+        if (pgtable_cache.nr_pt < PT_CACHE_HIGH) {
+            set_page_ref(page, 0);
+            list_add(&(pgtable_cache.pt_list), &(page->page_link));
+            pgtable_cache.nr_pt ++;
+            cached = 1;
+        }
+    }
+    local_intr_restore(intr_flag);
+    return cached;
+}
+
+// pgtable_cache_drain - 把缓存的一级/二级页表全部归还给 pmm_manager
+void
+pgtable_cache_drain(void) {
+    bool intr_flag;
+    local_intr_save(intr_flag);
+    {
+        pgtable_cache_shrink();
+    }
+    local_intr_restore(intr_flag);
+}
+
+void
+pgtable_cache_get_stat(struct pgtable_cache_stat *stat) {
+    *stat = pgtable_cache.stat;
+    stat->nr_pgdir = pgtable_cache.nr_pgdir;
+    stat->nr_pt = pgtable_cache.nr_pt;
+}
+
 // 分配 n 个 page 的连续空间,封装缺页处理
 struct Page *
 alloc_pages(size_t n) {
@@ -195,13 +661,32 @@ alloc_pages(size_t n) {
     {
          local_intr_save(intr_flag);
          {
-              page = pmm_manager->alloc_pages(n);
+              if (n == 1 && page_cache.enabled) {
+                   page = page_cache_alloc();
+              }
+              else {
+                   page = pmm_manager->alloc_pages(n);
+              }
+              if (page == NULL && (page_cache.count > 0 || zero_pool.count > 0 || pgtable_cache_count() > 0)) {
+                   // 缓存的单页可能阻碍了合并, 预清零池和页表页缓存占用的页也可以让出: 归还后重试
+                   page_cache_shrink(page_cache.count);
+                   zero_pool_shrink(zero_pool.count);
+                   pgtable_cache_shrink();
+                   page = pmm_manager->alloc_pages(n);
+              }
          }
          local_intr_restore(intr_flag);
 
          if (page != NULL || n > 1 || swap_init_ok == 0) break;
-         
+
+         // 先换出共享内存对象中的页; 没有可换出的, 再按原来的方式从 check_mm_struct 中换出
+         if (shmem_swap_out(n) != 0) {
+              continue ;
+         }
          extern struct mm_struct *check_mm_struct;
+         if (check_mm_struct == NULL) {
+              break;
+         }
          //LOG("page %x, call swap_out in alloc_pages %d\n",page, n);
          swap_out(check_mm_struct, n, 0);
     }
@@ -215,11 +700,107 @@ free_pages(struct Page *base, size_t n) {
     bool intr_flag;
     local_intr_save(intr_flag);
     {
-        pmm_manager->free_pages(base, n);
+        if (n == 1 && page_cache.enabled) {
+            page_cache_free(base, 0);
+        }
+        else {
+            pmm_manager->free_pages(base, n);
+        }
     }
     local_intr_restore(intr_flag);
 }
 
+// free_page_cold - 释放一个短期内不会再被访问的页, 放入缓存冷端, 优先归还给 pmm_manager
+void
+free_page_cold(struct Page *page) {
+    bool intr_flag;
+    local_intr_save(intr_flag);
+    {
+        if (page_cache.enabled) {
+            page_cache_free(page, 1);
+        }
+        else {
+            pmm_manager->free_pages(page, 1);
+        }
+    }
+    local_intr_restore(intr_flag);
+}
+
+// alloc_pages_bulk - 分配至多 n 个单页(不要求连续)存入 array, 返回实际分配的页数.
+// 整个过程只进入一次临界区. 内存不足时不会触发换出, 由调用者决定是否退回 alloc_page.
+size_t
+alloc_pages_bulk(size_t n, struct Page **array) {
+    size_t got = 0;
+    bool intr_flag;
+    local_intr_save(intr_flag);
+    {
+        // 先取单页缓存中的热页
+        if (page_cache.enabled) {
+            while (got < n && page_cache.count > 0) {
+                list_entry_t *le = list_next(&(page_cache.list));
+                list_del(le);
+                page_cache.count --;
+                array[got ++] = le2page(le, page_link);
+            }
+        }
+        got += pmm_manager_alloc_bulk(n - got, array + got);
+        if (got < n && (zero_pool.count > 0 || pgtable_cache_count() > 0)) {
+            zero_pool_shrink(zero_pool.count);
+            pgtable_cache_shrink();
+            got += pmm_manager_alloc_bulk(n - got, array + got);
+        }
+    }
+    local_intr_restore(intr_flag);
+    return got;
+}
+
+// free_pages_bulk - 释放 array 中的 n 个单页. 物理上连续的页合并为一次 pmm_manager->free_pages.
+// 批量释放的页(进程退出, 解除映射)短期内不会再被访问, 不进入单页缓存.
+void
+free_pages_bulk(struct Page **array, size_t n) {
+    bool intr_flag;
+    local_intr_save(intr_flag);
+    {
+        pmm_manager_free_bulk(array, n);
+    }
+    local_intr_restore(intr_flag);
+}
+
+// page_batch_alloc - 从 batch 中取一页, batch 为空时批量补充 want 页(至多 PAGE_BATCH_SIZE).
+// 批量分配失败时退回 alloc_page, 以便在内存不足时仍能触发换出.
+struct Page *
+page_batch_alloc(struct page_batch *batch, size_t want) {
+    if (page_batch_empty(batch)) {
+        if (want > PAGE_BATCH_SIZE) {
+            want = PAGE_BATCH_SIZE;
+        }
+        batch->next = 0;
+        if ((batch->nr = alloc_pages_bulk(want > 0 ? want : 1, batch->pages)) == 0) {
+            return alloc_page();
+        }
+    }
+    return batch->pages[batch->next ++];
+}
+
+// page_batch_free - 把待释放的页放入 batch, 攒满一批再统一释放
+void
+page_batch_free(struct page_batch *batch, struct Page *page) {
+    assert(batch->next == 0);
+    batch->pages[batch->nr ++] = page;
+    if (batch->nr == PAGE_BATCH_SIZE) {
+        page_batch_drain(batch);
+    }
+}
+
+// page_batch_drain - 释放 batch 中剩余的页: 未用完的预分配页, 或尚未释放的待释放页
+void
+page_batch_drain(struct page_batch *batch) {
+    if (!page_batch_empty(batch)) {
+        free_pages_bulk(batch->pages + batch->next, batch->nr - batch->next);
+    }
+    page_batch_init(batch);
+}
+
 //nr_free_pages - call pmm->nr_free_pages to get the size (nr*PAGESIZE) 
 //of current free memory
 size_t
@@ -228,7 +809,7 @@ nr_free_pages(void) {
     bool intr_flag;
     local_intr_save(intr_flag);
     {
-        ret = pmm_manager->nr_free_pages();
+        ret = pmm_manager->nr_free_pages() + page_cache.count + zero_pool.count + pgtable_cache_count();
     }
     local_intr_restore(intr_flag);
     return ret;
@@ -341,6 +922,9 @@ page_init(void) {
  *      1) 对于一级页表, 参考 entry.S, 一个 PAGESIZE 大小的一级页表,在 KERNELBASE之上还可以维护 1G 的内存>896MB,所以仍然使用已经定义的一级页表__boot_pgdir即可.
  *      2) 对于二级页表, 则需要896M/4K=224K个 entry,每个二级页表含 1K个 entry,所以共需要 224 个二级页表.
  *      3) ucore 中比较方便地设定为每个页表的大小是 1024 个,正好占用一个 page.所以需要224*4K=896KB 的空间容纳这些页表.
+ *
+ * 开启 PSE 后, la 与 pa 都按 PTSIZE 对齐的部分直接用 4MB 大页(一级页表项设置 PTE_PS)映射, 不再需要二级页表,
+ * 上面的 224 个页表全部省去, 内核访问直接映射区时 TLB 缺失也大大减少. 不对齐的首尾部分仍用 4KB 页.
  */ 
 static void
 boot_map_segment(pde_t *pgdir, uintptr_t la, size_t size, uintptr_t pa, uint32_t perm) {
@@ -357,16 +941,63 @@ boot_map_segment(pde_t *pgdir, uintptr_t la, size_t size, uintptr_t pa, uint32_t
     LOG_TAB("校准后映射区间: [0x%08lx, 0x%08lx), 页数:%u\n", la, pa, n);
     LOG_TAB("校准后映射区间: [0x%08lx,0x%08lx + 0x%08lx ) => [0x%08lx, 0x%08lx + 0x%08lx )\n", la, la, n * PGSIZE, pa, pa, n * PGSIZE);
 
-    for (; n > 0; n --, la += PGSIZE, pa += PGSIZE) {
+    size_t nr_large = 0;
+    while (n > 0) {
+        if (large_pages && la % PTSIZE == 0 && pa % PTSIZE == 0 && n >= NPTEENTRY) {
+            pgdir[PDX(la)] = pa | PTE_P | PTE_PS | perm;    // 写一级页表项, 直接映射 4MB
+            n -= NPTEENTRY, la += PTSIZE, pa += PTSIZE, nr_large ++;
+            continue ;
+        }
         pte_t *ptep = get_pte(pgdir, la, 1);
         assert(ptep != NULL);
         *ptep = pa | PTE_P | perm;  // 写 la 对应的二级页表; 要保证权限的正确性.
+        n --, la += PGSIZE, pa += PGSIZE;
     }
+    LOG_TAB("其中 4MB 大页 %u 个.\n", nr_large);
     LOG_TAB("映射完毕, 直接按照可管理内存上限映射. 虚存对一级页表比例: [KERNBASE, KERNBASE + KMEMSIZE) <=> [768, 896) <=> [3/4, 7/8)\n");
     
     LOG_LINE("完毕: 内核区域映射");
 }
 
+/**
+ * 预先建立内核栈区 [KSTACKBASE, KSTACKTOP) 的二级页表(只建表, 不映射任何页).
+ * 进程的一级页表复制 boot_pgdir 的内核部分时, 指向的是同一组二级页表,
+ * 之后 proc.c 在其中映射或解除映射内核栈, 对所有进程的页表立即可见.
+ * 必须在创建任何进程页表(包括页表页缓存中的一级页表)之前调用.
+ */
+static void
+boot_map_kstack_area(void) {
+    uintptr_t la;
+    for (la = KSTACKBASE; la < KSTACKTOP; la += PTSIZE) {
+        assert(get_pte(boot_pgdir, la, 1) != NULL);
+        boot_pgdir[PDX(la)] &= ~PTE_U;
+    }
+    LOG_TAB("内核栈区 [0x%08lx, 0x%08lx): 已建立 %u 个二级页表.\n", KSTACKBASE, KSTACKTOP, KSTACKAREA / PTSIZE);
+}
+
+// enable_large_pages - 处理器支持时打开 CR4.PSE, 使一级页表项中的 PTE_PS 生效
+static void
+enable_large_pages(void) {
+    uint32_t edx;
+    cpuid(1, NULL, NULL, NULL, &edx);
+    if (edx & CPUID_FEAT_PSE) {
+        lcr4(rcr4() | CR4_PSE);
+        large_pages = 1;
+        LOG_TAB("已开启 CR4.PSE: 内核直接映射使用 4MB 大页.\n");
+    }
+}
+
+// enable_global_pages - 处理器支持时打开 CR4.PGE, 使 PTE_G 生效
+static void
+enable_global_pages(void) {
+    uint32_t edx;
+    cpuid(1, NULL, NULL, NULL, &edx);
+    if (edx & CPUID_FEAT_PGE) {
+        lcr4(rcr4() | CR4_PGE);
+        LOG_TAB("已开启 CR4.PGE: 内核映射为全局页.\n");
+    }
+}
+
 //boot_alloc_page - allocate one page using pmm->alloc_pages(1) 
 // return value: the kernel virtual address of this allocated page
 //note: this function is used to get the memory for PDT(Page Directory Table)&PT(Page Table)
@@ -401,12 +1032,29 @@ pmm_init(void) {
 
     // 测试pmm 的alloc/free
     check_alloc_page();
+    // TLSF 的自检与性能对比在借来的页上进行, 不论当前选用哪个管理器都运行
+    tlsf_check();
+
+    // pmm_manager 自检完毕, 在其之上启用单页缓存
+    page_cache_init();
+    check_page_cache();
+
+    // 预清零页池, 由 proc_init 创建的 zeroproc 在空闲时填充
+    zero_pool_init();
+    check_zero_pool();
+    zero_page_init();
+
+    // 页表页缓存, 内核页表建立之后才能自检
+    pgtable_cache_init();
+
+    check_alloc_pages_bulk();
 
     check_pgdir();
 
     // 编译时校验: KERNBASE和KERNTOP都是PTSIZE的整数,即可以用两级页表管理(4M 的倍数)
     static_assert(KERNBASE % PTSIZE == 0);
     static_assert( KERNTOP % PTSIZE == 0);
+    static_assert(KSTACKAREA % PTSIZE == 0 && KSTACKTOP <= VPT);
 
     // 定义一块映射,使得可以更方便地访问一级页表的内容.在 print_pgdir 中用到.
     // 定义一个高于 KERNBASE + KMEMSIZE 的地址 VPT, 设置[VPT, VPT + 4MB) => [PADDR(boot_pgdir), PADDR(boot_pgdir) + 4MB )的映射.
@@ -420,7 +1068,13 @@ pmm_init(void) {
 
     // 把所有物理内存区域映射到虚拟空间.即 [0, KMEMSIZE)->[KERNBASE, KERNBASE+KERNBASE);
     // 在此过程中会建立二级页表, 写对应的一级页表.
-    boot_map_segment(boot_pgdir, KERNBASE, KMEMSIZE, 0, PTE_W);
+    // 内核映射在所有进程中都相同, 标记为全局页, 进程切换(重新加载 cr3)时不会被刷出 TLB.
+    // 原先映射 [KERNBASE, KERNBASE + 4M) 的 __boot_pt1 被大页替换, 需刷新 TLB.
+    enable_large_pages();
+    boot_map_segment(boot_pgdir, KERNBASE, KMEMSIZE, 0, PTE_W | PTE_G);
+    enable_global_pages();
+    tlb_flush_global();
+    boot_map_kstack_area();
     print_all_pt(boot_pgdir);
 
     // 到目前为止还是用的 bootloader 的GDT.
@@ -430,6 +1084,7 @@ pmm_init(void) {
 
     // 基本的虚拟地址空间分布已经建立.检查其正确性.
     check_boot_pgdir();
+    check_pgtable_cache();
 
     print_pgdir();
     
@@ -449,6 +1104,8 @@ pmm_init(void) {
  * 
  * 注意:只负责找到,不负责内容的读写!
  * 
+ * 若 la 位于 4MB 大页(一级页表项设置了 PTE_PS)中, 没有二级页表, 返回的是一级页表项本身.
+ * 调用者需检查 *ptep & PTE_PS, 此时物理地址为 PDE_LARGE_ADDR(*ptep) + (la & (PTSIZE - 1)).
  */ 
 pte_t *
 get_pte(pde_t *pgdir, uintptr_t la, bool create) {
@@ -465,17 +1122,19 @@ get_pte(pde_t *pgdir, uintptr_t la, bool create) {
     //      la 的一级页表索引=PDX(la)
     //      la 的一级页表项地址=&pgdir[PDX(la)]
     pde_t *pdep = &pgdir[PDX(la)];
+    if ((*pdep & PTE_P) && (*pdep & PTE_PS)) {
+        return (pte_t *)pdep;
+    }
     // 2. 保证二级页表的存在性(如果指定 create)
     //      一级页表项的 PTE_P 位标记了二级页表是否存在.实际上这正是按需分配内存的体现.
     //      如果不存在,就可以专门申请一个page,来存储二级页表, 并更新一级页表项的状态.
     if (!(*pdep & PTE_P)) {
         struct Page *page;
-        if (!create || (page = alloc_page()) == NULL) {
+        if (!create || (page = alloc_pt()) == NULL) {
             return NULL;
         }
         set_page_ref(page, 1);
         uintptr_t pa = page2pa(page);
-        memset(KADDR(pa), 0, PGSIZE);
         *pdep = pa | PTE_U | PTE_W | PTE_P; // 更新一级页表项状态.默认状态是用户/可写/存在. 可以在上层更改状态,如设置为内核项.
     }
     // 3. 定位二级页表
@@ -496,6 +1155,9 @@ get_page(pde_t *pgdir, uintptr_t la, pte_t **ptep_store) {
         *ptep_store = ptep;
     }
     if (ptep != NULL && *ptep & PTE_P) {
+        if (*ptep & PTE_PS) {
+            return pa2page(PDE_LARGE_ADDR(*ptep) + (la & (PTSIZE - 1)));
+        }
         return pte2page(*ptep);
     }
     return NULL;
@@ -545,96 +1207,256 @@ page_remove_pte(pde_t *pgdir, uintptr_t la, pte_t *ptep) {
     }
 }
 
-void
+/**
+ * 4MB 大页: PTSIZE 对齐的连续 NPTEENTRY 页, 由一个设置了 PTE_PS 的一级页表项映射.
+ * 引用计数只记在首页上, 其余页的 ref 为 0; 整块一起分配, 一起释放.
+ */
+
+// alloc_large_page - 分配一个 4MB 大页. 未开启 PSE 或没有 PTSIZE 对齐的连续内存时返回 NULL
+static struct Page *
+alloc_large_page(void) {
+    if (!large_pages) {
+        return NULL;
+    }
+    struct Page *page, *base;
+    if ((page = alloc_pages(NPTEENTRY)) == NULL) {
+        return NULL;
+    }
+    if (page2pa(page) % PTSIZE != 0) {
+        // buddy 分配的 2^10 页块总是对齐的; 其他算法多申请一些, 从中切出对齐的部分, 归还首尾
+        free_pages(page, NPTEENTRY);
+        size_t n = 2 * NPTEENTRY - 1;
+        if ((base = alloc_pages(n)) == NULL) {
+            return NULL;
+        }
+        page = pa2page(ROUNDUP(page2pa(base), PTSIZE));
+        if (page != base) {
+            free_pages(base, page - base);
+        }
+        if (page + NPTEENTRY != base + n) {
+            free_pages(page + NPTEENTRY, base + n - (page + NPTEENTRY));
+        }
+    }
+    return page;
+}
+
+// page_remove_large - 移除一级页表项 pdep 上的大页映射, 引用归零时整块释放
+static void
+page_remove_large(pde_t *pgdir, uintptr_t la, pde_t *pdep) {
+    struct Page *page = pa2page(PDE_LARGE_ADDR(*pdep));
+    if (page_ref_dec(page) == 0) {
+        free_pages(page, NPTEENTRY);
+    }
+    *pdep = 0;
+    tlb_invalidate(pgdir, la);
+}
+
+// split_large_pde - 把 la 所在的大页拆成一个二级页表上的 NPTEENTRY 个 4KB 映射, 以便只解除其中一部分
+static int
+split_large_pde(pde_t *pgdir, uintptr_t la) {
+    pde_t *pdep = &pgdir[PDX(la)];
+    struct Page *head = pa2page(PDE_LARGE_ADDR(*pdep)), *pt;
+    assert(page_ref(head) == 1);
+    if ((pt = alloc_page()) == NULL) {
+        return -E_NO_MEM;
+    }
+    set_page_ref(pt, 1);
+    pte_t *ptep = page2kva(pt);
+    uint32_t perm = (*pdep & PTE_USER);
+    int i;
+    for (i = 0; i < NPTEENTRY; i ++) {
+        set_page_ref(head + i, 1);
+        ptep[i] = page2pa(head + i) | PTE_P | perm;
+    }
+    *pdep = page2pa(pt) | PTE_U | PTE_W | PTE_P;
+    tlb_invalidate(pgdir, la);
+    return 0;
+}
+
+// split_range_ends - 拆开只有一部分落在 [start, end) 中的大页. 这样的大页只可能在范围的两端
+static int
+split_range_ends(pde_t *pgdir, uintptr_t start, uintptr_t end) {
+    uintptr_t ends[2] = {start, end - PGSIZE};
+    int i, ret;
+    for (i = 0; i < 2; i ++) {
+        uintptr_t slot = ROUNDDOWN(ends[i], PTSIZE);
+        pde_t pde = pgdir[PDX(slot)];
+        if ((pde & PTE_P) && (pde & PTE_PS) && (slot < start || slot + PTSIZE > end)) {
+            if ((ret = split_large_pde(pgdir, slot)) != 0) {
+                return ret;
+            }
+        }
+    }
+    return 0;
+}
+
+// unmap_range - 解除 [start, end) 的映射, 引用计数归零的页攒成一批统一释放
+//             - 需要拆开大页而内存不足时返回 -E_NO_MEM, 此时还没有解除任何映射
+int
 unmap_range(pde_t *pgdir, uintptr_t start, uintptr_t end) {
     assert(start % PGSIZE == 0 && end % PGSIZE == 0);
     assert(USER_ACCESS(start, end));
 
+    int ret;
+    if ((ret = split_range_ends(pgdir, start, end)) != 0) {
+        return ret;
+    }
+
+    struct page_batch batch;
+    page_batch_init(&batch);
     do {
         pte_t *ptep = get_pte(pgdir, start, 0);
         if (ptep == NULL) {
             start = ROUNDDOWN(start + PTSIZE, PTSIZE);
             continue ;
         }
-        if (*ptep != 0) {
-            page_remove_pte(pgdir, start, ptep);
+        if (*ptep & PTE_PS) {
+            // 两端的大页已经拆开, 剩下的大页整个都在范围内, 整块释放
+            assert(start % PTSIZE == 0 && end - start >= PTSIZE);
+            page_remove_large(pgdir, start, ptep);
+            start += PTSIZE;
+            continue ;
+        }
+        if (*ptep & PTE_P) {
+            struct Page *page = pte2page(*ptep);
+            if (page_ref_dec(page) == 0) {
+                page_batch_free(&batch, page);
+            }
+            if (*ptep & PTE_PREFAULT) {
+                fault_around_account(*ptep);
+            }
+            *ptep = 0;
+            tlb_invalidate(pgdir, start);
+        }
+        else if (*ptep != 0) {
+            // 换出项也一并清除, 保证 exit_range 释放的二级页表全为 0, 可直接放入页表页缓存
+            *ptep = 0;
         }
         start += PGSIZE;
     } while (start != 0 && start < end);
+    page_batch_drain(&batch);
+    return 0;
 }
 
+// exit_range - 释放 [start, end) 对应的二级页表
+//            - 调用者需先对此一级页表中的所有 vma 调用 unmap_range, 释放的二级页表全为 0, 放入页表页缓存
 void
 exit_range(pde_t *pgdir, uintptr_t start, uintptr_t end) {
     assert(start % PGSIZE == 0 && end % PGSIZE == 0);
     assert(USER_ACCESS(start, end));
 
+    struct page_batch batch;
+    page_batch_init(&batch);
     start = ROUNDDOWN(start, PTSIZE);
     do {
         int pde_idx = PDX(start);
-        if (pgdir[pde_idx] & PTE_P) {
-            free_page(pde2page(pgdir[pde_idx]));
+        if (pgdir[pde_idx] & PTE_PS) {
+            // 大页没有二级页表; 通常已被 unmap_range 移除
+            page_remove_large(pgdir, start, &pgdir[pde_idx]);
+        }
+        else if (pgdir[pde_idx] & PTE_P) {
+            struct Page *pt = pde2page(pgdir[pde_idx]);
+            if (!cache_free_pt(pt)) {
+                page_batch_free(&batch, pt);
+            }
             pgdir[pde_idx] = 0;
         }
         start += PTSIZE;
     } while (start != 0 && start < end);
+    page_batch_drain(&batch);
+}
+
+// copy_large_pde - 复制 la 处的大页: 优先分配新的大页, 没有连续内存时退化为逐个 4KB 页复制
+static int
+copy_large_pde(pde_t *to, pde_t *from, uintptr_t la) {
+    assert(la % PTSIZE == 0);
+    pde_t pde = from[PDX(la)];
+    uint32_t perm = (pde & PTE_USER);
+    char *src = KADDR(PDE_LARGE_ADDR(pde));
+    struct Page *npage;
+    if ((npage = alloc_large_page()) != NULL) {
+        memcpy(page2kva(npage), src, PTSIZE);
+        set_page_ref(npage, 1);
+        to[PDX(la)] = page2pa(npage) | PTE_P | PTE_PS | perm;
+        return 0;
+    }
+    int i;
+    for (i = 0; i < NPTEENTRY; i ++, la += PGSIZE, src += PGSIZE) {
+        if ((npage = alloc_page()) == NULL) {
+            return -E_NO_MEM;
+        }
+        memcpy(page2kva(npage), src, PGSIZE);
+        // 与缺页分配的页一样登记为可换出
+        if (pgdir_install_page(to, npage, la, perm) == NULL) {
+            return -E_NO_MEM;
+        }
+    }
+    return 0;
 }
+
 /* copy_range - copy content of memory (start, end) of one process A to another process B
  * @to:    the addr of process B's Page Directory
  * @from:  the addr of process A's Page Directory
- * @share: flags to indicate to dup OR share. We just use dup method, so it didn't be used.
+ * @share: flags to indicate to dup OR share.
  *
  * CALL GRAPH: copy_mm-->dup_mmap-->copy_range
+ *
+ * 写时复制(COW): 不复制页的内容, 而是让 B 映射 A 的同一个物理页, page_ref 加一.
+ * share 为 0 时, 可写的页在 A, B 中都改为只读, 之后任何一方写入都会引起缺页,
+ * 由 do_pgfault 在 page_ref > 1 时复制一份, 否则直接恢复写权限. share 为 1 时双方共享同一页, 权限不变.
+ *
+ * 换出的页(PTE 为换出项)直接为 B 读入一份私有副本, 只读映射: 换出位置由虚拟地址决定, 父子进程不能共用同一项.
+ * 大页(PTE_PS)仍整块复制, 见 copy_large_pde.
  */
 int
 copy_range(pde_t *to, pde_t *from, uintptr_t start, uintptr_t end, bool share) {
     assert(start % PGSIZE == 0 && end % PGSIZE == 0);
     assert(USER_ACCESS(start, end));
-    // copy content by page unit.
+    int ret = 0;
+    bool write_protected = 0;
     do {
         //call get_pte to find process A's pte according to the addr start
-        pte_t *ptep = get_pte(from, start, 0), *nptep;
+        pte_t *ptep = get_pte(from, start, 0);
         if (ptep == NULL) {
             start = ROUNDDOWN(start + PTSIZE, PTSIZE);
             continue ;
         }
-        //call get_pte to find process B's pte according to the addr start. If pte is NULL, just alloc a PT
+        if (*ptep & PTE_PS) {
+            if ((ret = copy_large_pde(to, from, start)) != 0) {
+                goto out;
+            }
+            start += PTSIZE;
+            continue ;
+        }
         if (*ptep & PTE_P) {
-            if ((nptep = get_pte(to, start, 1)) == NULL) {
-                return -E_NO_MEM;
+            if (!share && (*ptep & PTE_W)) {
+                *ptep &= ~PTE_W;
+                write_protected = 1;
+            }
+            // B 与 A 映射同一页, page_insert 使 page_ref 加一
+            if ((ret = page_insert(to, pte2page(*ptep), start, *ptep & PTE_USER)) != 0) {
+                goto out;
+            }
+        }
+        else if (*ptep != 0) {
+            struct Page *npage;
+            if ((ret = swap_in_copy(*ptep, &npage)) != 0) {
+                goto out;
+            }
+            if ((ret = page_insert(to, npage, start, PTE_U)) != 0) {
+                free_page(npage);
+                goto out;
             }
-        uint32_t perm = (*ptep & PTE_USER);
-        //get page from ptep
-        struct Page *page = pte2page(*ptep);
-        // alloc a page for process B
-        struct Page *npage=alloc_page();
-        assert(page!=NULL);
-        assert(npage!=NULL);
-        int ret=0;
-        /* LAB5:EXERCISE2 YOUR CODE
-         * replicate content of page to npage, build the map of phy addr of nage with the linear addr start
-         *
-         * Some Useful MACROs and DEFINEs, you can use them in below implementation.
-         * MACROs or Functions:
-         *    page2kva(struct Page *page): return the kernel vritual addr of memory which page managed (SEE pmm.h)
-         *    page_insert: build the map of phy addr of an Page with the linear addr la
-         *    memcpy: typical memory copy function
-         *
-         * (1) find src_kvaddr: the kernel virtual address of page
-         * (2) find dst_kvaddr: the kernel virtual address of npage
-         * (3) memory copy from src_kvaddr to dst_kvaddr, size is PGSIZE
-         * (4) build the map of phy addr of  nage with the linear addr start
-         */
-        void * kva_src = page2kva(page);
-        void * kva_dst = page2kva(npage);
-    
-        memcpy(kva_dst, kva_src, PGSIZE);
-
-        ret = page_insert(to, npage, start, perm);
-        assert(ret == 0);
         }
         start += PGSIZE;
     } while (start != 0 && start < end);
-    return 0;
+
+out:
+    // A 的页表项去掉了写权限, 刷新 A 的 TLB(用户页不是全局页, 重新加载 cr3 即可)
+    if (write_protected && rcr3() == PADDR(from)) {
+        lcr3(PADDR(from));
+    }
+    return ret;
 }
 
 // 移除 pgdir 中 la 对应的二级页表项
@@ -677,13 +1499,43 @@ page_insert(pde_t *pgdir, struct Page *page, uintptr_t la, uint32_t perm) {
 
 // invalidate a TLB entry, but only if the page tables being
 // edited are the ones currently in use by the processor.
+// 内核映射为所有页表共享的全局页, 不会随 cr3 切换而刷新, 所以无论 pgdir 是否为当前页表都要作废.
 void
 tlb_invalidate(pde_t *pgdir, uintptr_t la) {
-    if (rcr3() == PADDR(pgdir)) {
+    if (rcr3() == PADDR(pgdir) || la >= KERNBASE) {
         invlpg((void *)la);
     }
 }
 
+// tlb_flush_global - 刷新整个 TLB, 包括全局页. 切换 cr3 只会刷新非全局页, 修改了多处内核映射时调用
+void
+tlb_flush_global(void) {
+    uintptr_t cr4 = rcr4();
+    if (cr4 & CR4_PGE) {
+        lcr4(cr4 & ~CR4_PGE);
+        lcr4(cr4);
+    }
+    else {
+        lcr3(rcr3());
+    }
+}
+
+// pgdir_alloc_large_page - 分配一个清零的大页, 用一个 PTE_PS 一级页表项映射 la 所在的 PTSIZE 区间.
+//                        - la 所在的一级页表项必须为空; 没有可用的大页时返回 NULL, 由调用者退化为 4KB 页
+struct Page *
+pgdir_alloc_large_page(pde_t *pgdir, uintptr_t la, uint32_t perm) {
+    pde_t *pdep = &pgdir[PDX(la)];
+    assert(*pdep == 0);
+    struct Page *page;
+    if ((page = alloc_large_page()) != NULL) {
+        memset(page2kva(page), 0, PTSIZE);
+        set_page_ref(page, 1);
+        *pdep = page2pa(page) | PTE_P | PTE_PS | perm;
+        tlb_invalidate(pgdir, ROUNDDOWN(la, PTSIZE));
+    }
+    return page;
+}
+
 // pgdir_alloc_page - call alloc_page & page_insert functions to 
 //                  - allocate a page size memory & setup an addr map
 //                  - pa<->la with linear address la and the PDT pgdir
@@ -697,9 +1549,9 @@ tlb_invalidate(pde_t *pgdir, uintptr_t la) {
  * la: liner address,线性地址
  * perm: permission,权限
  */ 
+// pgdir_install_page - 把新分配的 page 映射到 la 并设为可交换, 失败时释放 page. page 为 NULL 时直接返回 NULL
 struct Page *
-pgdir_alloc_page(pde_t *pgdir, uintptr_t la, uint32_t perm) {
-    struct Page *page = alloc_page();
+pgdir_install_page(pde_t *pgdir, struct Page *page, uintptr_t la, uint32_t perm) {
     if (page != NULL) {
         if (page_insert(pgdir, page, la, perm) != 0) {
             free_page(page);
@@ -725,12 +1577,173 @@ pgdir_alloc_page(pde_t *pgdir, uintptr_t la, uint32_t perm) {
     return page;
 }
 
+struct Page *
+pgdir_alloc_page(pde_t *pgdir, uintptr_t la, uint32_t perm) {
+    return pgdir_install_page(pgdir, alloc_page(), la, perm);
+}
+
+// pgdir_alloc_page_zeroed - 同 pgdir_alloc_page, 但保证新页内容全为 0. 用于匿名页的缺页处理
+struct Page *
+pgdir_alloc_page_zeroed(pde_t *pgdir, uintptr_t la, uint32_t perm) {
+    return pgdir_install_page(pgdir, alloc_page_zeroed(), la, perm);
+}
+
 static void
 check_alloc_page(void) {
     pmm_manager->check();
     LOG_TAB("%-20s%s\n","check_alloc_page()", ": succeed!");
 }
 
+static void
+check_page_cache(void) {
+    // 从空的缓存开始, 避免测试中途超过 PAGE_CACHE_HIGH 从尾部归还
+    page_cache_drain();
+    size_t nr_free_store = nr_free_pages();
+    struct page_cache_stat stat0, stat1;
+    page_cache_get_stat(&stat0);
+
+    // 缓存为空: 一次批量补充 PAGE_CACHE_BATCH 页
+    struct Page *p0, *p1;
+    assert((p0 = alloc_page()) != NULL);
+    assert(nr_free_pages() == nr_free_store - 1);
+    page_cache_get_stat(&stat1);
+    assert(stat1.miss == stat0.miss + 1 && stat1.refill == stat0.refill + 1);
+    assert(stat1.count == PAGE_CACHE_BATCH - 1);
+    free_page(p0);
+    assert(nr_free_pages() == nr_free_store);
+
+    // 刚释放的热页应被立即复用
+    assert((p1 = alloc_page()) == p0);
+    page_cache_get_stat(&stat1);
+    assert(stat1.hit == stat0.hit + 1);
+
+    // 冷页排在热页之后: 分配先取热页, 冷页留在尾部
+    assert((p0 = alloc_page()) != NULL && p0 != p1);
+    free_page_cold(p1);
+    free_page(p0);
+    assert(list_prev(&(page_cache.list)) == &(p1->page_link));
+    assert(alloc_page() == p0);
+    assert(list_prev(&(page_cache.list)) == &(p1->page_link));
+    free_page(p0);
+
+    page_cache_drain();
+    page_cache_get_stat(&stat1);
+    assert(stat1.count == 0);
+    assert(nr_free_pages() == nr_free_store);
+    LOG_TAB("%-20s%s\n","check_page_cache()", ": succeed!");
+}
+
+static void
+check_zero_pool(void) {
+    size_t nr_free_store = nr_free_pages();
+    struct zero_pool_stat stat0, stat1;
+    zero_pool_get_stat(&stat0);
+    assert(stat0.count == 0);
+
+    // 池空: 退化为 alloc_page + memset
+    struct Page *p0, *p1;
+    assert((p0 = alloc_page_zeroed()) != NULL);
+    zero_pool_get_stat(&stat1);
+    assert(stat1.miss == stat0.miss + 1);
+    memset(page2kva(p0), 0xa5, PGSIZE);
+    free_page(p0);
+
+    // 池中的页计入 nr_free_pages, 取出时内容全为 0
+    assert(zero_pool_fill(2) == 2);
+    assert(nr_free_pages() == nr_free_store);
+    assert((p1 = alloc_page_zeroed()) != NULL);
+    zero_pool_get_stat(&stat1);
+    assert(stat1.hit == stat0.hit + 1 && stat1.count == 1);
+    int i;
+    for (i = 0; i < PGSIZE; i ++) {
+        assert(((char *)page2kva(p1))[i] == 0);
+    }
+    free_page(p1);
+
+    zero_pool_drain();
+    zero_pool_get_stat(&stat1);
+    assert(stat1.count == 0);
+    assert(nr_free_pages() == nr_free_store);
+    LOG_TAB("%-20s%s\n","check_zero_pool()", ": succeed!");
+}
+
+static void
+check_pgtable_cache(void) {
+    size_t nr_free_store = nr_free_pages();
+    struct pgtable_cache_stat stat0, stat1;
+    pgtable_cache_get_stat(&stat0);
+
+    // 一级页表: 内核部分与 boot_pgdir 相同, 释放后复用同一页, 用户部分被清零
+    pde_t *pgdir, *pgdir2;
+    assert((pgdir = alloc_pgdir()) != NULL);
+    assert(memcmp(pgdir + PDX(KERNBASE), boot_pgdir + PDX(KERNBASE), (PDX(VPT) - PDX(KERNBASE)) * sizeof(pde_t)) == 0);
+    assert(pgdir[PDX(VPT)] == (PADDR(pgdir) | PTE_P | PTE_W));
+    pgdir[0] = 0x12345000 | PTE_P;
+    free_pgdir(pgdir);
+    assert(nr_free_pages() == nr_free_store);
+    assert((pgdir2 = alloc_pgdir()) == pgdir);
+    assert(pgdir[0] == 0 && pgdir[PDX(VPT)] == (PADDR(pgdir) | PTE_P | PTE_W));
+    pgtable_cache_get_stat(&stat1);
+    assert(stat1.pgdir_hit == stat0.pgdir_hit + 1);
+
+    // 二级页表: exit_range 释放后由下一次 get_pte 直接复用. unmap_range/exit_range 只接受用户地址
+    struct Page *page;
+    assert(get_pte(pgdir, PTSIZE, 1) != NULL);
+    struct Page *pt = pde2page(pgdir[1]);
+    assert((page = alloc_page()) != NULL);
+    assert(page_insert(pgdir, page, PTSIZE + PGSIZE, PTE_U | PTE_W) == 0);
+    unmap_range(pgdir, PTSIZE, 2 * PTSIZE);
+    exit_range(pgdir, PTSIZE, 2 * PTSIZE);
+    assert(pgdir[1] == 0);
+    assert(get_pte(pgdir, 2 * PTSIZE, 1) != NULL && pde2page(pgdir[2]) == pt);
+    int i;
+    for (i = 0; i < NPTEENTRY; i ++) {
+        assert(((pte_t *)page2kva(pt))[i] == 0);
+    }
+    pgtable_cache_get_stat(&stat1);
+    assert(stat1.pt_hit == stat0.pt_hit + 1);
+    exit_range(pgdir, 2 * PTSIZE, 3 * PTSIZE);
+    free_pgdir(pgdir);
+
+    pgtable_cache_drain();
+    pgtable_cache_get_stat(&stat1);
+    assert(stat1.nr_pgdir == 0 && stat1.nr_pt == 0);
+    assert(nr_free_pages() == nr_free_store);
+    LOG_TAB("%-20s%s\n","check_pgtable_cache()", ": succeed!");
+}
+
+static void
+check_alloc_pages_bulk(void) {
+    size_t nr_free_store = nr_free_pages();
+    struct Page *array[PAGE_BATCH_SIZE];
+    size_t i, j;
+
+    assert(alloc_pages_bulk(PAGE_BATCH_SIZE, array) == PAGE_BATCH_SIZE);
+    assert(nr_free_pages() == nr_free_store - PAGE_BATCH_SIZE);
+    for (i = 0; i < PAGE_BATCH_SIZE; i ++) {
+        assert(!PageReserved(array[i]) && !PageProperty(array[i]));
+        for (j = 0; j < i; j ++) {
+            assert(array[i] != array[j]);
+        }
+    }
+    free_pages_bulk(array, PAGE_BATCH_SIZE);
+    assert(nr_free_pages() == nr_free_store);
+
+    // 只用掉一页, 其余的预分配页在 drain 时归还
+    struct page_batch batch;
+    page_batch_init(&batch);
+    struct Page *p = page_batch_alloc(&batch, 4);
+    assert(p != NULL && batch.nr == 4 && batch.next == 1);
+    page_batch_drain(&batch);
+    assert(page_batch_empty(&batch));
+    assert(nr_free_pages() == nr_free_store - 1);
+
+    page_batch_free(&batch, p);
+    page_batch_drain(&batch);
+    assert(nr_free_pages() == nr_free_store);
+    LOG_TAB("%-20s%s\n","check_alloc_pages_bulk()", ": succeed!");
+}
+
 static void
 check_pgdir(void) {
     assert(npage <= KMEMSIZE / PGSIZE);
@@ -786,11 +1799,27 @@ check_boot_pgdir(void) {
     int i;
     for (i = 0; i < npage; i += PGSIZE) {
         assert((ptep = get_pte(boot_pgdir, (uintptr_t)KADDR(i), 0)) != NULL);
-        assert(PTE_ADDR(*ptep) == i);
+        if (*ptep & PTE_PS) {
+            assert(ptep == &boot_pgdir[PDX(KADDR(i))]);
+            assert(PDE_LARGE_ADDR(*ptep) == ROUNDDOWN(i, PTSIZE));
+        }
+        else {
+            assert(PTE_ADDR(*ptep) == i);
+        }
+        assert(get_page(boot_pgdir, (uintptr_t)KADDR(i), NULL) == pa2page(i));
+        assert(*ptep & PTE_G);
+    }
+    if (large_pages) {
+        assert(boot_pgdir[PDX(KERNBASE)] & PTE_PS);
     }
 
     assert(PDE_ADDR(boot_pgdir[PDX(VPT)]) == PADDR(boot_pgdir));
 
+    uintptr_t la;
+    for (la = KSTACKBASE; la < KSTACKTOP; la += PTSIZE) {
+        assert((boot_pgdir[PDX(la)] & (PTE_P | PTE_U | PTE_PS)) == PTE_P);
+    }
+
     assert(boot_pgdir[0] == 0);
 
     struct Page *p;
@@ -852,8 +1881,9 @@ get_pgtable_items(size_t left, size_t right, size_t start, uintptr_t *table, siz
         if (left_store != NULL) {
             *left_store = start;
         }
-        int perm = (table[start ++] & PTE_USER);
-        while (start < right && (table[start] & PTE_USER) == perm) {
+        // 一级页表中 PTE_PS 也参与区分, 使大页与普通页表分段显示
+        int perm = (table[start ++] & (PTE_USER | PTE_PS));
+        while (start < right && (table[start] & (PTE_USER | PTE_PS)) == perm) {
             start ++;
         }
         if (right_store != NULL) {
@@ -873,6 +1903,12 @@ print_pgdir(void) {
     while ((perm = get_pgtable_items(0, NPDEENTRY, right, vpd, &left, &right)) != 0) {
         LOG_TAB("PDE(%03x) %08x-%08x %08x %s\n", right - left,
                 left * PTSIZE, right * PTSIZE, (right - left) * PTSIZE, perm2str(perm));
+        if (perm & PTE_PS) {
+            // 4MB 大页没有二级页表, 不能经 vpt 访问
+            LOG_TAB("  |-- 4M  (%05x) %08x-%08x %08x %s\n", (right - left) * NPTEENTRY,
+                    left * PTSIZE, right * PTSIZE, (right - left) * PTSIZE, perm2str(perm));
+            continue ;
+        }
         size_t l, r = left * NPTEENTRY;
         while ((perm = get_pgtable_items(left * NPTEENTRY, right * NPTEENTRY, r, vpt, &l, &r)) != 0) {
             LOG_TAB("  |-- PTE(%05x) %08x-%08x %08x %s\n", r - l,
@@ -20,6 +20,9 @@ struct pmm_manager {
     void (*free_pages)(struct Page *base, size_t n);  // free >=n pages with "base" addr of Page descriptor structures(memlayout.h)
     size_t (*nr_free_pages)(void);                    // return the number of free pages 
     void (*check)(void);                              // check the correctness of XXX_pmm_manager 
+    size_t (*alloc_pages_bulk)(size_t n, struct Page **array);
+                                                      // optional: allocate up to n single pages into array in one call,
+                                                      // return the number allocated. NULL means alloc_pages(1) in a loop
 };
 
 extern const struct pmm_manager *pmm_manager;
@@ -35,6 +38,89 @@ size_t nr_free_pages(void);
 #define alloc_page() alloc_pages(1)
 #define free_page(page) free_pages(page, 1)
 
+void free_page_cold(struct Page *page);
+
+size_t alloc_pages_bulk(size_t n, struct Page **array);
+void free_pages_bulk(struct Page **array, size_t n);
+
+/**
+ * 批量分配的缓冲区: 逐页建立或解除映射的路径(如 exit)先批量取一组页, 再逐个消费,
+ * 用完再补充, 使分配器的进入次数从"每页一次"降为"每批一次".
+ */
+#define PAGE_BATCH_SIZE         32
+
+struct page_batch {
+    struct Page *pages[PAGE_BATCH_SIZE];
+    size_t nr;          // 缓冲区中的页数
+    size_t next;        // 下一个可用页的下标
+};
+
+static inline void
+page_batch_init(struct page_batch *batch) {
+    batch->nr = batch->next = 0;
+}
+
+static inline bool
+page_batch_empty(struct page_batch *batch) {
+    return batch->next == batch->nr;
+}
+
+struct Page *page_batch_alloc(struct page_batch *batch, size_t want);
+void page_batch_free(struct page_batch *batch, struct Page *page);
+void page_batch_drain(struct page_batch *batch);
+
+// 单页缓存的统计信息
+struct page_cache_stat {
+    size_t hit;         // 直接从缓存中分配的次数
+    size_t miss;        // 缓存为空, 需从 pmm_manager 补充的次数
+    size_t refill;      // 批量补充次数
+    size_t drain;       // 批量归还次数
+    size_t count;       // 当前缓存页数
+};
+
+void page_cache_drain(void);
+void page_cache_enable(bool enable);
+void page_cache_get_stat(struct page_cache_stat *stat);
+
+// 预清零页池的统计信息
+struct zero_pool_stat {
+    size_t hit;         // 直接从池中取到清零页的次数
+    size_t miss;        // 池为空, 当场清零的次数
+    size_t zeroed;      // 空闲时预先清零的总页数
+    size_t count;       // 当前池中页数
+    size_t high;        // 目标水位
+    size_t min_count;   // 池曾降到的最低水位
+    size_t max_count;   // 池曾达到的最高水位
+};
+
+struct Page *alloc_page_zeroed(void);
+bool zero_pool_need_fill(void);
+size_t zero_pool_fill(size_t n);
+void zero_pool_drain(void);
+void zero_pool_get_stat(struct zero_pool_stat *stat);
+
+extern struct Page *zero_page;
+
+static inline bool
+is_zero_page(struct Page *page) {
+    return page == zero_page;
+}
+
+// 页表页缓存的统计信息
+struct pgtable_cache_stat {
+    size_t pgdir_hit;   // 复用缓存中一级页表的次数
+    size_t pgdir_miss;  // 缓存为空, 新建一级页表的次数
+    size_t pt_hit;      // 复用缓存中二级页表的次数
+    size_t pt_miss;     // 缓存为空, 分配清零页作二级页表的次数
+    size_t nr_pgdir;    // 当前缓存的一级页表数
+    size_t nr_pt;       // 当前缓存的二级页表数
+};
+
+pde_t *alloc_pgdir(void);
+void free_pgdir(pde_t *pgdir);
+void pgtable_cache_drain(void);
+void pgtable_cache_get_stat(struct pgtable_cache_stat *stat);
+
 pte_t *get_pte(pde_t *pgdir, uintptr_t la, bool create);
 struct Page *get_page(pde_t *pgdir, uintptr_t la, pte_t **ptep_store);
 void page_remove(pde_t *pgdir, uintptr_t la);
@@ -42,8 +128,12 @@ int page_insert(pde_t *pgdir, struct Page *page, uintptr_t la, uint32_t perm);
 
 void load_esp0(uintptr_t esp0);
 void tlb_invalidate(pde_t *pgdir, uintptr_t la);
+void tlb_flush_global(void);
 struct Page *pgdir_alloc_page(pde_t *pgdir, uintptr_t la, uint32_t perm);
-void unmap_range(pde_t *pgdir, uintptr_t start, uintptr_t end);
+struct Page *pgdir_alloc_page_zeroed(pde_t *pgdir, uintptr_t la, uint32_t perm);
+struct Page *pgdir_install_page(pde_t *pgdir, struct Page *page, uintptr_t la, uint32_t perm);
+struct Page *pgdir_alloc_large_page(pde_t *pgdir, uintptr_t la, uint32_t perm);
+int unmap_range(pde_t *pgdir, uintptr_t start, uintptr_t end);
 void exit_range(pde_t *pgdir, uintptr_t start, uintptr_t end);
 int copy_range(pde_t *to, pde_t *from, uintptr_t start, uintptr_t end, bool share);
 
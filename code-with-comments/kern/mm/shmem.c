@@ -0,0 +1,353 @@
+#include <defs.h>
+#include <string.h>
+#include <assert.h>
+#include <stdio.h>
+#include <error.h>
+#include <sync.h>
+#include <pmm.h>
+#include <vmm.h>
+#include <swap.h>
+#include <swapfs.h>
+#include <kmalloc.h>
+#include <kdebug.h>
+#include <inode.h>
+#include <iobuf.h>
+#include <shmem.h>
+
+// 所有共享内存对象, 按名字查找和换出时遍历
+static list_entry_t shmem_list = { &shmem_list, &shmem_list };
+static size_t nr_shmem, shmem_swap_out_num, shmem_swap_in_num;
+
+/**
+ * shmem_create_file - 创建 len 字节(按页向上取整)的共享内存对象.
+ * node 不为 NULL 时, 对象开头的 filesz 字节来自 node 中 offset 处, 对象持有 node 的一个引用;
+ * writeback 为真时销毁前把这部分写回文件(MAP_SHARED 的可写文件映射).
+ * 新对象的引用计数为 0, 由映射它的 vma 增加.
+ */
+struct shmem_struct *
+shmem_create_file(size_t len, struct inode *node, off_t offset, size_t filesz, bool writeback) {
+    size_t npages = ROUNDUP(len, PGSIZE) / PGSIZE;
+    assert(npages != 0 && filesz <= len);
+
+    struct shmem_struct *shmem;
+    if ((shmem = kmalloc(sizeof(struct shmem_struct))) == NULL) {
+        return NULL;
+    }
+    if ((shmem->entries = kmalloc(npages * sizeof(pte_t))) == NULL) {
+        kfree(shmem);
+        return NULL;
+    }
+    memset(shmem->entries, 0, npages * sizeof(pte_t));
+    shmem->npages = npages;
+    shmem->ref = 0;
+    sem_init(&(shmem->sem), 1);
+    list_init(&(shmem->vma_list));
+    shmem->name[0] = '\0';
+    shmem->node = node;
+    shmem->offset = offset;
+    shmem->filesz = (node != NULL) ? filesz : 0;
+    shmem->writeback = (node != NULL) ? writeback : 0;
+    shmem->clock_hand = 0;
+    if (node != NULL) {
+        vop_ref_inc(node);
+    }
+
+    bool intr_flag;
+    local_intr_save(intr_flag);
+    {
+        list_add(&shmem_list, &(shmem->list_link));
+        nr_shmem ++;
+    }
+    local_intr_restore(intr_flag);
+    return shmem;
+}
+
+// shmem_create - 创建匿名共享内存对象
+struct shmem_struct *
+shmem_create(size_t len) {
+    return shmem_create_file(len, NULL, 0, 0, 0);
+}
+
+// shmem_create_named - 创建名为 name 的共享内存对象, 调用者需先确认此名字未被使用
+struct shmem_struct *
+shmem_create_named(const char *name, size_t len) {
+    assert(strlen(name) <= SHMEM_NAME_MAX && shmem_lookup(name) == NULL);
+    struct shmem_struct *shmem;
+    if ((shmem = shmem_create(len)) != NULL) {
+        strcpy(shmem->name, name);
+    }
+    return shmem;
+}
+
+// shmem_lookup - 按名字查找共享内存对象, 没有则返回 NULL
+struct shmem_struct *
+shmem_lookup(const char *name) {
+    if (name[0] == '\0') {
+        return NULL;
+    }
+    list_entry_t *le = &shmem_list;
+    while ((le = list_next(le)) != &shmem_list) {
+        struct shmem_struct *shmem = le2shmem(le, list_link);
+        if (strcmp(shmem->name, name) == 0) {
+            return shmem;
+        }
+    }
+    return NULL;
+}
+
+// shmem_writeback - 把已分配页中来自文件的部分写回文件. 没有记录脏页, 已分配(含已换出)的页都写回
+static void
+shmem_writeback(struct shmem_struct *shmem) {
+    size_t i;
+    for (i = 0; i < shmem->npages && i * PGSIZE < shmem->filesz; i ++) {
+        struct Page *page;
+        int ret;
+        if (shmem->entries[i] == 0) {
+            continue ;
+        }
+        if ((ret = shmem_get_page(shmem, i, &page)) != 0) {
+            LOG("shmem_writeback: 第 %u 页换入失败, error = %e.\n", i, ret);
+            continue ;
+        }
+        size_t n = shmem->filesz - i * PGSIZE;
+        if (n > PGSIZE) {
+            n = PGSIZE;
+        }
+        struct iobuf __iob, *iob = iobuf_init(&__iob, page2kva(page), n, shmem->offset + i * PGSIZE);
+        if ((ret = vop_write(shmem->node, iob)) != 0) {
+            LOG("shmem_writeback: 第 %u 页写回失败, error = %e.\n", i, ret);
+        }
+        page_ref_dec(page);
+    }
+}
+
+// shmem_destroy - 对象已不再被映射: 写回文件, 释放所有页, 换出项和对文件的引用
+void
+shmem_destroy(struct shmem_struct *shmem) {
+    assert(shmem_ref(shmem) == 0 && list_empty(&(shmem->vma_list)));
+    if (shmem->writeback) {
+        shmem_writeback(shmem);
+    }
+
+    bool intr_flag;
+    local_intr_save(intr_flag);
+    {
+        list_del(&(shmem->list_link));
+        nr_shmem --;
+    }
+    local_intr_restore(intr_flag);
+
+    size_t i;
+    for (i = 0; i < shmem->npages; i ++) {
+        pte_t entry = shmem->entries[i];
+        if (entry & PTE_P) {
+            struct Page *page = pte2page(entry);
+            if (page_ref_dec(page) == 0) {
+                free_page(page);
+            }
+        }
+        else if (entry != 0) {
+            swap_entry_free(entry);
+        }
+    }
+    if (shmem->node != NULL) {
+        vop_ref_dec(shmem->node);
+    }
+    kfree(shmem->entries);
+    kfree(shmem);
+}
+
+// shmem_fill_page - 分配第 index 页: 来自文件的部分读入, 其余清零
+static int
+shmem_fill_page(struct shmem_struct *shmem, size_t index, struct Page **page_store) {
+    size_t start = index * PGSIZE, n = 0;
+    if (start < shmem->filesz) {
+        n = shmem->filesz - start;
+        if (n > PGSIZE) {
+            n = PGSIZE;
+        }
+    }
+    struct Page *page;
+    if ((page = (n == PGSIZE) ? alloc_page() : alloc_page_zeroed()) == NULL) {
+        return -E_NO_MEM;
+    }
+    if (n != 0) {
+        struct iobuf __iob, *iob = iobuf_init(&__iob, page2kva(page), n, shmem->offset + start);
+        int ret = vop_read(shmem->node, iob);
+        if (ret == 0 && iob->io_resid != 0) {
+            ret = -E_INVAL;     // 文件比建立映射时短
+        }
+        if (ret != 0) {
+            free_page(page);
+            return ret;
+        }
+    }
+    *page_store = page;
+    return 0;
+}
+
+// shmem_swap_in_page - 第 index 页已被换出: 读回一个新页, 释放换出项
+static int
+shmem_swap_in_page(struct shmem_struct *shmem, size_t index, struct Page **page_store) {
+    swap_entry_t entry = shmem->entries[index];
+    int ret;
+    if ((ret = swap_in_copy(entry, page_store)) != 0) {
+        return ret;
+    }
+    swap_entry_free(entry);
+    shmem_swap_in_num ++;
+    return 0;
+}
+
+/**
+ * shmem_get_page - 取对象的第 index 页, 还未分配则先分配并填充, 已换出则先换入.
+ * 返回时页的引用计数已为调用者加一, 调用者建立映射(page_insert 会再加一)后用 page_ref_dec 放掉,
+ * 这样在此期间即使分配内存触发换出, 这一页也不会被选中.
+ */
+int
+shmem_get_page(struct shmem_struct *shmem, size_t index, struct Page **page_store) {
+    assert(index < shmem->npages);
+    int ret = 0;
+    struct Page *page;
+    down(&(shmem->sem));
+    pte_t entry = shmem->entries[index];
+    if (!(entry & PTE_P)) {
+        if (entry == 0) {
+            ret = shmem_fill_page(shmem, index, &page);
+        }
+        else {
+            ret = shmem_swap_in_page(shmem, index, &page);
+        }
+        if (ret != 0) {
+            goto out;
+        }
+        set_page_ref(page, 1);
+        shmem->entries[index] = page2pa(page) | PTE_P;
+    }
+    page = pte2page(shmem->entries[index]);
+    page_ref_inc(page);
+    *page_store = page;
+out:
+    up(&(shmem->sem));
+    return ret;
+}
+
+// shmem_for_each_pte - 对第 index 页在各个映射中的页表项调用 fn
+static void
+shmem_for_each_pte(struct shmem_struct *shmem, size_t index,
+                   void (*fn)(pde_t *pgdir, uintptr_t la, pte_t *ptep, void *arg), void *arg) {
+    struct Page *page = pte2page(shmem->entries[index]);
+    list_entry_t *le = &(shmem->vma_list);
+    while ((le = list_next(le)) != &(shmem->vma_list)) {
+        struct vma_struct *vma = le2vma(le, shmem_link);
+        uintptr_t la = vma->vm_shmem_base + index * PGSIZE;
+        pde_t *pgdir = vma->vm_mm->pgdir;
+        pte_t *ptep;
+        // 进程退出时页表在 vma 之前释放, 此时 pgdir 为 NULL
+        if (la < vma->vm_start || la >= vma->vm_end || pgdir == NULL) {
+            continue ;
+        }
+        if ((ptep = get_pte(pgdir, la, 0)) != NULL && (*ptep & PTE_P) && pte2page(*ptep) == page) {
+            fn(pgdir, la, ptep, arg);
+        }
+    }
+}
+
+// 清除 PTE_A, 记录是否有映射最近访问过此页
+static void
+clear_young(pde_t *pgdir, uintptr_t la, pte_t *ptep, void *arg) {
+    if (*ptep & PTE_A) {
+        *ptep &= ~PTE_A;
+        tlb_invalidate(pgdir, la);
+        *(bool *)arg = 1;
+    }
+}
+
+// 解除映射, 之后访问会重新缺页, 由 shmem_get_page 换入
+static void
+unmap_pte(pde_t *pgdir, uintptr_t la, pte_t *ptep, void *arg) {
+    page_remove(pgdir, la);
+}
+
+/**
+ * shmem_swap_out - 内存不足时从共享内存对象中换出最多 n 页, 返回换出的页数.
+ * 按对象链表和各对象的 clock_hand 做时钟扫描: 第一遍跳过(并清除)最近被访问过的页, 第二遍不再挑剔.
+ * 正在被填充或换入的对象(信号量被占用)直接跳过, 因此可以在分配内存的路径上调用.
+ */
+size_t
+shmem_swap_out(size_t n) {
+    size_t nr = 0;
+    int pass;
+    if (!swap_init_ok) {
+        return 0;
+    }
+    for (pass = 0; pass < 2 && nr < n; pass ++) {
+        list_entry_t *le = &shmem_list;
+        while (nr < n && (le = list_next(le)) != &shmem_list) {
+            struct shmem_struct *shmem = le2shmem(le, list_link);
+            if (!try_down(&(shmem->sem))) {
+                continue ;
+            }
+            size_t i;
+            for (i = 0; i < shmem->npages && nr < n; i ++) {
+                size_t index = shmem->clock_hand;
+                shmem->clock_hand = (index + 1) % shmem->npages;
+                if (!(shmem->entries[index] & PTE_P)) {
+                    continue ;
+                }
+                if (pass == 0) {
+                    bool young = 0;
+                    shmem_for_each_pte(shmem, index, clear_young, &young);
+                    if (young) {
+                        continue ;
+                    }
+                }
+                shmem_for_each_pte(shmem, index, unmap_pte, NULL);
+                struct Page *page = pte2page(shmem->entries[index]);
+                swap_entry_t entry;
+                if (page_ref(page) != 1 || (entry = swap_entry_alloc()) == 0) {
+                    continue ;
+                }
+                if (swapfs_write(entry, page) != 0) {
+                    swap_entry_free(entry);
+                    continue ;
+                }
+                shmem->entries[index] = entry;
+                set_page_ref(page, 0);
+                free_page_cold(page);
+                shmem_swap_out_num ++, nr ++;
+            }
+            up(&(shmem->sem));
+        }
+    }
+    if (nr != 0) {
+        LOG("shmem_swap_out: 换出了 %u 页共享内存.\n", nr);
+    }
+    return nr;
+}
+
+void
+shmem_get_stat(struct shmem_stat *stat) {
+    memset(stat, 0, sizeof(struct shmem_stat));
+    bool intr_flag;
+    local_intr_save(intr_flag);
+    {
+        list_entry_t *le = &shmem_list;
+        while ((le = list_next(le)) != &shmem_list) {
+            struct shmem_struct *shmem = le2shmem(le, list_link);
+            size_t i;
+            for (i = 0; i < shmem->npages; i ++) {
+                if (shmem->entries[i] & PTE_P) {
+                    stat->nr_resident ++;
+                }
+                else if (shmem->entries[i] != 0) {
+                    stat->nr_swapped ++;
+                }
+            }
+        }
+        stat->nr_shmem = nr_shmem;
+        stat->swap_out = shmem_swap_out_num;
+        stat->swap_in = shmem_swap_in_num;
+    }
+    local_intr_restore(intr_flag);
+}
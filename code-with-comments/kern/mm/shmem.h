@@ -0,0 +1,78 @@
+#ifndef __KERN_MM_SHMEM_H__
+#define __KERN_MM_SHMEM_H__
+
+#include <defs.h>
+#include <list.h>
+#include <mmu.h>
+#include <unistd.h>
+#include <sem.h>
+
+struct Page;
+struct inode;
+
+/**
+ * 共享内存对象: 一组按页编号的物理页, 可以被多个 vma(属于同一或不同进程)映射.
+ *
+ * 页在第一次缺页时才分配(匿名对象清零, 文件对象从后备文件读入), 之后所有映射者看到同一物理页.
+ * fork 时映射此对象的 vma 与父进程共享页表项, 不做写时复制.
+ * 对象持有其中每页的一个引用, 最后一个 vma 被销毁时释放全部页.
+ *
+ * entries[i] 的格式与页表项相同: 0 表示还未分配, PTE_P 置位时是物理页, 否则是换出项.
+ * 内存不足时 shmem_swap_out 经 vma_list 解除各处映射后把页换出, 下次缺页时再换入.
+ * 有名字的对象可以由不相关的进程按名字找到(SYS_shmem), 名字在对象销毁前有效.
+ */
+struct shmem_struct {
+    size_t npages;          // 对象的页数
+    pte_t *entries;         // 每页一项, 见上
+    int ref;                // 映射此对象的 vma 数
+    semaphore_t sem;        // 保护 entries 的填充与换入换出(读文件/磁盘时可能睡眠)
+    list_entry_t vma_list;  // 映射此对象的 vma, 用于换出时解除映射
+    list_entry_t list_link; // 所有共享内存对象的链表
+    char name[SHMEM_NAME_MAX + 1];  // 空串为匿名对象
+    struct inode *node;     // 后备文件, NULL 为匿名共享内存
+    off_t offset;           // 第 0 页对应的文件偏移
+    size_t filesz;          // 对象开头来自文件的字节数, 其余部分清零
+    bool writeback;         // 销毁时把 [0, filesz) 写回文件
+    size_t clock_hand;      // 换出时从这一页开始扫描
+};
+
+#define le2shmem(le, member)                \
+    to_struct((le), struct shmem_struct, member)
+
+// 共享内存的统计信息
+struct shmem_stat {
+    size_t nr_shmem;        // 当前对象数
+    size_t nr_resident;     // 在内存中的页数
+    size_t nr_swapped;      // 已换出的页数
+    size_t swap_out;        // 累计换出次数
+    size_t swap_in;         // 累计换入次数
+};
+
+struct shmem_struct *shmem_create(size_t len);
+struct shmem_struct *shmem_create_named(const char *name, size_t len);
+struct shmem_struct *shmem_create_file(size_t len, struct inode *node, off_t offset, size_t filesz, bool writeback);
+struct shmem_struct *shmem_lookup(const char *name);
+void shmem_destroy(struct shmem_struct *shmem);
+int shmem_get_page(struct shmem_struct *shmem, size_t index, struct Page **page_store);
+size_t shmem_swap_out(size_t n);
+void shmem_get_stat(struct shmem_stat *stat);
+
+static inline int
+shmem_ref(struct shmem_struct *shmem) {
+    return shmem->ref;
+}
+
+static inline int
+shmem_ref_inc(struct shmem_struct *shmem) {
+    shmem->ref += 1;
+    return shmem->ref;
+}
+
+static inline int
+shmem_ref_dec(struct shmem_struct *shmem) {
+    shmem->ref -= 1;
+    return shmem->ref;
+}
+
+#endif /* !__KERN_MM_SHMEM_H__ */
+
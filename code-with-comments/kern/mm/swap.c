@@ -1,13 +1,17 @@
 #include <swap.h>
 #include <swapfs.h>
 #include <swap_fifo.h>
+#include <swap_clock.h>
 #include <stdio.h>
 #include <string.h>
 #include <memlayout.h>
 #include <pmm.h>
 #include <mmu.h>
-#include <default_pmm.h>
+#include <sync.h>
 #include <kdebug.h>
+#include <error.h>
+#include <kmalloc.h>
+#include <shmem.h>
 
 // the valid vaddr for check is between 0~CHECK_VALID_VADDR-1
 #define CHECK_VALID_VIR_PAGE_NUM 5
@@ -17,6 +21,10 @@
 #define CHECK_VALID_PHY_PAGE_NUM 4
 // the max access seq number
 #define MAX_SEQ_NO 10
+// 比较置换算法用的更长的访问序列: 虚拟页数与轮数
+#define CHECK_TRACE_VIR_PAGE_NUM 8
+#define CHECK_TRACE_VADDR (CHECK_TRACE_VIR_PAGE_NUM+1)*0x1000
+#define CHECK_TRACE_ROUNDS 24
 
 static struct swap_manager *sm;
 size_t max_swap_offset;
@@ -28,6 +36,50 @@ unsigned int swap_page[CHECK_VALID_VIR_PAGE_NUM];
 unsigned int swap_in_seq_no[MAX_SEQ_NO],swap_out_seq_no[MAX_SEQ_NO];
 
 static void check_swap(void);
+static void check_shmem_swap(void);
+static void check_cow_swap(void);
+
+/* *
+ * 换出项分配器. swap_out 使用由虚拟地址推出的换出项(只服务于 check_mm_struct),
+ * 其他换出者(如共享内存)从这里按位图分配. 从交换分区的高端往下分配, 避开 swap_out 使用的低端偏移.
+ * */
+static uint32_t *swap_map;      // 第 i 位为 1 表示偏移 i 已被分配
+static size_t swap_map_hint;    // 下一次从这个偏移开始往下找
+
+swap_entry_t
+swap_entry_alloc(void)
+{
+     swap_entry_t entry = 0;
+     bool intr_flag;
+     local_intr_save(intr_flag);
+     {
+          size_t i, offset = swap_map_hint;
+          for (i = 1; i < max_swap_offset; i ++) {
+               if (!(swap_map[offset / 32] & (1 << (offset % 32)))) {
+                    swap_map[offset / 32] |= (1 << (offset % 32));
+                    swap_map_hint = (offset > 1) ? offset - 1 : max_swap_offset - 1;
+                    entry = offset << 8;
+                    break;
+               }
+               offset = (offset > 1) ? offset - 1 : max_swap_offset - 1;
+          }
+     }
+     local_intr_restore(intr_flag);
+     return entry;
+}
+
+void
+swap_entry_free(swap_entry_t entry)
+{
+     size_t offset = swap_offset(entry);
+     bool intr_flag;
+     local_intr_save(intr_flag);
+     {
+          assert(swap_map[offset / 32] & (1 << (offset % 32)));
+          swap_map[offset / 32] &= ~(1 << (offset % 32));
+     }
+     local_intr_restore(intr_flag);
+}
 
 int
 swap_init(void)
@@ -40,9 +92,19 @@ swap_init(void)
      {
           panic("bad max_swap_offset %08x.\n", max_swap_offset);
      }
+
+     size_t map_size = ROUNDUP(max_swap_offset, 32) / 32 * sizeof(uint32_t);
+     if ((swap_map = kmalloc(map_size)) == NULL) {
+          panic("no memory for swap_map.\n");
+     }
+     memset(swap_map, 0, map_size);
+     swap_map_hint = max_swap_offset - 1;
      
 
-     sm = &swap_manager_fifo;
+     // 可选实例:
+     //      swap_manager_fifo  : 先进先出, 不看页是否被访问, 循环访问时会反复换出常用的页
+     //      swap_manager_clock : 扩展时钟, 按 PTE_A/PTE_D 优先换出最近没有访问的干净页, 自检时与 fifo 对比缺页次数
+     sm = &swap_manager_clock;
      int r = sm->init();
      
      if (r == 0)
@@ -50,6 +112,8 @@ swap_init(void)
           swap_init_ok = 1;
           LOG("SWAP: manager = %s\n", sm->name);
           check_swap();
+          check_shmem_swap();
+          check_cow_swap();
      }
 
      LOG_LINE("初始化完毕:交换分区");
@@ -71,6 +135,10 @@ swap_tick_event(struct mm_struct *mm)
 int
 swap_map_swappable(struct mm_struct *mm, uintptr_t addr, struct Page *page, int swap_in)
 {
+     // 共享零页映射在各处, 内容永远为 0, 不能被选为换出对象
+     if (is_zero_page(page)) {
+          return 0;
+     }
      return sm->map_swappable(mm, addr, page, swap_in);
 }
 
@@ -103,10 +171,18 @@ swap_out(struct mm_struct *mm, int n, int in_tick)
 
           //LOG("SWAP: choose victim page 0x%08x\n", page);
           
+          assert(!is_zero_page(page));
           v=page->pra_vaddr; 
           pte_t *ptep = get_pte(mm->pgdir, v, 0);
           assert((*ptep & PTE_P) != 0);
 
+          // fork 后写时复制共享的页还映射在其他页表中, 换出项只能写回这一处, 不能换出
+          if (page_ref(page) > 1) {
+                    LOG("swap_out: i %d, page in vaddr 0x%x is shared, skip\n", i, v);
+                    sm->map_swappable(mm, v, page, 0);
+                    continue;
+          }
+
           if (swapfs_write( (page->pra_vaddr/PGSIZE+1)<<8, page) != 0) {
                     LOG("SWAP: failed to save\n");
                     sm->map_swappable(mm, v, page, 0);
@@ -115,7 +191,7 @@ swap_out(struct mm_struct *mm, int n, int in_tick)
           else {
                     LOG("swap_out: i %d, store page in vaddr 0x%x to disk swap entry %d\n", i, v, page->pra_vaddr/PGSIZE+1);
                     *ptep = (page->pra_vaddr/PGSIZE+1)<<8;
-                    free_page(page);
+                    free_page_cold(page);
           }
           
           tlb_invalidate(mm->pgdir, v);
@@ -142,6 +218,23 @@ swap_in(struct mm_struct *mm, uintptr_t addr, struct Page **ptr_result)
      return 0;
 }
 
+// swap_in_copy - 把换出项 entry 对应的磁盘页读入一个新页, 供 fork 时给子进程一份私有副本
+int
+swap_in_copy(swap_entry_t entry, struct Page **ptr_result)
+{
+     struct Page *result;
+     int r;
+     if ((result = alloc_page()) == NULL) {
+          return -E_NO_MEM;
+     }
+     if ((r = swapfs_read(entry, result)) != 0) {
+          free_page(result);
+          return r;
+     }
+     *ptr_result=result;
+     return 0;
+}
+
 
 
 static inline void
@@ -176,24 +269,77 @@ struct Page * check_rp[CHECK_VALID_PHY_PAGE_NUM];
 pte_t * check_ptep[CHECK_VALID_PHY_PAGE_NUM];
 unsigned int check_swap_addr[CHECK_VALID_VIR_PAGE_NUM];
 
-extern free_area_t free_area;
+/**
+ * 测试期间暂扣的空闲页.
+ * 不再直接替换某个 pmm_manager 的 free list, 而是把其余空闲页全部分配出来暂扣,
+ * 使测试与具体的物理内存分配算法无关.
+ * 直接调用 pmm_manager->alloc_pages, 避免 alloc_pages 在内存耗尽时触发换出.
+ */
+static list_entry_t check_hold_list;
 
-#define free_list (free_area.free_list)
-#define nr_free (free_area.nr_free)
+static void
+check_hold_free_pages(void) {
+     list_init(&check_hold_list);
+     page_cache_enable(0);
+     zero_pool_drain();
+     pgtable_cache_drain();
+     bool intr_flag;
+     local_intr_save(intr_flag);
+     {
+          struct Page *page;
+          while ((page = pmm_manager->alloc_pages(1)) != NULL) {
+               list_add(&check_hold_list, &(page->page_link));
+          }
+     }
+     local_intr_restore(intr_flag);
+     assert(nr_free_pages() == 0);
+}
 
 static void
-check_swap(void)
+check_release_free_pages(void) {
+     list_entry_t *le;
+     while ((le = list_next(&check_hold_list)) != &check_hold_list) {
+          list_del(le);
+          free_page(le2page(le, page_link));
+     }
+     page_cache_enable(1);
+}
+
+// check_trace_access - 两个热页每轮都写, 其余的冷页轮流只读一次.
+// fifo 会周期性地换出热页; 扩展时钟给热页第二次机会, 并优先换出读过的干净冷页
+static int
+check_trace_access(void)
 {
-    //backup mem env
-     int ret, count = 0, total = 0, i;
-     list_entry_t *le = &free_list;
-     while ((le = list_next(le)) != &free_list) {
-        struct Page *p = le2page(le, page_link);
-        assert(PageProperty(p));
-        count ++, total += p->property;
+     int i, r;
+     for (i = CHECK_VALID_PHY_PAGE_NUM + 1; i <= CHECK_TRACE_VIR_PAGE_NUM; i ++) {
+          *(unsigned char *)(i * 0x1000) = 0x0a + i - 1;
+     }
+     assert(pgfault_num == CHECK_TRACE_VIR_PAGE_NUM);
+     for (r = 0; r < CHECK_TRACE_ROUNDS; r ++) {
+          *(unsigned char *)0x1000 = 0x0a;
+          *(unsigned char *)0x2000 = 0x0b;
+          i = 3 + r % (CHECK_TRACE_VIR_PAGE_NUM - 2);
+          assert(*(unsigned char *)(i * 0x1000) == 0x0a + i - 1);
      }
-     assert(total == nr_free_pages());
-     LOG("BEGIN check_swap: count %d, total %d\n",count,total);// count: 连续空闲块数量 total: 空闲 page 数量
+     return 0;
+}
+
+/**
+ * check_swap_run - 用置换算法 manager 在 [0x1000, end) 上运行访问序列 access, 返回缺页次数.
+ * 物理页只有 CHECK_VALID_PHY_PAGE_NUM 个, 前四个虚拟页由 check_content_set 写入.
+ */
+static unsigned int
+check_swap_run(struct swap_manager *manager, uintptr_t end, int (*access)(void))
+{
+    //backup mem env
+     int ret, i;
+     unsigned int faults;
+     size_t nr_free_pages_store = nr_free_pages();
+     LOG("BEGIN check_swap: %s, total %d\n", manager->name, nr_free_pages_store);// total: 空闲 page 数量
+
+     struct swap_manager *sm_store = sm;
+     sm = manager;
+     assert(sm->init() == 0);
      
      //now we set the phy pages env     
      // 1. 创建内存描述符
@@ -208,8 +354,8 @@ check_swap(void)
      pde_t *pgdir = mm->pgdir = boot_pgdir;
      assert(pgdir[0] == 0);
 
-     // 从 0X1000 到 (5+1)*0x1000
-     struct vma_struct *vma = vma_create(BEING_CHECK_VALID_VADDR, CHECK_VALID_VADDR, VM_WRITE | VM_READ);
+     // 从 0X1000 到 end
+     struct vma_struct *vma = vma_create(BEING_CHECK_VALID_VADDR, end, VM_WRITE | VM_READ);
      assert(vma != NULL);
 
      insert_vma_struct(mm, vma);
@@ -226,18 +372,12 @@ check_swap(void)
           assert(check_rp[i] != NULL );
           assert(!PageProperty(check_rp[i]));
      }
-     list_entry_t free_list_store = free_list;
-     list_init(&free_list);
-     assert(list_empty(&free_list));
-     
-     //assert(alloc_page() == NULL);
+     check_hold_free_pages();
      
-     unsigned int nr_free_store = nr_free;
-     nr_free = 0;
      for (i=0;i<CHECK_VALID_PHY_PAGE_NUM;i++) {
         free_pages(check_rp[i],1);
      }
-     assert(nr_free==CHECK_VALID_PHY_PAGE_NUM);
+     assert(nr_free_pages()==CHECK_VALID_PHY_PAGE_NUM);
      
      LOG("set up init env for check_swap begin!\n");
      //setup initial vir_page<->phy_page environment for page relpacement algorithm 
@@ -246,7 +386,7 @@ check_swap(void)
      pgfault_num=0;
      
      check_content_set();
-     assert( nr_free == 0);         
+     assert(nr_free_pages() == 0);
      for(i = 0; i<MAX_SEQ_NO ; i++) 
          swap_out_seq_no[i]=swap_in_seq_no[i]=-1;
      
@@ -260,8 +400,24 @@ check_swap(void)
      }
      LOG("set up init env for check_swap over!\n");
      // now access the virt pages to test  page relpacement algorithm 
-     ret=check_content_access();
+     ret=access();
      assert(ret==0);
+     faults = pgfault_num;
+
+     // 定时处理不接在时钟中断上(可换出的页只在自检期间存在), 在这里直接调用.
+     // 时钟算法清除所有内存中页的 PTE_A, 保留 PTE_D; a 是两个访问序列最后都在内存中的页
+     pte_t *ptep = get_pte(pgdir, 0x1000, 0);
+     bool clock = (sm == &swap_manager_clock);
+     assert(!clock || ((*ptep & PTE_P) && (*ptep & PTE_A) && (*ptep & PTE_D)));
+     assert(sm->tick_event(mm) == 0);
+     if (clock) {
+          uintptr_t addr;
+          for (addr = BEING_CHECK_VALID_VADDR; addr < end; addr += PGSIZE) {
+               ptep = get_pte(pgdir, addr, 0);
+               assert(!(*ptep & PTE_P) || !(*ptep & PTE_A));
+          }
+          assert(*get_pte(pgdir, 0x1000, 0) & PTE_D);
+     }
      
      //restore kernel mem env
      for (i=0;i<CHECK_VALID_PHY_PAGE_NUM;i++) {
@@ -275,17 +431,159 @@ check_swap(void)
      mm_destroy(mm);
      check_mm_struct = NULL;
      
-     nr_free = nr_free_store;
-     free_list = free_list_store;
+     check_release_free_pages();
+     sm = sm_store;
 
-     
-     le = &free_list;
-     while ((le = list_next(le)) != &free_list) {
-         struct Page *p = le2page(le, page_link);
-         count --, total -= p->property;
+     LOG("total is %d, now %d\n", nr_free_pages_store, nr_free_pages());
+     return faults;
+}
+
+// check_swap - 两种置换算法分别运行原来的访问序列和更长的访问序列, 比较缺页次数
+static void
+check_swap(void)
+{
+     unsigned int fifo_faults, clock_faults;
+
+     fifo_faults = check_swap_run(&swap_manager_fifo, CHECK_VALID_VADDR, check_content_access);
+     clock_faults = check_swap_run(&swap_manager_clock, CHECK_VALID_VADDR, check_content_access);
+     LOG_TAB("check_swap: %d 个物理页, 缺页次数:\n", CHECK_VALID_PHY_PAGE_NUM);
+     LOG_TAB("\tcheck_swap 序列: fifo %u, clock %u\n", fifo_faults, clock_faults);
+     assert(clock_faults <= fifo_faults);
+
+     fifo_faults = check_swap_run(&swap_manager_fifo, CHECK_TRACE_VADDR, check_trace_access);
+     clock_faults = check_swap_run(&swap_manager_clock, CHECK_TRACE_VADDR, check_trace_access);
+     LOG_TAB("\t%d 页 %d 轮的序列: fifo %u, clock %u\n",
+             CHECK_TRACE_VIR_PAGE_NUM, CHECK_TRACE_ROUNDS, fifo_faults, clock_faults);
+     assert(clock_faults < fifo_faults);
+
+     LOG_TAB("%-20s%s\n","check_swap()", ": succeed!");
+}
+
+// check_shmem_swap - 共享内存页的换出与换入: 时钟扫描给最近访问过的页第二次机会, 换出时解除所有映射
+static void
+check_shmem_swap(void)
+{
+     size_t nr_free_pages_store = nr_free_pages();
+     struct shmem_stat stat0, stat1;
+     shmem_get_stat(&stat0);
+
+     struct mm_struct *mm = mm_create();
+     assert(mm != NULL);
+     pde_t *pgdir = mm->pgdir = boot_pgdir;
+     uintptr_t base = PTSIZE, addr2 = base + 4 * PGSIZE;
+     assert(pgdir[PDX(base)] == 0);
+
+     struct shmem_struct *shmem = shmem_create_named("check_shmem", 4 * PGSIZE);
+     assert(shmem != NULL && shmem_lookup("check_shmem") == shmem);
+     assert(mm_map_shmem(mm, base, 4 * PGSIZE, VM_READ | VM_WRITE, shmem) == 0);
+     assert(mm_map_shmem(mm, addr2, 4 * PGSIZE, VM_READ, shmem) == 0);
+     int i;
+     for (i = 0; i < 4; i ++) {
+          assert(do_pgfault(mm, 2, base + i * PGSIZE) == 0);
+          *(int *)(base + i * PGSIZE) = i + 0x100;
      }
-     LOG("count is %d, total is %d\n",count,total);
-     //assert(count == 0);
-     
-     LOG("check_swap() succeeded!\n");
+     assert(do_pgfault(mm, 0, addr2) == 0 && *(int *)addr2 == 0x100);
+
+     // 都被访问过: 第一遍只清除 PTE_A, 第二遍从时钟指针处换出两页, 两处映射都被解除
+     assert(shmem_swap_out(2) == 2);
+     assert(get_page(pgdir, base, NULL) == NULL && get_page(pgdir, addr2, NULL) == NULL);
+     assert(get_page(pgdir, base + 2 * PGSIZE, NULL) != NULL);
+     shmem_get_stat(&stat1);
+     assert(stat1.nr_swapped == stat0.nr_swapped + 2 && stat1.swap_out == stat0.swap_out + 2);
+
+     // 第 2 页刚被访问, 第 3 页的 PTE_A 已在上一次扫描中清除: 换出第 3 页
+     *(int *)(base + 2 * PGSIZE) = 0x102;
+     assert(shmem_swap_out(1) == 1);
+     assert(get_page(pgdir, base + 3 * PGSIZE, NULL) == NULL && get_page(pgdir, base + 2 * PGSIZE, NULL) != NULL);
+
+     // 再次访问时换入, 内容不变
+     assert(do_pgfault(mm, 0, addr2 + PGSIZE) == 0 && *(int *)(addr2 + PGSIZE) == 0x101);
+     assert(do_pgfault(mm, 2, base) == 0 && *(int *)base == 0x100);
+     assert(do_pgfault(mm, 0, base + 3 * PGSIZE) == 0 && *(int *)(base + 3 * PGSIZE) == 0x103);
+     shmem_get_stat(&stat1);
+     assert(stat1.nr_swapped == stat0.nr_swapped && stat1.swap_in == stat0.swap_in + 3);
+
+     unmap_range(pgdir, base, base + 8 * PGSIZE);
+     exit_range(pgdir, base, base + 8 * PGSIZE);
+     assert(pgdir[PDX(base)] == 0);
+     mm->pgdir = NULL;
+     mm_destroy(mm);
+     assert(shmem_lookup("check_shmem") == NULL);
+
+     assert(nr_free_pages_store == nr_free_pages());
+     LOG_TAB("%-20s%s\n","check_shmem_swap()", ": succeed!");
+}
+
+/**
+ * check_cow_swap_run - 用置换算法 manager 检查写时复制后的换出.
+ * fork 后父进程写共享页, 复制得到的新页接替原来的页进入置换队列: 换出的是父进程的新页,
+ * 子进程仍映射的原来的页留在内存中, 内容不变.
+ */
+static void
+check_cow_swap_run(struct swap_manager *manager)
+{
+     size_t nr_free_pages_store = nr_free_pages();
+     struct swap_manager *sm_store = sm;
+     sm = manager;
+     assert(sm->init() == 0);
+
+     struct mm_struct *mm = mm_create(), *child = mm_create();
+     assert(mm != NULL && child != NULL);
+     pde_t *pgdir = mm->pgdir = boot_pgdir;
+     assert((child->pgdir = alloc_pgdir()) != NULL);
+     uintptr_t base = PTSIZE;
+     assert(pgdir[PDX(base)] == 0);
+     assert(mm_map(mm, base, PGSIZE, VM_READ | VM_WRITE, NULL) == 0);
+
+     extern struct mm_struct *check_mm_struct;
+     assert(check_mm_struct == NULL);
+     check_mm_struct = mm;
+
+     assert(do_pgfault(mm, 2, base) == 0);
+     *(int *)base = 0x5a5a5a5a;
+     struct Page *page = get_page(pgdir, base, NULL);
+     assert(page != NULL && page->pra_vaddr == base);
+
+     // fork 后父进程写: 复制一份, 原来的页只剩子进程的引用
+     assert(dup_mmap(child, mm) == 0);
+     assert(get_page(child->pgdir, base, NULL) == page && page_ref(page) == 2);
+     assert(do_pgfault(mm, 3, base) == 0);
+     struct Page *npage = get_page(pgdir, base, NULL);
+     assert(npage != page && page_ref(page) == 1 && npage->pra_vaddr == base);
+     *(int *)base = 0xa5a5a5a5;
+
+     // 队列中只有新页: 换出它, 子进程的页不受影响
+     assert(swap_out(mm, 1, 0) == 1);
+     pte_t *ptep = get_pte(pgdir, base, 0);
+     assert(ptep != NULL && !(*ptep & PTE_P) && *ptep != 0);
+     assert(get_page(child->pgdir, base, NULL) == page && page_ref(page) == 1);
+     assert(*(int *)page2kva(page) == 0x5a5a5a5a);
+     assert(swap_out(mm, 1, 0) == 0);
+
+     // 换入后是父进程写入的内容
+     assert(do_pgfault(mm, 0, base) == 0 && *(int *)base == 0xa5a5a5a5);
+
+     unmap_range(child->pgdir, base, base + PGSIZE);
+     exit_range(child->pgdir, base, base + PGSIZE);
+     free_pgdir(child->pgdir);
+     child->pgdir = NULL;
+     mm_destroy(child);
+
+     unmap_range(pgdir, base, base + PGSIZE);
+     exit_range(pgdir, base, base + PGSIZE);
+     assert(pgdir[PDX(base)] == 0);
+     mm->pgdir = NULL;
+     mm_destroy(mm);
+     check_mm_struct = NULL;
+     sm = sm_store;
+
+     assert(nr_free_pages_store == nr_free_pages());
+}
+
+static void
+check_cow_swap(void)
+{
+     check_cow_swap_run(&swap_manager_fifo);
+     check_cow_swap_run(&swap_manager_clock);
+     LOG_TAB("%-20s%s\n","check_cow_swap()", ": succeed!");
 }
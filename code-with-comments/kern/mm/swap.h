@@ -58,6 +58,9 @@ int swap_map_swappable(struct mm_struct *mm, uintptr_t addr, struct Page *page,
 int swap_set_unswappable(struct mm_struct *mm, uintptr_t addr);
 int swap_out(struct mm_struct *mm, int n, int in_tick);
 int swap_in(struct mm_struct *mm, uintptr_t addr, struct Page **ptr_result);
+int swap_in_copy(swap_entry_t entry, struct Page **ptr_result);
+swap_entry_t swap_entry_alloc(void);
+void swap_entry_free(swap_entry_t entry);
 
 //#define MEMBER_OFFSET(m,t) ((int)(&((t *)0)->m))
 //#define FROM_MEMBER(m,t,a) ((t *)((char *)(a) - MEMBER_OFFSET(m,t)))
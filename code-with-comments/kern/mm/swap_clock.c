@@ -0,0 +1,209 @@
+#include <defs.h>
+#include <x86.h>
+#include <stdio.h>
+#include <string.h>
+#include <swap.h>
+#include <swap_clock.h>
+#include <list.h>
+#include <error.h>
+#include <kdebug.h>
+
+/* *
+ * 扩展时钟(改进的第二次机会)页置换算法.
+ *
+ * 可换出的页按进入的顺序排成一个环, 时钟指针指向下一个被考察的页. 每页按页表项中硬件维护的
+ * 访问位 PTE_A 和修改位 PTE_D 分为四类, 换出时依次寻找:
+ *      (0,0) 最近没有访问, 也没有修改: 最佳的换出对象;
+ *      (0,1) 最近没有访问, 但修改过;
+ *      (1,0) 最近访问过, 没有修改;
+ *      (1,1) 最近访问过, 也修改过.
+ * 具体做法是最多转四圈:
+ *      1. 从指针处找 (0,0) 的页, 不修改任何位;
+ *      2. 没找到则找 (0,1) 的页, 同时清除经过的页的 PTE_A;
+ *      3. 重复第 1 步, 此时原来的 (1,0) 已变成 (0,0);
+ *      4. 重复第 2 步, 此时一定能找到.
+ * 被频繁访问的页总能在指针再次经过之前重新置上 PTE_A, 从而留在内存中; fifo 不看访问位, 会周期性地换出它们.
+ * PTE_D 只用来排序, 不在这里清除: 没有写回磁盘之前清除它会丢失"页已修改"的信息.
+ * */
+
+// pra: page replace algorithm. 与 fifo 一样, 只有一个 check_mm_struct 使用, 用全局的环和指针即可
+static list_entry_t pra_list_head;
+static list_entry_t *clock_hand;    // 下一个被考察的页; 环为空时指向 pra_list_head
+
+// clock_next - 环中 le 的下一页, 跳过表头
+static inline list_entry_t *
+clock_next(list_entry_t *head, list_entry_t *le)
+{
+     le = list_next(le);
+     return (le == head) ? list_next(head) : le;
+}
+
+static int
+_clock_init_mm(struct mm_struct *mm)
+{
+     list_init(&pra_list_head);
+     clock_hand = &pra_list_head;
+     mm->sm_priv = &pra_list_head;
+     return 0;
+}
+
+// 新页放在指针的前面, 即指针转一圈后最后才考察它
+static int
+_clock_map_swappable(struct mm_struct *mm, uintptr_t addr, struct Page *page, int swap_in)
+{
+     list_entry_t *head = (list_entry_t *)mm->sm_priv;
+     list_entry_t *entry = &(page->pra_page_link);
+     assert(entry != NULL && head != NULL);
+     list_add_before(clock_hand, entry);
+     return 0;
+}
+
+// 按上面的四步从指针处选出换出的页, 从环中移除, 指针移到它的下一页
+static int
+_clock_swap_out_victim(struct mm_struct *mm, struct Page **ptr_page, int in_tick)
+{
+     LOG("clock 页换出处理\n");
+
+     list_entry_t *head = (list_entry_t *)mm->sm_priv;
+     assert(head != NULL);
+     assert(in_tick == 0);
+     if (list_empty(head)) {
+          return -E_NO_MEM;
+     }
+     if (clock_hand == head) {
+          clock_hand = list_next(head);
+     }
+
+     int round;
+     for (round = 0; round < 4; round ++) {
+          bool want_dirty = (round % 2 == 1);
+          list_entry_t *le = clock_hand;
+          do {
+               struct Page *page = le2page(le, pra_page_link);
+               pte_t *ptep = get_pte(mm->pgdir, page->pra_vaddr, 0);
+               assert(ptep != NULL && (*ptep & PTE_P));
+               if (!(*ptep & PTE_A) && ((*ptep & PTE_D) != 0) == want_dirty) {
+                    clock_hand = clock_next(head, le);
+                    list_del(le);
+                    if (list_empty(head)) {
+                         clock_hand = head;
+                    }
+                    *ptr_page = page;
+                    return 0;
+               }
+               if (want_dirty && (*ptep & PTE_A)) {
+                    *ptep &= ~PTE_A;
+                    tlb_invalidate(mm->pgdir, page->pra_vaddr);
+               }
+               le = clock_next(head, le);
+          } while (le != clock_hand);
+     }
+     panic("clock: no victim after four rounds.\n");
+}
+
+// check_swap 的访问序列(与 fifo 相同), 最近写过的页得到第二次机会, 缺页比 fifo 少两次
+static int
+_clock_check_swap(void) {
+    // 此时环中为 a b c d, 指针指向 a, 四页都是 (1,1)
+    LOG("write Virt Page c in clock_check_swap\n");
+    *(unsigned char *)0x3000 = 0x0c;
+    assert(pgfault_num==4);
+    LOG("write Virt Page a in clock_check_swap\n");
+    *(unsigned char *)0x1000 = 0x0a;
+    assert(pgfault_num==4);
+    LOG("write Virt Page d in clock_check_swap\n");
+    *(unsigned char *)0x4000 = 0x0d;
+    assert(pgfault_num==4);
+    LOG("write Virt Page b in clock_check_swap\n");
+    *(unsigned char *)0x2000 = 0x0b;
+    assert(pgfault_num==4);
+    // 四圈后换出 a, 其余页都变为 (0,1)
+    LOG("write Virt Page e in clock_check_swap\n");
+    *(unsigned char *)0x5000 = 0x0e;
+    assert(pgfault_num==5);
+    LOG("write Virt Page b in clock_check_swap\n");
+    *(unsigned char *)0x2000 = 0x0b;
+    assert(pgfault_num==5);
+    // b 刚写过, 清除 PTE_A 后换出 c
+    LOG("write Virt Page a in clock_check_swap\n");
+    *(unsigned char *)0x1000 = 0x0a;
+    assert(pgfault_num==6);
+    // b 仍在内存中, fifo 在这里缺页
+    LOG("write Virt Page b in clock_check_swap\n");
+    *(unsigned char *)0x2000 = 0x0b;
+    assert(pgfault_num==6);
+    LOG("write Virt Page c in clock_check_swap\n");
+    *(unsigned char *)0x3000 = 0x0c;
+    assert(pgfault_num==7);
+    LOG("write Virt Page d in clock_check_swap\n");
+    *(unsigned char *)0x4000 = 0x0d;
+    assert(pgfault_num==8);
+    LOG("write Virt Page e in clock_check_swap\n");
+    *(unsigned char *)0x5000 = 0x0e;
+    assert(pgfault_num==9);
+    // a 仍在内存中, fifo 在这里缺页
+    LOG("write Virt Page a in clock_check_swap\n");
+    assert(*(unsigned char *)0x1000 == 0x0a);
+    *(unsigned char *)0x1000 = 0x0a;
+    assert(pgfault_num==9);
+    return 0;
+}
+
+static int
+_clock_init(void)
+{
+     return 0;
+}
+
+// 把映射在 addr 的页移出环, 例如写时复制把它换成了新页; 指针指向它时移到下一页
+static int
+_clock_set_unswappable(struct mm_struct *mm, uintptr_t addr)
+{
+     list_entry_t *head = (list_entry_t *)mm->sm_priv, *le = head;
+     assert(head != NULL);
+     while ((le = list_next(le)) != head) {
+          if (le2page(le, pra_page_link)->pra_vaddr == addr) {
+               if (clock_hand == le) {
+                    clock_hand = clock_next(head, le);
+               }
+               list_del(le);
+               if (list_empty(head)) {
+                    clock_hand = head;
+               }
+               return 0;
+          }
+     }
+     return -E_INVAL;
+}
+
+// 清除所有页的 PTE_A, 使"访问过"只表示上次清除后访问过. 没有接在时钟中断上:
+// 可换出的页只在自检期间存在, 置换只依靠换出时第 2, 4 步的清除; 自检中直接调用它
+static int
+_clock_tick_event(struct mm_struct *mm)
+{
+     list_entry_t *head = (list_entry_t *)mm->sm_priv, *le = head;
+     if (head == NULL || mm->pgdir == NULL) {
+          return 0;
+     }
+     while ((le = list_next(le)) != head) {
+          struct Page *page = le2page(le, pra_page_link);
+          pte_t *ptep = get_pte(mm->pgdir, page->pra_vaddr, 0);
+          if (ptep != NULL && (*ptep & PTE_A)) {
+               *ptep &= ~PTE_A;
+               tlb_invalidate(mm->pgdir, page->pra_vaddr);
+          }
+     }
+     return 0;
+}
+
+struct swap_manager swap_manager_clock =
+{
+     .name            = "extended clock swap manager",
+     .init            = &_clock_init,
+     .init_mm         = &_clock_init_mm,
+     .tick_event      = &_clock_tick_event,
+     .map_swappable   = &_clock_map_swappable,
+     .set_unswappable = &_clock_set_unswappable,
+     .swap_out_victim = &_clock_swap_out_victim,
+     .check_swap      = &_clock_check_swap,
+};
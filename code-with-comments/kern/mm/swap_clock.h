@@ -0,0 +1,7 @@
+#ifndef __KERN_MM_SWAP_CLOCK_H__
+#define __KERN_MM_SWAP_CLOCK_H__
+
+#include <swap.h>
+extern struct swap_manager swap_manager_clock;
+
+#endif
@@ -5,6 +5,7 @@
 #include <swap.h>
 #include <swap_fifo.h>
 #include <list.h>
+#include <error.h>
 #include <kdebug.h>
 
 /* [wikipedia]The simplest Page Replacement Algorithm(PRA) is a FIFO algorithm. The first-in, first-out
@@ -133,10 +134,19 @@ _fifo_init(void)
     return 0;
 }
 
+// 把映射在 addr 的页移出队列, 例如写时复制把它换成了新页. 队列中没有这一页时返回 -E_INVAL
 static int
 _fifo_set_unswappable(struct mm_struct *mm, uintptr_t addr)
 {
-    return 0;
+    list_entry_t *head=(list_entry_t*) mm->sm_priv, *le = head;
+    assert(head != NULL);
+    while ((le = list_next(le)) != head) {
+        if (le2page(le, pra_page_link)->pra_vaddr == addr) {
+            list_del(le);
+            return 0;
+        }
+    }
+    return -E_INVAL;
 }
 
 static int
@@ -0,0 +1,461 @@
+#include <pmm.h>
+#include <list.h>
+#include <string.h>
+#include <stdio.h>
+#include <x86.h>
+#include <sync.h>
+#include <default_pmm.h>
+#include <tlsf_pmm.h>
+#include <kdebug.h>
+
+/**
+ * TLSF (Two-Level Segregated Fit) 内存分配算法.
+ *
+ * 空闲块按大小分到 TLSF_FL_COUNT * TLSF_SL_COUNT 个 free list 中:
+ *      - 一级索引 fl 由块大小的最高位决定, 即 [2^f, 2^(f+1)) 为一个一级区间;
+ *      - 二级索引 sl 把一级区间再等分为 TLSF_SL_COUNT 份;
+ *      - 小于 TLSF_SL_COUNT 页的块直接放在 fl = 0, sl = size 中, 每个 list 只有一种大小.
+ * 两级位图 fl_bitmap / sl_bitmap[fl] 记录哪些 list 非空, 借助 bsf/bsr 指令一步找到合适的 list.
+ *
+ * 分配 n 页:
+ *      1) 把 n 向上取整到下一个二级区间的起点, 保证该区间及之后的任意块都 >= n (good fit);
+ *      2) 在位图中找到第一个不小于该区间的非空 list, 取其首块;
+ *      3) 块大于 n 时把剩余部分重新插入对应的 list.
+ * 释放 n 页:
+ *      通过边界标记(boundary tag)直接定位物理上相邻的前后两个空闲块并立即合并, 再插入对应的 list.
+ *
+ * 两个方向都不含任何循环, 时间复杂度与空闲块数量和内存大小无关, 最坏情况也是 O(1).
+ *
+ * 沿用 struct Page 的约定:
+ *      - 空闲块的首页设置 PG_property, property 记录此块的页数;
+ *      - 页数大于 1 的空闲块, 其末页设置 PG_tail, property 同样记录块的页数, 用于从后方定位块首;
+ *      - 空闲块的其他页及已分配页 property = 0, PG_property 与 PG_tail 清零.
+ */
+
+static struct tlsf_control {
+    uint32_t fl_bitmap;                                     // 第 fl 位表示 sl_bitmap[fl] 非 0
+    uint32_t sl_bitmap[TLSF_FL_COUNT];                      // 第 sl 位表示 blocks[fl][sl] 非空
+    list_entry_t blocks[TLSF_FL_COUNT][TLSF_SL_COUNT];
+    size_t nr_free;
+} tlsf;
+
+// 自检时暂存 tlsf, 让测试在一个只含测试区域的空分配器上进行. TLSF 不是当前的 pmm_manager 时暂存的是未使用的状态
+static struct tlsf_control tlsf_store;
+
+// 最高位/最低位的下标, x 不能为 0. 编译为一条 bsr/bsf 指令
+#define tlsf_fls(x)             (31 - __builtin_clz(x))
+#define tlsf_ffs(x)             (__builtin_ctz(x))
+
+// 大小为 size 的块所属的 list
+static inline void
+tlsf_mapping_insert(size_t size, int *fl, int *sl) {
+    if (size < TLSF_SL_COUNT) {
+        *fl = 0;
+        *sl = size;
+    }
+    else {
+        int f = tlsf_fls(size);
+        *sl = (size >> (f - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT;
+        *fl = f - TLSF_SL_LOG2 + 1;
+    }
+}
+
+// 分配 size 页时开始查找的 list: 其中任意块都不小于 size. 超出管理范围时返回 0
+static inline bool
+tlsf_mapping_search(size_t size, int *fl, int *sl) {
+    if (size >= TLSF_SL_COUNT) {
+        size += (1 << (tlsf_fls(size) - TLSF_SL_LOG2)) - 1;
+    }
+    tlsf_mapping_insert(size, fl, sl);
+    return *fl < TLSF_FL_COUNT;
+}
+
+static void
+tlsf_init(void) {
+    int fl, sl;
+    tlsf.fl_bitmap = 0;
+    for (fl = 0; fl < TLSF_FL_COUNT; fl ++) {
+        tlsf.sl_bitmap[fl] = 0;
+        for (sl = 0; sl < TLSF_SL_COUNT; sl ++) {
+            list_init(&(tlsf.blocks[fl][sl]));
+        }
+    }
+    tlsf.nr_free = 0;
+}
+
+// 把 [page, page + size) 标记为空闲块并插入对应的 list
+static void
+tlsf_insert_block(struct Page *page, size_t size) {
+    int fl, sl;
+    tlsf_mapping_insert(size, &fl, &sl);
+    assert(fl < TLSF_FL_COUNT);
+    page->property = size;
+    SetPageProperty(page);
+    if (size > 1) {
+        struct Page *tail = page + size - 1;
+        tail->property = size;
+        SetPageTail(tail);
+    }
+    list_add(&(tlsf.blocks[fl][sl]), &(page->page_link));
+    tlsf.sl_bitmap[fl] |= (1 << sl);
+    tlsf.fl_bitmap |= (1 << fl);
+}
+
+// 把空闲块 page 从 list 中摘下, 清除首末页的标记
+static void
+tlsf_remove_block(struct Page *page) {
+    size_t size = page->property;
+    int fl, sl;
+    tlsf_mapping_insert(size, &fl, &sl);
+    list_del(&(page->page_link));
+    if (list_empty(&(tlsf.blocks[fl][sl]))) {
+        tlsf.sl_bitmap[fl] &= ~(1 << sl);
+        if (tlsf.sl_bitmap[fl] == 0) {
+            tlsf.fl_bitmap &= ~(1 << fl);
+        }
+    }
+    if (size > 1) {
+        struct Page *tail = page + size - 1;
+        tail->property = 0;
+        ClearPageTail(tail);
+    }
+    page->property = 0;
+    ClearPageProperty(page);
+}
+
+// 归还 [base, base + n) 并与物理上相邻的空闲块合并
+static void
+tlsf_free_block(struct Page *base, size_t n) {
+    size_t size = n;
+    struct Page *next = base + n, *prev = base - 1;
+    if (next < pages + npage && PageProperty(next)) {
+        size += next->property;
+        tlsf_remove_block(next);
+    }
+    if (base > pages) {
+        struct Page *head = NULL;
+        if (PageTail(prev)) {
+            head = prev - prev->property + 1;
+        }
+        else if (PageProperty(prev)) {  // 单页的空闲块, 首页即末页
+            head = prev;
+        }
+        if (head != NULL) {
+            size += head->property;
+            tlsf_remove_block(head);
+            base = head;
+        }
+    }
+    tlsf_insert_block(base, size);
+    tlsf.nr_free += n;
+}
+
+static void
+tlsf_init_memmap(struct Page *base, size_t n) {
+    assert(n > 0);
+    struct Page *p = base;
+    for (; p != base + n; p ++) {
+        assert(PageReserved(p));
+        p->flags = p->property = 0;
+        set_page_ref(p, 0);
+    }
+    tlsf_free_block(base, n);
+    LOG_TAB("\ttlsf_init_memmap: 空闲空间管理\n");
+    LOG_TAB("\t\t已将一块连续地址空间加入 TLSF,起始: 0x%08lx, page 数:%d.\n", base, n);
+    LOG_TAB("\t\t当前空闲 page 数:%d\n", tlsf.nr_free);
+}
+
+// 从空闲块 page 的头部切下 n 页, 剩余部分重新插入
+static struct Page *
+tlsf_take_block(struct Page *page, size_t n) {
+    size_t size = page->property;
+    assert(size >= n);
+    tlsf_remove_block(page);
+    if (size > n) {
+        tlsf_insert_block(page + n, size - n);
+    }
+    tlsf.nr_free -= n;
+    return page;
+}
+
+static struct Page *
+tlsf_alloc_pages(size_t n) {
+    assert(n > 0);
+    int fl, sl;
+    if (n > tlsf.nr_free || !tlsf_mapping_search(n, &fl, &sl)) {
+        return NULL;
+    }
+    uint32_t sl_map = tlsf.sl_bitmap[fl] & (~0U << sl);
+    if (sl_map == 0) {
+        uint32_t fl_map = tlsf.fl_bitmap & (~0U << (fl + 1));
+        if (fl_map == 0) {
+            return NULL;
+        }
+        fl = tlsf_ffs(fl_map);
+        sl_map = tlsf.sl_bitmap[fl];
+    }
+    sl = tlsf_ffs(sl_map);
+
+    return tlsf_take_block(le2page(list_next(&(tlsf.blocks[fl][sl])), page_link), n);
+}
+
+// 批量分配单页: 优先整段分配剩余需求, 失败时取走当前最大的空闲块
+static size_t
+tlsf_alloc_pages_bulk(size_t n, struct Page **array) {
+    size_t got = 0;
+    while (got < n && tlsf.fl_bitmap != 0) {
+        size_t k = n - got;
+        struct Page *page = tlsf_alloc_pages(k);
+        if (page == NULL) {
+            int fl = tlsf_fls(tlsf.fl_bitmap);
+            int sl = tlsf_fls(tlsf.sl_bitmap[fl]);
+            page = le2page(list_next(&(tlsf.blocks[fl][sl])), page_link);
+            if (k > page->property) {
+                k = page->property;
+            }
+            page = tlsf_take_block(page, k);
+        }
+        while (k -- > 0) {
+            array[got ++] = page ++;
+        }
+    }
+    return got;
+}
+
+static void
+tlsf_free_pages(struct Page *base, size_t n) {
+    assert(n > 0);
+    struct Page *p = base;
+    for (; p != base + n; p ++) {
+        assert(!PageReserved(p) && !PageProperty(p));
+        p->flags = 0;
+        set_page_ref(p, 0);
+    }
+    tlsf_free_block(base, n);
+}
+
+static size_t
+tlsf_nr_free_pages(void) {
+    return tlsf.nr_free;
+}
+
+// 遍历所有 list, 校验位图, 首末页标记与 nr_free, 返回空闲块数
+static int
+tlsf_check_lists(void) {
+    int fl, sl, count = 0;
+    size_t total = 0;
+    for (fl = 0; fl < TLSF_FL_COUNT; fl ++) {
+        for (sl = 0; sl < TLSF_SL_COUNT; sl ++) {
+            list_entry_t *head = &(tlsf.blocks[fl][sl]), *le = head;
+            assert(!list_empty(head) == !!(tlsf.sl_bitmap[fl] & (1 << sl)));
+            while ((le = list_next(le)) != head) {
+                struct Page *p = le2page(le, page_link);
+                int f, s;
+                assert(PageProperty(p) && p->property > 0);
+                tlsf_mapping_insert(p->property, &f, &s);
+                assert(f == fl && s == sl);
+                if (p->property > 1) {
+                    assert(PageTail(p + p->property - 1) && p[p->property - 1].property == p->property);
+                }
+                count ++, total += p->property;
+            }
+        }
+        assert(!!tlsf.sl_bitmap[fl] == !!(tlsf.fl_bitmap & (1 << fl)));
+    }
+    assert(total == tlsf.nr_free);
+    return count;
+}
+
+/**
+ * 性能对比: 在同一块 TLSF_BENCH_PAGES 页的区域上, 用同一个伪随机序列分别驱动 first fit 和 TLSF,
+ * 每次分配/释放用 rdtsc 计时, 记录最坏情况.
+ * first fit 的开销随空闲块数量(碎片程度)增长, TLSF 则保持常数.
+ */
+#define TLSF_BENCH_PAGES        1022    // 加上前后两页恰为伙伴系统的最大块
+#define TLSF_BENCH_SLOTS        128
+#define TLSF_BENCH_ROUNDS       4096
+
+struct tlsf_bench_result {
+    uint64_t alloc_max;         // 单次分配的最大周期数
+    uint64_t free_max;          // 单次释放的最大周期数
+    int nr_alloc, nr_free, nr_fail;
+};
+
+static void
+tlsf_bench_run(struct Page *(*alloc_fn)(size_t), void (*free_fn)(struct Page *, size_t),
+               struct tlsf_bench_result *res) {
+    static struct Page *live[TLSF_BENCH_SLOTS];
+    static size_t live_n[TLSF_BENCH_SLOTS];
+    uint32_t seed = 1;
+    uint64_t t0, t1;
+    int i;
+    memset(res, 0, sizeof(struct tlsf_bench_result));
+    memset(live, 0, sizeof(live));
+    for (i = 0; i < TLSF_BENCH_ROUNDS; i ++) {
+        seed = seed * 1103515245 + 12345;
+        int slot = (seed >> 16) % TLSF_BENCH_SLOTS;
+        if (live[slot] != NULL) {
+            t0 = rdtsc();
+            free_fn(live[slot], live_n[slot]);
+            t1 = rdtsc();
+            live[slot] = NULL;
+            res->nr_free ++;
+            if (t1 - t0 > res->free_max) {
+                res->free_max = t1 - t0;
+            }
+        }
+        else {
+            size_t n = ((seed >> 8) % 8) + 1;
+            t0 = rdtsc();
+            struct Page *p = alloc_fn(n);
+            t1 = rdtsc();
+            if (p == NULL) {
+                res->nr_fail ++;
+                continue;
+            }
+            live[slot] = p, live_n[slot] = n;
+            res->nr_alloc ++;
+            if (t1 - t0 > res->alloc_max) {
+                res->alloc_max = t1 - t0;
+            }
+        }
+    }
+    for (i = 0; i < TLSF_BENCH_SLOTS; i ++) {
+        if (live[i] != NULL) {
+            free_fn(live[i], live_n[i]);
+        }
+    }
+}
+
+static void
+tlsf_bench(void) {
+    struct tlsf_bench_result ff, tl;
+    bool intr_flag;
+    int i;
+
+    // 前后各留一页保持已分配, 避免测试区域与暂存的空闲块合并
+    struct Page *base = alloc_pages(TLSF_BENCH_PAGES + 2), *arena = base + 1;
+    assert(base != NULL);
+
+    local_intr_save(intr_flag);
+    {
+        // first fit: 暂存 free_area(default_pmm_manager 可能正是当前的管理器), 把测试区域交给它单独管理
+        free_area_t free_area_store = free_area;
+        for (i = 0; i < TLSF_BENCH_PAGES; i ++) {
+            SetPageReserved(arena + i);
+        }
+        default_pmm_manager.init();
+        default_pmm_manager.init_memmap(arena, TLSF_BENCH_PAGES);
+        tlsf_bench_run(default_pmm_manager.alloc_pages, default_pmm_manager.free_pages, &ff);
+        assert(default_pmm_manager.nr_free_pages() == TLSF_BENCH_PAGES);
+        assert(default_pmm_manager.alloc_pages(TLSF_BENCH_PAGES) == arena);
+        free_area = free_area_store;
+
+        // TLSF: 暂存当前状态, 只管理测试区域
+        tlsf_store = tlsf;
+        tlsf_init();
+        tlsf_free_pages(arena, TLSF_BENCH_PAGES);
+        tlsf_bench_run(tlsf_alloc_pages, tlsf_free_pages, &tl);
+        assert(tlsf_check_lists() == 1 && tlsf.nr_free == TLSF_BENCH_PAGES);
+        assert(tlsf_alloc_pages(TLSF_BENCH_PAGES) == arena);
+        tlsf = tlsf_store;
+    }
+    local_intr_restore(intr_flag);
+    free_pages(base, TLSF_BENCH_PAGES + 2);
+
+    LOG_TAB("tlsf_bench: %d 轮随机分配/释放, 最坏情况周期数:\n", TLSF_BENCH_ROUNDS);
+    LOG_TAB("\tfirst fit: alloc %llu, free %llu (%d 次分配, %d 次失败)\n",
+            ff.alloc_max, ff.free_max, ff.nr_alloc, ff.nr_fail);
+    LOG_TAB("\ttlsf     : alloc %llu, free %llu (%d 次分配, %d 次失败)\n",
+            tl.alloc_max, tl.free_max, tl.nr_alloc, tl.nr_fail);
+}
+
+// tlsf_check - 在从当前 pmm_manager 借来的页上自检 TLSF 并与 first fit 对比, 与选用哪个管理器无关
+void
+tlsf_check(void) {
+    int fl, sl;
+    tlsf_mapping_insert(15, &fl, &sl);
+    assert(fl == 0 && sl == 15);
+    tlsf_mapping_insert(16, &fl, &sl);
+    assert(fl == 1 && sl == 0);
+    tlsf_mapping_insert(33, &fl, &sl);
+    assert(fl == 2 && sl == 0);
+    assert(tlsf_mapping_search(33, &fl, &sl) && fl == 2 && sl == 1);
+    tlsf_mapping_insert(34, &fl, &sl);
+    assert(fl == 2 && sl == 1);
+
+    // 前后各留一页保持已分配, 中间 8 页作为测试场地
+    struct Page *base = alloc_pages(10), *a = base + 1, *p0, *p1;
+    assert(base != NULL && !PageProperty(base));
+
+    bool intr_flag;
+    local_intr_save(intr_flag);
+    {
+        tlsf_store = tlsf;
+        tlsf_init();
+        assert(tlsf_alloc_pages(1) == NULL);
+
+        // 立即合并: 前后两个单页块夹着的页被释放后合为一块
+        tlsf_free_pages(a + 2, 1);
+        tlsf_free_pages(a + 4, 1);
+        assert(tlsf_check_lists() == 2);
+        tlsf_free_pages(a + 3, 1);
+        assert(tlsf_check_lists() == 1);
+        assert(PageProperty(a + 2) && a[2].property == 3);
+        assert(PageTail(a + 4) && !PageProperty(a + 4));
+        tlsf_free_pages(a, 2);
+        tlsf_free_pages(a + 5, 3);
+        assert(tlsf_check_lists() == 1 && tlsf.nr_free == 8);
+        assert(PageProperty(a) && a->property == 8 && PageTail(a + 7));
+        assert(tlsf_alloc_pages(9) == NULL);
+
+        // 拆分: 剩余部分重新插入
+        assert((p0 = tlsf_alloc_pages(3)) == a);
+        assert(!PageProperty(a) && PageTail(a + 7) && a[7].property == 5);
+        assert(PageProperty(a + 3) && a[3].property == 5);
+        assert((p1 = tlsf_alloc_pages(5)) == a + 3);
+        assert(!PageTail(a + 7) && a[7].property == 0);
+        assert(tlsf_alloc_pages(1) == NULL && tlsf.nr_free == 0);
+
+        tlsf_free_pages(p0, 3);
+        tlsf_free_pages(p1, 5);
+        assert(tlsf_check_lists() == 1);
+        assert(tlsf_alloc_pages(8) == a);
+
+        tlsf = tlsf_store;
+    }
+    local_intr_restore(intr_flag);
+    free_pages(base, 10);
+
+    tlsf_bench();
+    LOG_TAB("%-20s%s\n","tlsf_check()", ": succeed!");
+}
+
+// TLSF 作为 pmm_manager 时的自检: 空闲块与计数一致, 分配/释放前后不变
+static void
+tlsf_manager_check(void) {
+    int count = tlsf_check_lists();
+    assert(tlsf.nr_free == nr_free_pages());
+
+    struct Page *p0, *p1, *p2;
+    assert((p0 = alloc_page()) != NULL);
+    assert((p1 = alloc_page()) != NULL);
+    assert((p2 = alloc_page()) != NULL);
+    assert(p0 != p1 && p0 != p2 && p1 != p2);
+    assert(page_ref(p0) == 0 && page_ref(p1) == 0 && page_ref(p2) == 0);
+    free_page(p0);
+    free_page(p1);
+    free_page(p2);
+    assert(tlsf_check_lists() == count);
+}
+
+const struct pmm_manager tlsf_pmm_manager = {
+    .name = "tlsf_pmm_manager",
+    .init = tlsf_init,
+    .init_memmap = tlsf_init_memmap,
+    .alloc_pages = tlsf_alloc_pages,
+    .free_pages = tlsf_free_pages,
+    .nr_free_pages = tlsf_nr_free_pages,
+    .check = tlsf_manager_check,
+    .alloc_pages_bulk = tlsf_alloc_pages_bulk,
+};
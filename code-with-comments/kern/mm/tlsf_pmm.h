@@ -0,0 +1,16 @@
+#ifndef __KERN_MM_TLSF_PMM_H__
+#define  __KERN_MM_TLSF_PMM_H__
+
+#include <pmm.h>
+
+// 二级索引: 每个一级区间 [2^f, 2^(f+1)) 再等分为 2^TLSF_SL_LOG2 个二级区间
+#define TLSF_SL_LOG2            4
+#define TLSF_SL_COUNT           (1 << TLSF_SL_LOG2)
+// 一级索引数: 可管理的最大块为 2^(TLSF_FL_COUNT + TLSF_SL_LOG2 - 1) 页 = 2GB, 大于 KMEMSIZE
+#define TLSF_FL_COUNT           16
+
+extern const struct pmm_manager tlsf_pmm_manager;
+
+void tlsf_check(void);
+#endif /* ! __KERN_MM_TLSF_PMM_H__ */
+
@@ -9,6 +9,10 @@
 #include <swap.h>
 #include <kmalloc.h>
 #include <kdebug.h>
+#include <inode.h>
+#include <iobuf.h>
+#include <shmem.h>
+#include <ksm.h>
 
 /* 
   vmm design include two parts: mm_struct (mm) & vma_struct (vma)
@@ -26,29 +30,57 @@
      struct vma_struct * vma_create (uintptr_t vm_start, uintptr_t vm_end,...)
      void insert_vma_struct(struct mm_struct *mm, struct vma_struct *vma)
      struct vma_struct * find_vma(struct mm_struct *mm, uintptr_t addr)
+     int mm_unmap(struct mm_struct *mm, uintptr_t addr, size_t len)
+     int mm_brk(struct mm_struct *mm, uintptr_t addr, size_t len)
+     uintptr_t get_unmapped_area(struct mm_struct *mm, size_t len)
    local functions
      inline void check_vma_overlap(struct vma_struct *prev, struct vma_struct *next)
+     void remove_vma_struct(struct mm_struct *mm, struct vma_struct *vma)
 ---------------
    check correctness functions
      void check_vmm(void);
      void check_vma_struct(void);
+     void check_mm_unmap(void);
+     void check_mm_brk(void);
      void check_pgfault(void);
+     void check_huge_pgfault(void);
+     void check_zero_pgfault(void);
+     void check_fault_around(void);
+     void check_uaccess(void);
+     void check_ksm(void);
 */
 
 static void check_vmm(void);
 static void check_vma_struct(void);
+static void check_vma_tree(void);
+static void check_mm_unmap(void);
+static void check_mm_brk(void);
 static void check_pgfault(void);
+static void check_huge_pgfault(void);
+static void check_cow_pgfault(void);
+static void check_zero_pgfault(void);
+static void check_fault_around(void);
+static void check_uaccess(void);
+static void check_ksm(void);
+
+// mm_struct 和 vma_struct 的对象 cache, 在 vmm_init 中创建
+static struct kmem_cache *mm_cachep, *vma_cachep;
 
 // mm_create -  alloc a mm_struct & initialize it.
 struct mm_struct *
 mm_create(void) {
-    struct mm_struct *mm = kmalloc(sizeof(struct mm_struct));
+    struct mm_struct *mm = kmem_cache_alloc(mm_cachep);
 
     if (mm != NULL) {
         list_init(&(mm->mmap_list));
+        rb_tree_init(&(mm->mmap_tree));
         mm->mmap_cache = NULL;
         mm->pgdir = NULL;
         mm->map_count = 0;
+        mm->fault_next = 0;
+        mm->fault_window = 1;
+        mm->brk_start = mm->brk = 0;
+        mm->ksm = 0;
 
         if (swap_init_ok) swap_init_mm(mm);
         else mm->sm_priv = NULL;
@@ -63,37 +95,47 @@ mm_create(void) {
 // vma_create - 分配一个 vma_struct 并初始化. (addr range: vm_start~vm_end)
 struct vma_struct *
 vma_create(uintptr_t vm_start, uintptr_t vm_end, uint32_t vm_flags) {
-    struct vma_struct *vma = kmalloc(sizeof(struct vma_struct));
+    struct vma_struct *vma = kmem_cache_alloc(vma_cachep);
 
     if (vma != NULL) {
         vma->vm_start = vm_start;
         vma->vm_end = vm_end;
         vma->vm_flags = vm_flags;
+        vma->vm_file = NULL;
+        vma->vm_shmem = NULL;
     }
     //LOG("创建了一个 vma. vm_start: %lu, vm_end: %lu, vm_flags: %u\n",vm_start, vm_end, vm_flags);
     return vma;
 }
 
 
+// 红黑树中按 vm_start 排序; 各 vma 互不重叠, 查找时命中 [vm_start, vm_end) 即可
+static int
+vma_compare(rb_node *a, rb_node *b) {
+    uintptr_t start1 = rbn2vma(a, rb_link)->vm_start, start2 = rbn2vma(b, rb_link)->vm_start;
+    return (start1 < start2) ? -1 : ((start1 > start2) ? 1 : 0);
+}
+
+static int
+vma_search(rb_node *node, void *key) {
+    struct vma_struct *vma = rbn2vma(node, rb_link);
+    uintptr_t addr = *(uintptr_t *)key;
+    if (vma->vm_end <= addr) {
+        return -1;
+    }
+    return (vma->vm_start > addr) ? 1 : 0;
+}
+
 // find_vma - find a vma  (vma->vm_start <= addr <= vma_vm_end)
+// 先看 mmap_cache, 未命中时在红黑树中查找, O(log n)
 struct vma_struct *
 find_vma(struct mm_struct *mm, uintptr_t addr) {
     struct vma_struct *vma = NULL;
     if (mm != NULL) {
-        vma = mm->mmap_cache;   // 起点理论上随便(双向链表),这里可能考虑局部性所以选择了 mmap_cache
+        vma = mm->mmap_cache;   // 考虑局部性, 先看上次找到的 vma
         if (!(vma != NULL && vma->vm_start <= addr && vma->vm_end > addr)) {
-                bool found = 0;
-                list_entry_t *list = &(mm->mmap_list), *le = list;
-                while ((le = list_next(le)) != list) {
-                    vma = le2vma(le, list_link);
-                    if (vma->vm_start<=addr && addr < vma->vm_end) {
-                        found = 1;
-                        break;
-                    }
-                }
-                if (!found) {
-                    vma = NULL;
-                }
+            rb_node *node = rb_search(&(mm->mmap_tree), vma_search, &addr);
+            vma = (node != NULL) ? rbn2vma(node, rb_link) : NULL;
         }
         if (vma != NULL) {
             mm->mmap_cache = vma;
@@ -113,20 +155,18 @@ check_vma_overlap(struct vma_struct *prev, struct vma_struct *next) {
 
 
 // insert_vma_struct -insert vma in mm's list link
+// 先插入红黑树, 再由树中的前驱确定在有序链表中的位置
 void
 insert_vma_struct(struct mm_struct *mm, struct vma_struct *vma) {
     assert(vma->vm_start < vma->vm_end);
     list_entry_t *list = &(mm->mmap_list);
     list_entry_t *le_prev = list, *le_next;
 
-        list_entry_t *le = list;
-        while ((le = list_next(le)) != list) {
-            struct vma_struct *mmap_prev = le2vma(le, list_link);
-            if (mmap_prev->vm_start > vma->vm_start) {
-                break;
-            }
-            le_prev = le;
-        }
+    rb_insert(&(mm->mmap_tree), &(vma->rb_link), vma_compare);
+    rb_node *prev = rb_prev(&(vma->rb_link));
+    if (prev != NULL) {
+        le_prev = &(rbn2vma(prev, rb_link)->list_link);
+    }
 
     le_next = list_next(le_prev);
 
@@ -144,19 +184,83 @@ insert_vma_struct(struct mm_struct *mm, struct vma_struct *vma) {
     mm->map_count ++;
 }
 
+// remove_vma_struct - 把 vma 从 mm 的红黑树和链表中摘下, 不释放
+static void
+remove_vma_struct(struct mm_struct *mm, struct vma_struct *vma) {
+    rb_delete(&(mm->mmap_tree), &(vma->rb_link));
+    list_del(&(vma->list_link));
+    if (mm->mmap_cache == vma) {
+        mm->mmap_cache = NULL;
+    }
+    mm->map_count --;
+}
+
+// vma_copy_backing - nvma 与 vma 映射同一文件或共享内存对象, 增加其引用
+static void
+vma_copy_backing(struct vma_struct *nvma, struct vma_struct *vma) {
+    if (vma->vm_file != NULL) {
+        vop_ref_inc(vma->vm_file);
+        nvma->vm_file = vma->vm_file;
+        nvma->vm_offset = vma->vm_offset;
+        nvma->vm_file_start = vma->vm_file_start;
+        nvma->vm_file_end = vma->vm_file_end;
+    }
+    if (vma->vm_shmem != NULL) {
+        shmem_ref_inc(vma->vm_shmem);
+        nvma->vm_shmem = vma->vm_shmem;
+        nvma->vm_shmem_base = vma->vm_shmem_base;
+        list_add(&(vma->vm_shmem->vma_list), &(nvma->shmem_link));
+    }
+}
+
+// vma_destroy - 释放 vma, 文件映射还要释放对文件的引用, 共享内存映射释放对对象的引用
+static void
+vma_destroy(struct vma_struct *vma) {
+    if (vma->vm_file != NULL) {
+        vop_ref_dec(vma->vm_file);
+    }
+    if (vma->vm_shmem != NULL) {
+        list_del(&(vma->shmem_link));
+        if (shmem_ref_dec(vma->vm_shmem) == 0) {
+            shmem_destroy(vma->vm_shmem);
+        }
+    }
+    kmem_cache_free(vma_cachep, vma);
+}
+
 // mm_destroy - free mm and mm internal fields
 void
 mm_destroy(struct mm_struct *mm) {
     assert(mm_count(mm) == 0);
+    ksm_exit_mm(mm);
 
     list_entry_t *list = &(mm->mmap_list), *le;
     while ((le = list_next(list)) != list) {
         list_del(le);
-        kfree(le2vma(le, list_link));  //kfree vma        
+        vma_destroy(le2vma(le, list_link));
     }
-    kfree(mm); //kfree mm
+    kmem_cache_free(mm_cachep, mm); //kfree mm
     mm=NULL;
 }
+// find_vma_above - 第一个 vm_end > addr 的 vma, 没有则返回 NULL
+static struct vma_struct *
+find_vma_above(struct mm_struct *mm, uintptr_t addr) {
+    struct vma_struct *found = NULL;
+    rb_node *node = mm->mmap_tree.root;
+    // vma 互不重叠, 按 vm_start 有序也就按 vm_end 有序
+    while (node != NULL) {
+        struct vma_struct *vma = rbn2vma(node, rb_link);
+        if (vma->vm_end > addr) {
+            found = vma;
+            node = node->left;
+        }
+        else {
+            node = node->right;
+        }
+    }
+    return found;
+}
+
 /**
  * 
  * 创建新的 vma 链接到给定的 mm 上.新的 vma 的参数由函数参数指定.
@@ -171,13 +275,18 @@ mm_map(struct mm_struct *mm, uintptr_t addr, size_t len, uint32_t vm_flags,
     if (!USER_ACCESS(start, end)) {
         return -E_INVAL;
     }
+    // 大页区域的起止必须按 PTSIZE 对齐, 使每个一级页表项都完整地落在区域内
+    if ((vm_flags & VM_HUGE) && (start % PTSIZE != 0 || end % PTSIZE != 0)) {
+        return -E_INVAL;
+    }
 
     assert(mm != NULL);
 
     int ret = -E_INVAL;
 
-    struct vma_struct *vma;
-    if ((vma = find_vma(mm, start)) != NULL && end > vma->vm_start) {
+    // [start, end) 不能与已有的 vma 重叠: 从空隙开始、跨过后面的 vma 也算重叠
+    struct vma_struct *vma = find_vma_above(mm, start);
+    if (vma != NULL && vma->vm_start < end) {
         goto out;
     }
     ret = -E_NO_MEM;
@@ -195,10 +304,186 @@ out:
     return ret;
 }
 
+/**
+ * mm_map_file - 建立文件映射的 vma: [addr, addr + filesz) 的内容按需从 node 的 offset 处读入,
+ * 其余到 addr + len 的部分(如 BSS)缺页时清零. vma 持有 node 的一个引用.
+ */
+int
+mm_map_file(struct mm_struct *mm, uintptr_t addr, size_t len, uint32_t vm_flags,
+            struct inode *node, off_t offset, size_t filesz) {
+    assert(filesz <= len);
+    struct vma_struct *vma;
+    int ret;
+    if ((ret = mm_map(mm, addr, len, vm_flags, &vma)) != 0) {
+        return ret;
+    }
+    vop_ref_inc(node);
+    vma->vm_file = node;
+    vma->vm_offset = offset;
+    vma->vm_file_start = addr;
+    vma->vm_file_end = addr + filesz;
+    return 0;
+}
+
+/**
+ * mm_map_shmem - 把共享内存对象 shmem 从第 0 页开始映射到 [addr, addr + len), vma 持有对象的一个引用.
+ */
+int
+mm_map_shmem(struct mm_struct *mm, uintptr_t addr, size_t len, uint32_t vm_flags,
+             struct shmem_struct *shmem) {
+    assert(addr % PGSIZE == 0 && len <= shmem->npages * PGSIZE);
+    struct vma_struct *vma;
+    int ret;
+    if ((ret = mm_map(mm, addr, len, vm_flags | VM_SHARE, &vma)) != 0) {
+        return ret;
+    }
+    shmem_ref_inc(shmem);
+    vma->vm_shmem = shmem;
+    vma->vm_shmem_base = addr;
+    list_add(&(shmem->vma_list), &(vma->shmem_link));
+    return 0;
+}
+
+/**
+ * mm_brk - 把堆扩展到 [addr, addr + len)(按页对齐), 这段地址必须还没有映射.
+ * 紧挨着的前一个 vma 是可读写的匿名区域(即之前扩展出的堆)时直接延长它, 使堆始终只占一个 vma.
+ */
+int
+mm_brk(struct mm_struct *mm, uintptr_t addr, size_t len) {
+    uintptr_t start = ROUNDDOWN(addr, PGSIZE), end = ROUNDUP(addr + len, PGSIZE);
+    if (!USER_ACCESS(start, end)) {
+        return -E_INVAL;
+    }
+
+    assert(mm != NULL);
+
+    struct vma_struct *vma = find_vma_above(mm, start);
+    if (vma != NULL && vma->vm_start < end) {
+        return -E_INVAL;
+    }
+    uint32_t vm_flags = VM_READ | VM_WRITE;
+    if ((vma = find_vma(mm, start - 1)) != NULL && vma->vm_end == start && vma->vm_flags == vm_flags &&
+        vma->vm_file == NULL && vma->vm_shmem == NULL) {
+        vma->vm_end = end;
+        return 0;
+    }
+    return mm_map(mm, start, end - start, vm_flags, NULL);
+}
+
+/**
+ * free_pgtables - 释放 [start, end) 经过的、不再与任何 vma 重叠的 PTSIZE 区域的二级页表.
+ * 这样的区域中的映射都已被 unmap_range 解除, 二级页表全为 0, 由 exit_range 放入页表页缓存.
+ * exit_mmap 只对剩下的 vma 调用 exit_range, 不在这里释放的二级页表就再也不会被释放.
+ */
+static void
+free_pgtables(struct mm_struct *mm, uintptr_t start, uintptr_t end) {
+    uintptr_t la;
+    for (la = ROUNDDOWN(start, PTSIZE); la < end; la += PTSIZE) {
+        uintptr_t slot_start = (la < USERBASE) ? USERBASE : la;
+        struct vma_struct *vma = find_vma_above(mm, slot_start);
+        if ((vma == NULL || vma->vm_start >= la + PTSIZE) && (mm->pgdir[PDX(la)] & PTE_P)) {
+            exit_range(mm->pgdir, slot_start, la + PTSIZE);
+            tlb_invalidate(mm->pgdir, slot_start);
+        }
+    }
+}
+
+/**
+ * mm_unmap - 解除 [addr, addr + len) 的映射(按页对齐).
+ * 完全落在范围内的 vma 被删除, 跨过边界的 vma 被截短, 包含整个范围的 vma 被拆成两个.
+ * 文件映射的 vm_file_start/vm_file_end 和共享内存的 vm_shmem_base 都是按地址记录的, 截短时不用调整.
+ * 最后释放不再有 vma 的区域的二级页表.
+ * 拆开两端的大页时内存不足返回 -E_NO_MEM, 映射和 vma 都保持不变.
+ */
+int
+mm_unmap(struct mm_struct *mm, uintptr_t addr, size_t len) {
+    uintptr_t start = ROUNDDOWN(addr, PGSIZE), end = ROUNDUP(addr + len, PGSIZE);
+    if (!USER_ACCESS(start, end)) {
+        return -E_INVAL;
+    }
+
+    assert(mm != NULL);
+
+    // 范围落在一个 vma 的中间时要把它拆成两个: 先分配好新的 vma, 使失败时什么都没有改变
+    struct vma_struct *vma = find_vma_above(mm, start), *next, *nvma = NULL;
+    if (vma != NULL && vma->vm_start < start && vma->vm_end > end) {
+        if ((nvma = vma_create(end, vma->vm_end, vma->vm_flags)) == NULL) {
+            return -E_NO_MEM;
+        }
+    }
+    // 页表项先一次解除: 唯一可能的失败(拆开大页)发生在修改 vma 之前
+    int ret;
+    if ((ret = unmap_range(mm->pgdir, start, end)) != 0) {
+        if (nvma != NULL) {
+            vma_destroy(nvma);
+        }
+        return ret;
+    }
+    for (; vma != NULL && vma->vm_start < end; vma = next) {
+        list_entry_t *le = list_next(&(vma->list_link));
+        next = (le != &(mm->mmap_list)) ? le2vma(le, list_link) : NULL;
+
+        uintptr_t un_start = (vma->vm_start > start) ? vma->vm_start : start;
+        uintptr_t un_end = (vma->vm_end < end) ? vma->vm_end : end;
+        if (un_start == vma->vm_start && un_end == vma->vm_end) {
+            remove_vma_struct(mm, vma);
+            vma_destroy(vma);
+            continue ;
+        }
+        // 只解除一部分: 剩下的部分不再按 PTSIZE 对齐, 不能再整块映射大页
+        vma->vm_flags &= ~VM_HUGE;
+        if (un_start != vma->vm_start && un_end != vma->vm_end) {
+            assert(nvma != NULL && nvma->vm_start == un_end && nvma->vm_end == vma->vm_end);
+            nvma->vm_flags = vma->vm_flags;
+            vma_copy_backing(nvma, vma);
+            vma->vm_end = un_start;
+            insert_vma_struct(mm, nvma);
+        }
+        else if (un_start != vma->vm_start) {
+            vma->vm_end = un_start;
+        }
+        else {
+            // vm_start 变大后仍在前后两个 vma 之间, 红黑树中的位置不变
+            vma->vm_start = un_end;
+        }
+    }
+    free_pgtables(mm, start, end);
+    return 0;
+}
+
+/**
+ * get_unmapped_area - 从 USERTOP 向下找第一段长为 len 的空闲地址, 找不到返回 0.
+ * 自顶向下沿 mmap_list 扫描 vma 之间的空隙, O(map_count).
+ */
+uintptr_t
+get_unmapped_area(struct mm_struct *mm, size_t len) {
+    len = ROUNDUP(len, PGSIZE);
+    if (len == 0 || len > USERTOP - USERBASE) {
+        return 0;
+    }
+    uintptr_t end = USERTOP;
+    list_entry_t *list = &(mm->mmap_list), *le = list;
+    while ((le = list_prev(le)) != list) {
+        struct vma_struct *vma = le2vma(le, list_link);
+        if (vma->vm_end <= end && end - vma->vm_end >= len) {
+            break ;
+        }
+        if (vma->vm_start < end) {
+            end = vma->vm_start;
+        }
+    }
+    if (end < USERBASE + len) {
+        return 0;
+    }
+    return end - len;
+}
+
 int
 dup_mmap(struct mm_struct *to, struct mm_struct *from) {
     LOG_TAB("\tdup_mmap:\n");
     assert(to != NULL && from != NULL);
+    to->brk_start = from->brk_start;
+    to->brk = from->brk;
     list_entry_t *list = &(from->mmap_list), *le = list;
     while ((le = list_prev(le)) != list) {
         struct vma_struct *vma, *nvma;
@@ -207,10 +492,12 @@ dup_mmap(struct mm_struct *to, struct mm_struct *from) {
         if (nvma == NULL) {
             return -E_NO_MEM;
         }
+        vma_copy_backing(nvma, vma);
 
         insert_vma_struct(to, nvma);
 
-        bool share = 0;
+        // 共享内存区域父子进程映射同一组页, 其余区域写时复制
+        bool share = ((vma->vm_flags & VM_SHARE) != 0);
         if (copy_range(to->pgdir, from->pgdir, vma->vm_start, vma->vm_end, share) != 0) {
             return -E_NO_MEM;
         }
@@ -225,7 +512,9 @@ exit_mmap(struct mm_struct *mm) {
     list_entry_t *list = &(mm->mmap_list), *le = list;
     while ((le = list_next(le)) != list) {
         struct vma_struct *vma = le2vma(le, list_link);
-        unmap_range(pgdir, vma->vm_start, vma->vm_end);
+        // vma 的两端不会落在大页中间(mm_unmap 截短 vma 时已拆开), 不需要拆分, 不会失败
+        int ret = unmap_range(pgdir, vma->vm_start, vma->vm_end);
+        assert(ret == 0);
     }
     while ((le = list_next(le)) != list) {
         struct vma_struct *vma = le2vma(le, list_link);
@@ -233,13 +522,34 @@ exit_mmap(struct mm_struct *mm) {
     }
 }
 
+/**
+ * 用户区与内核区之间的复制.
+ *
+ * 用户进程(mm 不为 NULL)只检查地址范围在用户区内, 不查找 vma, 直接由 kern/mm/uaccess.S 中的函数复制:
+ * 缺页照常由 do_pgfault 处理, 地址不合法时经异常表返回错误. 因此复制期间也不必持有 lock_mm.
+ * 内核线程(mm 为 NULL)传入的是内核地址, 检查范围后直接 memcpy.
+ */
+size_t __copy_user(void *dst, const void *src, size_t len);
+bool __copy_string_user(char *dst, const char *src, size_t maxn);
+
+/**
+ * 把数据从用户区复制到内核区. writable 为真时要求用户区可写(之后还要写回同一位置), 此时仍逐个检查 vma.
+ */
 bool
 copy_from_user(struct mm_struct *mm, void *dst, const void *src, size_t len, bool writable) {
-    if (!user_mem_check(mm, (uintptr_t)src, len, writable)) {
+    if (mm == NULL || writable) {
+        if (!user_mem_check(mm, (uintptr_t)src, len, writable)) {
+            return 0;
+        }
+    }
+    else if (!USER_ACCESS((uintptr_t)src, (uintptr_t)src + len)) {
         return 0;
     }
-    memcpy(dst, src, len);
-    return 1;
+    if (mm == NULL) {
+        memcpy(dst, src, len);
+        return 1;
+    }
+    return __copy_user(dst, src, len) == 0;
 }
 
 /**
@@ -249,17 +559,28 @@ copy_from_user(struct mm_struct *mm, void *dst, const void *src, size_t len, boo
  */ 
 bool
 copy_to_user(struct mm_struct *mm, void *dst, const void *src, size_t len) {
-    if (!user_mem_check(mm, (uintptr_t)dst, len, 1)) {
+    if (mm == NULL) {
+        if (!user_mem_check(mm, (uintptr_t)dst, len, 1)) {
+            return 0;
+        }
+        memcpy(dst, src, len);
+        return 1;
+    }
+    if (!USER_ACCESS((uintptr_t)dst, (uintptr_t)dst + len)) {
         return 0;
     }
-    memcpy(dst, src, len);
-    return 1;
+    return __copy_user(dst, src, len) == 0;
 }
 
 // vmm_init - 初始化虚拟内存管理模块
 //          - now just call check_vmm to check correctness of vmm
 void
 vmm_init(void) {
+    mm_cachep = kmem_cache_create("mm_struct", sizeof(struct mm_struct), 0, NULL);
+    vma_cachep = kmem_cache_create("vma_struct", sizeof(struct vma_struct), 0, NULL);
+    assert(mm_cachep != NULL && vma_cachep != NULL);
+    ksm_init();
+
     LOG_LINE("测试开始:虚拟内存管理模块(vmm)");
     check_vmm();
     LOG_LINE("测试结束:虚拟内存管理模块(vmm)");
@@ -270,7 +591,16 @@ vmm_init(void) {
 static void
 check_vmm(void) {
     check_vma_struct();
+    check_vma_tree();
     check_pgfault();
+    check_huge_pgfault();
+    check_cow_pgfault();
+    check_zero_pgfault();
+    check_mm_unmap();
+    check_mm_brk();
+    check_fault_around();
+    check_uaccess();
+    check_ksm();
 
     LOG("check_vmm() succeeded.\n");
 }
@@ -343,6 +673,78 @@ check_vma_struct(void) {
     LOG("check_vma_struct() succeeded!\n");
 }
 
+/**
+ * 性能对比: 插入 VMA_BENCH_COUNT 个 vma(乱序), 对同一组随机地址分别用红黑树(find_vma, 清空 mmap_cache)
+ * 和有序链表线性查找, 用 rdtsc 统计总周期数. 线性查找的开销随 vma 数量线性增长, 红黑树为 O(log n).
+ */
+#define VMA_BENCH_COUNT         4096
+#define VMA_BENCH_LOOKUPS       4096
+
+static struct vma_struct *
+find_vma_linear(struct mm_struct *mm, uintptr_t addr) {
+    list_entry_t *list = &(mm->mmap_list), *le = list;
+    while ((le = list_next(le)) != list) {
+        struct vma_struct *vma = le2vma(le, list_link);
+        if (vma->vm_start <= addr && addr < vma->vm_end) {
+            return vma;
+        }
+    }
+    return NULL;
+}
+
+static void
+check_vma_tree(void) {
+    size_t nr_free_pages_store = nr_free_pages();
+    struct mm_struct *mm = mm_create();
+    assert(mm != NULL);
+
+    // 第 i 个 vma 为 [i * 3, i * 3 + 2) 页; 以 1237 为步长(与 VMA_BENCH_COUNT 互素)乱序插入
+    int i, j;
+    for (i = 0, j = 0; i < VMA_BENCH_COUNT; i ++, j = (j + 1237) % VMA_BENCH_COUNT) {
+        struct vma_struct *vma = vma_create(j * 3 * PGSIZE, (j * 3 + 2) * PGSIZE, VM_READ);
+        assert(vma != NULL);
+        insert_vma_struct(mm, vma);
+    }
+    assert(mm->map_count == VMA_BENCH_COUNT);
+    int black_height = rb_check(&(mm->mmap_tree));
+
+    list_entry_t *le = &(mm->mmap_list);
+    for (i = 0; i < VMA_BENCH_COUNT; i ++) {
+        le = list_next(le);
+        assert(le2vma(le, list_link)->vm_start == i * 3 * PGSIZE);
+    }
+    assert(list_next(le) == &(mm->mmap_list));
+
+    uint64_t tree_cycles = 0, list_cycles = 0, t0;
+    uint32_t seed = 1;
+    for (i = 0; i < VMA_BENCH_LOOKUPS; i ++) {
+        seed = seed * 1103515245 + 12345;
+        uintptr_t addr = (seed >> 8) % (VMA_BENCH_COUNT * 3 * PGSIZE);
+        struct vma_struct *vma1, *vma2;
+
+        mm->mmap_cache = NULL;
+        t0 = rdtsc();
+        vma1 = find_vma(mm, addr);
+        tree_cycles += rdtsc() - t0;
+
+        t0 = rdtsc();
+        vma2 = find_vma_linear(mm, addr);
+        list_cycles += rdtsc() - t0;
+
+        assert(vma1 == vma2);
+        assert((vma1 != NULL) == ((addr / PGSIZE) % 3 != 2));
+    }
+
+    mm_destroy(mm);
+    assert(nr_free_pages_store == nr_free_pages());
+
+    LOG_TAB("check_vma_tree: %d 个 vma, 红黑树黑高 %d, %d 次随机查找的总周期数:\n",
+            VMA_BENCH_COUNT, black_height, VMA_BENCH_LOOKUPS);
+    LOG_TAB("\trb tree: %llu\n", tree_cycles);
+    LOG_TAB("\tlist   : %llu\n", list_cycles);
+    LOG_TAB("%-20s%s\n","check_vma_tree()", ": succeed!");
+}
+
 struct mm_struct *check_mm_struct;  // 当前ucore 认为的合法虚拟内存空间集合
 
 // check_pgfault - pgfault handler 测试函数
@@ -398,9 +800,628 @@ check_pgfault(void) {
 
     LOG_LINE("测试通过: page fault");
 }
+/**
+ * 以下测试在 boot_pgdir 中建立 vma 并直接访问. mm_map/unmap_range 只接受用户地址,
+ * 用 USERBASE 之上第一个按 PTSIZE 对齐、一级页表项为空的区域.
+ */
+#define CHECK_BASE              PTSIZE
+
+// check_huge_pgfault - VM_HUGE 区域的缺页处理测试: 大页映射, 部分解除时的拆分, 以及没有大页时的退化
+static void
+check_huge_pgfault(void) {
+    size_t nr_free_pages_store = nr_free_pages();
+    struct mm_struct *mm = mm_create();
+    assert(mm != NULL);
+    pde_t *pgdir = mm->pgdir = boot_pgdir;
+    assert(pgdir[PDX(CHECK_BASE)] == 0);
+
+    assert(mm_map(mm, CHECK_BASE + PGSIZE, PTSIZE, VM_READ | VM_WRITE | VM_HUGE, NULL) == -E_INVAL);
+    assert(mm_map(mm, CHECK_BASE, PTSIZE, VM_READ | VM_WRITE | VM_HUGE, NULL) == 0);
+
+    uintptr_t addr = CHECK_BASE + PTSIZE / 2 + 0x100;
+    assert(do_pgfault(mm, 2, addr) == 0);
+    struct Page *page = get_page(pgdir, ROUNDDOWN(addr, PGSIZE), NULL);
+    assert(page != NULL);
+    *(int *)addr = 0x5a5a5a5a;
+    if (pgdir[PDX(CHECK_BASE)] & PTE_PS) {
+        LOG_TAB("VM_HUGE: 已用 4MB 大页映射.\n");
+        assert(get_page(pgdir, CHECK_BASE, NULL) + NPTEENTRY / 2 == page);
+        assert(*(int *)(addr - PTSIZE / 2) == 0);
+        // 没有内存拆开大页时解除失败, 映射和 vma 都不变
+        list_entry_t hold, *le;
+        list_init(&hold);
+        struct Page *p;
+        while ((p = alloc_page()) != NULL) {
+            list_add(&hold, &(p->page_link));
+        }
+        assert(mm_unmap(mm, CHECK_BASE, PGSIZE) == -E_NO_MEM);
+        assert(pgdir[PDX(CHECK_BASE)] & PTE_PS);
+        struct vma_struct *vma = find_vma(mm, CHECK_BASE);
+        assert(vma != NULL && vma->vm_start == CHECK_BASE && (vma->vm_flags & VM_HUGE));
+        while ((le = list_next(&hold)) != &hold) {
+            list_del(le);
+            free_page(le2page(le, page_link));
+        }
+        // 只解除第一页: 大页被拆成 4KB 页, 其余内容不变
+        assert(unmap_range(pgdir, CHECK_BASE, CHECK_BASE + PGSIZE) == 0);
+        assert(!(pgdir[PDX(CHECK_BASE)] & PTE_PS) && (pgdir[PDX(CHECK_BASE)] & PTE_P));
+        assert(get_page(pgdir, CHECK_BASE, NULL) == NULL);
+        assert(get_page(pgdir, ROUNDDOWN(addr, PGSIZE), NULL) == page && page_ref(page) == 1);
+    }
+    else {
+        LOG_TAB("VM_HUGE: 没有可用的大页, 已退化为 4KB 页.\n");
+    }
+    assert(*(int *)addr == 0x5a5a5a5a);
+
+    unmap_range(pgdir, CHECK_BASE, CHECK_BASE + PTSIZE);
+    exit_range(pgdir, CHECK_BASE, CHECK_BASE + PTSIZE);
+    assert(pgdir[PDX(CHECK_BASE)] == 0);
+
+    mm->pgdir = NULL;
+    mm_destroy(mm);
+
+    assert(nr_free_pages_store == nr_free_pages());
+    LOG_TAB("%-20s%s\n","check_huge_pgfault()", ": succeed!");
+}
+
+// check_cow_pgfault - 写时复制: copy_range 共享只读页, 写缺页时按 page_ref 决定复制还是恢复写权限
+static void
+check_cow_pgfault(void) {
+    size_t nr_free_pages_store = nr_free_pages();
+    struct mm_struct *mm = mm_create(), *nmm = mm_create();
+    assert(mm != NULL && nmm != NULL);
+    pde_t *pgdir = mm->pgdir = boot_pgdir;
+    assert(pgdir[PDX(CHECK_BASE)] == 0);
+    assert((nmm->pgdir = alloc_pgdir()) != NULL);
+    assert(mm_map(mm, CHECK_BASE, PTSIZE, VM_READ | VM_WRITE, NULL) == 0);
+    assert(mm_map(nmm, CHECK_BASE, PTSIZE, VM_READ | VM_WRITE, NULL) == 0);
+
+    uintptr_t addr = CHECK_BASE + 0x100;
+    assert(do_pgfault(mm, 2, addr) == 0);
+    *(int *)addr = 0x5a5a5a5a;
+    pte_t *ptep, *nptep;
+    struct Page *page = get_page(pgdir, CHECK_BASE, &ptep), *npage;
+    assert(page != NULL && (*ptep & PTE_W));
+
+    // fork: 共享同一页, 双方都只读
+    assert(copy_range(nmm->pgdir, pgdir, CHECK_BASE, CHECK_BASE + PTSIZE, 0) == 0);
+    assert(get_page(nmm->pgdir, CHECK_BASE, &nptep) == page && page_ref(page) == 2);
+    assert(!(*ptep & PTE_W) && !(*nptep & PTE_W));
+    assert(*(int *)addr == 0x5a5a5a5a);
+
+    // 一方写: 复制一份, 另一方仍看到原来的内容
+    assert(do_pgfault(mm, 3, addr) == 0);
+    npage = get_page(pgdir, CHECK_BASE, &ptep);
+    assert(npage != page && (*ptep & PTE_W));
+    assert(page_ref(page) == 1 && page_ref(npage) == 1);
+    assert(*(int *)addr == 0x5a5a5a5a);
+    *(int *)addr = 0xa5a5a5a5;
+    assert(*(int *)(page2kva(page) + 0x100) == 0x5a5a5a5a);
+
+    // 另一方写: 已是唯一的引用, 直接恢复写权限, 不再复制
+    assert(do_pgfault(nmm, 3, addr) == 0);
+    assert(get_page(nmm->pgdir, CHECK_BASE, &nptep) == page && (*nptep & PTE_W));
+
+    unmap_range(nmm->pgdir, CHECK_BASE, CHECK_BASE + PTSIZE);
+    exit_range(nmm->pgdir, CHECK_BASE, CHECK_BASE + PTSIZE);
+    free_pgdir(nmm->pgdir);
+    nmm->pgdir = NULL;
+    mm_destroy(nmm);
+
+    unmap_range(pgdir, CHECK_BASE, CHECK_BASE + PTSIZE);
+    exit_range(pgdir, CHECK_BASE, CHECK_BASE + PTSIZE);
+    assert(pgdir[PDX(CHECK_BASE)] == 0);
+    mm->pgdir = NULL;
+    mm_destroy(mm);
+
+    assert(nr_free_pages_store == nr_free_pages());
+    LOG_TAB("%-20s%s\n","check_cow_pgfault()", ": succeed!");
+}
+
+// check_zero_pgfault - 匿名内存的读缺页映射共享零页, 写缺页时换成私有页, fork 后双方共享零页
+static void
+check_zero_pgfault(void) {
+    size_t nr_free_pages_store = nr_free_pages();
+    int zero_ref = page_ref(zero_page);
+    struct mm_struct *mm = mm_create(), *nmm = mm_create();
+    assert(mm != NULL && nmm != NULL);
+    pde_t *pgdir = mm->pgdir = boot_pgdir;
+    assert(pgdir[PDX(CHECK_BASE)] == 0);
+    assert((nmm->pgdir = alloc_pgdir()) != NULL);
+    assert(mm_map(mm, CHECK_BASE, 4 * PGSIZE, VM_READ | VM_WRITE, NULL) == 0);
+    assert(mm_map(nmm, CHECK_BASE, 4 * PGSIZE, VM_READ | VM_WRITE, NULL) == 0);
+
+    // 读: 只读地映射零页, 不占内存
+    uintptr_t addr = CHECK_BASE + 0x100;
+    assert(get_pte(pgdir, CHECK_BASE, 1) != NULL);
+    size_t nr_free_pages_pt = nr_free_pages();
+    assert(do_pgfault(mm, 0, addr) == 0);
+    pte_t *ptep, *nptep;
+    assert(get_page(pgdir, CHECK_BASE, &ptep) == zero_page && !(*ptep & PTE_W));
+    assert(nr_free_pages() == nr_free_pages_pt && page_ref(zero_page) == zero_ref + 1);
+    assert(*(int *)addr == 0);
+
+    // fork: 双方共享零页
+    assert(copy_range(nmm->pgdir, pgdir, CHECK_BASE, CHECK_BASE + 4 * PGSIZE, 0) == 0);
+    assert(get_page(nmm->pgdir, CHECK_BASE, &nptep) == zero_page && page_ref(zero_page) == zero_ref + 2);
+
+    // 写: 换成私有的清零页, 另一方仍映射零页
+    assert(do_pgfault(mm, 3, addr) == 0);
+    struct Page *page = get_page(pgdir, CHECK_BASE, &ptep);
+    assert(page != zero_page && (*ptep & PTE_W) && page_ref(page) == 1);
+    assert(page_ref(zero_page) == zero_ref + 1 && *(int *)addr == 0);
+    *(int *)addr = 0x5a5a5a5a;
+    assert(*(int *)(page2kva(zero_page) + 0x100) == 0);
+
+    unmap_range(nmm->pgdir, CHECK_BASE, CHECK_BASE + PTSIZE);
+    exit_range(nmm->pgdir, CHECK_BASE, CHECK_BASE + PTSIZE);
+    free_pgdir(nmm->pgdir);
+    nmm->pgdir = NULL;
+    mm_destroy(nmm);
+
+    unmap_range(pgdir, CHECK_BASE, CHECK_BASE + PTSIZE);
+    exit_range(pgdir, CHECK_BASE, CHECK_BASE + PTSIZE);
+    assert(pgdir[PDX(CHECK_BASE)] == 0);
+    mm->pgdir = NULL;
+    mm_destroy(mm);
+
+    assert(page_ref(zero_page) == zero_ref);
+    assert(nr_free_pages_store == nr_free_pages());
+    LOG_TAB("%-20s%s\n","check_zero_pgfault()", ": succeed!");
+}
+
+// check_mm_unmap - mm_unmap 的删除/截短/拆分, get_unmapped_area 的自顶向下查找, 以及共享内存对象的映射
+static void
+check_mm_unmap(void) {
+    size_t nr_free_pages_store = nr_free_pages();
+    struct mm_struct *mm = mm_create();
+    assert(mm != NULL);
+    pde_t *pgdir = mm->pgdir = boot_pgdir;
+    assert(pgdir[PDX(CHECK_BASE)] == 0);
+
+    uintptr_t base = CHECK_BASE;
+    struct vma_struct *vma;
+    assert(mm_map(mm, base, 8 * PGSIZE, VM_READ | VM_WRITE, &vma) == 0);
+    int i;
+    for (i = 0; i < 8; i ++) {
+        assert(do_pgfault(mm, 2, base + i * PGSIZE) == 0);
+        *(int *)(base + i * PGSIZE) = i;
+    }
+
+    // 解除中间两页: 拆成 [0, 2), [4, 8) 两个 vma
+    assert(mm_unmap(mm, base + 2 * PGSIZE, 2 * PGSIZE) == 0);
+    assert(mm->map_count == 2 && vma->vm_start == base && vma->vm_end == base + 2 * PGSIZE);
+    assert(find_vma(mm, base + 2 * PGSIZE) == NULL && find_vma(mm, base + 3 * PGSIZE) == NULL);
+    assert(get_page(pgdir, base + 2 * PGSIZE, NULL) == NULL && get_page(pgdir, base + 3 * PGSIZE, NULL) == NULL);
+    struct vma_struct *nvma = find_vma(mm, base + 4 * PGSIZE);
+    assert(nvma != NULL && nvma->vm_start == base + 4 * PGSIZE && nvma->vm_end == base + 8 * PGSIZE);
+    assert(*(int *)(base + 4 * PGSIZE) == 4 && *(int *)(base + PGSIZE) == 1);
+    // 区域中还有 vma: 二级页表保留
+    assert(pgdir[PDX(CHECK_BASE)] & PTE_P);
+
+    // 跨过末尾: 截短尾部; 不按页对齐的起点: 截短头部
+    assert(mm_unmap(mm, base + 6 * PGSIZE, 4 * PGSIZE) == 0);
+    assert(nvma->vm_end == base + 6 * PGSIZE && get_page(pgdir, base + 7 * PGSIZE, NULL) == NULL);
+    assert(mm_unmap(mm, base + 0x10, 1) == 0);
+    assert(vma->vm_start == base + PGSIZE && find_vma(mm, base) == NULL && find_vma(mm, base + PGSIZE) == vma);
+
+    // 从空隙 [2, 4) 开始、跨过后面的 vma [4, 6) 的范围也算重叠, 不能映射(mmap 给出起始地址时)
+    assert(mm_map(mm, base + 3 * PGSIZE, 2 * PGSIZE, VM_READ, NULL) == -E_INVAL);
+    assert(mm_map(mm, base + 2 * PGSIZE, 8 * PGSIZE, VM_READ, NULL) == -E_INVAL);
+    assert(mm->map_count == 2 && find_vma(mm, base + 3 * PGSIZE) == NULL);
+    assert(mm->map_count == 2 && rb_check(&(mm->mmap_tree)) > 0);
+    assert(mm_unmap(mm, 0, PGSIZE) == -E_INVAL);
+
+    // get_unmapped_area: 从 USERTOP 向下找第一段足够大的空隙
+    assert(get_unmapped_area(mm, 2 * PGSIZE) == USERTOP - 2 * PGSIZE);
+    assert(mm_map(mm, USERTOP - PGSIZE, PGSIZE, VM_READ, NULL) == 0);
+    assert(mm_map(mm, USERTOP - 5 * PGSIZE, 2 * PGSIZE, VM_READ, NULL) == 0);
+    assert(get_unmapped_area(mm, 2 * PGSIZE) == USERTOP - 3 * PGSIZE);
+    assert(get_unmapped_area(mm, 3 * PGSIZE) == USERTOP - 8 * PGSIZE);
+    assert(get_unmapped_area(mm, USERTOP) == 0);
+    assert(do_pgfault(mm, 0, USERTOP - PGSIZE) == 0 && (pgdir[PDX(USERTOP - PGSIZE)] & PTE_P));
+    assert(mm_unmap(mm, USERTOP - 5 * PGSIZE, 5 * PGSIZE) == 0 && mm->map_count == 2);
+    assert(pgdir[PDX(USERTOP - PGSIZE)] == 0);
+
+    // 同一共享内存对象映射两次: 两处看到同一物理页, 最后一个映射解除时对象被释放
+    struct shmem_struct *shmem = shmem_create(2 * PGSIZE);
+    assert(shmem != NULL);
+    uintptr_t addr1 = base + 8 * PGSIZE, addr2 = base + 12 * PGSIZE;
+    assert(mm_map_shmem(mm, addr1, 2 * PGSIZE, VM_READ | VM_WRITE, shmem) == 0);
+    assert(mm_map_shmem(mm, addr2, 2 * PGSIZE, VM_READ, shmem) == 0);
+    assert(shmem_ref(shmem) == 2);
+    assert(do_pgfault(mm, 2, addr1 + PGSIZE) == 0);
+    *(int *)(addr1 + PGSIZE) = 0x5a5a5a5a;
+    assert(do_pgfault(mm, 0, addr2 + PGSIZE) == 0);
+    assert(*(int *)(addr2 + PGSIZE) == 0x5a5a5a5a);
+    struct Page *page = get_page(pgdir, addr1 + PGSIZE, NULL);
+    assert(page == pte2page(shmem->entries[1]) && page == get_page(pgdir, addr2 + PGSIZE, NULL) && page_ref(page) == 3);
+    assert(shmem->entries[0] == 0);
+    assert(mm_unmap(mm, addr1, 2 * PGSIZE) == 0);
+    assert(shmem_ref(shmem) == 1 && page_ref(page) == 2);
+
+    assert(mm_unmap(mm, base, PTSIZE) == 0);
+    assert(mm->map_count == 0 && list_empty(&(mm->mmap_list)) && rb_tree_empty(&(mm->mmap_tree)));
+    // 区域中已没有 vma: mm_unmap 释放了二级页表
+    assert(pgdir[PDX(CHECK_BASE)] == 0);
+    mm->pgdir = NULL;
+    mm_destroy(mm);
+
+    assert(nr_free_pages_store == nr_free_pages());
+    LOG_TAB("%-20s%s\n","check_mm_unmap()", ": succeed!");
+}
+
+// check_mm_brk - 堆向上扩展时延长同一个 vma, 不与程序的段合并, 也不能覆盖已有的映射
+static void
+check_mm_brk(void) {
+    size_t nr_free_pages_store = nr_free_pages();
+    struct mm_struct *mm = mm_create();
+    assert(mm != NULL);
+    pde_t *pgdir = mm->pgdir = boot_pgdir;
+    assert(pgdir[PDX(CHECK_BASE)] == 0);
+
+    // 代码段之后开始堆
+    uintptr_t base = CHECK_BASE;
+    struct vma_struct *heap;
+    assert(mm_map(mm, base, PGSIZE, VM_READ | VM_EXEC, NULL) == 0);
+    assert(mm_brk(mm, base + PGSIZE, PGSIZE) == 0 && mm->map_count == 2);
+    heap = find_vma(mm, base + PGSIZE);
+    assert(heap != NULL && heap->vm_start == base + PGSIZE && heap->vm_end == base + 2 * PGSIZE);
+
+    // 继续扩展: 延长同一个 vma
+    assert(mm_brk(mm, base + 2 * PGSIZE, 2 * PGSIZE) == 0 && mm->map_count == 2);
+    assert(heap->vm_end == base + 4 * PGSIZE && find_vma(mm, base + 3 * PGSIZE) == heap);
+    assert(do_pgfault(mm, 2, base + 3 * PGSIZE) == 0);
+    *(int *)(base + 3 * PGSIZE) = 0x5a5a5a5a;
+
+    // 与已有的映射重叠
+    assert(mm_map(mm, base + 6 * PGSIZE, PGSIZE, VM_READ, NULL) == 0);
+    assert(mm_brk(mm, base + 4 * PGSIZE, 4 * PGSIZE) == -E_INVAL && heap->vm_end == base + 4 * PGSIZE);
+    assert(mm_brk(mm, base + 2 * PGSIZE, PGSIZE) == -E_INVAL);
+
+    // 收缩: 解除末尾的页
+    assert(mm_unmap(mm, base + 3 * PGSIZE, PGSIZE) == 0 && heap->vm_end == base + 3 * PGSIZE);
+    assert(get_page(pgdir, base + 3 * PGSIZE, NULL) == NULL);
+
+    // 扩展到下一个 PTSIZE 区域再收缩回来(do_brk 的做法): 那个区域的二级页表随之释放
+    assert(mm_unmap(mm, base + 6 * PGSIZE, PGSIZE) == 0 && pgdir[PDX(base + PTSIZE)] == 0);
+    assert(mm_brk(mm, base + 3 * PGSIZE, PTSIZE) == 0 && heap->vm_end == base + PTSIZE + 3 * PGSIZE);
+    assert(do_pgfault(mm, 2, base + PTSIZE + PGSIZE) == 0 && (pgdir[PDX(base + PTSIZE)] & PTE_P));
+    assert(mm_unmap(mm, base + 3 * PGSIZE, PTSIZE) == 0 && heap->vm_end == base + 3 * PGSIZE);
+    assert(pgdir[PDX(base + PTSIZE)] == 0 && (pgdir[PDX(base)] & PTE_P));
+
+    assert(mm_unmap(mm, base, PTSIZE) == 0 && mm->map_count == 0);
+    assert(pgdir[PDX(CHECK_BASE)] == 0);
+    mm->pgdir = NULL;
+    mm_destroy(mm);
+
+    assert(nr_free_pages_store == nr_free_pages());
+    LOG_TAB("%-20s%s\n","check_mm_brk()", ": succeed!");
+}
+
+// check_fault_around - 顺序访问时窗口逐次加倍, 随机访问时减半, 以及解除映射时的统计
+static void
+check_fault_around(void) {
+    size_t nr_free_pages_store = nr_free_pages();
+    struct fault_around_stat stat0, stat1;
+    fault_around_set_max(FAULT_AROUND_DEFAULT);
+    fault_around_get_stat(&stat0);
+
+    struct mm_struct *mm = mm_create();
+    assert(mm != NULL);
+    pde_t *pgdir = mm->pgdir = boot_pgdir;
+    assert(pgdir[PDX(CHECK_BASE)] == 0);
+
+    // 顺序读 64 页: 窗口 1, 2, 4, 8, 16, 16, 16, 最后一次被 vma 末尾截断, 共缺页 8 次
+    uintptr_t base = CHECK_BASE;
+    assert(mm_map(mm, base, 64 * PGSIZE, VM_READ | VM_WRITE, NULL) == 0);
+    int i, nr_faults = 0;
+    for (i = 0; i < 64; i ++) {
+        pte_t *ptep = get_pte(pgdir, base + i * PGSIZE, 0);
+        if (ptep == NULL || !(*ptep & PTE_P)) {
+            assert(do_pgfault(mm, 0, base + i * PGSIZE) == 0);
+            nr_faults ++;
+        }
+        assert(*(volatile int *)(base + i * PGSIZE) == 0);
+    }
+    assert(nr_faults == 8);
+    fault_around_get_stat(&stat1);
+    assert(stat1.faults == stat0.faults + 6 && stat1.mapped == stat0.mapped + 56);
+    assert(mm_unmap(mm, base, 64 * PGSIZE) == 0);
+    fault_around_get_stat(&stat1);
+    assert(stat1.used == stat0.used + 56 && stat1.unused == stat0.unused);
+
+    // 不连续的缺页: 窗口 16 -> 8 -> 4, 顺带映射的页都没被访问过
+    assert(mm_map(mm, base, 64 * PGSIZE, VM_READ | VM_WRITE, NULL) == 0);
+    assert(do_pgfault(mm, 2, base + 10 * PGSIZE) == 0);
+    assert(get_page(pgdir, base + 17 * PGSIZE, NULL) != NULL && get_page(pgdir, base + 18 * PGSIZE, NULL) == NULL);
+    assert(do_pgfault(mm, 2, base + 40 * PGSIZE) == 0);
+    assert(get_page(pgdir, base + 43 * PGSIZE, NULL) != NULL && get_page(pgdir, base + 44 * PGSIZE, NULL) == NULL);
+
+    // 上限为 1 时关闭: 即使是顺序访问也只映射缺页的那一页
+    fault_around_set_max(1);
+    assert(do_pgfault(mm, 2, base + 44 * PGSIZE) == 0);
+    assert(get_page(pgdir, base + 45 * PGSIZE, NULL) == NULL && mm->fault_window == 1);
+    fault_around_set_max(FAULT_AROUND_DEFAULT);
+
+    assert(mm_unmap(mm, base, 64 * PGSIZE) == 0);
+    fault_around_get_stat(&stat1);
+    assert(stat1.mapped == stat0.mapped + 56 + 10 && stat1.unused == stat0.unused + 10);
+    assert(pgdir[PDX(CHECK_BASE)] == 0);
+    mm->pgdir = NULL;
+    mm_destroy(mm);
+
+    assert(nr_free_pages_store == nr_free_pages());
+    LOG_TAB("%-20s%s\n","check_fault_around()", ": succeed!");
+}
+
+// check_uaccess - 不预先检查 vma 的用户区复制: 缺页在复制中处理, 非法地址经异常表返回错误
+static void
+check_uaccess(void) {
+    size_t nr_free_pages_store = nr_free_pages();
+    struct mm_struct *mm = mm_create();
+    assert(mm != NULL);
+    pde_t *pgdir = mm->pgdir = boot_pgdir;
+    assert(pgdir[PDX(CHECK_BASE)] == 0);
+    // 借用 check_mm_struct, 使复制中的缺页由 pgfault_handler 交给此 mm 处理
+    assert(check_mm_struct == NULL);
+    check_mm_struct = mm;
+
+    // [0, 2) 可读写, [3, 4) 只读, 其余没有 vma
+    uintptr_t base = CHECK_BASE;
+    assert(mm_map(mm, base, 2 * PGSIZE, VM_READ | VM_WRITE, NULL) == 0);
+    assert(mm_map(mm, base + 3 * PGSIZE, PGSIZE, VM_READ, NULL) == 0);
+
+    // 跨页复制, 两页都还未映射
+    char buf[8];
+    char *uaddr = (char *)(base + PGSIZE - 3);
+    assert(copy_to_user(mm, uaddr, "uaccess", 8));
+    assert(get_page(pgdir, base, NULL) != NULL && get_page(pgdir, base + PGSIZE, NULL) != NULL);
+    assert(copy_from_user(mm, buf, uaddr, 8, 0) && strcmp(buf, "uaccess") == 0);
+    assert(copy_string(mm, buf, uaddr, 8) && strcmp(buf, "uaccess") == 0);
+    assert(!copy_string(mm, buf, uaddr, 7));
+
+    // 写只读的 vma, 读写没有 vma 的地址, 内核地址: 都返回错误
+    assert(!copy_to_user(mm, (void *)(base + 3 * PGSIZE), buf, 1));
+    assert(copy_from_user(mm, buf, (void *)(base + 3 * PGSIZE), 1, 0) && buf[0] == 0);
+    assert(!copy_from_user(mm, buf, (void *)(base + 2 * PGSIZE - 4), 8, 0));
+    assert(!copy_to_user(mm, (void *)(base + 2 * PGSIZE), buf, 1));
+    assert(!copy_from_user(mm, buf, (void *)KERNBASE, 1, 0));
+    // 没有结尾的字符串一直读到没有 vma 的页
+    memset(buf, 'x', sizeof(buf));
+    assert(copy_to_user(mm, (void *)(base + 2 * PGSIZE - 8), buf, 8));
+    assert(!copy_string(mm, buf, (void *)(base + 2 * PGSIZE - 8), 16));
+
+    check_mm_struct = NULL;
+    assert(mm_unmap(mm, base, PTSIZE) == 0);
+    assert(pgdir[PDX(CHECK_BASE)] == 0);
+    mm->pgdir = NULL;
+    mm_destroy(mm);
+
+    assert(nr_free_pages_store == nr_free_pages());
+    LOG_TAB("%-20s%s\n","check_uaccess()", ": succeed!");
+}
+
+// 扫描到整轮结束
+static void
+check_ksm_full_scan(struct ksm_stat *stat) {
+    size_t full_scans = stat->full_scans;
+    do {
+        ksm_scan(1);
+        ksm_get_stat(stat);
+    } while (stat->full_scans == full_scans);
+}
+
+// check_ksm - 两个 mm 中内容相同的页合并为一个只读页, 全零页换成零页, 刚写过的页推迟一轮, 写时各自复制
+static void
+check_ksm(void) {
+    size_t nr_free_pages_store = nr_free_pages();
+    int zero_ref = page_ref(zero_page);
+    struct mm_struct *mm = mm_create(), *nmm = mm_create();
+    assert(mm != NULL && nmm != NULL);
+    pde_t *pgdir = mm->pgdir = boot_pgdir;
+    assert(pgdir[PDX(CHECK_BASE)] == 0);
+    assert((nmm->pgdir = alloc_pgdir()) != NULL);
+    assert(mm_map(mm, CHECK_BASE, 4 * PGSIZE, VM_READ | VM_WRITE, NULL) == 0);
+    assert(mm_map(nmm, CHECK_BASE, 4 * PGSIZE, VM_READ | VM_WRITE, NULL) == 0);
+
+    // mm: A A 0 B, nmm: A - - B(刚写过)
+    struct Page *page[4], *npage0, *npage3;
+    pte_t *ptep;
+    int i;
+    for (i = 0; i < 4; i ++) {
+        assert((page[i] = pgdir_alloc_page(pgdir, CHECK_BASE + i * PGSIZE, PTE_USER)) != NULL);
+    }
+    assert((npage0 = pgdir_alloc_page(nmm->pgdir, CHECK_BASE, PTE_USER)) != NULL);
+    assert((npage3 = pgdir_alloc_page(nmm->pgdir, CHECK_BASE + 3 * PGSIZE, PTE_USER)) != NULL);
+    memset(page2kva(page[0]), 0x5a, PGSIZE);
+    memset(page2kva(page[1]), 0x5a, PGSIZE);
+    memset(page2kva(page[2]), 0, PGSIZE);
+    memset(page2kva(page[3]), 0xa5, PGSIZE);
+    memset(page2kva(npage0), 0x5a, PGSIZE);
+    memset(page2kva(npage3), 0xa5, PGSIZE);
+    assert(get_page(nmm->pgdir, CHECK_BASE + 3 * PGSIZE, &ptep) == npage3);
+    *ptep |= PTE_D;
+
+    struct ksm_stat stat;
+    ksm_register(mm);
+    ksm_register(nmm);
+    ksm_get_stat(&stat);
+    assert(stat.nr_mm == 2);
+
+    // 第一轮: 三个 A 合并为 page[0], 零页替换 page[2]; 刚写过的 nmm B 只清除 PTE_D
+    check_ksm_full_scan(&stat);
+    assert(get_page(pgdir, CHECK_BASE, &ptep) == page[0] && !(*ptep & PTE_W));
+    assert(get_page(pgdir, CHECK_BASE + PGSIZE, NULL) == page[0]);
+    assert(get_page(nmm->pgdir, CHECK_BASE, NULL) == page[0] && page_ref(page[0]) == 4);
+    assert(get_page(pgdir, CHECK_BASE + 2 * PGSIZE, NULL) == zero_page && page_ref(zero_page) == zero_ref + 1);
+    assert(get_page(nmm->pgdir, CHECK_BASE + 3 * PGSIZE, &ptep) == npage3 && !(*ptep & PTE_D));
+    assert(stat.pages_shared == 1 && stat.pages_sharing == 3 && stat.pages_saved == 2 && stat.zero_merged == 1);
+
+    // 第二轮: 两个 B 合并
+    check_ksm_full_scan(&stat);
+    assert(get_page(nmm->pgdir, CHECK_BASE + 3 * PGSIZE, NULL) == page[3] && page_ref(page[3]) == 3);
+    assert(stat.pages_shared == 2 && stat.pages_sharing == 5 && stat.pages_saved == 3);
+
+    // 写合并页: 复制一份, 其他映射不变
+    assert(do_pgfault(nmm, 3, CHECK_BASE) == 0);
+    assert((npage0 = get_page(nmm->pgdir, CHECK_BASE, &ptep)) != page[0] && (*ptep & PTE_W));
+    assert(page_ref(page[0]) == 3 && memcmp(page2kva(npage0), page2kva(page[0]), PGSIZE) == 0);
+
+    unmap_range(nmm->pgdir, CHECK_BASE, CHECK_BASE + PTSIZE);
+    exit_range(nmm->pgdir, CHECK_BASE, CHECK_BASE + PTSIZE);
+    free_pgdir(nmm->pgdir);
+    nmm->pgdir = NULL;
+    mm_destroy(nmm);
+
+    // 最后一个登记的 mm 销毁时释放所有稳定页
+    unmap_range(pgdir, CHECK_BASE, CHECK_BASE + PTSIZE);
+    exit_range(pgdir, CHECK_BASE, CHECK_BASE + PTSIZE);
+    assert(pgdir[PDX(CHECK_BASE)] == 0);
+    mm->pgdir = NULL;
+    mm_destroy(mm);
+    ksm_get_stat(&stat);
+    assert(stat.nr_mm == 0 && stat.pages_shared == 0);
+
+    assert(page_ref(zero_page) == zero_ref);
+    assert(nr_free_pages_store == nr_free_pages());
+    LOG_TAB("%-20s%s\n","check_ksm()", ": succeed!");
+}
+
 //page fault number
 volatile unsigned int pgfault_num=0;
 
+/**
+ * vma_fill_page - 文件映射的 vma 中 la 处的页第一次被访问: 分配一页映射到 la,
+ * 读入文件内容与此页相交的部分, 其余部分清零. 完全来自文件的页不必预先清零.
+ */
+static int
+vma_fill_page(struct mm_struct *mm, struct vma_struct *vma, uintptr_t la, uint32_t perm) {
+    uintptr_t start = (la > vma->vm_file_start) ? la : vma->vm_file_start;
+    uintptr_t end = (la + PGSIZE < vma->vm_file_end) ? la + PGSIZE : vma->vm_file_end;
+    struct Page *page;
+    if (start >= end) {
+        return (pgdir_alloc_page_zeroed(mm->pgdir, la, perm) != NULL) ? 0 : -E_NO_MEM;
+    }
+    if ((page = (start == la && end == la + PGSIZE) ? alloc_page() : alloc_page_zeroed()) == NULL) {
+        return -E_NO_MEM;
+    }
+
+    off_t offset = vma->vm_offset + (start - vma->vm_file_start);
+    struct iobuf __iob, *iob = iobuf_init(&__iob, page2kva(page) + (start - la), end - start, offset);
+    int ret = vop_read(vma->vm_file, iob);
+    if (ret == 0 && iob->io_resid != 0) {
+        ret = -E_INVAL;     // 文件比建立映射时短
+    }
+    if (ret != 0) {
+        free_page(page);
+        return ret;
+    }
+    if (pgdir_install_page(mm->pgdir, page, la, perm) == NULL) {
+        return -E_NO_MEM;
+    }
+    LOG("按需加载: 0x%08lx 读入文件偏移 0x%08lx 处的 %u 字节.\n", la, offset, end - start);
+    return 0;
+}
+
+/**
+ * fault-around: 缺页时顺带映射同一 vma, 同一二级页表中紧随其后的若干个还未映射的页,
+ * 顺序访问时一次缺页就能代替多次. 顺带映射的页表项带 PTE_PREFAULT 标记,
+ * 解除映射时按 PTE_A 统计它们是否真的被访问过(fault_around_account).
+ *
+ * 窗口大小按 mm 自适应: 缺页地址恰好是上次映射范围的下一页时视为顺序访问, 窗口加倍(不超过 fault_around_max),
+ * 否则减半(不小于 1, 即只映射缺页的那一页). 随机访问很快退化为逐页缺页, 不会白白分配内存.
+ */
+static size_t fault_around_max = FAULT_AROUND_DEFAULT;
+static size_t fault_around_faults, fault_around_mapped, fault_around_used, fault_around_unused;
+
+// fault_around_set_max - 设置窗口上限(页), 1 表示关闭 fault-around
+void
+fault_around_set_max(size_t max) {
+    if (max < 1) {
+        max = 1;
+    }
+    fault_around_max = (max > NPTEENTRY) ? NPTEENTRY : max;
+}
+
+// fault_around_account - 解除一个带 PTE_PREFAULT 的页表项时调用, 按 PTE_A 统计是否被访问过
+void
+fault_around_account(pte_t pte) {
+    if (pte & PTE_A) {
+        fault_around_used ++;
+    }
+    else {
+        fault_around_unused ++;
+    }
+}
+
+void
+fault_around_get_stat(struct fault_around_stat *stat) {
+    stat->max = fault_around_max;
+    stat->faults = fault_around_faults;
+    stat->mapped = fault_around_mapped;
+    stat->used = fault_around_used;
+    stat->unused = fault_around_unused;
+}
+
+/**
+ * fault_around - addr 处的缺页已经处理完, 按 mm 当前的窗口映射其后的页.
+ * 只映射页表项为 0 的页(已映射的和换出项不动), 不跨过 vma 和二级页表的边界, 分配失败时就此停止.
+ * zero 为真(匿名内存的读缺页)时顺带映射的也是共享零页, 不分配内存.
+ */
+static void
+fault_around(struct mm_struct *mm, struct vma_struct *vma, uintptr_t addr, uint32_t perm, bool zero) {
+    if (addr == mm->fault_next) {
+        mm->fault_window *= 2;
+    }
+    else {
+        mm->fault_window /= 2;
+    }
+    if (mm->fault_window > fault_around_max) {
+        mm->fault_window = fault_around_max;
+    }
+    if (mm->fault_window < 1) {
+        mm->fault_window = 1;
+    }
+
+    uintptr_t end = addr + mm->fault_window * PGSIZE;
+    uintptr_t pt_end = ROUNDDOWN(addr, PTSIZE) + PTSIZE;
+    if (end > vma->vm_end || end < addr) {
+        end = vma->vm_end;
+    }
+    if (end > pt_end && pt_end != 0) {
+        end = pt_end;
+    }
+    mm->fault_next = end;
+
+    size_t mapped = 0;
+    pte_t *ptep = get_pte(mm->pgdir, addr, 0);
+    for (addr += PGSIZE, ptep ++; addr < end; addr += PGSIZE, ptep ++) {
+        if (*ptep != 0) {
+            continue ;
+        }
+        if (vma->vm_file != NULL) {
+            if (vma_fill_page(mm, vma, addr, perm | PTE_PREFAULT) != 0) {
+                break;
+            }
+        }
+        else if (zero) {
+            if (page_insert(mm->pgdir, zero_page, addr, (perm & ~PTE_W) | PTE_PREFAULT) != 0) {
+                break;
+            }
+        }
+        else if (pgdir_alloc_page_zeroed(mm->pgdir, addr, perm | PTE_PREFAULT) == NULL) {
+            break;
+        }
+        mapped ++;
+    }
+    if (mapped != 0) {
+        fault_around_faults ++;
+        fault_around_mapped += mapped;
+        LOG("fault-around: 顺带映射了 %u 页.\n", mapped);
+    }
+}
+
 /**
  * do_pgfault - page fault 中断处理函数,用于处理缺页异常.
  * 
@@ -483,6 +1504,15 @@ do_pgfault(struct mm_struct *mm, uint32_t error_code, uintptr_t addr) {
 
     ret = -E_NO_MEM;
 
+    // VM_HUGE 区域中整个 4MB 都还未映射: 尝试一次性用大页映射, 没有连续内存时继续走 4KB 页的流程
+    if ((vma->vm_flags & VM_HUGE) && mm->pgdir[PDX(addr)] == 0) {
+        if (pgdir_alloc_large_page(mm->pgdir, addr, perm) != NULL) {
+            LOG("已用 4MB 大页映射 0x%08lx.\n", ROUNDDOWN(addr, PTSIZE));
+            return 0;
+        }
+        LOG("没有连续的 4MB 内存, 退化为 4KB 页.\n");
+    }
+
     pte_t *ptep=NULL;
     /*
     * MACROs or Functions:
@@ -548,20 +1578,79 @@ do_pgfault(struct mm_struct *mm, uint32_t error_code, uintptr_t addr) {
     }
     LOG("已得到此地址的页表项\n");
     if (*ptep == 0) { // 1. 若页表项中物理地址的值为空,则分配一个物理页并将 addr 映射过去
-        if (pgdir_alloc_page(mm->pgdir, addr, perm) == NULL) {
-            LOG("pgdir_alloc_page in do_pgfault failed\n");
+        if (vma->vm_shmem != NULL) {
+            struct Page *page;
+            if ((ret = shmem_get_page(vma->vm_shmem, (addr - vma->vm_shmem_base) / PGSIZE, &page)) != 0) {
+                LOG("shmem_get_page in do_pgfault failed\n");
+                goto failed;
+            }
+            ret = page_insert(mm->pgdir, page, addr, perm);
+            page_ref_dec(page);
+            if (ret != 0) {
+                goto failed;
+            }
+        }
+        else if (vma->vm_file != NULL) {
+            if ((ret = vma_fill_page(mm, vma, addr, perm)) != 0) {
+                LOG("vma_fill_page in do_pgfault failed\n");
+                goto failed;
+            }
+        }
+        else if (!(error_code & 2)) {
+            // 匿名内存的读缺页: 只读地映射共享零页, 第一次写时再分配私有页
+            if (page_insert(mm->pgdir, zero_page, addr, perm & ~PTE_W) != 0) {
+                LOG("page_insert of zero page in do_pgfault failed\n");
+                goto failed;
+            }
+        }
+        else if (pgdir_alloc_page_zeroed(mm->pgdir, addr, perm) == NULL) {
+            LOG("pgdir_alloc_page_zeroed in do_pgfault failed\n");
             goto failed;
         }
+        // check_swap 按页统计缺页次数, 它的 mm 不做 fault-around
+        if (vma->vm_shmem == NULL && mm != check_mm_struct) {
+            fault_around(mm, vma, addr, perm, vma->vm_file == NULL && !(error_code & 2));
+        }
     }
     else {
         struct Page *page=NULL;
         LOG("do pgfault: ptep %x, pte %x\n",ptep, *ptep);
         if (*ptep & PTE_P) {
-            //if process write to this existed readonly page (PTE_P means existed), then should be here now.
-            //we can implement the delayed memory space copy for fork child process (AKA copy on write, COW).
-            //we didn't implement now, we will do it in future.
-            panic("error write a non-writable pte");
-            //page = pte2page(*ptep);
+            // 写一个只读的已存在页: fork 后写时复制共享的页(见 copy_range), 或共享零页. 前面已校验 vma 可写.
+            // 仍被其他页表共享(page_ref > 1)时复制一份, 否则已是唯一的引用, 直接恢复写权限.
+            // 共享零页自己持有一个引用, 总是走复制的分支, 且不必复制内容, 取一个清零页即可.
+            page = pte2page(*ptep);
+            if (page_ref(page) > 1) {
+                struct Page *npage;
+                if (is_zero_page(page)) {
+                    npage = alloc_page_zeroed();
+                }
+                else if ((npage = alloc_page()) != NULL) {
+                    memcpy(page2kva(npage), page2kva(page), PGSIZE);
+                }
+                if (npage == NULL) {
+                    LOG("alloc_page for copy-on-write in do_pgfault failed\n");
+                    goto failed;
+                }
+                if (*ptep & PTE_PREFAULT) {
+                    fault_around_account(*ptep | PTE_A);    // 写入即是访问, 新的页表项不再带标记
+                }
+                // 新页接替原来的页登记为可换出: 原来的页仍映射在别的页表中, 留在队列里会被按 addr 换出
+                bool tracked = (swap_init_ok && mm == check_mm_struct && swap_set_unswappable(mm, addr) == 0);
+                if (pgdir_install_page(mm->pgdir, npage, addr, perm) == NULL) {
+                    if (tracked) {
+                        swap_map_swappable(mm, addr, page, 0);
+                    }
+                    goto failed;
+                }
+                LOG("写时复制: 0x%08lx 已复制到新页.\n", addr);
+            }
+            else {
+                *ptep |= PTE_W;
+                tlb_invalidate(mm->pgdir, addr);
+                LOG("写时复制: 0x%08lx 只剩一处引用, 恢复写权限.\n", addr);
+            }
+            return 0;
         } else{
            // if this pte is a swap entry, then load data from disk to a page with phy addr
            // and call page_insert to map the phy addr with logical addr
@@ -630,9 +1719,20 @@ user_mem_check(struct mm_struct *mm, uintptr_t addr, size_t len, bool write) {
  * 带合法性检测的字符串复制函数
  * 
  * 合法性定义: 从src到 src+maxn 必须可读
+ * 用户进程的字符串由 __copy_string_user 直接复制, 只需保证不越过 USERTOP(见 copy_from_user)
  */ 
 bool
 copy_string(struct mm_struct *mm, char *dst, const char *src, size_t maxn) {
+    if (mm != NULL) {
+        uintptr_t start = (uintptr_t)src;
+        if (!(USERBASE <= start && start < USERTOP)) {
+            return 0;
+        }
+        if (maxn > USERTOP - start) {
+            maxn = USERTOP - start;
+        }
+        return __copy_string_user(dst, src, maxn);
+    }
     size_t alen, part = ROUNDDOWN((uintptr_t)src + PGSIZE, PGSIZE) - (uintptr_t)src;
     while (1) {
         if (part > maxn) {
@@ -3,6 +3,7 @@
 
 #include <defs.h>
 #include <list.h>
+#include <rb_tree.h>
 #include <memlayout.h>
 #include <sync.h>
 #include <proc.h>
@@ -27,17 +28,24 @@ vma : virtual memory area, 连续虚拟内存空间, 通过线性链表和红黑
      struct vma_struct * vma_create (uintptr_t vm_start, uintptr_t vm_end,...)
      void insert_vma_struct(struct mm_struct *mm, struct vma_struct *vma)
      struct vma_struct * find_vma(struct mm_struct *mm, uintptr_t addr)
+     int mm_unmap(struct mm_struct *mm, uintptr_t addr, size_t len)
+     int mm_brk(struct mm_struct *mm, uintptr_t addr, size_t len)
+     uintptr_t get_unmapped_area(struct mm_struct *mm, size_t len)
    local functions
      inline void check_vma_overlap(struct vma_struct *prev, struct vma_struct *next)
 ---------------
    check correctness functions
      void check_vmm(void);
      void check_vma_struct(void);
+     void check_vma_tree(void);
+     void check_mm_unmap(void);
      void check_pgfault(void);
 */
 
 //pre define
 struct mm_struct;
+struct inode;
+struct shmem_struct;
 
 /**
  * 虚拟连续内存空间 virtual continuous memory area(vma)
@@ -52,16 +60,29 @@ struct vma_struct {
     uintptr_t vm_end;        // end addr of vma
     uint32_t vm_flags;       // flags of vma
     list_entry_t list_link;  // vma 链表,按基址排序      | linear list link which sorted by start addr of vma
+    rb_node rb_link;         // vma 红黑树, 以 vm_start 为键  | redblack link which sorted by start addr of vma
+    struct inode *vm_file;   // 文件映射: 缺页时从此文件读入, NULL 为匿名映射
+    off_t vm_offset;         // vm_file_start 对应的文件偏移
+    uintptr_t vm_file_start; // [vm_file_start, vm_file_end) 的内容来自文件, vma 中其余部分(如 BSS)缺页时清零
+    uintptr_t vm_file_end;
+    struct shmem_struct *vm_shmem;  // VM_SHARE 区域映射的共享内存对象, 缺页时取其中的页
+    uintptr_t vm_shmem_base;        // 共享内存对象第 0 页映射到的地址
+    list_entry_t shmem_link;        // 映射同一共享内存对象的 vma 链表, 换出时用于找到所有映射
 };
 
 #define le2vma(le, member)                  \
     to_struct((le), struct vma_struct, member)
 
+#define rbn2vma(node, member)               \
+    to_struct((node), struct vma_struct, member)
+
 // vma 属性
 #define VM_READ                 0x00000001
 #define VM_WRITE                0x00000002
 #define VM_EXEC                 0x00000004
 #define VM_STACK                0x00000008
+#define VM_HUGE                 0x00000010  // 匿名区域, 按 PTSIZE 对齐, 缺页时尽量用 4MB 大页映射
+#define VM_SHARE                0x00000020  // 映射 vm_shmem, fork 时共享而不是写时复制
 
 /**
  * 面向处理器的虚拟内存状态维护器.
@@ -83,6 +104,7 @@ struct vma_struct {
  */ 
 struct mm_struct {
     list_entry_t mmap_list;        // vma 链表,按基址排序                       | linear list link which sorted by start addr of vma 
+    rb_tree mmap_tree;             // vma 红黑树, 用于查找; 遍历仍用 mmap_list      | redblack tree of vma, used for lookup
     struct vma_struct *mmap_cache; // 当前正在使用的 vma                        | current accessed vma, used for speed purpose
     pde_t *pgdir;                  // the PDT of these vma
     int map_count;                 // vma 个数                                 | the count of these vma
@@ -90,6 +112,12 @@ struct mm_struct {
     int mm_count;                  // 共享同一 mm 的进程数量
     semaphore_t mm_sem;            // 互斥量,用于在 dup_mmap 函数中复制 mm 
     int locked_by;                 // the lock owner process's pid
+    uintptr_t fault_next;          // 上次缺页映射范围之后的第一页, 用于检测顺序访问
+    size_t fault_window;           // 当前 fault-around 窗口(页数)
+    uintptr_t brk_start;           // 堆的起始地址: 程序各段之后的第一页
+    uintptr_t brk;                 // 堆的当前末尾(按页对齐), [brk_start, brk) 由 SYS_brk 映射
+    bool ksm;                      // 已登记给 KSM 扫描(见 kern/mm/ksm.c)
+    list_entry_t ksm_link;         // 登记的 mm 链表
 };
 
 struct vma_struct *find_vma(struct mm_struct *mm, uintptr_t addr);
@@ -102,6 +130,10 @@ void mm_destroy(struct mm_struct *mm);
 void vmm_init(void);
 int mm_map(struct mm_struct *mm, uintptr_t addr, size_t len, uint32_t vm_flags,
            struct vma_struct **vma_store);
+int mm_map_file(struct mm_struct *mm, uintptr_t addr, size_t len, uint32_t vm_flags,
+                struct inode *node, off_t offset, size_t filesz);
+int mm_map_shmem(struct mm_struct *mm, uintptr_t addr, size_t len, uint32_t vm_flags,
+                 struct shmem_struct *shmem);
 int do_pgfault(struct mm_struct *mm, uint32_t error_code, uintptr_t addr);
 
 int mm_unmap(struct mm_struct *mm, uintptr_t addr, size_t len);
@@ -110,6 +142,21 @@ void exit_mmap(struct mm_struct *mm);
 uintptr_t get_unmapped_area(struct mm_struct *mm, size_t len);
 int mm_brk(struct mm_struct *mm, uintptr_t addr, size_t len);
 
+#define FAULT_AROUND_DEFAULT    16      // fault-around 窗口上限的默认值(页)
+
+// fault-around 的统计信息
+struct fault_around_stat {
+    size_t max;         // 窗口上限(页), 1 表示关闭
+    size_t faults;      // 顺带映射了其他页的缺页次数
+    size_t mapped;      // 顺带映射的页数
+    size_t used;        // 顺带映射后被访问过的页数, 即省下的缺页次数(解除映射时统计)
+    size_t unused;      // 顺带映射后直到解除映射都没有被访问的页数
+};
+
+void fault_around_set_max(size_t max);
+void fault_around_account(pte_t pte);
+void fault_around_get_stat(struct fault_around_stat *stat);
+
 extern volatile unsigned int pgfault_num;
 extern struct mm_struct *check_mm_struct;
 
@@ -15,6 +15,11 @@
 #include <fs.h>
 #include <vfs.h>
 #include <sysfile.h>
+#include <file.h>
+#include <inode.h>
+#include <stat.h>
+#include <shmem.h>
+#include <ksm.h>
 #include <kdebug.h>
 
 /**
@@ -77,11 +82,14 @@ SYS_fork        : create child process, dup mm            -->do_fork-->wakeup_pr
 SYS_wait        : wait process                            -->do_wait
 SYS_exec        : after fork, process execute a program   -->load a program and refresh the mm
 SYS_clone       : create child thread                     -->do_fork-->wakeup_proc
+SYS_vfork       : create child process, share mm          -->do_fork-->wakeup_proc-->vfork_wait
 SYS_yield       : process flag itself need resecheduling, -- proc->need_sched=1, then scheduler will rescheule this process
 SYS_sleep       : process sleep                           -->do_sleep 
 SYS_kill        : kill process                            -->do_kill-->proc->flags |= PF_EXITING
                                                                  -->wakeup_proc-->do_wait-->do_exit   
 SYS_getpid      : get the process's pid
+SYS_ksm         : let ksmproc merge identical pages       -->do_ksm-->ksm_register
+SYS_brk         : move the end of the heap                -->do_brk-->mm_brk/mm_unmap
 
 */
 
@@ -96,9 +104,16 @@ list_entry_t proc_list;
 static list_entry_t hash_list[HASH_LIST_SIZE];
 
 // idle proc
+// proc_struct 的对象 cache
+static struct kmem_cache *proc_cachep;
+
 struct proc_struct *idleproc = NULL;
 // init proc
 struct proc_struct *initproc = NULL;
+// 空闲时填充预清零页池的内核线程
+struct proc_struct *zeroproc = NULL;
+// 合并相同页的内核线程
+struct proc_struct *ksmproc = NULL;
 // current proc
 struct proc_struct *current = NULL;
 
@@ -115,7 +130,7 @@ void switch_to(struct context *from, struct context *to);
  */ 
 static struct proc_struct *
 alloc_proc(void) {
-    struct proc_struct *proc = kmalloc(sizeof(struct proc_struct));
+    struct proc_struct *proc = kmem_cache_alloc(proc_cachep);
     if (proc != NULL) {
      //LAB5 YOUR CODE : (update LAB4 steps)
     /*
@@ -256,7 +271,7 @@ proc_run(struct proc_struct *proc) {
             LOG_TAB("已更新 current\n");
             load_esp0(next->kstack + KSTACKSIZE);           // 2 当前进程的内核栈顶
             LOG_TAB("已更新 kstack\n");
-            lcr3(next->cr3);    //3 用于用户进程页表切换
+            lcr3(next->cr3);    //3 用于用户进程页表切换. 内核映射为全局页(PTE_G), 不会被刷出 TLB
             // 把当前环境保存在 from,把 to 的状态加载到环境上
             switch_to(&(prev->context), &(next->context));  //4 执行完之后,当前进程已经是下一个进程了. 注意,context 的初始值是什么?
             LOG("pid=%d, 切换后\n", proc->pid);
@@ -337,38 +352,228 @@ kernel_thread(int (*fn)(void *), void *arg, uint32_t clone_flags) {
     return do_fork(clone_flags | CLONE_VM, 0, &tf);
 }
 
+/**
+ * 内核栈池
+ *
+ * 内核栈不再取自直接映射区的 KSTACKPAGE 个物理连续页, 而是映射在内核栈区 [KSTACKBASE, KSTACKTOP):
+ * 栈区划分为 KSTACK_NR_SLOTS 个槽, 每槽底部 KSTACKGUARD 页不映射(保护页), 其上 KSTACKPAGE 页逐页映射单页.
+ * - 物理页不必连续, 进程创建不再受内存碎片影响;
+ * - 内核栈溢出会落在保护页上引起缺页, 而不是悄悄改写相邻的内存.
+ *
+ * 进程回收时栈连同映射一起放回池中, 按 LIFO 复用(最近释放的栈最可能仍在 cache 中),
+ * 稳态下 do_fork/do_wait 不再进入页分配器. 池满(KSTACK_POOL_HIGH)时才解除映射并归还物理页.
+ * 栈区的二级页表由 pmm_init 预先建好, 为所有页表共享, 这里只修改其中的页表项.
+ */
+#define KSTACK_NR_SLOTS         (KSTACKAREA / KSTACKSLOT)
+#define KSTACK_POOL_HIGH        8
+
+#define kstack_slot2addr(slot)  (KSTACKBASE + (slot) * KSTACKSLOT + KSTACKGUARD * PGSIZE)
+#define kstack_addr2slot(addr)  (((addr) - KSTACKBASE) / KSTACKSLOT)
+
+static struct {
+    uintptr_t pool[KSTACK_POOL_HIGH];           // 已映射的空闲栈, pool[count - 1] 为最近释放的
+    size_t count;
+    uint16_t free_slots[KSTACK_NR_SLOTS];       // 未映射的空闲槽
+    size_t nr_free_slots;
+    size_t hit;                                 // 直接从池中取到栈的次数
+    size_t miss;                                // 池为空, 新映射栈的次数
+    size_t unmap;                               // 池满, 解除映射归还物理页的次数
+} kstack_pool;
+
+static void
+kstack_pool_init(void) {
+    // 每个进程都有内核栈: 槽数不少于 MAX_PROCESS, do_fork 就不会因为槽用完而失败
+    static_assert(KSTACK_NR_SLOTS >= MAX_PROCESS);
+    int slot;
+    kstack_pool.count = kstack_pool.nr_free_slots = 0;
+    kstack_pool.hit = kstack_pool.miss = kstack_pool.unmap = 0;
+    for (slot = KSTACK_NR_SLOTS - 1; slot >= 0; slot --) {
+        kstack_pool.free_slots[kstack_pool.nr_free_slots ++] = slot;
+    }
+}
+
+// kstack_map - 取一个空闲槽, 分配 KSTACKPAGE 个单页映射为内核栈, 返回栈底地址, 失败返回 0
+static uintptr_t
+kstack_map(void) {
+    struct Page *pages[KSTACKPAGE];
+    uintptr_t kstack = 0;
+    size_t i, slot;
+    bool intr_flag;
+
+    local_intr_save(intr_flag);
+    if (kstack_pool.nr_free_slots > 0) {
+        slot = kstack_pool.free_slots[-- kstack_pool.nr_free_slots];
+        kstack = kstack_slot2addr(slot);
+    }
+    local_intr_restore(intr_flag);
+    if (kstack == 0) {
+        return 0;
+    }
+
+    if ((i = alloc_pages_bulk(KSTACKPAGE, pages)) != KSTACKPAGE) {
+        free_pages_bulk(pages, i);
+        goto failed;
+    }
+    for (i = 0; i < KSTACKPAGE; i ++) {
+        if (page_insert(boot_pgdir, pages[i], kstack + i * PGSIZE, PTE_W | PTE_G) != 0) {
+            // 已映射的页由 page_remove 归还, 其余的直接归还
+            free_pages_bulk(pages + i, KSTACKPAGE - i);
+            while (i -- > 0) {
+                page_remove(boot_pgdir, kstack + i * PGSIZE);
+            }
+            goto failed;
+        }
+    }
+    return kstack;
+
+failed:
+    local_intr_save(intr_flag);
+    kstack_pool.free_slots[kstack_pool.nr_free_slots ++] = slot;
+    local_intr_restore(intr_flag);
+    return 0;
+}
+
+// kstack_unmap - 解除内核栈的映射并归还物理页, 槽放回空闲槽
+static void
+kstack_unmap(uintptr_t kstack) {
+    size_t i;
+    bool intr_flag;
+    for (i = 0; i < KSTACKPAGE; i ++) {
+        page_remove(boot_pgdir, kstack + i * PGSIZE);
+    }
+    local_intr_save(intr_flag);
+    kstack_pool.free_slots[kstack_pool.nr_free_slots ++] = kstack_addr2slot(kstack);
+    local_intr_restore(intr_flag);
+}
+
 /**
  * 申请内核栈 = KSTACKPAGE 2 page
  * (供 TSS 段使用)
+ * 优先复用池中最近释放的栈.
  */ 
 static int
 setup_kstack(struct proc_struct *proc) {
-    struct Page *page = alloc_pages(KSTACKPAGE);
-    if (page != NULL) {
-        LOG_TAB("setup_kstack: kstack = new page(2)\n");
-        proc->kstack = (uintptr_t)page2kva(page);
-        return 0;
+    uintptr_t kstack = 0;
+    bool intr_flag;
+    local_intr_save(intr_flag);
+    {
+        if (kstack_pool.count > 0) {
+            kstack = kstack_pool.pool[-- kstack_pool.count];
+            kstack_pool.hit ++;
+        }
+        else {
+            kstack_pool.miss ++;
+        }
     }
-    return -E_NO_MEM;
+    local_intr_restore(intr_flag);
+
+    if (kstack == 0 && (kstack = kstack_map()) == 0) {
+        return -E_NO_MEM;
+    }
+    LOG_TAB("setup_kstack: kstack = 0x%08lx\n", kstack);
+    proc->kstack = kstack;
+    return 0;
 }
 
 // put_kstack - free the memory space of process kernel stack
-// 释放内核栈
+// 释放内核栈: 放回池中, 池满则解除映射
 static void
 put_kstack(struct proc_struct *proc) {
-    free_pages(kva2page((void *)(proc->kstack)), KSTACKPAGE);
+    uintptr_t kstack = proc->kstack;
+    bool intr_flag;
+    local_intr_save(intr_flag);
+    {
+        if (kstack_pool.count < KSTACK_POOL_HIGH) {
+            kstack_pool.pool[kstack_pool.count ++] = kstack;
+            kstack = 0;
+        }
+        else {
+            kstack_pool.unmap ++;
+        }
+    }
+    local_intr_restore(intr_flag);
+
+    if (kstack != 0) {
+        kstack_unmap(kstack);
+    }
+}
+
+// check_kstack_pool - 内核栈池自检: 栈页已映射可写, 保护页未映射, 释放后 LIFO 复用
+static void
+check_kstack_pool(void) {
+    struct proc_struct p1, p2;
+    size_t nr_free_pages_store = nr_free_pages();
+    size_t hit_store = kstack_pool.hit, miss_store = kstack_pool.miss;
+
+    assert(setup_kstack(&p1) == 0 && setup_kstack(&p2) == 0);
+    assert(kstack_pool.miss == miss_store + 2);
+    assert(p1.kstack != p2.kstack);
+    assert(KSTACKBASE <= p1.kstack && p1.kstack + KSTACKSIZE <= KSTACKTOP);
+    memset((void *)p1.kstack, 0x5a, KSTACKSIZE);
+    memset((void *)p2.kstack, 0xa5, KSTACKSIZE);
+    assert(*(uint8_t *)(p1.kstack + KSTACKSIZE - 1) == 0x5a);
+    if (KSTACKGUARD > 0) {
+        pte_t *ptep = get_pte(boot_pgdir, p1.kstack - PGSIZE, 0);
+        assert(ptep != NULL && !(*ptep & PTE_P));
+    }
+
+    put_kstack(&p1);
+    put_kstack(&p2);
+    assert(kstack_pool.count == 2);
+    // LIFO: 后释放的先被复用
+    uintptr_t kstack1 = p1.kstack, kstack2 = p2.kstack;
+    assert(setup_kstack(&p1) == 0 && p1.kstack == kstack2);
+    assert(setup_kstack(&p2) == 0 && p2.kstack == kstack1);
+    assert(kstack_pool.hit == hit_store + 2);
+    put_kstack(&p1);
+    put_kstack(&p2);
+
+    kstack_pool_drain();
+    assert(kstack_pool.count == 0);
+    assert(kstack_pool.nr_free_slots == KSTACK_NR_SLOTS);
+    assert(nr_free_pages_store == nr_free_pages());
+    LOG_TAB("%-20s%s\n","check_kstack_pool()", ": succeed!");
+}
+
+// kstack_pool_drain - 解除池中所有栈的映射, 归还物理页
+void
+kstack_pool_drain(void) {
+    uintptr_t kstack;
+    bool intr_flag;
+    while (1) {
+        local_intr_save(intr_flag);
+        kstack = (kstack_pool.count > 0) ? kstack_pool.pool[-- kstack_pool.count] : 0;
+        local_intr_restore(intr_flag);
+        if (kstack == 0) {
+            break;
+        }
+        kstack_unmap(kstack);
+    }
+}
+
+void
+kstack_pool_get_stat(struct kstack_pool_stat *stat) {
+    bool intr_flag;
+    local_intr_save(intr_flag);
+    {
+        stat->hit = kstack_pool.hit;
+        stat->miss = kstack_pool.miss;
+        stat->unmap = kstack_pool.unmap;
+        stat->count = kstack_pool.count;
+        stat->nr_used = KSTACK_NR_SLOTS - kstack_pool.nr_free_slots - kstack_pool.count;
+        stat->nr_slots = KSTACK_NR_SLOTS;
+    }
+    local_intr_restore(intr_flag);
 }
 
 // setup_pgdir - alloc one page as PDT
+// 一级页表来自页表页缓存, 内核部分已按 boot_pgdir 填好
 static int
 setup_pgdir(struct mm_struct *mm) {
-    struct Page *page;
-    if ((page = alloc_page()) == NULL) {
+    pde_t *pgdir;
+    if ((pgdir = alloc_pgdir()) == NULL) {
         return -E_NO_MEM;
     }
-    pde_t *pgdir = page2kva(page);
-    memcpy(pgdir, boot_pgdir, PGSIZE);  // 直接复制内核一级页表
-    pgdir[PDX(VPT)] = PADDR(pgdir) | PTE_P | PTE_W; // 自映射
     mm->pgdir = pgdir;
     return 0;
 }
@@ -376,7 +581,8 @@ setup_pgdir(struct mm_struct *mm) {
 // put_pgdir - free the memory space of PDT
 static void
 put_pgdir(struct mm_struct *mm) {
-    free_page(kva2page(mm->pgdir));
+    free_pgdir(mm->pgdir);
+    mm->pgdir = NULL;
 }
 
 // copy_mm - process "proc" duplicate OR share process "current"'s mm according clone_flags
@@ -417,6 +623,10 @@ copy_mm(uint32_t clone_flags, struct proc_struct *proc) {
     if (ret != 0) {
         goto bad_dup_cleanup_mmap;
     }
+    // 登记给 KSM 的进程 fork 出的子进程同样参与合并
+    if (oldmm->ksm) {
+        ksm_register(mm);
+    }
 
 good_mm:
     mm_count_inc(mm);
@@ -503,6 +713,33 @@ put_fs(struct proc_struct *proc) {
     }
 }
 
+/**
+ * vfork: 子进程与父进程共享 mm(CLONE_VM), 不复制地址空间; 父进程睡眠到子进程 exec 或退出,
+ * 即子进程不再使用这个 mm 时才返回(CLONE_VFORK). 适合 fork 之后马上 exec 的场合, 如 sh 启动命令.
+ * 子进程在父进程的用户栈上运行, 只能调用 exec 或 exit, 不能从调用 vfork 的函数返回.
+ * 文件表仍然复制, 子进程在 exec 前做的重定向不影响父进程.
+ */
+// vfork_wait - 父进程等待 vfork 的子进程释放共享的 mm
+static void
+vfork_wait(struct proc_struct *proc) {
+    while (proc->flags & PF_VFORK) {
+        current->state = PROC_SLEEPING;
+        current->wait_state = WT_VFORK;
+        schedule();
+    }
+}
+
+// vfork_release - vfork 的子进程已不再使用父进程的 mm(exec 或 exit), 唤醒父进程
+static void
+vfork_release(void) {
+    if (current->flags & PF_VFORK) {
+        current->flags &= ~PF_VFORK;
+        if (current->parent->wait_state == WT_VFORK) {
+            wakeup_proc(current->parent);
+        }
+    }
+}
+
 /* do_fork -     parent process for a new child process
  * @clone_flags: used to guide how to clone the child process
  * @stack:       the parent's user stack pointer. if stack==0, It means to fork a kernel thread.
@@ -562,6 +799,9 @@ do_fork(uint32_t clone_flags, uintptr_t stack, struct trapframe *tf) {
     LOG_TAB("2. 指定父进程: current\n");
     proc->parent = current;
     assert(current->wait_state == 0);
+    if (clone_flags & CLONE_VFORK) {
+        proc->flags |= PF_VFORK;
+    }
     // 建立内核栈空间,并用proc->kstack维护,(指向栈底,低地址)
     LOG_TAB("3. 设置内核栈空间: 2 page\n");
     if (setup_kstack(proc) != 0) {
@@ -600,6 +840,9 @@ do_fork(uint32_t clone_flags, uintptr_t stack, struct trapframe *tf) {
 
     // 子进程不会执行至此
     ret = proc->pid;    // 对父进程返回子进程的 pid
+    if (clone_flags & CLONE_VFORK) {
+        vfork_wait(proc);
+    }
 fork_out:
     LOG("\ndo_fork end\n");
     return ret;
@@ -609,7 +852,7 @@ bad_fork_cleanup_fs:  //for LAB8
 bad_fork_cleanup_kstack:
     put_kstack(proc);
 bad_fork_cleanup_proc:
-    kfree(proc);
+    kmem_cache_free(proc_cachep, proc);
     LOG("\ndo_fork bad end\n");
     goto fork_out;
 }
@@ -662,6 +905,7 @@ do_exit(int error_code) {
         }
         current->mm = NULL;             // 表示当前进程的内存已释放完毕
     }
+    vfork_release();
     put_fs(current); //for LAB8
     current->state = PROC_ZOMBIE;       // 一旦进程设置为 PROC_ZOMBIE 就无力回天了,无法在此被调度,只能等死
     current->exit_code = error_code;
@@ -770,8 +1014,6 @@ load_icode(int fd, int argc, char **kargv) {
     }
     LOG_TAB("\t初始化: 页表, 即 mm->pgdir\n");
 
-    struct Page *page;
-
     struct elfhdr __elf, *elf = &__elf;
     // (从磁盘)加载 elf 文件头
     if ((ret = load_icode_read(fd, elf, sizeof(struct elfhdr), 0)) != 0) {
@@ -785,15 +1027,22 @@ load_icode(int fd, int argc, char **kargv) {
     }
     LOG_TAB("已验证: elf header 有效\n");
 
+    // 各段按需加载: 这里只为每段建立文件映射的 vma, 页在第一次被访问时由 do_pgfault 从文件读入,
+    // BSS 部分缺页时清零. 每个 vma 持有 inode 的引用, 文件随后即可关闭.
+    struct inode *node;
+    if ((ret = file_getinode(fd, &node)) != 0) {
+        goto bad_elf_cleanup_pgdir;
+    }
+
     // (从磁盘)加载所有 elf program header
     struct proghdr __ph, *ph = &__ph;
-    uint32_t vm_flags, perm, phnum;
+    uint32_t vm_flags, phnum;
     LOG_TAB("开始加载 elf program:\n");
     for (phnum = 0; phnum < elf->e_phnum; phnum ++) {
         LOG_TAB("正在加载第 %d 个 program, 共 %d 个.\n",phnum+1, elf->e_phnum);
         off_t phoff = elf->e_phoff + sizeof(struct proghdr) * phnum;
         if ((ret = load_icode_read(fd, ph, sizeof(struct proghdr), phoff)) != 0) {
-            goto bad_cleanup_mmap;
+            goto bad_cleanup_node;
         }
         LOG_TAB("\t已加载: program header\n");
         
@@ -803,74 +1052,30 @@ load_icode(int fd, int argc, char **kargv) {
         }
         if (ph->p_filesz > ph->p_memsz) {
             ret = -E_INVAL_ELF;
-            goto bad_cleanup_mmap;
+            goto bad_cleanup_node;
         }
-        if (ph->p_filesz == 0) {
+        if (ph->p_memsz == 0) {
             continue ;
         }
         LOG_TAB("\t已校验: program header\n");
         /*** elf program header 校验 end ***/
         // 根据elf 标志位 确认内存描述符属性
-        vm_flags = 0, perm = PTE_U;
+        vm_flags = 0;
         if (ph->p_flags & ELF_PF_X) vm_flags |= VM_EXEC;
         if (ph->p_flags & ELF_PF_W) vm_flags |= VM_WRITE;
         if (ph->p_flags & ELF_PF_R) vm_flags |= VM_READ;
-        if (vm_flags & VM_WRITE) perm |= PTE_W;
         // 
-        if ((ret = mm_map(mm, ph->p_va, ph->p_memsz, vm_flags, NULL)) != 0) {
-            goto bad_cleanup_mmap;
+        if ((ret = mm_map_file(mm, ph->p_va, ph->p_memsz, vm_flags, node, ph->p_offset, ph->p_filesz)) != 0) {
+            goto bad_cleanup_node;
         }
-        LOG_TAB("\t已建立 mm: [0x%08lx,0x%08lx)\n", ph->p_va, ph->p_va + ph->p_memsz);
-        off_t offset = ph->p_offset;
-        size_t off, size;
-        uintptr_t start = ph->p_va, end, la = ROUNDDOWN(start, PGSIZE);
-
-        ret = -E_NO_MEM;
-
-        end = ph->p_va + ph->p_filesz;
-        while (start < end) {
-            if ((page = pgdir_alloc_page(mm->pgdir, la, perm)) == NULL) {
-                ret = -E_NO_MEM;
-                goto bad_cleanup_mmap;
-            }
-            off = start - la, size = PGSIZE - off, la += PGSIZE;
-            if (end < la) {
-                size -= la - end;
-            }
-            if ((ret = load_icode_read(fd, page2kva(page) + off, size, offset)) != 0) {
-                goto bad_cleanup_mmap;
-            }
-            start += size, offset += size;
-        }
-        end = ph->p_va + ph->p_memsz;
-
-        if (start < la) {
-            /* ph->p_memsz == ph->p_filesz */
-            if (start == end) {
-                continue ;
-            }
-            off = start + PGSIZE - la, size = PGSIZE - off;
-            if (end < la) {
-                size -= la - end;
-            }
-            memset(page2kva(page) + off, 0, size);
-            start += size;
-            assert((end < la && start == end) || (end >= la && start == la));
-        }
-        while (start < end) {
-            if ((page = pgdir_alloc_page(mm->pgdir, la, perm)) == NULL) {
-                ret = -E_NO_MEM;
-                goto bad_cleanup_mmap;
-            }
-            off = start - la, size = PGSIZE - off, la += PGSIZE;
-            if (end < la) {
-                size -= la - end;
-            }
-            memset(page2kva(page) + off, 0, size);
-            start += size;
+        LOG_TAB("\t已建立 mm: [0x%08lx,0x%08lx), 其中 0x%08lx 字节来自文件偏移 0x%08lx\n",
+                ph->p_va, ph->p_va + ph->p_memsz, ph->p_filesz, ph->p_offset);
+        // 堆从最高的段之后开始
+        if (ROUNDUP(ph->p_va + ph->p_memsz, PGSIZE) > mm->brk_start) {
+            mm->brk_start = mm->brk = ROUNDUP(ph->p_va + ph->p_memsz, PGSIZE);
         }
-        LOG_TAB("\t已建立: 页表\n");
     }
+    vop_ref_dec(node);
     sysfile_close(fd);
 
     vm_flags = VM_READ | VM_WRITE | VM_STACK;
@@ -918,6 +1123,8 @@ load_icode(int fd, int argc, char **kargv) {
     LOG("load_icode end.\n");
 out:
     return ret;
+bad_cleanup_node:
+    vop_ref_dec(node);
 bad_cleanup_mmap:
     exit_mmap(mm);
 bad_elf_cleanup_pgdir:
@@ -939,7 +1146,8 @@ put_kargv(int argc, char **kargv) {
 static int
 copy_kargv(struct mm_struct *mm, int argc, char **kargv, const char **argv) {
     int i, ret = -E_INVAL;
-    if (!user_mem_check(mm, (uintptr_t)argv, sizeof(const char *) * argc, 0)) {
+    const char *uargv[EXEC_MAX_ARG_NUM];
+    if (!copy_from_user(mm, uargv, argv, sizeof(const char *) * argc, 0)) {
         return ret;
     }
     for (i = 0; i < argc; i ++) {
@@ -947,7 +1155,7 @@ copy_kargv(struct mm_struct *mm, int argc, char **kargv, const char **argv) {
         if ((buffer = kmalloc(EXEC_MAX_ARG_LEN + 1)) == NULL) {
             goto failed_nomem;
         }
-        if (!copy_string(mm, buffer, argv[i], EXEC_MAX_ARG_LEN + 1)) {
+        if (!copy_string(mm, buffer, uargv[i], EXEC_MAX_ARG_LEN + 1)) {
             kfree(buffer);
             goto failed_cleanup;
         }
@@ -1029,6 +1237,7 @@ do_execve(const char *name, int argc, const char **argv) {
         }
         current->mm = NULL;
     }
+    vfork_release();
     ret= -E_NO_MEM;;
     if ((ret = load_icode(fd, argc, kargv)) != 0) {
         goto execve_exit;
@@ -1120,7 +1329,7 @@ found:
     }
     local_intr_restore(intr_flag);
     put_kstack(proc);
-    kfree(proc);
+    kmem_cache_free(proc_cachep, proc);
     return 0;
 }
 
@@ -1146,6 +1355,286 @@ do_kill(int pid) {
     return -E_INVAL;
 }
 
+/**
+ * do_mmap_file - 把 fd 对应文件中 offset 开始的内容映射到 [addr, addr + len).
+ * 私有映射缺页时读入各自的副本; MAP_SHARED 映射建立以文件为后备的共享内存对象,
+ * 此映射及 fork 出的子进程共享同一组页, 可写时在对象销毁前写回文件.
+ * 文件在 offset 之后不足 len 的部分清零, 写入它们不会扩展文件.
+ */
+static int
+do_mmap_file(struct mm_struct *mm, uintptr_t addr, size_t len, uint32_t vm_flags, bool shared,
+             int fd, off_t offset) {
+    if (offset < 0 || offset % PGSIZE != 0) {
+        return -E_INVAL;
+    }
+    if (!file_testfd(fd, 1, shared && (vm_flags & VM_WRITE))) {
+        return -E_INVAL;
+    }
+    int ret;
+    struct inode *node;
+    if ((ret = file_getinode(fd, &node)) != 0) {
+        return ret;
+    }
+    struct stat __stat, *stat = &__stat;
+    if ((ret = vop_fstat(node, stat)) != 0) {
+        goto out;
+    }
+    ret = -E_INVAL;
+    if (!S_ISREG(stat->st_mode)) {
+        goto out;
+    }
+    size_t filesz = 0;
+    if (stat->st_size > offset) {
+        filesz = stat->st_size - offset;
+        if (filesz > len) {
+            filesz = len;
+        }
+    }
+    if (!shared) {
+        ret = mm_map_file(mm, addr, len, vm_flags, node, offset, filesz);
+        goto out;
+    }
+    struct shmem_struct *shmem;
+    ret = -E_NO_MEM;
+    if ((shmem = shmem_create_file(len, node, offset, filesz, (vm_flags & VM_WRITE) != 0)) == NULL) {
+        goto out;
+    }
+    if ((ret = mm_map_shmem(mm, addr, len, vm_flags, shmem)) != 0) {
+        shmem_destroy(shmem);
+    }
+out:
+    vop_ref_dec(node);
+    return ret;
+}
+
+// mmap_check_addr - 检查用户给出的起始地址; 为 0 时由内核找一段长为 len 的空闲地址
+static int
+mmap_check_addr(struct mm_struct *mm, uintptr_t *addr, size_t len) {
+    if (*addr == 0) {
+        if ((*addr = get_unmapped_area(mm, len)) == 0) {
+            return -E_NO_MEM;
+        }
+    }
+    else if (*addr % PGSIZE != 0) {
+        return -E_INVAL;
+    }
+    return 0;
+}
+
+/**
+ * do_mmap - SYS_mmap: 在当前进程的地址空间中建立映射, 页在第一次访问时由 do_pgfault 填充.
+ * @addr_store: 用户空间中的地址. 传入期望的起始地址(按页对齐, 0 表示由内核选择), 成功时写回实际的起始地址
+ * @mmap_flags: MMAP_WRITE 可写, MMAP_SHARED 共享映射(fork 后父子进程看到同一组页)
+ * @fd, @offset: fd < 0 为匿名映射(内容清零), 否则映射此文件从 offset(按页对齐)开始的内容
+ */
+int
+do_mmap(uintptr_t *addr_store, size_t len, uint32_t mmap_flags, int fd, off_t offset) {
+    struct mm_struct *mm = current->mm;
+    if (mm == NULL) {
+        panic("kernel thread call mmap!!.\n");
+    }
+    if (addr_store == NULL || len == 0 || (len = ROUNDUP(len, PGSIZE)) == 0) {
+        return -E_INVAL;
+    }
+
+    uint32_t vm_flags = VM_READ;
+    if (mmap_flags & MMAP_WRITE) {
+        vm_flags |= VM_WRITE;
+    }
+    bool shared = ((mmap_flags & MMAP_SHARED) != 0);
+
+    int ret = -E_INVAL;
+    uintptr_t addr;
+    lock_mm(mm);
+    if (!copy_from_user(mm, &addr, addr_store, sizeof(uintptr_t), 1)) {
+        goto out_unlock;
+    }
+    if ((ret = mmap_check_addr(mm, &addr, len)) != 0) {
+        goto out_unlock;
+    }
+
+    if (fd >= 0) {
+        ret = do_mmap_file(mm, addr, len, vm_flags, shared, fd, offset);
+    }
+    else if (shared) {
+        struct shmem_struct *shmem;
+        ret = -E_NO_MEM;
+        if ((shmem = shmem_create(len)) != NULL && (ret = mm_map_shmem(mm, addr, len, vm_flags, shmem)) != 0) {
+            shmem_destroy(shmem);
+        }
+    }
+    else {
+        ret = mm_map(mm, addr, len, vm_flags, NULL);
+    }
+    if (ret == 0) {
+        copy_to_user(mm, addr_store, &addr, sizeof(uintptr_t));
+    }
+
+out_unlock:
+    unlock_mm(mm);
+    return ret;
+}
+
+/**
+ * do_shmem - SYS_shmem: 把共享内存段映射到当前进程, 之后用 munmap 解除.
+ * @name: 段名(用户空间字符串), 同名的段在所有进程中是同一个; NULL 为匿名段, 只能经 fork 共享
+ * @len: 段不存在时按此长度创建; 已存在时不能超过段的长度, 0 表示整个段
+ * @mmap_flags: MMAP_WRITE 可写
+ * @addr_store: 同 do_mmap
+ * 段在最后一个映射解除(munmap 或进程退出)时销毁, 名字随之失效.
+ */
+int
+do_shmem(const char *name, size_t len, uint32_t mmap_flags, uintptr_t *addr_store) {
+    struct mm_struct *mm = current->mm;
+    if (mm == NULL) {
+        panic("kernel thread call shmem!!.\n");
+    }
+    if (addr_store == NULL || ROUNDUP(len, PGSIZE) < len) {
+        return -E_INVAL;
+    }
+    len = ROUNDUP(len, PGSIZE);
+
+    uint32_t vm_flags = VM_READ;
+    if (mmap_flags & MMAP_WRITE) {
+        vm_flags |= VM_WRITE;
+    }
+
+    int ret = -E_INVAL;
+    char kname[SHMEM_NAME_MAX + 1];
+    struct shmem_struct *shmem = NULL;
+    uintptr_t addr;
+    lock_mm(mm);
+    // 先取完用户空间的参数(可能缺页睡眠), 之后查找和创建之间不会被打断, 同名的段不会被创建两次
+    if (!copy_from_user(mm, &addr, addr_store, sizeof(uintptr_t), 1)) {
+        goto out_unlock;
+    }
+    if (name != NULL) {
+        if (!copy_string(mm, kname, name, sizeof(kname)) || kname[0] == '\0') {
+            goto out_unlock;
+        }
+        shmem = shmem_lookup(kname);
+    }
+    if (shmem != NULL) {
+        if (len == 0) {
+            len = shmem->npages * PGSIZE;
+        }
+        else if (len > shmem->npages * PGSIZE) {
+            goto out_unlock;
+        }
+    }
+    else if (len == 0) {
+        goto out_unlock;
+    }
+    if ((ret = mmap_check_addr(mm, &addr, len)) != 0) {
+        goto out_unlock;
+    }
+
+    if (shmem == NULL) {
+        ret = -E_NO_MEM;
+        if ((shmem = (name != NULL) ? shmem_create_named(kname, len) : shmem_create(len)) == NULL) {
+            goto out_unlock;
+        }
+    }
+    if ((ret = mm_map_shmem(mm, addr, len, vm_flags, shmem)) != 0) {
+        if (shmem_ref(shmem) == 0) {
+            shmem_destroy(shmem);
+        }
+        goto out_unlock;
+    }
+    copy_to_user(mm, addr_store, &addr, sizeof(uintptr_t));
+
+out_unlock:
+    unlock_mm(mm);
+    return ret;
+}
+
+/**
+ * do_brk - SYS_brk: 把堆的末尾移到 *brk_store(按页向上取整), 成功时写回新的末尾.
+ * *brk_store 为 0 时只取回当前末尾. 堆从程序的最后一段之后开始, 收缩时解除多出的页.
+ */
+int
+do_brk(uintptr_t *brk_store) {
+    struct mm_struct *mm = current->mm;
+    if (mm == NULL) {
+        panic("kernel thread call brk!!.\n");
+    }
+    if (brk_store == NULL) {
+        return -E_INVAL;
+    }
+
+    int ret = -E_INVAL;
+    uintptr_t brk;
+    lock_mm(mm);
+    if (!copy_from_user(mm, &brk, brk_store, sizeof(uintptr_t), 1)) {
+        goto out_unlock;
+    }
+    if (brk != 0) {
+        if (brk < mm->brk_start || ROUNDUP(brk, PGSIZE) < brk) {
+            goto out_unlock;
+        }
+        brk = ROUNDUP(brk, PGSIZE);
+        ret = 0;
+        if (brk < mm->brk) {
+            ret = mm_unmap(mm, brk, mm->brk - brk);
+        }
+        else if (brk > mm->brk) {
+            ret = mm_brk(mm, mm->brk, brk - mm->brk);
+        }
+        if (ret != 0) {
+            goto out_unlock;
+        }
+        mm->brk = brk;
+    }
+    ret = 0;
+    copy_to_user(mm, brk_store, &(mm->brk), sizeof(uintptr_t));
+
+out_unlock:
+    unlock_mm(mm);
+    return ret;
+}
+
+/**
+ * do_ksm - SYS_ksm: KSM_ENABLE 让 ksmproc 合并当前进程中内容相同的页(fork 时继承), KSM_DISABLE 停止;
+ * KSM_SAVED 返回当前合并省下的页数.
+ */
+int
+do_ksm(int op) {
+    struct mm_struct *mm = current->mm;
+    if (mm == NULL) {
+        panic("kernel thread call ksm!!.\n");
+    }
+    struct ksm_stat stat;
+    switch (op) {
+    case KSM_ENABLE:
+        ksm_register(mm);
+        return 0;
+    case KSM_DISABLE:
+        ksm_unregister(mm);
+        return 0;
+    case KSM_SAVED:
+        ksm_get_stat(&stat);
+        return stat.pages_saved;
+    }
+    return -E_INVAL;
+}
+
+// do_munmap - SYS_munmap: 解除 [addr, addr + len) 的映射, 范围内没有映射的部分被忽略
+int
+do_munmap(uintptr_t addr, size_t len) {
+    struct mm_struct *mm = current->mm;
+    if (mm == NULL) {
+        panic("kernel thread call munmap!!.\n");
+    }
+    if (len == 0) {
+        return -E_INVAL;
+    }
+    int ret;
+    lock_mm(mm);
+    ret = mm_unmap(mm, addr, len);
+    unlock_mm(mm);
+    return ret;
+}
+
 // kernel_execve - do SYS_exec syscall to exec a user program called by user_main kernel_thread
 /**
  * 执行用户程序
@@ -1209,6 +1698,8 @@ init_main(void *arg) {
     }
     
     size_t nr_free_pages_store = nr_free_pages();
+    // 常驻的分配在此之前都已完成: 所有 kmem_cache 由各模块的 init 创建, zeroproc, ksmproc 由 proc_init 创建.
+    // ksmproc 运行时分配的 rmap_item, stable_node 在最后一个登记的 mm 退出时由 ksm_exit_mm 全部释放
     size_t kernel_allocated_store = kallocated();
 
     int pid = kernel_thread(user_main, NULL, 0);
@@ -1224,11 +1715,15 @@ init_main(void *arg) {
     }
 
     fs_cleanup();
+    // 池中缓存的内核栈不计入空闲页
+    kstack_pool_drain();
         
     LOG_TAB("all user-mode processes have quit.\n");
     assert(initproc->cptr == NULL && initproc->yptr == NULL && initproc->optr == NULL);
-    assert(nr_process == 2);
-    assert(list_next(&proc_list) == &(initproc->list_link));
+    // 此时仅剩 idleproc, initproc 和常驻的 zeroproc, ksmproc
+    assert(nr_process == 4);
+    assert(list_next(&proc_list) == &(ksmproc->list_link));
+    assert(list_next(list_next(&proc_list)) == &(zeroproc->list_link));
     assert(list_prev(&proc_list) == &(initproc->list_link));
     assert(nr_free_pages_store == nr_free_pages());
     assert(kernel_allocated_store == kallocated());
@@ -1237,10 +1732,34 @@ init_main(void *arg) {
     return 0;
 }
 
+// zero_main - zeroproc 内核线程执行函数
+// 每次被 cpu_idle 唤醒后清零一批页放入预清零池, 然后立即睡眠让出 CPU.
+// 只有在没有其他可运行进程时才会被唤醒, 所以不会与正常进程争抢时间片.
+#define ZERO_FILL_BATCH         8
+
+static int
+zero_main(void *arg) {
+    lab6_set_priority(1);
+    while (1) {
+        zero_pool_fill(ZERO_FILL_BATCH);
+        bool intr_flag;
+        local_intr_save(intr_flag);
+        {
+            current->state = PROC_SLEEPING;
+            current->wait_state = WT_ZERO;
+        }
+        local_intr_restore(intr_flag);
+        schedule();
+    }
+    return 0;
+}
+
 /*
  * 初始化进程环境
  *  1. 创建 1st 内核进程 idleproc
  *  2. 创建 2nd 内核进程 init_main
+ *  3. 创建 3rd 内核进程 zero_main
+ *  4. 创建 4th 内核进程 ksm_main
  */
 void
 proc_init(void) {
@@ -1249,6 +1768,13 @@ proc_init(void) {
     LOG("proc_init begin:\n");
     LOG_TAB("初始化队列: proc_list\n");
 
+    if ((proc_cachep = kmem_cache_create("proc_struct", sizeof(struct proc_struct), 0, NULL)) == NULL) {
+        panic("cannot create proc_struct cache.\n");
+    }
+
+    kstack_pool_init();
+    check_kstack_pool();
+
     int i;
     // 初始化进程表
     list_init(&proc_list);
@@ -1294,12 +1820,27 @@ proc_init(void) {
     initproc = find_proc(pid);
     set_proc_name(initproc, "init");
 
+    if ((pid = kernel_thread(zero_main, NULL, 0)) <= 0) {
+        panic("create zero_main failed.\n");
+    }
+    zeroproc = find_proc(pid);
+    set_proc_name(zeroproc, "zero");
+
+    if ((pid = kernel_thread(ksm_main, NULL, 0)) <= 0) {
+        panic("create ksm_main failed.\n");
+    }
+    ksmproc = find_proc(pid);
+    set_proc_name(ksmproc, "ksm");
+
     assert(idleproc != NULL && idleproc->pid == 0);
     assert(initproc != NULL && initproc->pid == 1);
+    assert(zeroproc != NULL && zeroproc->pid == 2);
+    assert(ksmproc != NULL && ksmproc->pid == 3);
     LOG("proc_init end\n");
 }
 
 // idle: 闲散的内核进程,不断地检测"当前进程"是否被指定暂时放弃资源.
+// 没有其他进程可运行时, 若预清零页池未满则唤醒 zeroproc 填充.
 void
 cpu_idle(void) {
     LOG("cpu_idle:\n");
@@ -1307,6 +1848,10 @@ cpu_idle(void) {
         if (current->need_resched) {
             schedule();
         }
+        else if (zeroproc != NULL && zeroproc->state == PROC_SLEEPING && zero_pool_need_fill()) {
+            wakeup_proc(zeroproc);
+            current->need_resched = 1;
+        }
     }
 }
 
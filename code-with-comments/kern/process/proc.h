@@ -42,7 +42,7 @@ struct context {
 };
 
 #define PROC_NAME_LEN               50
-#define MAX_PROCESS                 4096
+#define MAX_PROCESS                 1024            // 每个进程占内核栈区的一个槽, 不能超过槽数(见 proc.c 的 KSTACK_NR_SLOTS)
 #define MAX_PID                     (MAX_PROCESS * 2)
 
 extern list_entry_t proc_list;
@@ -77,6 +77,7 @@ struct proc_struct {
 };
 
 #define PF_EXITING                  0x00000001      // getting shutdown
+#define PF_VFORK                    0x00000002      // vfork 的子进程, 还在借用父进程的 mm
 
 // 等待状态(等待原因))
 #define WT_INTERRUPTED               0x80000000                    // the wait state could be interrupted
@@ -84,11 +85,14 @@ struct proc_struct {
 #define WT_KSEM                      0x00000100                    // wait kernel semaphore
 #define WT_TIMER                    (0x00000002 | WT_INTERRUPTED)  // wait timer
 #define WT_KBD                      (0x00000004 | WT_INTERRUPTED)  // wait the input of keyboard
+#define WT_ZERO                      0x00000008                    // zeroproc waits for the cpu to be idle
+#define WT_VFORK                     0x00000010                    // wait the vfork child to exec or exit
+#define WT_KSM                       0x00000020                    // ksmproc waits for a mm to scan
 
 #define le2proc(le, member)         \
     to_struct((le), struct proc_struct, member)
 
-extern struct proc_struct *idleproc, *initproc, *current;
+extern struct proc_struct *idleproc, *initproc, *zeroproc, *ksmproc, *current;
 
 void proc_init(void);
 void proc_run(struct proc_struct *proc);
@@ -105,6 +109,24 @@ int do_yield(void);
 int do_execve(const char *name, int argc, const char **argv);
 int do_wait(int pid, int *code_store);
 int do_kill(int pid);
+int do_mmap(uintptr_t *addr_store, size_t len, uint32_t mmap_flags, int fd, off_t offset);
+int do_munmap(uintptr_t addr, size_t len);
+int do_shmem(const char *name, size_t len, uint32_t mmap_flags, uintptr_t *addr_store);
+int do_brk(uintptr_t *brk_store);
+int do_ksm(int op);
+// 内核栈池的统计信息
+struct kstack_pool_stat {
+    size_t hit;         // 直接从池中取到栈的次数
+    size_t miss;        // 池为空, 新映射栈的次数
+    size_t unmap;       // 池满, 解除映射归还物理页的次数
+    size_t count;       // 当前池中栈数
+    size_t nr_used;     // 正在被进程使用的栈数
+    size_t nr_slots;    // 内核栈区的总槽数
+};
+
+void kstack_pool_drain(void);
+void kstack_pool_get_stat(struct kstack_pool_stat *stat);
+
 //FOR LAB6, set the process's priority (bigger value will get more CPU time)
 void lab6_set_priority(uint32_t priority);
 int do_sleep(unsigned int time);
@@ -24,6 +24,13 @@ sys_fork(uint32_t arg[]) {
     return do_fork(0, stack, tf);
 }
 
+static int
+sys_vfork(uint32_t arg[]) {
+    struct trapframe *tf = current->tf;
+    uintptr_t stack = tf->tf_esp;
+    return do_fork(CLONE_VM | CLONE_VFORK, stack, tf);
+}
+
 static int
 sys_wait(uint32_t arg[]) {
     int pid = (int)arg[0];
@@ -150,6 +157,44 @@ sys_getdirentry(uint32_t arg[]) {
     return sysfile_getdirentry(fd, direntp);
 }
 
+static int
+sys_mmap(uint32_t arg[]) {
+    uintptr_t *addr_store = (uintptr_t *)arg[0];
+    size_t len = (size_t)arg[1];
+    uint32_t mmap_flags = (uint32_t)arg[2];
+    int fd = (int)arg[3];
+    off_t offset = (off_t)arg[4];
+    return do_mmap(addr_store, len, mmap_flags, fd, offset);
+}
+
+static int
+sys_munmap(uint32_t arg[]) {
+    uintptr_t addr = (uintptr_t)arg[0];
+    size_t len = (size_t)arg[1];
+    return do_munmap(addr, len);
+}
+
+static int
+sys_shmem(uint32_t arg[]) {
+    const char *name = (const char *)arg[0];
+    size_t len = (size_t)arg[1];
+    uint32_t mmap_flags = (uint32_t)arg[2];
+    uintptr_t *addr_store = (uintptr_t *)arg[3];
+    return do_shmem(name, len, mmap_flags, addr_store);
+}
+
+static int
+sys_brk(uint32_t arg[]) {
+    uintptr_t *brk_store = (uintptr_t *)arg[0];
+    return do_brk(brk_store);
+}
+
+static int
+sys_ksm(uint32_t arg[]) {
+    int op = (int)arg[0];
+    return do_ksm(op);
+}
+
 static int
 sys_dup(uint32_t arg[]) {
     int fd1 = (int)arg[0];
@@ -162,12 +207,18 @@ static int (*syscalls[])(uint32_t arg[]) = {
     [SYS_fork]              sys_fork,
     [SYS_wait]              sys_wait,
     [SYS_exec]              sys_exec,
+    [SYS_vfork]             sys_vfork,
     [SYS_yield]             sys_yield,
     [SYS_kill]              sys_kill,
     [SYS_getpid]            sys_getpid,
     [SYS_putc]              sys_putc,
     [SYS_pgdir]             sys_pgdir,
     [SYS_gettime]           sys_gettime,
+    [SYS_mmap]              sys_mmap,
+    [SYS_munmap]            sys_munmap,
+    [SYS_shmem]             sys_shmem,
+    [SYS_ksm]               sys_ksm,
+    [SYS_brk]               sys_brk,
     [SYS_lab6_set_priority] sys_lab6_set_priority,
     [SYS_sleep]             sys_sleep,
     [SYS_open]              sys_open,
@@ -229,6 +229,31 @@ pgfault_handler(struct trapframe *tf) {
     return do_pgfault(mm, tf->tf_err, rcr2());
 }
 
+/**
+ * 异常表: 内核中可能在访问用户地址时出错的指令 => 出错后转去执行的修复代码(见 kern/mm/uaccess.S).
+ * 由链接脚本收集 __ex_table 段, 表项很少, 顺序查找即可.
+ */
+struct exception_table_entry {
+    uintptr_t insn;
+    uintptr_t fixup;
+};
+
+extern const struct exception_table_entry __EX_TABLE_BEGIN__[];
+extern const struct exception_table_entry __EX_TABLE_END__[];
+
+// fixup_exception - 出错的指令在异常表中时, 修改 tf 使中断返回到修复代码, 返回 1
+static bool
+fixup_exception(struct trapframe *tf) {
+    const struct exception_table_entry *entry;
+    for (entry = __EX_TABLE_BEGIN__; entry < __EX_TABLE_END__; entry ++) {
+        if (entry->insn == tf->tf_eip) {
+            tf->tf_eip = entry->fixup;
+            return 1;
+        }
+    }
+    return 0;
+}
+
 static volatile int in_swap_tick_event = 0;
 extern struct mm_struct *check_mm_struct;
 
@@ -244,6 +269,11 @@ trap_dispatch(struct trapframe *tf) {
     case T_PGFLT:  //page fault
         LOG("内核检测到缺页异常中断.\n");
         if ((ret = pgfault_handler(tf)) != 0) {
+            // 复制用户数据时访问了不合法的用户地址: 转到修复代码, 由复制函数返回错误
+            if (trap_in_kernel(tf) && fixup_exception(tf)) {
+                LOG("pgfault in kernel fixed up, eip = 0x%08x.\n", tf->tf_eip);
+                break;
+            }
             print_trapframe(tf);
             if (current == NULL) {
                 panic("handle pgfault failed. ret=%d\n", ret);
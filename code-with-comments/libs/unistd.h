@@ -9,6 +9,7 @@
 #define SYS_wait            3
 #define SYS_exec            4
 #define SYS_clone           5
+#define SYS_vfork           6
 #define SYS_yield           10
 #define SYS_sleep           11
 #define SYS_kill            12
@@ -17,6 +18,8 @@
 #define SYS_mmap            20
 #define SYS_munmap          21
 #define SYS_shmem           22
+#define SYS_ksm             23
+#define SYS_brk             24
 #define SYS_putc            30
 #define SYS_pgdir           31
 #define SYS_open            100
@@ -36,6 +39,19 @@
 #define CLONE_VM            0x00000100  // set if VM shared between processes
 #define CLONE_THREAD        0x00000200  // thread group
 #define CLONE_FS            0x00000800  // set if shared between processes
+#define CLONE_VFORK         0x00004000  // parent sleeps until the child execs or exits
+
+/* SYS_mmap flags */
+#define MMAP_WRITE          0x00000100  // mapping is writable
+#define MMAP_SHARED         0x00000200  // changes are shared with forked children (and written back to the file)
+
+/* SYS_shmem */
+#define SHMEM_NAME_MAX      31          // max length of a shared memory segment name
+
+/* SYS_ksm operations */
+#define KSM_DISABLE         0           // stop merging pages of the calling process
+#define KSM_ENABLE          1           // merge identical pages of the calling process (inherited by fork)
+#define KSM_SAVED           2           // return the number of pages currently saved by merging
 
 /* VFS flags */
 // flags for open: choose one of these
@@ -45,11 +45,15 @@ static inline uint32_t read_eflags(void) __attribute__((always_inline));
 static inline void write_eflags(uint32_t eflags) __attribute__((always_inline));
 static inline void lcr0(uintptr_t cr0) __attribute__((always_inline));
 static inline void lcr3(uintptr_t cr3) __attribute__((always_inline));
+static inline void lcr4(uintptr_t cr4) __attribute__((always_inline));
 static inline uintptr_t rcr0(void) __attribute__((always_inline));
 static inline uintptr_t rcr1(void) __attribute__((always_inline));
 static inline uintptr_t rcr2(void) __attribute__((always_inline));
 static inline uintptr_t rcr3(void) __attribute__((always_inline));
+static inline uintptr_t rcr4(void) __attribute__((always_inline));
 static inline void invlpg(void *addr) __attribute__((always_inline));
+static inline uint64_t rdtsc(void) __attribute__((always_inline));
+static inline void cpuid(uint32_t info, uint32_t *eaxp, uint32_t *ebxp, uint32_t *ecxp, uint32_t *edxp) __attribute__((always_inline));
 
 // 汇编命令和参考: https://docs.oracle.com/cd/E19455-01/806-3773/6jct9o0aj/index.html
 
@@ -182,6 +186,11 @@ lcr3(uintptr_t cr3) {
     asm volatile ("mov %0, %%cr3" :: "r" (cr3) : "memory");
 }
 
+static inline void
+lcr4(uintptr_t cr4) {
+    asm volatile ("mov %0, %%cr4" :: "r" (cr4) : "memory");
+}
+
 static inline uintptr_t
 rcr0(void) {
     uintptr_t cr0;
@@ -210,11 +219,39 @@ rcr3(void) {
     return cr3;
 }
 
+static inline uintptr_t
+rcr4(void) {
+    uintptr_t cr4;
+    asm volatile ("mov %%cr4, %0" : "=r" (cr4) :: "memory");
+    return cr4;
+}
+
 static inline void
 invlpg(void *addr) {
     asm volatile ("invlpg (%0)" :: "r" (addr) : "memory");
 }
 
+// rdtsc - 读取时间戳计数器(Time Stamp Counter), 用于测量代码片段消耗的 CPU 周期数
+static inline uint64_t
+rdtsc(void) {
+    uint64_t tsc;
+    asm volatile ("rdtsc" : "=A" (tsc));
+    return tsc;
+}
+
+// cpuid - 查询处理器信息, info 为功能号; 不需要的输出传 NULL
+static inline void
+cpuid(uint32_t info, uint32_t *eaxp, uint32_t *ebxp, uint32_t *ecxp, uint32_t *edxp) {
+    uint32_t eax, ebx, ecx, edx;
+    asm volatile ("cpuid"
+            : "=a" (eax), "=b" (ebx), "=c" (ecx), "=d" (edx)
+            : "a" (info));
+    if (eaxp) *eaxp = eax;
+    if (ebxp) *ebxp = ebx;
+    if (ecxp) *ecxp = ecx;
+    if (edxp) *edxp = edx;
+}
+
 static inline int __strcmp(const char *s1, const char *s2) __attribute__((always_inline));
 static inline char *__strcpy(char *dst, const char *src) __attribute__((always_inline));
 static inline void *__memset(void *s, char c, size_t n) __attribute__((always_inline));
@@ -0,0 +1,4302 @@
+
+obj/__user_badarg.out:     file format elf32-i386
+
+
+Disassembly of section .text:
+
+00800020 <opendir>:
+
+DIR dir, *dirp=&dir;
+
+// path -- > DIR
+DIR *
+opendir(const char *path) {
+  800020:	55                   	push   %ebp
+  800021:	89 e5                	mov    %esp,%ebp
+  800023:	53                   	push   %ebx
+  800024:	83 ec 24             	sub    $0x24,%esp
+
+    if ((dirp->fd = open(path, O_RDONLY)) < 0) {
+  800027:	8b 1d 00 30 80 00    	mov    0x803000,%ebx
+  80002d:	83 ec 08             	sub    $0x8,%esp
+  800030:	6a 00                	push   $0x0
+  800032:	ff 75 08             	push   0x8(%ebp)
+  800035:	e8 c1 00 00 00       	call   8000fb <open>
+  80003a:	83 c4 10             	add    $0x10,%esp
+  80003d:	89 03                	mov    %eax,(%ebx)
+  80003f:	8b 03                	mov    (%ebx),%eax
+  800041:	85 c0                	test   %eax,%eax
+  800043:	78 44                	js     800089 <opendir+0x69>
+        goto failed;
+    }
+    struct stat __stat, *stat = &__stat;
+  800045:	8d 45 e4             	lea    -0x1c(%ebp),%eax
+  800048:	89 45 f4             	mov    %eax,-0xc(%ebp)
+    if (fstat(dirp->fd, stat) != 0 || !S_ISDIR(stat->st_mode)) {
+  80004b:	a1 00 30 80 00       	mov    0x803000,%eax
+  800050:	8b 00                	mov    (%eax),%eax
+  800052:	83 ec 08             	sub    $0x8,%esp
+  800055:	ff 75 f4             	push   -0xc(%ebp)
+  800058:	50                   	push   %eax
+  800059:	e8 20 01 00 00       	call   80017e <fstat>
+  80005e:	83 c4 10             	add    $0x10,%esp
+  800061:	85 c0                	test   %eax,%eax
+  800063:	75 27                	jne    80008c <opendir+0x6c>
+  800065:	8b 45 f4             	mov    -0xc(%ebp),%eax
+  800068:	8b 00                	mov    (%eax),%eax
+  80006a:	25 00 70 00 00       	and    $0x7000,%eax
+  80006f:	3d 00 20 00 00       	cmp    $0x2000,%eax
+  800074:	75 16                	jne    80008c <opendir+0x6c>
+        goto failed;
+    }
+    dirp->dirent.offset = 0;
+  800076:	a1 00 30 80 00       	mov    0x803000,%eax
+  80007b:	c7 40 04 00 00 00 00 	movl   $0x0,0x4(%eax)
+    return dirp;
+  800082:	a1 00 30 80 00       	mov    0x803000,%eax
+  800087:	eb 09                	jmp    800092 <opendir+0x72>
+        goto failed;
+  800089:	90                   	nop
+  80008a:	eb 01                	jmp    80008d <opendir+0x6d>
+        goto failed;
+  80008c:	90                   	nop
+
+failed:
+    return NULL;
+  80008d:	b8 00 00 00 00       	mov    $0x0,%eax
+}
+  800092:	8b 5d fc             	mov    -0x4(%ebp),%ebx
+  800095:	c9                   	leave
+  800096:	c3                   	ret
+
+00800097 <readdir>:
+
+struct dirent *
+readdir(DIR *dirp) {
+  800097:	55                   	push   %ebp
+  800098:	89 e5                	mov    %esp,%ebp
+  80009a:	83 ec 08             	sub    $0x8,%esp
+    if (sys_getdirentry(dirp->fd, &(dirp->dirent)) == 0) {
+  80009d:	8b 45 08             	mov    0x8(%ebp),%eax
+  8000a0:	8d 50 04             	lea    0x4(%eax),%edx
+  8000a3:	8b 45 08             	mov    0x8(%ebp),%eax
+  8000a6:	8b 00                	mov    (%eax),%eax
+  8000a8:	83 ec 08             	sub    $0x8,%esp
+  8000ab:	52                   	push   %edx
+  8000ac:	50                   	push   %eax
+  8000ad:	e8 57 0b 00 00       	call   800c09 <sys_getdirentry>
+  8000b2:	83 c4 10             	add    $0x10,%esp
+  8000b5:	85 c0                	test   %eax,%eax
+  8000b7:	75 08                	jne    8000c1 <readdir+0x2a>
+        return &(dirp->dirent);
+  8000b9:	8b 45 08             	mov    0x8(%ebp),%eax
+  8000bc:	83 c0 04             	add    $0x4,%eax
+  8000bf:	eb 05                	jmp    8000c6 <readdir+0x2f>
+    }
+    return NULL;
+  8000c1:	b8 00 00 00 00       	mov    $0x0,%eax
+}
+  8000c6:	c9                   	leave
+  8000c7:	c3                   	ret
+
+008000c8 <closedir>:
+
+void
+closedir(DIR *dirp) {
+  8000c8:	55                   	push   %ebp
+  8000c9:	89 e5                	mov    %esp,%ebp
+  8000cb:	83 ec 08             	sub    $0x8,%esp
+    close(dirp->fd);
+  8000ce:	8b 45 08             	mov    0x8(%ebp),%eax
+  8000d1:	8b 00                	mov    (%eax),%eax
+  8000d3:	83 ec 0c             	sub    $0xc,%esp
+  8000d6:	50                   	push   %eax
+  8000d7:	e8 38 00 00 00       	call   800114 <close>
+  8000dc:	83 c4 10             	add    $0x10,%esp
+}
+  8000df:	90                   	nop
+  8000e0:	c9                   	leave
+  8000e1:	c3                   	ret
+
+008000e2 <getcwd>:
+
+int
+getcwd(char *buffer, size_t len) {
+  8000e2:	55                   	push   %ebp
+  8000e3:	89 e5                	mov    %esp,%ebp
+  8000e5:	83 ec 08             	sub    $0x8,%esp
+    return sys_getcwd(buffer, len);
+  8000e8:	83 ec 08             	sub    $0x8,%esp
+  8000eb:	ff 75 0c             	push   0xc(%ebp)
+  8000ee:	ff 75 08             	push   0x8(%ebp)
+  8000f1:	e8 fe 0a 00 00       	call   800bf4 <sys_getcwd>
+  8000f6:	83 c4 10             	add    $0x10,%esp
+}
+  8000f9:	c9                   	leave
+  8000fa:	c3                   	ret
+
+008000fb <open>:
+#include <stat.h>
+#include <error.h>
+#include <unistd.h>
+
+int
+open(const char *path, uint32_t open_flags) {
+  8000fb:	55                   	push   %ebp
+  8000fc:	89 e5                	mov    %esp,%ebp
+  8000fe:	83 ec 08             	sub    $0x8,%esp
+    return sys_open(path, open_flags);
+  800101:	83 ec 08             	sub    $0x8,%esp
+  800104:	ff 75 0c             	push   0xc(%ebp)
+  800107:	ff 75 08             	push   0x8(%ebp)
+  80010a:	e8 4f 0a 00 00       	call   800b5e <sys_open>
+  80010f:	83 c4 10             	add    $0x10,%esp
+}
+  800112:	c9                   	leave
+  800113:	c3                   	ret
+
+00800114 <close>:
+
+int
+close(int fd) {
+  800114:	55                   	push   %ebp
+  800115:	89 e5                	mov    %esp,%ebp
+  800117:	83 ec 08             	sub    $0x8,%esp
+    return sys_close(fd);
+  80011a:	83 ec 0c             	sub    $0xc,%esp
+  80011d:	ff 75 08             	push   0x8(%ebp)
+  800120:	e8 4e 0a 00 00       	call   800b73 <sys_close>
+  800125:	83 c4 10             	add    $0x10,%esp
+}
+  800128:	c9                   	leave
+  800129:	c3                   	ret
+
+0080012a <read>:
+
+/**
+ * 从 fd 读取len 个字节到 base
+ */ 
+int
+read(int fd, void *base, size_t len) {
+  80012a:	55                   	push   %ebp
+  80012b:	89 e5                	mov    %esp,%ebp
+  80012d:	83 ec 08             	sub    $0x8,%esp
+    return sys_read(fd, base, len);
+  800130:	83 ec 04             	sub    $0x4,%esp
+  800133:	ff 75 10             	push   0x10(%ebp)
+  800136:	ff 75 0c             	push   0xc(%ebp)
+  800139:	ff 75 08             	push   0x8(%ebp)
+  80013c:	e8 44 0a 00 00       	call   800b85 <sys_read>
+  800141:	83 c4 10             	add    $0x10,%esp
+}
+  800144:	c9                   	leave
+  800145:	c3                   	ret
+
+00800146 <write>:
+
+int
+write(int fd, void *base, size_t len) {
+  800146:	55                   	push   %ebp
+  800147:	89 e5                	mov    %esp,%ebp
+  800149:	83 ec 08             	sub    $0x8,%esp
+    return sys_write(fd, base, len);
+  80014c:	83 ec 04             	sub    $0x4,%esp
+  80014f:	ff 75 10             	push   0x10(%ebp)
+  800152:	ff 75 0c             	push   0xc(%ebp)
+  800155:	ff 75 08             	push   0x8(%ebp)
+  800158:	e8 40 0a 00 00       	call   800b9d <sys_write>
+  80015d:	83 c4 10             	add    $0x10,%esp
+}
+  800160:	c9                   	leave
+  800161:	c3                   	ret
+
+00800162 <seek>:
+
+int
+seek(int fd, off_t pos, int whence) {
+  800162:	55                   	push   %ebp
+  800163:	89 e5                	mov    %esp,%ebp
+  800165:	83 ec 08             	sub    $0x8,%esp
+    return sys_seek(fd, pos, whence);
+  800168:	83 ec 04             	sub    $0x4,%esp
+  80016b:	ff 75 10             	push   0x10(%ebp)
+  80016e:	ff 75 0c             	push   0xc(%ebp)
+  800171:	ff 75 08             	push   0x8(%ebp)
+  800174:	e8 3c 0a 00 00       	call   800bb5 <sys_seek>
+  800179:	83 c4 10             	add    $0x10,%esp
+}
+  80017c:	c9                   	leave
+  80017d:	c3                   	ret
+
+0080017e <fstat>:
+
+int
+fstat(int fd, struct stat *stat) {
+  80017e:	55                   	push   %ebp
+  80017f:	89 e5                	mov    %esp,%ebp
+  800181:	83 ec 08             	sub    $0x8,%esp
+    return sys_fstat(fd, stat);
+  800184:	83 ec 08             	sub    $0x8,%esp
+  800187:	ff 75 0c             	push   0xc(%ebp)
+  80018a:	ff 75 08             	push   0x8(%ebp)
+  80018d:	e8 3b 0a 00 00       	call   800bcd <sys_fstat>
+  800192:	83 c4 10             	add    $0x10,%esp
+}
+  800195:	c9                   	leave
+  800196:	c3                   	ret
+
+00800197 <fsync>:
+
+int
+fsync(int fd) {
+  800197:	55                   	push   %ebp
+  800198:	89 e5                	mov    %esp,%ebp
+  80019a:	83 ec 08             	sub    $0x8,%esp
+    return sys_fsync(fd);
+  80019d:	83 ec 0c             	sub    $0xc,%esp
+  8001a0:	ff 75 08             	push   0x8(%ebp)
+  8001a3:	e8 3a 0a 00 00       	call   800be2 <sys_fsync>
+  8001a8:	83 c4 10             	add    $0x10,%esp
+}
+  8001ab:	c9                   	leave
+  8001ac:	c3                   	ret
+
+008001ad <dup2>:
+
+int
+dup2(int fd1, int fd2) {
+  8001ad:	55                   	push   %ebp
+  8001ae:	89 e5                	mov    %esp,%ebp
+  8001b0:	83 ec 08             	sub    $0x8,%esp
+    return sys_dup(fd1, fd2);
+  8001b3:	83 ec 08             	sub    $0x8,%esp
+  8001b6:	ff 75 0c             	push   0xc(%ebp)
+  8001b9:	ff 75 08             	push   0x8(%ebp)
+  8001bc:	e8 60 0a 00 00       	call   800c21 <sys_dup>
+  8001c1:	83 c4 10             	add    $0x10,%esp
+}
+  8001c4:	c9                   	leave
+  8001c5:	c3                   	ret
+
+008001c6 <transmode>:
+
+static char
+transmode(struct stat *stat) {
+  8001c6:	55                   	push   %ebp
+  8001c7:	89 e5                	mov    %esp,%ebp
+  8001c9:	83 ec 10             	sub    $0x10,%esp
+    uint32_t mode = stat->st_mode;
+  8001cc:	8b 45 08             	mov    0x8(%ebp),%eax
+  8001cf:	8b 00                	mov    (%eax),%eax
+  8001d1:	89 45 fc             	mov    %eax,-0x4(%ebp)
+    if (S_ISREG(mode)) return 'r';
+  8001d4:	8b 45 fc             	mov    -0x4(%ebp),%eax
+  8001d7:	25 00 70 00 00       	and    $0x7000,%eax
+  8001dc:	3d 00 10 00 00       	cmp    $0x1000,%eax
+  8001e1:	75 07                	jne    8001ea <transmode+0x24>
+  8001e3:	b8 72 00 00 00       	mov    $0x72,%eax
+  8001e8:	eb 5d                	jmp    800247 <transmode+0x81>
+    if (S_ISDIR(mode)) return 'd';
+  8001ea:	8b 45 fc             	mov    -0x4(%ebp),%eax
+  8001ed:	25 00 70 00 00       	and    $0x7000,%eax
+  8001f2:	3d 00 20 00 00       	cmp    $0x2000,%eax
+  8001f7:	75 07                	jne    800200 <transmode+0x3a>
+  8001f9:	b8 64 00 00 00       	mov    $0x64,%eax
+  8001fe:	eb 47                	jmp    800247 <transmode+0x81>
+    if (S_ISLNK(mode)) return 'l';
+  800200:	8b 45 fc             	mov    -0x4(%ebp),%eax
+  800203:	25 00 70 00 00       	and    $0x7000,%eax
+  800208:	3d 00 30 00 00       	cmp    $0x3000,%eax
+  80020d:	75 07                	jne    800216 <transmode+0x50>
+  80020f:	b8 6c 00 00 00       	mov    $0x6c,%eax
+  800214:	eb 31                	jmp    800247 <transmode+0x81>
+    if (S_ISCHR(mode)) return 'c';
+  800216:	8b 45 fc             	mov    -0x4(%ebp),%eax
+  800219:	25 00 70 00 00       	and    $0x7000,%eax
+  80021e:	3d 00 40 00 00       	cmp    $0x4000,%eax
+  800223:	75 07                	jne    80022c <transmode+0x66>
+  800225:	b8 63 00 00 00       	mov    $0x63,%eax
+  80022a:	eb 1b                	jmp    800247 <transmode+0x81>
+    if (S_ISBLK(mode)) return 'b';
+  80022c:	8b 45 fc             	mov    -0x4(%ebp),%eax
+  80022f:	25 00 70 00 00       	and    $0x7000,%eax
+  800234:	3d 00 50 00 00       	cmp    $0x5000,%eax
+  800239:	75 07                	jne    800242 <transmode+0x7c>
+  80023b:	b8 62 00 00 00       	mov    $0x62,%eax
+  800240:	eb 05                	jmp    800247 <transmode+0x81>
+    return '-';
+  800242:	b8 2d 00 00 00       	mov    $0x2d,%eax
+}
+  800247:	c9                   	leave
+  800248:	c3                   	ret
+
+00800249 <print_stat>:
+
+void
+print_stat(const char *name, int fd, struct stat *stat) {
+  800249:	55                   	push   %ebp
+  80024a:	89 e5                	mov    %esp,%ebp
+  80024c:	83 ec 08             	sub    $0x8,%esp
+    cprintf("[%03d] %s\n", fd, name);
+  80024f:	83 ec 04             	sub    $0x4,%esp
+  800252:	ff 75 08             	push   0x8(%ebp)
+  800255:	ff 75 0c             	push   0xc(%ebp)
+  800258:	68 40 1d 80 00       	push   $0x801d40
+  80025d:	e8 62 06 00 00       	call   8008c4 <cprintf>
+  800262:	83 c4 10             	add    $0x10,%esp
+    cprintf("    mode    : %c\n", transmode(stat));
+  800265:	83 ec 0c             	sub    $0xc,%esp
+  800268:	ff 75 10             	push   0x10(%ebp)
+  80026b:	e8 56 ff ff ff       	call   8001c6 <transmode>
+  800270:	83 c4 10             	add    $0x10,%esp
+  800273:	0f be c0             	movsbl %al,%eax
+  800276:	83 ec 08             	sub    $0x8,%esp
+  800279:	50                   	push   %eax
+  80027a:	68 4b 1d 80 00       	push   $0x801d4b
+  80027f:	e8 40 06 00 00       	call   8008c4 <cprintf>
+  800284:	83 c4 10             	add    $0x10,%esp
+    cprintf("    links   : %lu\n", stat->st_nlinks);
+  800287:	8b 45 10             	mov    0x10(%ebp),%eax
+  80028a:	8b 40 04             	mov    0x4(%eax),%eax
+  80028d:	83 ec 08             	sub    $0x8,%esp
+  800290:	50                   	push   %eax
+  800291:	68 5d 1d 80 00       	push   $0x801d5d
+  800296:	e8 29 06 00 00       	call   8008c4 <cprintf>
+  80029b:	83 c4 10             	add    $0x10,%esp
+    cprintf("    blocks  : %lu\n", stat->st_blocks);
+  80029e:	8b 45 10             	mov    0x10(%ebp),%eax
+  8002a1:	8b 40 08             	mov    0x8(%eax),%eax
+  8002a4:	83 ec 08             	sub    $0x8,%esp
+  8002a7:	50                   	push   %eax
+  8002a8:	68 70 1d 80 00       	push   $0x801d70
+  8002ad:	e8 12 06 00 00       	call   8008c4 <cprintf>
+  8002b2:	83 c4 10             	add    $0x10,%esp
+    cprintf("    size    : %lu\n", stat->st_size);
+  8002b5:	8b 45 10             	mov    0x10(%ebp),%eax
+  8002b8:	8b 40 0c             	mov    0xc(%eax),%eax
+  8002bb:	83 ec 08             	sub    $0x8,%esp
+  8002be:	50                   	push   %eax
+  8002bf:	68 83 1d 80 00       	push   $0x801d83
+  8002c4:	e8 fb 05 00 00       	call   8008c4 <cprintf>
+  8002c9:	83 c4 10             	add    $0x10,%esp
+}
+  8002cc:	90                   	nop
+  8002cd:	c9                   	leave
+  8002ce:	c3                   	ret
+
+008002cf <_start>:
+.text
+.globl _start
+_start:
+    # set ebp for backtrace
+    movl $0x0, %ebp
+  8002cf:	bd 00 00 00 00       	mov    $0x0,%ebp
+
+    # load argc and argv
+    movl (%esp), %ebx
+  8002d4:	8b 1c 24             	mov    (%esp),%ebx
+    lea 0x4(%esp), %ecx
+  8002d7:	8d 4c 24 04          	lea    0x4(%esp),%ecx
+
+
+    # move down the esp register
+    # since it may cause page fault in backtrace
+    subl $0x20, %esp
+  8002db:	83 ec 20             	sub    $0x20,%esp
+
+    # save argc and argv on stack
+    pushl %ecx
+  8002de:	51                   	push   %ecx
+    pushl %ebx
+  8002df:	53                   	push   %ebx
+
+    # call user-program function
+    call umain
+  8002e0:	e8 81 0c 00 00       	call   800f66 <umain>
+1:  jmp 1b
+  8002e5:	eb fe                	jmp    8002e5 <_start+0x16>
+
+008002e7 <size_class>:
+static header_t *free_list[NCLASS];
+static header_t *large_list;
+static char *arena_ptr, *arena_end;
+
+static int
+size_class(size_t size) {
+  8002e7:	55                   	push   %ebp
+  8002e8:	89 e5                	mov    %esp,%ebp
+  8002ea:	83 ec 10             	sub    $0x10,%esp
+    int c = 0;
+  8002ed:	c7 45 fc 00 00 00 00 	movl   $0x0,-0x4(%ebp)
+    while (class_size(c) < size) {
+  8002f4:	eb 04                	jmp    8002fa <size_class+0x13>
+        c ++;
+  8002f6:	83 45 fc 01          	addl   $0x1,-0x4(%ebp)
+    while (class_size(c) < size) {
+  8002fa:	8b 45 fc             	mov    -0x4(%ebp),%eax
+  8002fd:	83 c0 04             	add    $0x4,%eax
+  800300:	ba 01 00 00 00       	mov    $0x1,%edx
+  800305:	89 c1                	mov    %eax,%ecx
+  800307:	d3 e2                	shl    %cl,%edx
+  800309:	89 d0                	mov    %edx,%eax
+  80030b:	3b 45 08             	cmp    0x8(%ebp),%eax
+  80030e:	72 e6                	jb     8002f6 <size_class+0xf>
+    }
+    return c;
+  800310:	8b 45 fc             	mov    -0x4(%ebp),%eax
+}
+  800313:	c9                   	leave
+  800314:	c3                   	ret
+
+00800315 <push_free>:
+
+static void
+push_free(header_t *h, int c) {
+  800315:	55                   	push   %ebp
+  800316:	89 e5                	mov    %esp,%ebp
+    h->s.size = class_size(c);
+  800318:	8b 45 0c             	mov    0xc(%ebp),%eax
+  80031b:	83 c0 04             	add    $0x4,%eax
+  80031e:	ba 01 00 00 00       	mov    $0x1,%edx
+  800323:	89 c1                	mov    %eax,%ecx
+  800325:	d3 e2                	shl    %cl,%edx
+  800327:	89 d0                	mov    %edx,%eax
+  800329:	89 c2                	mov    %eax,%edx
+  80032b:	8b 45 08             	mov    0x8(%ebp),%eax
+  80032e:	89 10                	mov    %edx,(%eax)
+    h->s.next = free_list[c];
+  800330:	8b 45 0c             	mov    0xc(%ebp),%eax
+  800333:	8b 14 85 40 31 80 00 	mov    0x803140(,%eax,4),%edx
+  80033a:	8b 45 08             	mov    0x8(%ebp),%eax
+  80033d:	89 50 04             	mov    %edx,0x4(%eax)
+    free_list[c] = h;
+  800340:	8b 45 0c             	mov    0xc(%ebp),%eax
+  800343:	8b 55 08             	mov    0x8(%ebp),%edx
+  800346:	89 14 85 40 31 80 00 	mov    %edx,0x803140(,%eax,4)
+}
+  80034d:	90                   	nop
+  80034e:	5d                   	pop    %ebp
+  80034f:	c3                   	ret
+
+00800350 <small_alloc>:
+
+// 小块: 优先取空闲链表, 否则从 arena 中切出
+static header_t *
+small_alloc(int c) {
+  800350:	55                   	push   %ebp
+  800351:	89 e5                	mov    %esp,%ebp
+  800353:	53                   	push   %ebx
+  800354:	83 ec 14             	sub    $0x14,%esp
+    header_t *h;
+    if ((h = free_list[c]) != NULL) {
+  800357:	8b 45 08             	mov    0x8(%ebp),%eax
+  80035a:	8b 04 85 40 31 80 00 	mov    0x803140(,%eax,4),%eax
+  800361:	89 45 f0             	mov    %eax,-0x10(%ebp)
+  800364:	83 7d f0 00          	cmpl   $0x0,-0x10(%ebp)
+  800368:	74 18                	je     800382 <small_alloc+0x32>
+        free_list[c] = h->s.next;
+  80036a:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  80036d:	8b 50 04             	mov    0x4(%eax),%edx
+  800370:	8b 45 08             	mov    0x8(%ebp),%eax
+  800373:	89 14 85 40 31 80 00 	mov    %edx,0x803140(,%eax,4)
+        return h;
+  80037a:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  80037d:	e9 e7 00 00 00       	jmp    800469 <small_alloc+0x119>
+    }
+    size_t size = class_size(c);
+  800382:	8b 45 08             	mov    0x8(%ebp),%eax
+  800385:	83 c0 04             	add    $0x4,%eax
+  800388:	ba 01 00 00 00       	mov    $0x1,%edx
+  80038d:	89 c1                	mov    %eax,%ecx
+  80038f:	d3 e2                	shl    %cl,%edx
+  800391:	89 d0                	mov    %edx,%eax
+  800393:	89 45 ec             	mov    %eax,-0x14(%ebp)
+    if (arena_end - arena_ptr < size) {
+  800396:	8b 15 68 31 80 00    	mov    0x803168,%edx
+  80039c:	a1 64 31 80 00       	mov    0x803164,%eax
+  8003a1:	29 c2                	sub    %eax,%edx
+  8003a3:	89 d0                	mov    %edx,%eax
+  8003a5:	3b 45 ec             	cmp    -0x14(%ebp),%eax
+  8003a8:	0f 83 98 00 00 00    	jae    800446 <small_alloc+0xf6>
+        // arena 剩下的部分总是 16 字节的整数倍, 可以完全切成各类的块
+        int i;
+        for (i = NCLASS - 1; i >= 0; i --) {
+  8003ae:	c7 45 f4 07 00 00 00 	movl   $0x7,-0xc(%ebp)
+  8003b5:	eb 54                	jmp    80040b <small_alloc+0xbb>
+            while (arena_end - arena_ptr >= class_size(i)) {
+                push_free((header_t *)arena_ptr, i);
+  8003b7:	a1 64 31 80 00       	mov    0x803164,%eax
+  8003bc:	ff 75 f4             	push   -0xc(%ebp)
+  8003bf:	50                   	push   %eax
+  8003c0:	e8 50 ff ff ff       	call   800315 <push_free>
+  8003c5:	83 c4 08             	add    $0x8,%esp
+                arena_ptr += class_size(i);
+  8003c8:	a1 64 31 80 00       	mov    0x803164,%eax
+  8003cd:	8b 55 f4             	mov    -0xc(%ebp),%edx
+  8003d0:	83 c2 04             	add    $0x4,%edx
+  8003d3:	bb 01 00 00 00       	mov    $0x1,%ebx
+  8003d8:	89 d1                	mov    %edx,%ecx
+  8003da:	d3 e3                	shl    %cl,%ebx
+  8003dc:	89 da                	mov    %ebx,%edx
+  8003de:	01 d0                	add    %edx,%eax
+  8003e0:	a3 64 31 80 00       	mov    %eax,0x803164
+            while (arena_end - arena_ptr >= class_size(i)) {
+  8003e5:	8b 15 68 31 80 00    	mov    0x803168,%edx
+  8003eb:	a1 64 31 80 00       	mov    0x803164,%eax
+  8003f0:	29 c2                	sub    %eax,%edx
+  8003f2:	8b 45 f4             	mov    -0xc(%ebp),%eax
+  8003f5:	83 c0 04             	add    $0x4,%eax
+  8003f8:	bb 01 00 00 00       	mov    $0x1,%ebx
+  8003fd:	89 c1                	mov    %eax,%ecx
+  8003ff:	d3 e3                	shl    %cl,%ebx
+  800401:	89 d8                	mov    %ebx,%eax
+  800403:	39 c2                	cmp    %eax,%edx
+  800405:	7d b0                	jge    8003b7 <small_alloc+0x67>
+        for (i = NCLASS - 1; i >= 0; i --) {
+  800407:	83 6d f4 01          	subl   $0x1,-0xc(%ebp)
+  80040b:	83 7d f4 00          	cmpl   $0x0,-0xc(%ebp)
+  80040f:	79 d4                	jns    8003e5 <small_alloc+0x95>
+            }
+        }
+        char *p = sbrk(ARENA_SIZE);
+  800411:	83 ec 0c             	sub    $0xc,%esp
+  800414:	68 00 40 00 00       	push   $0x4000
+  800419:	e8 3b 0a 00 00       	call   800e59 <sbrk>
+  80041e:	83 c4 10             	add    $0x10,%esp
+  800421:	89 45 e8             	mov    %eax,-0x18(%ebp)
+        if (p == (char *)-1) {
+  800424:	83 7d e8 ff          	cmpl   $0xffffffff,-0x18(%ebp)
+  800428:	75 07                	jne    800431 <small_alloc+0xe1>
+            return NULL;
+  80042a:	b8 00 00 00 00       	mov    $0x0,%eax
+  80042f:	eb 38                	jmp    800469 <small_alloc+0x119>
+        }
+        arena_ptr = p, arena_end = p + ARENA_SIZE;
+  800431:	8b 45 e8             	mov    -0x18(%ebp),%eax
+  800434:	a3 64 31 80 00       	mov    %eax,0x803164
+  800439:	8b 45 e8             	mov    -0x18(%ebp),%eax
+  80043c:	05 00 40 00 00       	add    $0x4000,%eax
+  800441:	a3 68 31 80 00       	mov    %eax,0x803168
+    }
+    h = (header_t *)arena_ptr;
+  800446:	a1 64 31 80 00       	mov    0x803164,%eax
+  80044b:	89 45 f0             	mov    %eax,-0x10(%ebp)
+    arena_ptr += size;
+  80044e:	8b 15 64 31 80 00    	mov    0x803164,%edx
+  800454:	8b 45 ec             	mov    -0x14(%ebp),%eax
+  800457:	01 d0                	add    %edx,%eax
+  800459:	a3 64 31 80 00       	mov    %eax,0x803164
+    h->s.size = size;
+  80045e:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  800461:	8b 55 ec             	mov    -0x14(%ebp),%edx
+  800464:	89 10                	mov    %edx,(%eax)
+    return h;
+  800466:	8b 45 f0             	mov    -0x10(%ebp),%eax
+}
+  800469:	8b 5d fc             	mov    -0x4(%ebp),%ebx
+  80046c:	c9                   	leave
+  80046d:	c3                   	ret
+
+0080046e <large_alloc>:
+
+// 大块: 首次适配复用空闲的大块, 没有则扩展堆
+static header_t *
+large_alloc(size_t size) {
+  80046e:	55                   	push   %ebp
+  80046f:	89 e5                	mov    %esp,%ebp
+  800471:	83 ec 18             	sub    $0x18,%esp
+    header_t **pp, *h;
+    for (pp = &large_list; (h = *pp) != NULL; pp = &(h->s.next)) {
+  800474:	c7 45 f4 60 31 80 00 	movl   $0x803160,-0xc(%ebp)
+  80047b:	eb 63                	jmp    8004e0 <large_alloc+0x72>
+        if (h->s.size >= size) {
+  80047d:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  800480:	8b 00                	mov    (%eax),%eax
+  800482:	3b 45 08             	cmp    0x8(%ebp),%eax
+  800485:	72 50                	jb     8004d7 <large_alloc+0x69>
+            *pp = h->s.next;
+  800487:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  80048a:	8b 50 04             	mov    0x4(%eax),%edx
+  80048d:	8b 45 f4             	mov    -0xc(%ebp),%eax
+  800490:	89 10                	mov    %edx,(%eax)
+            if (h->s.size > size) {
+  800492:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  800495:	8b 00                	mov    (%eax),%eax
+  800497:	39 45 08             	cmp    %eax,0x8(%ebp)
+  80049a:	73 36                	jae    8004d2 <large_alloc+0x64>
+                header_t *rest = (header_t *)((char *)h + size);
+  80049c:	8b 55 f0             	mov    -0x10(%ebp),%edx
+  80049f:	8b 45 08             	mov    0x8(%ebp),%eax
+  8004a2:	01 d0                	add    %edx,%eax
+  8004a4:	89 45 e8             	mov    %eax,-0x18(%ebp)
+                rest->s.size = h->s.size - size;
+  8004a7:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  8004aa:	8b 00                	mov    (%eax),%eax
+  8004ac:	2b 45 08             	sub    0x8(%ebp),%eax
+  8004af:	89 c2                	mov    %eax,%edx
+  8004b1:	8b 45 e8             	mov    -0x18(%ebp),%eax
+  8004b4:	89 10                	mov    %edx,(%eax)
+                rest->s.next = large_list;
+  8004b6:	8b 15 60 31 80 00    	mov    0x803160,%edx
+  8004bc:	8b 45 e8             	mov    -0x18(%ebp),%eax
+  8004bf:	89 50 04             	mov    %edx,0x4(%eax)
+                large_list = rest;
+  8004c2:	8b 45 e8             	mov    -0x18(%ebp),%eax
+  8004c5:	a3 60 31 80 00       	mov    %eax,0x803160
+                h->s.size = size;
+  8004ca:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  8004cd:	8b 55 08             	mov    0x8(%ebp),%edx
+  8004d0:	89 10                	mov    %edx,(%eax)
+            }
+            return h;
+  8004d2:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  8004d5:	eb 47                	jmp    80051e <large_alloc+0xb0>
+    for (pp = &large_list; (h = *pp) != NULL; pp = &(h->s.next)) {
+  8004d7:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  8004da:	83 c0 04             	add    $0x4,%eax
+  8004dd:	89 45 f4             	mov    %eax,-0xc(%ebp)
+  8004e0:	8b 45 f4             	mov    -0xc(%ebp),%eax
+  8004e3:	8b 00                	mov    (%eax),%eax
+  8004e5:	89 45 f0             	mov    %eax,-0x10(%ebp)
+  8004e8:	83 7d f0 00          	cmpl   $0x0,-0x10(%ebp)
+  8004ec:	75 8f                	jne    80047d <large_alloc+0xf>
+        }
+    }
+    char *p = sbrk(size);
+  8004ee:	8b 45 08             	mov    0x8(%ebp),%eax
+  8004f1:	83 ec 0c             	sub    $0xc,%esp
+  8004f4:	50                   	push   %eax
+  8004f5:	e8 5f 09 00 00       	call   800e59 <sbrk>
+  8004fa:	83 c4 10             	add    $0x10,%esp
+  8004fd:	89 45 ec             	mov    %eax,-0x14(%ebp)
+    if (p == (char *)-1) {
+  800500:	83 7d ec ff          	cmpl   $0xffffffff,-0x14(%ebp)
+  800504:	75 07                	jne    80050d <large_alloc+0x9f>
+        return NULL;
+  800506:	b8 00 00 00 00       	mov    $0x0,%eax
+  80050b:	eb 11                	jmp    80051e <large_alloc+0xb0>
+    }
+    h = (header_t *)p;
+  80050d:	8b 45 ec             	mov    -0x14(%ebp),%eax
+  800510:	89 45 f0             	mov    %eax,-0x10(%ebp)
+    h->s.size = size;
+  800513:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  800516:	8b 55 08             	mov    0x8(%ebp),%edx
+  800519:	89 10                	mov    %edx,(%eax)
+    return h;
+  80051b:	8b 45 f0             	mov    -0x10(%ebp),%eax
+}
+  80051e:	c9                   	leave
+  80051f:	c3                   	ret
+
+00800520 <large_trim>:
+
+// 把位于堆顶的空闲大块交还给内核, 直到堆顶不再是空闲的大块
+static void
+large_trim(void) {
+  800520:	55                   	push   %ebp
+  800521:	89 e5                	mov    %esp,%ebp
+  800523:	83 ec 18             	sub    $0x18,%esp
+    header_t **pp, *h;
+    char *top = sbrk(0);
+  800526:	83 ec 0c             	sub    $0xc,%esp
+  800529:	6a 00                	push   $0x0
+  80052b:	e8 29 09 00 00       	call   800e59 <sbrk>
+  800530:	83 c4 10             	add    $0x10,%esp
+  800533:	89 45 f0             	mov    %eax,-0x10(%ebp)
+    for (pp = &large_list; (h = *pp) != NULL; ) {
+  800536:	c7 45 f4 60 31 80 00 	movl   $0x803160,-0xc(%ebp)
+  80053d:	eb 4a                	jmp    800589 <large_trim+0x69>
+        if ((char *)h + h->s.size == top) {
+  80053f:	8b 45 ec             	mov    -0x14(%ebp),%eax
+  800542:	8b 10                	mov    (%eax),%edx
+  800544:	8b 45 ec             	mov    -0x14(%ebp),%eax
+  800547:	01 d0                	add    %edx,%eax
+  800549:	39 45 f0             	cmp    %eax,-0x10(%ebp)
+  80054c:	75 32                	jne    800580 <large_trim+0x60>
+            *pp = h->s.next;
+  80054e:	8b 45 ec             	mov    -0x14(%ebp),%eax
+  800551:	8b 50 04             	mov    0x4(%eax),%edx
+  800554:	8b 45 f4             	mov    -0xc(%ebp),%eax
+  800557:	89 10                	mov    %edx,(%eax)
+            if (sbrk(-(intptr_t)h->s.size) == (char *)-1) {
+  800559:	8b 45 ec             	mov    -0x14(%ebp),%eax
+  80055c:	8b 00                	mov    (%eax),%eax
+  80055e:	f7 d8                	neg    %eax
+  800560:	83 ec 0c             	sub    $0xc,%esp
+  800563:	50                   	push   %eax
+  800564:	e8 f0 08 00 00       	call   800e59 <sbrk>
+  800569:	83 c4 10             	add    $0x10,%esp
+  80056c:	83 f8 ff             	cmp    $0xffffffff,%eax
+  80056f:	74 28                	je     800599 <large_trim+0x79>
+                return ;
+            }
+            top = (char *)h;
+  800571:	8b 45 ec             	mov    -0x14(%ebp),%eax
+  800574:	89 45 f0             	mov    %eax,-0x10(%ebp)
+            pp = &large_list;   // 新的堆顶之下可能还有空闲的大块
+  800577:	c7 45 f4 60 31 80 00 	movl   $0x803160,-0xc(%ebp)
+            continue;
+  80057e:	eb 09                	jmp    800589 <large_trim+0x69>
+        }
+        pp = &(h->s.next);
+  800580:	8b 45 ec             	mov    -0x14(%ebp),%eax
+  800583:	83 c0 04             	add    $0x4,%eax
+  800586:	89 45 f4             	mov    %eax,-0xc(%ebp)
+    for (pp = &large_list; (h = *pp) != NULL; ) {
+  800589:	8b 45 f4             	mov    -0xc(%ebp),%eax
+  80058c:	8b 00                	mov    (%eax),%eax
+  80058e:	89 45 ec             	mov    %eax,-0x14(%ebp)
+  800591:	83 7d ec 00          	cmpl   $0x0,-0x14(%ebp)
+  800595:	75 a8                	jne    80053f <large_trim+0x1f>
+  800597:	eb 01                	jmp    80059a <large_trim+0x7a>
+                return ;
+  800599:	90                   	nop
+    }
+}
+  80059a:	c9                   	leave
+  80059b:	c3                   	ret
+
+0080059c <malloc>:
+
+void *
+malloc(size_t size) {
+  80059c:	55                   	push   %ebp
+  80059d:	89 e5                	mov    %esp,%ebp
+  80059f:	83 ec 18             	sub    $0x18,%esp
+    size_t total = size + sizeof(header_t);
+  8005a2:	8b 45 08             	mov    0x8(%ebp),%eax
+  8005a5:	83 c0 08             	add    $0x8,%eax
+  8005a8:	89 45 f0             	mov    %eax,-0x10(%ebp)
+    if (size == 0 || total < size) {
+  8005ab:	83 7d 08 00          	cmpl   $0x0,0x8(%ebp)
+  8005af:	74 08                	je     8005b9 <malloc+0x1d>
+  8005b1:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  8005b4:	3b 45 08             	cmp    0x8(%ebp),%eax
+  8005b7:	73 0a                	jae    8005c3 <malloc+0x27>
+        return NULL;
+  8005b9:	b8 00 00 00 00       	mov    $0x0,%eax
+  8005be:	e9 80 00 00 00       	jmp    800643 <malloc+0xa7>
+    }
+    header_t *h;
+    if (total <= MAX_SMALL) {
+  8005c3:	81 7d f0 00 08 00 00 	cmpl   $0x800,-0x10(%ebp)
+  8005ca:	77 1c                	ja     8005e8 <malloc+0x4c>
+        h = small_alloc(size_class(total));
+  8005cc:	ff 75 f0             	push   -0x10(%ebp)
+  8005cf:	e8 13 fd ff ff       	call   8002e7 <size_class>
+  8005d4:	83 c4 04             	add    $0x4,%esp
+  8005d7:	83 ec 0c             	sub    $0xc,%esp
+  8005da:	50                   	push   %eax
+  8005db:	e8 70 fd ff ff       	call   800350 <small_alloc>
+  8005e0:	83 c4 10             	add    $0x10,%esp
+  8005e3:	89 45 f4             	mov    %eax,-0xc(%ebp)
+  8005e6:	eb 48                	jmp    800630 <malloc+0x94>
+    }
+    else {
+        if ((total = ROUNDUP(total, PGSIZE)) < size) {
+  8005e8:	c7 45 ec 00 10 00 00 	movl   $0x1000,-0x14(%ebp)
+  8005ef:	8b 55 f0             	mov    -0x10(%ebp),%edx
+  8005f2:	8b 45 ec             	mov    -0x14(%ebp),%eax
+  8005f5:	01 d0                	add    %edx,%eax
+  8005f7:	83 e8 01             	sub    $0x1,%eax
+  8005fa:	89 45 e8             	mov    %eax,-0x18(%ebp)
+  8005fd:	8b 45 e8             	mov    -0x18(%ebp),%eax
+  800600:	ba 00 00 00 00       	mov    $0x0,%edx
+  800605:	f7 75 ec             	divl   -0x14(%ebp)
+  800608:	8b 45 e8             	mov    -0x18(%ebp),%eax
+  80060b:	29 d0                	sub    %edx,%eax
+  80060d:	89 45 f0             	mov    %eax,-0x10(%ebp)
+  800610:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  800613:	3b 45 08             	cmp    0x8(%ebp),%eax
+  800616:	73 07                	jae    80061f <malloc+0x83>
+            return NULL;
+  800618:	b8 00 00 00 00       	mov    $0x0,%eax
+  80061d:	eb 24                	jmp    800643 <malloc+0xa7>
+        }
+        h = large_alloc(total);
+  80061f:	83 ec 0c             	sub    $0xc,%esp
+  800622:	ff 75 f0             	push   -0x10(%ebp)
+  800625:	e8 44 fe ff ff       	call   80046e <large_alloc>
+  80062a:	83 c4 10             	add    $0x10,%esp
+  80062d:	89 45 f4             	mov    %eax,-0xc(%ebp)
+    }
+    return (h != NULL) ? (void *)(h + 1) : NULL;
+  800630:	83 7d f4 00          	cmpl   $0x0,-0xc(%ebp)
+  800634:	74 08                	je     80063e <malloc+0xa2>
+  800636:	8b 45 f4             	mov    -0xc(%ebp),%eax
+  800639:	83 c0 08             	add    $0x8,%eax
+  80063c:	eb 05                	jmp    800643 <malloc+0xa7>
+  80063e:	b8 00 00 00 00       	mov    $0x0,%eax
+}
+  800643:	c9                   	leave
+  800644:	c3                   	ret
+
+00800645 <free>:
+
+void
+free(void *ptr) {
+  800645:	55                   	push   %ebp
+  800646:	89 e5                	mov    %esp,%ebp
+  800648:	83 ec 18             	sub    $0x18,%esp
+    if (ptr == NULL) {
+  80064b:	83 7d 08 00          	cmpl   $0x0,0x8(%ebp)
+  80064f:	74 4c                	je     80069d <free+0x58>
+        return ;
+    }
+    header_t *h = (header_t *)ptr - 1;
+  800651:	8b 45 08             	mov    0x8(%ebp),%eax
+  800654:	83 e8 08             	sub    $0x8,%eax
+  800657:	89 45 f4             	mov    %eax,-0xc(%ebp)
+    if (h->s.size <= MAX_SMALL) {
+  80065a:	8b 45 f4             	mov    -0xc(%ebp),%eax
+  80065d:	8b 00                	mov    (%eax),%eax
+  80065f:	3d 00 08 00 00       	cmp    $0x800,%eax
+  800664:	77 1c                	ja     800682 <free+0x3d>
+        push_free(h, size_class(h->s.size));
+  800666:	8b 45 f4             	mov    -0xc(%ebp),%eax
+  800669:	8b 00                	mov    (%eax),%eax
+  80066b:	50                   	push   %eax
+  80066c:	e8 76 fc ff ff       	call   8002e7 <size_class>
+  800671:	83 c4 04             	add    $0x4,%esp
+  800674:	50                   	push   %eax
+  800675:	ff 75 f4             	push   -0xc(%ebp)
+  800678:	e8 98 fc ff ff       	call   800315 <push_free>
+  80067d:	83 c4 08             	add    $0x8,%esp
+  800680:	eb 1c                	jmp    80069e <free+0x59>
+    }
+    else {
+        h->s.next = large_list;
+  800682:	8b 15 60 31 80 00    	mov    0x803160,%edx
+  800688:	8b 45 f4             	mov    -0xc(%ebp),%eax
+  80068b:	89 50 04             	mov    %edx,0x4(%eax)
+        large_list = h;
+  80068e:	8b 45 f4             	mov    -0xc(%ebp),%eax
+  800691:	a3 60 31 80 00       	mov    %eax,0x803160
+        large_trim();
+  800696:	e8 85 fe ff ff       	call   800520 <large_trim>
+  80069b:	eb 01                	jmp    80069e <free+0x59>
+        return ;
+  80069d:	90                   	nop
+    }
+}
+  80069e:	c9                   	leave
+  80069f:	c3                   	ret
+
+008006a0 <calloc>:
+
+void *
+calloc(size_t nmemb, size_t size) {
+  8006a0:	55                   	push   %ebp
+  8006a1:	89 e5                	mov    %esp,%ebp
+  8006a3:	83 ec 18             	sub    $0x18,%esp
+    if (size != 0 && nmemb > (size_t)-1 / size) {
+  8006a6:	83 7d 0c 00          	cmpl   $0x0,0xc(%ebp)
+  8006aa:	74 19                	je     8006c5 <calloc+0x25>
+  8006ac:	b8 ff ff ff ff       	mov    $0xffffffff,%eax
+  8006b1:	ba 00 00 00 00       	mov    $0x0,%edx
+  8006b6:	f7 75 0c             	divl   0xc(%ebp)
+  8006b9:	3b 45 08             	cmp    0x8(%ebp),%eax
+  8006bc:	73 07                	jae    8006c5 <calloc+0x25>
+        return NULL;
+  8006be:	b8 00 00 00 00       	mov    $0x0,%eax
+  8006c3:	eb 37                	jmp    8006fc <calloc+0x5c>
+    }
+    void *ptr;
+    if ((ptr = malloc(nmemb * size)) != NULL) {
+  8006c5:	8b 45 08             	mov    0x8(%ebp),%eax
+  8006c8:	0f af 45 0c          	imul   0xc(%ebp),%eax
+  8006cc:	83 ec 0c             	sub    $0xc,%esp
+  8006cf:	50                   	push   %eax
+  8006d0:	e8 c7 fe ff ff       	call   80059c <malloc>
+  8006d5:	83 c4 10             	add    $0x10,%esp
+  8006d8:	89 45 f4             	mov    %eax,-0xc(%ebp)
+  8006db:	83 7d f4 00          	cmpl   $0x0,-0xc(%ebp)
+  8006df:	74 18                	je     8006f9 <calloc+0x59>
+        memset(ptr, 0, nmemb * size);
+  8006e1:	8b 45 08             	mov    0x8(%ebp),%eax
+  8006e4:	0f af 45 0c          	imul   0xc(%ebp),%eax
+  8006e8:	83 ec 04             	sub    $0x4,%esp
+  8006eb:	50                   	push   %eax
+  8006ec:	6a 00                	push   $0x0
+  8006ee:	ff 75 f4             	push   -0xc(%ebp)
+  8006f1:	e8 a4 13 00 00       	call   801a9a <memset>
+  8006f6:	83 c4 10             	add    $0x10,%esp
+    }
+    return ptr;
+  8006f9:	8b 45 f4             	mov    -0xc(%ebp),%eax
+}
+  8006fc:	c9                   	leave
+  8006fd:	c3                   	ret
+
+008006fe <realloc>:
+
+void *
+realloc(void *ptr, size_t size) {
+  8006fe:	55                   	push   %ebp
+  8006ff:	89 e5                	mov    %esp,%ebp
+  800701:	83 ec 18             	sub    $0x18,%esp
+    if (ptr == NULL) {
+  800704:	83 7d 08 00          	cmpl   $0x0,0x8(%ebp)
+  800708:	75 10                	jne    80071a <realloc+0x1c>
+        return malloc(size);
+  80070a:	83 ec 0c             	sub    $0xc,%esp
+  80070d:	ff 75 0c             	push   0xc(%ebp)
+  800710:	e8 87 fe ff ff       	call   80059c <malloc>
+  800715:	83 c4 10             	add    $0x10,%esp
+  800718:	eb 72                	jmp    80078c <realloc+0x8e>
+    }
+    if (size == 0) {
+  80071a:	83 7d 0c 00          	cmpl   $0x0,0xc(%ebp)
+  80071e:	75 15                	jne    800735 <realloc+0x37>
+        free(ptr);
+  800720:	83 ec 0c             	sub    $0xc,%esp
+  800723:	ff 75 08             	push   0x8(%ebp)
+  800726:	e8 1a ff ff ff       	call   800645 <free>
+  80072b:	83 c4 10             	add    $0x10,%esp
+        return NULL;
+  80072e:	b8 00 00 00 00       	mov    $0x0,%eax
+  800733:	eb 57                	jmp    80078c <realloc+0x8e>
+    }
+    size_t old = ((header_t *)ptr - 1)->s.size - sizeof(header_t);
+  800735:	8b 45 08             	mov    0x8(%ebp),%eax
+  800738:	83 e8 08             	sub    $0x8,%eax
+  80073b:	8b 00                	mov    (%eax),%eax
+  80073d:	83 e8 08             	sub    $0x8,%eax
+  800740:	89 45 f4             	mov    %eax,-0xc(%ebp)
+    if (size <= old) {
+  800743:	8b 45 0c             	mov    0xc(%ebp),%eax
+  800746:	39 45 f4             	cmp    %eax,-0xc(%ebp)
+  800749:	72 05                	jb     800750 <realloc+0x52>
+        return ptr;
+  80074b:	8b 45 08             	mov    0x8(%ebp),%eax
+  80074e:	eb 3c                	jmp    80078c <realloc+0x8e>
+    }
+    void *nptr;
+    if ((nptr = malloc(size)) != NULL) {
+  800750:	83 ec 0c             	sub    $0xc,%esp
+  800753:	ff 75 0c             	push   0xc(%ebp)
+  800756:	e8 41 fe ff ff       	call   80059c <malloc>
+  80075b:	83 c4 10             	add    $0x10,%esp
+  80075e:	89 45 f0             	mov    %eax,-0x10(%ebp)
+  800761:	83 7d f0 00          	cmpl   $0x0,-0x10(%ebp)
+  800765:	74 22                	je     800789 <realloc+0x8b>
+        memcpy(nptr, ptr, old);
+  800767:	83 ec 04             	sub    $0x4,%esp
+  80076a:	ff 75 f4             	push   -0xc(%ebp)
+  80076d:	ff 75 08             	push   0x8(%ebp)
+  800770:	ff 75 f0             	push   -0x10(%ebp)
+  800773:	e8 03 14 00 00       	call   801b7b <memcpy>
+  800778:	83 c4 10             	add    $0x10,%esp
+        free(ptr);
+  80077b:	83 ec 0c             	sub    $0xc,%esp
+  80077e:	ff 75 08             	push   0x8(%ebp)
+  800781:	e8 bf fe ff ff       	call   800645 <free>
+  800786:	83 c4 10             	add    $0x10,%esp
+    }
+    return nptr;
+  800789:	8b 45 f0             	mov    -0x10(%ebp),%eax
+}
+  80078c:	c9                   	leave
+  80078d:	c3                   	ret
+
+0080078e <__panic>:
+#include <stdio.h>
+#include <ulib.h>
+#include <error.h>
+
+void
+__panic(const char *file, int line, const char *fmt, ...) {
+  80078e:	55                   	push   %ebp
+  80078f:	89 e5                	mov    %esp,%ebp
+  800791:	83 ec 18             	sub    $0x18,%esp
+    // print the 'message'
+    va_list ap;
+    va_start(ap, fmt);
+  800794:	8d 45 14             	lea    0x14(%ebp),%eax
+  800797:	89 45 f4             	mov    %eax,-0xc(%ebp)
+    cprintf("user panic at %s:%d:\n    ", file, line);
+  80079a:	83 ec 04             	sub    $0x4,%esp
+  80079d:	ff 75 0c             	push   0xc(%ebp)
+  8007a0:	ff 75 08             	push   0x8(%ebp)
+  8007a3:	68 96 1d 80 00       	push   $0x801d96
+  8007a8:	e8 17 01 00 00       	call   8008c4 <cprintf>
+  8007ad:	83 c4 10             	add    $0x10,%esp
+    vcprintf(fmt, ap);
+  8007b0:	8b 45 f4             	mov    -0xc(%ebp),%eax
+  8007b3:	83 ec 08             	sub    $0x8,%esp
+  8007b6:	50                   	push   %eax
+  8007b7:	ff 75 10             	push   0x10(%ebp)
+  8007ba:	e8 d4 00 00 00       	call   800893 <vcprintf>
+  8007bf:	83 c4 10             	add    $0x10,%esp
+    cprintf("\n");
+  8007c2:	83 ec 0c             	sub    $0xc,%esp
+  8007c5:	68 b0 1d 80 00       	push   $0x801db0
+  8007ca:	e8 f5 00 00 00       	call   8008c4 <cprintf>
+  8007cf:	83 c4 10             	add    $0x10,%esp
+    va_end(ap);
+    exit(-E_PANIC);
+  8007d2:	83 ec 0c             	sub    $0xc,%esp
+  8007d5:	6a f6                	push   $0xfffffff6
+  8007d7:	e8 32 05 00 00       	call   800d0e <exit>
+
+008007dc <__warn>:
+}
+
+void
+__warn(const char *file, int line, const char *fmt, ...) {
+  8007dc:	55                   	push   %ebp
+  8007dd:	89 e5                	mov    %esp,%ebp
+  8007df:	83 ec 18             	sub    $0x18,%esp
+    va_list ap;
+    va_start(ap, fmt);
+  8007e2:	8d 45 14             	lea    0x14(%ebp),%eax
+  8007e5:	89 45 f4             	mov    %eax,-0xc(%ebp)
+    cprintf("user warning at %s:%d:\n    ", file, line);
+  8007e8:	83 ec 04             	sub    $0x4,%esp
+  8007eb:	ff 75 0c             	push   0xc(%ebp)
+  8007ee:	ff 75 08             	push   0x8(%ebp)
+  8007f1:	68 b2 1d 80 00       	push   $0x801db2
+  8007f6:	e8 c9 00 00 00       	call   8008c4 <cprintf>
+  8007fb:	83 c4 10             	add    $0x10,%esp
+    vcprintf(fmt, ap);
+  8007fe:	8b 45 f4             	mov    -0xc(%ebp),%eax
+  800801:	83 ec 08             	sub    $0x8,%esp
+  800804:	50                   	push   %eax
+  800805:	ff 75 10             	push   0x10(%ebp)
+  800808:	e8 86 00 00 00       	call   800893 <vcprintf>
+  80080d:	83 c4 10             	add    $0x10,%esp
+    cprintf("\n");
+  800810:	83 ec 0c             	sub    $0xc,%esp
+  800813:	68 b0 1d 80 00       	push   $0x801db0
+  800818:	e8 a7 00 00 00       	call   8008c4 <cprintf>
+  80081d:	83 c4 10             	add    $0x10,%esp
+    va_end(ap);
+}
+  800820:	90                   	nop
+  800821:	c9                   	leave
+  800822:	c3                   	ret
+
+00800823 <shmem_open>:
+/**
+ * shmem_open - 映射名为 name 的段, 不存在时按 len 字节创建. 段已存在时 len 为 0 表示映射整个段.
+ * mmap_flags 可为 MMAP_WRITE. 返回映射的起始地址, 失败返回 NULL.
+ */
+void *
+shmem_open(const char *name, size_t len, uint32_t mmap_flags) {
+  800823:	55                   	push   %ebp
+  800824:	89 e5                	mov    %esp,%ebp
+  800826:	83 ec 18             	sub    $0x18,%esp
+    uintptr_t addr_store = 0;
+  800829:	c7 45 f4 00 00 00 00 	movl   $0x0,-0xc(%ebp)
+    if (sys_shmem(name, len, mmap_flags, &addr_store) != 0) {
+  800830:	8d 45 f4             	lea    -0xc(%ebp),%eax
+  800833:	50                   	push   %eax
+  800834:	ff 75 10             	push   0x10(%ebp)
+  800837:	ff 75 0c             	push   0xc(%ebp)
+  80083a:	ff 75 08             	push   0x8(%ebp)
+  80083d:	e8 c5 02 00 00       	call   800b07 <sys_shmem>
+  800842:	83 c4 10             	add    $0x10,%esp
+  800845:	85 c0                	test   %eax,%eax
+  800847:	74 07                	je     800850 <shmem_open+0x2d>
+        return NULL;
+  800849:	b8 00 00 00 00       	mov    $0x0,%eax
+  80084e:	eb 03                	jmp    800853 <shmem_open+0x30>
+    }
+    return (void *)addr_store;
+  800850:	8b 45 f4             	mov    -0xc(%ebp),%eax
+}
+  800853:	c9                   	leave
+  800854:	c3                   	ret
+
+00800855 <shmem_close>:
+
+int
+shmem_close(void *addr, size_t len) {
+  800855:	55                   	push   %ebp
+  800856:	89 e5                	mov    %esp,%ebp
+  800858:	83 ec 08             	sub    $0x8,%esp
+    return sys_munmap((uintptr_t)addr, len);
+  80085b:	8b 45 08             	mov    0x8(%ebp),%eax
+  80085e:	83 ec 08             	sub    $0x8,%esp
+  800861:	ff 75 0c             	push   0xc(%ebp)
+  800864:	50                   	push   %eax
+  800865:	e8 88 02 00 00       	call   800af2 <sys_munmap>
+  80086a:	83 c4 10             	add    $0x10,%esp
+}
+  80086d:	c9                   	leave
+  80086e:	c3                   	ret
+
+0080086f <cputch>:
+/* *
+ * cputch - writes a single character @c to stdout, and it will
+ * increace the value of counter pointed by @cnt.
+ * */
+static void
+cputch(int c, int *cnt) {
+  80086f:	55                   	push   %ebp
+  800870:	89 e5                	mov    %esp,%ebp
+  800872:	83 ec 08             	sub    $0x8,%esp
+    sys_putc(c);
+  800875:	83 ec 0c             	sub    $0xc,%esp
+  800878:	ff 75 08             	push   0x8(%ebp)
+  80087b:	e8 fc 01 00 00       	call   800a7c <sys_putc>
+  800880:	83 c4 10             	add    $0x10,%esp
+    (*cnt) ++;
+  800883:	8b 45 0c             	mov    0xc(%ebp),%eax
+  800886:	8b 00                	mov    (%eax),%eax
+  800888:	8d 50 01             	lea    0x1(%eax),%edx
+  80088b:	8b 45 0c             	mov    0xc(%ebp),%eax
+  80088e:	89 10                	mov    %edx,(%eax)
+}
+  800890:	90                   	nop
+  800891:	c9                   	leave
+  800892:	c3                   	ret
+
+00800893 <vcprintf>:
+ *
+ * Call this function if you are already dealing with a va_list.
+ * Or you probably want cprintf() instead.
+ * */
+int
+vcprintf(const char *fmt, va_list ap) {
+  800893:	55                   	push   %ebp
+  800894:	89 e5                	mov    %esp,%ebp
+  800896:	83 ec 18             	sub    $0x18,%esp
+    int cnt = 0;
+  800899:	c7 45 f4 00 00 00 00 	movl   $0x0,-0xc(%ebp)
+    vprintfmt((void*)cputch, NO_FD, &cnt, fmt, ap);
+  8008a0:	83 ec 0c             	sub    $0xc,%esp
+  8008a3:	ff 75 0c             	push   0xc(%ebp)
+  8008a6:	ff 75 08             	push   0x8(%ebp)
+  8008a9:	8d 45 f4             	lea    -0xc(%ebp),%eax
+  8008ac:	50                   	push   %eax
+  8008ad:	68 d9 6a ff ff       	push   $0xffff6ad9
+  8008b2:	68 6f 08 80 00       	push   $0x80086f
+  8008b7:	e8 18 09 00 00       	call   8011d4 <vprintfmt>
+  8008bc:	83 c4 20             	add    $0x20,%esp
+    return cnt;
+  8008bf:	8b 45 f4             	mov    -0xc(%ebp),%eax
+}
+  8008c2:	c9                   	leave
+  8008c3:	c3                   	ret
+
+008008c4 <cprintf>:
+ *
+ * The return value is the number of characters which would be
+ * written to stdout.
+ * */
+int
+cprintf(const char *fmt, ...) {
+  8008c4:	55                   	push   %ebp
+  8008c5:	89 e5                	mov    %esp,%ebp
+  8008c7:	83 ec 18             	sub    $0x18,%esp
+    va_list ap;
+
+    va_start(ap, fmt);
+  8008ca:	8d 45 0c             	lea    0xc(%ebp),%eax
+  8008cd:	89 45 f0             	mov    %eax,-0x10(%ebp)
+    int cnt = vcprintf(fmt, ap);
+  8008d0:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  8008d3:	83 ec 08             	sub    $0x8,%esp
+  8008d6:	50                   	push   %eax
+  8008d7:	ff 75 08             	push   0x8(%ebp)
+  8008da:	e8 b4 ff ff ff       	call   800893 <vcprintf>
+  8008df:	83 c4 10             	add    $0x10,%esp
+  8008e2:	89 45 f4             	mov    %eax,-0xc(%ebp)
+    va_end(ap);
+
+    return cnt;
+  8008e5:	8b 45 f4             	mov    -0xc(%ebp),%eax
+}
+  8008e8:	c9                   	leave
+  8008e9:	c3                   	ret
+
+008008ea <cputs>:
+/* *
+ * cputs- writes the string pointed by @str to stdout and
+ * appends a newline character.
+ * */
+int
+cputs(const char *str) {
+  8008ea:	55                   	push   %ebp
+  8008eb:	89 e5                	mov    %esp,%ebp
+  8008ed:	83 ec 18             	sub    $0x18,%esp
+    int cnt = 0;
+  8008f0:	c7 45 f0 00 00 00 00 	movl   $0x0,-0x10(%ebp)
+    char c;
+    while ((c = *str ++) != '\0') {
+  8008f7:	eb 14                	jmp    80090d <cputs+0x23>
+        cputch(c, &cnt);
+  8008f9:	0f be 45 f7          	movsbl -0x9(%ebp),%eax
+  8008fd:	83 ec 08             	sub    $0x8,%esp
+  800900:	8d 55 f0             	lea    -0x10(%ebp),%edx
+  800903:	52                   	push   %edx
+  800904:	50                   	push   %eax
+  800905:	e8 65 ff ff ff       	call   80086f <cputch>
+  80090a:	83 c4 10             	add    $0x10,%esp
+    while ((c = *str ++) != '\0') {
+  80090d:	8b 45 08             	mov    0x8(%ebp),%eax
+  800910:	8d 50 01             	lea    0x1(%eax),%edx
+  800913:	89 55 08             	mov    %edx,0x8(%ebp)
+  800916:	0f b6 00             	movzbl (%eax),%eax
+  800919:	88 45 f7             	mov    %al,-0x9(%ebp)
+  80091c:	80 7d f7 00          	cmpb   $0x0,-0x9(%ebp)
+  800920:	75 d7                	jne    8008f9 <cputs+0xf>
+    }
+    cputch('\n', &cnt);
+  800922:	83 ec 08             	sub    $0x8,%esp
+  800925:	8d 45 f0             	lea    -0x10(%ebp),%eax
+  800928:	50                   	push   %eax
+  800929:	6a 0a                	push   $0xa
+  80092b:	e8 3f ff ff ff       	call   80086f <cputch>
+  800930:	83 c4 10             	add    $0x10,%esp
+    return cnt;
+  800933:	8b 45 f0             	mov    -0x10(%ebp),%eax
+}
+  800936:	c9                   	leave
+  800937:	c3                   	ret
+
+00800938 <fputch>:
+
+
+static void
+fputch(char c, int *cnt, int fd) {
+  800938:	55                   	push   %ebp
+  800939:	89 e5                	mov    %esp,%ebp
+  80093b:	83 ec 18             	sub    $0x18,%esp
+  80093e:	8b 45 08             	mov    0x8(%ebp),%eax
+  800941:	88 45 f4             	mov    %al,-0xc(%ebp)
+    write(fd, &c, sizeof(char));
+  800944:	83 ec 04             	sub    $0x4,%esp
+  800947:	6a 01                	push   $0x1
+  800949:	8d 45 f4             	lea    -0xc(%ebp),%eax
+  80094c:	50                   	push   %eax
+  80094d:	ff 75 10             	push   0x10(%ebp)
+  800950:	e8 f1 f7 ff ff       	call   800146 <write>
+  800955:	83 c4 10             	add    $0x10,%esp
+    (*cnt) ++;
+  800958:	8b 45 0c             	mov    0xc(%ebp),%eax
+  80095b:	8b 00                	mov    (%eax),%eax
+  80095d:	8d 50 01             	lea    0x1(%eax),%edx
+  800960:	8b 45 0c             	mov    0xc(%ebp),%eax
+  800963:	89 10                	mov    %edx,(%eax)
+}
+  800965:	90                   	nop
+  800966:	c9                   	leave
+  800967:	c3                   	ret
+
+00800968 <vfprintf>:
+
+int
+vfprintf(int fd, const char *fmt, va_list ap) {
+  800968:	55                   	push   %ebp
+  800969:	89 e5                	mov    %esp,%ebp
+  80096b:	83 ec 18             	sub    $0x18,%esp
+    int cnt = 0;
+  80096e:	c7 45 f4 00 00 00 00 	movl   $0x0,-0xc(%ebp)
+    vprintfmt((void*)fputch, fd, &cnt, fmt, ap);
+  800975:	83 ec 0c             	sub    $0xc,%esp
+  800978:	ff 75 10             	push   0x10(%ebp)
+  80097b:	ff 75 0c             	push   0xc(%ebp)
+  80097e:	8d 45 f4             	lea    -0xc(%ebp),%eax
+  800981:	50                   	push   %eax
+  800982:	ff 75 08             	push   0x8(%ebp)
+  800985:	68 38 09 80 00       	push   $0x800938
+  80098a:	e8 45 08 00 00       	call   8011d4 <vprintfmt>
+  80098f:	83 c4 20             	add    $0x20,%esp
+    return cnt;
+  800992:	8b 45 f4             	mov    -0xc(%ebp),%eax
+}
+  800995:	c9                   	leave
+  800996:	c3                   	ret
+
+00800997 <fprintf>:
+
+int
+fprintf(int fd, const char *fmt, ...) {
+  800997:	55                   	push   %ebp
+  800998:	89 e5                	mov    %esp,%ebp
+  80099a:	83 ec 18             	sub    $0x18,%esp
+    va_list ap;
+
+    va_start(ap, fmt);
+  80099d:	8d 45 10             	lea    0x10(%ebp),%eax
+  8009a0:	89 45 f0             	mov    %eax,-0x10(%ebp)
+    int cnt = vfprintf(fd, fmt, ap);
+  8009a3:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  8009a6:	83 ec 04             	sub    $0x4,%esp
+  8009a9:	50                   	push   %eax
+  8009aa:	ff 75 0c             	push   0xc(%ebp)
+  8009ad:	ff 75 08             	push   0x8(%ebp)
+  8009b0:	e8 b3 ff ff ff       	call   800968 <vfprintf>
+  8009b5:	83 c4 10             	add    $0x10,%esp
+  8009b8:	89 45 f4             	mov    %eax,-0xc(%ebp)
+    va_end(ap);
+
+    return cnt;
+  8009bb:	8b 45 f4             	mov    -0xc(%ebp),%eax
+}
+  8009be:	c9                   	leave
+  8009bf:	c3                   	ret
+
+008009c0 <syscall>:
+
+
+#define MAX_ARGS            5
+
+static inline int
+syscall(int num, ...) {
+  8009c0:	55                   	push   %ebp
+  8009c1:	89 e5                	mov    %esp,%ebp
+  8009c3:	57                   	push   %edi
+  8009c4:	56                   	push   %esi
+  8009c5:	53                   	push   %ebx
+  8009c6:	83 ec 20             	sub    $0x20,%esp
+    va_list ap;
+    va_start(ap, num);
+  8009c9:	8d 45 0c             	lea    0xc(%ebp),%eax
+  8009cc:	89 45 e8             	mov    %eax,-0x18(%ebp)
+    uint32_t a[MAX_ARGS];
+    int i, ret;
+    for (i = 0; i < MAX_ARGS; i ++) {
+  8009cf:	c7 45 f0 00 00 00 00 	movl   $0x0,-0x10(%ebp)
+  8009d6:	eb 16                	jmp    8009ee <syscall+0x2e>
+        a[i] = va_arg(ap, uint32_t);
+  8009d8:	8b 45 e8             	mov    -0x18(%ebp),%eax
+  8009db:	8d 50 04             	lea    0x4(%eax),%edx
+  8009de:	89 55 e8             	mov    %edx,-0x18(%ebp)
+  8009e1:	8b 10                	mov    (%eax),%edx
+  8009e3:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  8009e6:	89 54 85 d4          	mov    %edx,-0x2c(%ebp,%eax,4)
+    for (i = 0; i < MAX_ARGS; i ++) {
+  8009ea:	83 45 f0 01          	addl   $0x1,-0x10(%ebp)
+  8009ee:	83 7d f0 04          	cmpl   $0x4,-0x10(%ebp)
+  8009f2:	7e e4                	jle    8009d8 <syscall+0x18>
+    asm volatile (
+        "int %1;"           // int = 
+        : "=a" (ret)        // 输出约束:返回值写入到 eax
+        : "i" (T_SYSCALL),  // 输入操作数: 系统调用导致的中断
+          "a" (num),        // eax, 中断号, trap_no
+          "d" (a[0]),       // edx
+  8009f4:	8b 55 d4             	mov    -0x2c(%ebp),%edx
+          "c" (a[1]),       // ecx
+  8009f7:	8b 4d d8             	mov    -0x28(%ebp),%ecx
+          "b" (a[2]),       // ebx
+  8009fa:	8b 5d dc             	mov    -0x24(%ebp),%ebx
+          "D" (a[3]),       // edi
+  8009fd:	8b 7d e0             	mov    -0x20(%ebp),%edi
+          "S" (a[4])        // esi
+  800a00:	8b 75 e4             	mov    -0x1c(%ebp),%esi
+    asm volatile (
+  800a03:	8b 45 08             	mov    0x8(%ebp),%eax
+  800a06:	cd 80                	int    $0x80
+  800a08:	89 45 ec             	mov    %eax,-0x14(%ebp)
+        : "cc", "memory");  // 乱码列表: 1 可能影响标志位 2 内存可能改变
+    return ret;
+  800a0b:	8b 45 ec             	mov    -0x14(%ebp),%eax
+}
+  800a0e:	83 c4 20             	add    $0x20,%esp
+  800a11:	5b                   	pop    %ebx
+  800a12:	5e                   	pop    %esi
+  800a13:	5f                   	pop    %edi
+  800a14:	5d                   	pop    %ebp
+  800a15:	c3                   	ret
+
+00800a16 <sys_exit>:
+
+int
+sys_exit(int error_code) {
+  800a16:	55                   	push   %ebp
+  800a17:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_exit, error_code);
+  800a19:	ff 75 08             	push   0x8(%ebp)
+  800a1c:	6a 01                	push   $0x1
+  800a1e:	e8 9d ff ff ff       	call   8009c0 <syscall>
+  800a23:	83 c4 08             	add    $0x8,%esp
+}
+  800a26:	c9                   	leave
+  800a27:	c3                   	ret
+
+00800a28 <sys_fork>:
+
+int
+sys_fork(void) {
+  800a28:	55                   	push   %ebp
+  800a29:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_fork);
+  800a2b:	6a 02                	push   $0x2
+  800a2d:	e8 8e ff ff ff       	call   8009c0 <syscall>
+  800a32:	83 c4 04             	add    $0x4,%esp
+}
+  800a35:	c9                   	leave
+  800a36:	c3                   	ret
+
+00800a37 <sys_wait>:
+
+int
+sys_wait(int pid, int *store) {
+  800a37:	55                   	push   %ebp
+  800a38:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_wait, pid, store);
+  800a3a:	ff 75 0c             	push   0xc(%ebp)
+  800a3d:	ff 75 08             	push   0x8(%ebp)
+  800a40:	6a 03                	push   $0x3
+  800a42:	e8 79 ff ff ff       	call   8009c0 <syscall>
+  800a47:	83 c4 0c             	add    $0xc,%esp
+}
+  800a4a:	c9                   	leave
+  800a4b:	c3                   	ret
+
+00800a4c <sys_yield>:
+
+int
+sys_yield(void) {
+  800a4c:	55                   	push   %ebp
+  800a4d:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_yield);
+  800a4f:	6a 0a                	push   $0xa
+  800a51:	e8 6a ff ff ff       	call   8009c0 <syscall>
+  800a56:	83 c4 04             	add    $0x4,%esp
+}
+  800a59:	c9                   	leave
+  800a5a:	c3                   	ret
+
+00800a5b <sys_kill>:
+
+int
+sys_kill(int pid) {
+  800a5b:	55                   	push   %ebp
+  800a5c:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_kill, pid);
+  800a5e:	ff 75 08             	push   0x8(%ebp)
+  800a61:	6a 0c                	push   $0xc
+  800a63:	e8 58 ff ff ff       	call   8009c0 <syscall>
+  800a68:	83 c4 08             	add    $0x8,%esp
+}
+  800a6b:	c9                   	leave
+  800a6c:	c3                   	ret
+
+00800a6d <sys_getpid>:
+
+int
+sys_getpid(void) {
+  800a6d:	55                   	push   %ebp
+  800a6e:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_getpid);
+  800a70:	6a 12                	push   $0x12
+  800a72:	e8 49 ff ff ff       	call   8009c0 <syscall>
+  800a77:	83 c4 04             	add    $0x4,%esp
+}
+  800a7a:	c9                   	leave
+  800a7b:	c3                   	ret
+
+00800a7c <sys_putc>:
+
+int
+sys_putc(int c) {
+  800a7c:	55                   	push   %ebp
+  800a7d:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_putc, c);
+  800a7f:	ff 75 08             	push   0x8(%ebp)
+  800a82:	6a 1e                	push   $0x1e
+  800a84:	e8 37 ff ff ff       	call   8009c0 <syscall>
+  800a89:	83 c4 08             	add    $0x8,%esp
+}
+  800a8c:	c9                   	leave
+  800a8d:	c3                   	ret
+
+00800a8e <sys_pgdir>:
+
+int
+sys_pgdir(void) {
+  800a8e:	55                   	push   %ebp
+  800a8f:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_pgdir);
+  800a91:	6a 1f                	push   $0x1f
+  800a93:	e8 28 ff ff ff       	call   8009c0 <syscall>
+  800a98:	83 c4 04             	add    $0x4,%esp
+}
+  800a9b:	c9                   	leave
+  800a9c:	c3                   	ret
+
+00800a9d <sys_lab6_set_priority>:
+
+void
+sys_lab6_set_priority(uint32_t priority)
+{
+  800a9d:	55                   	push   %ebp
+  800a9e:	89 e5                	mov    %esp,%ebp
+    syscall(SYS_lab6_set_priority, priority);
+  800aa0:	ff 75 08             	push   0x8(%ebp)
+  800aa3:	68 ff 00 00 00       	push   $0xff
+  800aa8:	e8 13 ff ff ff       	call   8009c0 <syscall>
+  800aad:	83 c4 08             	add    $0x8,%esp
+}
+  800ab0:	90                   	nop
+  800ab1:	c9                   	leave
+  800ab2:	c3                   	ret
+
+00800ab3 <sys_sleep>:
+
+int
+sys_sleep(unsigned int time) {
+  800ab3:	55                   	push   %ebp
+  800ab4:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_sleep, time);
+  800ab6:	ff 75 08             	push   0x8(%ebp)
+  800ab9:	6a 0b                	push   $0xb
+  800abb:	e8 00 ff ff ff       	call   8009c0 <syscall>
+  800ac0:	83 c4 08             	add    $0x8,%esp
+}
+  800ac3:	c9                   	leave
+  800ac4:	c3                   	ret
+
+00800ac5 <sys_gettime>:
+
+size_t
+sys_gettime(void) {
+  800ac5:	55                   	push   %ebp
+  800ac6:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_gettime);
+  800ac8:	6a 11                	push   $0x11
+  800aca:	e8 f1 fe ff ff       	call   8009c0 <syscall>
+  800acf:	83 c4 04             	add    $0x4,%esp
+}
+  800ad2:	c9                   	leave
+  800ad3:	c3                   	ret
+
+00800ad4 <sys_mmap>:
+
+int
+sys_mmap(uintptr_t *addr_store, size_t len, uint32_t mmap_flags, int fd, off_t offset) {
+  800ad4:	55                   	push   %ebp
+  800ad5:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_mmap, addr_store, len, mmap_flags, fd, offset);
+  800ad7:	ff 75 18             	push   0x18(%ebp)
+  800ada:	ff 75 14             	push   0x14(%ebp)
+  800add:	ff 75 10             	push   0x10(%ebp)
+  800ae0:	ff 75 0c             	push   0xc(%ebp)
+  800ae3:	ff 75 08             	push   0x8(%ebp)
+  800ae6:	6a 14                	push   $0x14
+  800ae8:	e8 d3 fe ff ff       	call   8009c0 <syscall>
+  800aed:	83 c4 18             	add    $0x18,%esp
+}
+  800af0:	c9                   	leave
+  800af1:	c3                   	ret
+
+00800af2 <sys_munmap>:
+
+int
+sys_munmap(uintptr_t addr, size_t len) {
+  800af2:	55                   	push   %ebp
+  800af3:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_munmap, addr, len);
+  800af5:	ff 75 0c             	push   0xc(%ebp)
+  800af8:	ff 75 08             	push   0x8(%ebp)
+  800afb:	6a 15                	push   $0x15
+  800afd:	e8 be fe ff ff       	call   8009c0 <syscall>
+  800b02:	83 c4 0c             	add    $0xc,%esp
+}
+  800b05:	c9                   	leave
+  800b06:	c3                   	ret
+
+00800b07 <sys_shmem>:
+
+int
+sys_shmem(const char *name, size_t len, uint32_t mmap_flags, uintptr_t *addr_store) {
+  800b07:	55                   	push   %ebp
+  800b08:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_shmem, name, len, mmap_flags, addr_store);
+  800b0a:	ff 75 14             	push   0x14(%ebp)
+  800b0d:	ff 75 10             	push   0x10(%ebp)
+  800b10:	ff 75 0c             	push   0xc(%ebp)
+  800b13:	ff 75 08             	push   0x8(%ebp)
+  800b16:	6a 16                	push   $0x16
+  800b18:	e8 a3 fe ff ff       	call   8009c0 <syscall>
+  800b1d:	83 c4 14             	add    $0x14,%esp
+}
+  800b20:	c9                   	leave
+  800b21:	c3                   	ret
+
+00800b22 <sys_brk>:
+
+int
+sys_brk(uintptr_t *brk_store) {
+  800b22:	55                   	push   %ebp
+  800b23:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_brk, brk_store);
+  800b25:	ff 75 08             	push   0x8(%ebp)
+  800b28:	6a 18                	push   $0x18
+  800b2a:	e8 91 fe ff ff       	call   8009c0 <syscall>
+  800b2f:	83 c4 08             	add    $0x8,%esp
+}
+  800b32:	c9                   	leave
+  800b33:	c3                   	ret
+
+00800b34 <sys_ksm>:
+
+int
+sys_ksm(int op) {
+  800b34:	55                   	push   %ebp
+  800b35:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_ksm, op);
+  800b37:	ff 75 08             	push   0x8(%ebp)
+  800b3a:	6a 17                	push   $0x17
+  800b3c:	e8 7f fe ff ff       	call   8009c0 <syscall>
+  800b41:	83 c4 08             	add    $0x8,%esp
+}
+  800b44:	c9                   	leave
+  800b45:	c3                   	ret
+
+00800b46 <sys_exec>:
+
+int
+sys_exec(const char *name, int argc, const char **argv) {
+  800b46:	55                   	push   %ebp
+  800b47:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_exec, name, argc, argv);
+  800b49:	ff 75 10             	push   0x10(%ebp)
+  800b4c:	ff 75 0c             	push   0xc(%ebp)
+  800b4f:	ff 75 08             	push   0x8(%ebp)
+  800b52:	6a 04                	push   $0x4
+  800b54:	e8 67 fe ff ff       	call   8009c0 <syscall>
+  800b59:	83 c4 10             	add    $0x10,%esp
+}
+  800b5c:	c9                   	leave
+  800b5d:	c3                   	ret
+
+00800b5e <sys_open>:
+
+int
+sys_open(const char *path, uint32_t open_flags) {
+  800b5e:	55                   	push   %ebp
+  800b5f:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_open, path, open_flags);
+  800b61:	ff 75 0c             	push   0xc(%ebp)
+  800b64:	ff 75 08             	push   0x8(%ebp)
+  800b67:	6a 64                	push   $0x64
+  800b69:	e8 52 fe ff ff       	call   8009c0 <syscall>
+  800b6e:	83 c4 0c             	add    $0xc,%esp
+}
+  800b71:	c9                   	leave
+  800b72:	c3                   	ret
+
+00800b73 <sys_close>:
+
+int
+sys_close(int fd) {
+  800b73:	55                   	push   %ebp
+  800b74:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_close, fd);
+  800b76:	ff 75 08             	push   0x8(%ebp)
+  800b79:	6a 65                	push   $0x65
+  800b7b:	e8 40 fe ff ff       	call   8009c0 <syscall>
+  800b80:	83 c4 08             	add    $0x8,%esp
+}
+  800b83:	c9                   	leave
+  800b84:	c3                   	ret
+
+00800b85 <sys_read>:
+
+int
+sys_read(int fd, void *base, size_t len) {
+  800b85:	55                   	push   %ebp
+  800b86:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_read, fd, base, len);
+  800b88:	ff 75 10             	push   0x10(%ebp)
+  800b8b:	ff 75 0c             	push   0xc(%ebp)
+  800b8e:	ff 75 08             	push   0x8(%ebp)
+  800b91:	6a 66                	push   $0x66
+  800b93:	e8 28 fe ff ff       	call   8009c0 <syscall>
+  800b98:	83 c4 10             	add    $0x10,%esp
+}
+  800b9b:	c9                   	leave
+  800b9c:	c3                   	ret
+
+00800b9d <sys_write>:
+
+int
+sys_write(int fd, void *base, size_t len) {
+  800b9d:	55                   	push   %ebp
+  800b9e:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_write, fd, base, len);
+  800ba0:	ff 75 10             	push   0x10(%ebp)
+  800ba3:	ff 75 0c             	push   0xc(%ebp)
+  800ba6:	ff 75 08             	push   0x8(%ebp)
+  800ba9:	6a 67                	push   $0x67
+  800bab:	e8 10 fe ff ff       	call   8009c0 <syscall>
+  800bb0:	83 c4 10             	add    $0x10,%esp
+}
+  800bb3:	c9                   	leave
+  800bb4:	c3                   	ret
+
+00800bb5 <sys_seek>:
+
+int
+sys_seek(int fd, off_t pos, int whence) {
+  800bb5:	55                   	push   %ebp
+  800bb6:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_seek, fd, pos, whence);
+  800bb8:	ff 75 10             	push   0x10(%ebp)
+  800bbb:	ff 75 0c             	push   0xc(%ebp)
+  800bbe:	ff 75 08             	push   0x8(%ebp)
+  800bc1:	6a 68                	push   $0x68
+  800bc3:	e8 f8 fd ff ff       	call   8009c0 <syscall>
+  800bc8:	83 c4 10             	add    $0x10,%esp
+}
+  800bcb:	c9                   	leave
+  800bcc:	c3                   	ret
+
+00800bcd <sys_fstat>:
+
+int
+sys_fstat(int fd, struct stat *stat) {
+  800bcd:	55                   	push   %ebp
+  800bce:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_fstat, fd, stat);
+  800bd0:	ff 75 0c             	push   0xc(%ebp)
+  800bd3:	ff 75 08             	push   0x8(%ebp)
+  800bd6:	6a 6e                	push   $0x6e
+  800bd8:	e8 e3 fd ff ff       	call   8009c0 <syscall>
+  800bdd:	83 c4 0c             	add    $0xc,%esp
+}
+  800be0:	c9                   	leave
+  800be1:	c3                   	ret
+
+00800be2 <sys_fsync>:
+
+int
+sys_fsync(int fd) {
+  800be2:	55                   	push   %ebp
+  800be3:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_fsync, fd);
+  800be5:	ff 75 08             	push   0x8(%ebp)
+  800be8:	6a 6f                	push   $0x6f
+  800bea:	e8 d1 fd ff ff       	call   8009c0 <syscall>
+  800bef:	83 c4 08             	add    $0x8,%esp
+}
+  800bf2:	c9                   	leave
+  800bf3:	c3                   	ret
+
+00800bf4 <sys_getcwd>:
+
+int
+sys_getcwd(char *buffer, size_t len) {
+  800bf4:	55                   	push   %ebp
+  800bf5:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_getcwd, buffer, len);
+  800bf7:	ff 75 0c             	push   0xc(%ebp)
+  800bfa:	ff 75 08             	push   0x8(%ebp)
+  800bfd:	6a 79                	push   $0x79
+  800bff:	e8 bc fd ff ff       	call   8009c0 <syscall>
+  800c04:	83 c4 0c             	add    $0xc,%esp
+}
+  800c07:	c9                   	leave
+  800c08:	c3                   	ret
+
+00800c09 <sys_getdirentry>:
+
+int
+sys_getdirentry(int fd, struct dirent *dirent) {
+  800c09:	55                   	push   %ebp
+  800c0a:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_getdirentry, fd, dirent);
+  800c0c:	ff 75 0c             	push   0xc(%ebp)
+  800c0f:	ff 75 08             	push   0x8(%ebp)
+  800c12:	68 80 00 00 00       	push   $0x80
+  800c17:	e8 a4 fd ff ff       	call   8009c0 <syscall>
+  800c1c:	83 c4 0c             	add    $0xc,%esp
+}
+  800c1f:	c9                   	leave
+  800c20:	c3                   	ret
+
+00800c21 <sys_dup>:
+
+int
+sys_dup(int fd1, int fd2) {
+  800c21:	55                   	push   %ebp
+  800c22:	89 e5                	mov    %esp,%ebp
+    return syscall(SYS_dup, fd1, fd2);
+  800c24:	ff 75 0c             	push   0xc(%ebp)
+  800c27:	ff 75 08             	push   0x8(%ebp)
+  800c2a:	68 82 00 00 00       	push   $0x82
+  800c2f:	e8 8c fd ff ff       	call   8009c0 <syscall>
+  800c34:	83 c4 0c             	add    $0xc,%esp
+}
+  800c37:	c9                   	leave
+  800c38:	c3                   	ret
+
+00800c39 <try_lock>:
+lock_init(lock_t *l) {
+    *l = 0;
+}
+
+static inline bool
+try_lock(lock_t *l) {
+  800c39:	55                   	push   %ebp
+  800c3a:	89 e5                	mov    %esp,%ebp
+  800c3c:	83 ec 10             	sub    $0x10,%esp
+  800c3f:	c7 45 fc 00 00 00 00 	movl   $0x0,-0x4(%ebp)
+  800c46:	8b 45 08             	mov    0x8(%ebp),%eax
+  800c49:	89 45 f8             	mov    %eax,-0x8(%ebp)
+ * @addr:   the address to count from
+ * */
+static inline bool
+test_and_set_bit(int nr, volatile void *addr) {
+    int oldbit;
+    asm volatile ("btsl %2, %1; sbbl %0, %0" : "=r" (oldbit), "=m" (*(volatile long *)addr) : "Ir" (nr) : "memory");
+  800c4c:	8b 55 f8             	mov    -0x8(%ebp),%edx
+  800c4f:	8b 45 fc             	mov    -0x4(%ebp),%eax
+  800c52:	0f ab 02             	bts    %eax,(%edx)
+  800c55:	19 c0                	sbb    %eax,%eax
+  800c57:	89 45 f4             	mov    %eax,-0xc(%ebp)
+    return oldbit != 0;
+  800c5a:	83 7d f4 00          	cmpl   $0x0,-0xc(%ebp)
+  800c5e:	0f 95 c0             	setne  %al
+  800c61:	0f b6 c0             	movzbl %al,%eax
+    return test_and_set_bit(0, l);
+}
+  800c64:	c9                   	leave
+  800c65:	c3                   	ret
+
+00800c66 <lock>:
+
+static inline void
+lock(lock_t *l) {
+  800c66:	55                   	push   %ebp
+  800c67:	89 e5                	mov    %esp,%ebp
+  800c69:	83 ec 18             	sub    $0x18,%esp
+    if (try_lock(l)) {
+  800c6c:	ff 75 08             	push   0x8(%ebp)
+  800c6f:	e8 c5 ff ff ff       	call   800c39 <try_lock>
+  800c74:	83 c4 04             	add    $0x4,%esp
+  800c77:	85 c0                	test   %eax,%eax
+  800c79:	74 3c                	je     800cb7 <lock+0x51>
+        int step = 0;
+  800c7b:	c7 45 f4 00 00 00 00 	movl   $0x0,-0xc(%ebp)
+        do {
+            yield();
+  800c82:	e8 eb 00 00 00       	call   800d72 <yield>
+            if (++ step == 100) {
+  800c87:	83 45 f4 01          	addl   $0x1,-0xc(%ebp)
+  800c8b:	83 7d f4 64          	cmpl   $0x64,-0xc(%ebp)
+  800c8f:	75 14                	jne    800ca5 <lock+0x3f>
+                step = 0;
+  800c91:	c7 45 f4 00 00 00 00 	movl   $0x0,-0xc(%ebp)
+                sleep(10);
+  800c98:	83 ec 0c             	sub    $0xc,%esp
+  800c9b:	6a 0a                	push   $0xa
+  800c9d:	e8 26 01 00 00       	call   800dc8 <sleep>
+  800ca2:	83 c4 10             	add    $0x10,%esp
+            }
+        } while (try_lock(l));
+  800ca5:	83 ec 0c             	sub    $0xc,%esp
+  800ca8:	ff 75 08             	push   0x8(%ebp)
+  800cab:	e8 89 ff ff ff       	call   800c39 <try_lock>
+  800cb0:	83 c4 10             	add    $0x10,%esp
+  800cb3:	85 c0                	test   %eax,%eax
+  800cb5:	75 cb                	jne    800c82 <lock+0x1c>
+    }
+}
+  800cb7:	90                   	nop
+  800cb8:	c9                   	leave
+  800cb9:	c3                   	ret
+
+00800cba <unlock>:
+
+static inline void
+unlock(lock_t *l) {
+  800cba:	55                   	push   %ebp
+  800cbb:	89 e5                	mov    %esp,%ebp
+  800cbd:	83 ec 10             	sub    $0x10,%esp
+  800cc0:	c7 45 fc 00 00 00 00 	movl   $0x0,-0x4(%ebp)
+  800cc7:	8b 45 08             	mov    0x8(%ebp),%eax
+  800cca:	89 45 f8             	mov    %eax,-0x8(%ebp)
+ * @addr:   the address to count from
+ * */
+static inline bool
+test_and_clear_bit(int nr, volatile void *addr) {
+    int oldbit;
+    asm volatile ("btrl %2, %1; sbbl %0, %0" : "=r" (oldbit), "=m" (*(volatile long *)addr) : "Ir" (nr) : "memory");
+  800ccd:	8b 55 f8             	mov    -0x8(%ebp),%edx
+  800cd0:	8b 45 fc             	mov    -0x4(%ebp),%eax
+  800cd3:	0f b3 02             	btr    %eax,(%edx)
+  800cd6:	19 c0                	sbb    %eax,%eax
+  800cd8:	89 45 f4             	mov    %eax,-0xc(%ebp)
+    return oldbit != 0;
+  800cdb:	83 7d f4 00          	cmpl   $0x0,-0xc(%ebp)
+    test_and_clear_bit(0, l);
+}
+  800cdf:	90                   	nop
+  800ce0:	c9                   	leave
+  800ce1:	c3                   	ret
+
+00800ce2 <lock_fork>:
+#include <lock.h>
+
+static lock_t fork_lock = INIT_LOCK;
+
+void
+lock_fork(void) {
+  800ce2:	55                   	push   %ebp
+  800ce3:	89 e5                	mov    %esp,%ebp
+  800ce5:	83 ec 08             	sub    $0x8,%esp
+    lock(&fork_lock);
+  800ce8:	83 ec 0c             	sub    $0xc,%esp
+  800ceb:	68 6c 31 80 00       	push   $0x80316c
+  800cf0:	e8 71 ff ff ff       	call   800c66 <lock>
+  800cf5:	83 c4 10             	add    $0x10,%esp
+}
+  800cf8:	90                   	nop
+  800cf9:	c9                   	leave
+  800cfa:	c3                   	ret
+
+00800cfb <unlock_fork>:
+
+void
+unlock_fork(void) {
+  800cfb:	55                   	push   %ebp
+  800cfc:	89 e5                	mov    %esp,%ebp
+    unlock(&fork_lock);
+  800cfe:	68 6c 31 80 00       	push   $0x80316c
+  800d03:	e8 b2 ff ff ff       	call   800cba <unlock>
+  800d08:	83 c4 04             	add    $0x4,%esp
+}
+  800d0b:	90                   	nop
+  800d0c:	c9                   	leave
+  800d0d:	c3                   	ret
+
+00800d0e <exit>:
+
+void
+exit(int error_code) {
+  800d0e:	55                   	push   %ebp
+  800d0f:	89 e5                	mov    %esp,%ebp
+  800d11:	83 ec 08             	sub    $0x8,%esp
+    sys_exit(error_code);
+  800d14:	83 ec 0c             	sub    $0xc,%esp
+  800d17:	ff 75 08             	push   0x8(%ebp)
+  800d1a:	e8 f7 fc ff ff       	call   800a16 <sys_exit>
+  800d1f:	83 c4 10             	add    $0x10,%esp
+    cprintf("BUG: exit failed.\n");
+  800d22:	83 ec 0c             	sub    $0xc,%esp
+  800d25:	68 ce 1d 80 00       	push   $0x801dce
+  800d2a:	e8 95 fb ff ff       	call   8008c4 <cprintf>
+  800d2f:	83 c4 10             	add    $0x10,%esp
+    while (1);
+  800d32:	90                   	nop
+  800d33:	eb fd                	jmp    800d32 <exit+0x24>
+
+00800d35 <fork>:
+}
+
+int
+fork(void) {
+  800d35:	55                   	push   %ebp
+  800d36:	89 e5                	mov    %esp,%ebp
+  800d38:	83 ec 08             	sub    $0x8,%esp
+    return sys_fork();
+  800d3b:	e8 e8 fc ff ff       	call   800a28 <sys_fork>
+}
+  800d40:	c9                   	leave
+  800d41:	c3                   	ret
+
+00800d42 <wait>:
+
+int
+wait(void) {
+  800d42:	55                   	push   %ebp
+  800d43:	89 e5                	mov    %esp,%ebp
+  800d45:	83 ec 08             	sub    $0x8,%esp
+    return sys_wait(0, NULL);
+  800d48:	83 ec 08             	sub    $0x8,%esp
+  800d4b:	6a 00                	push   $0x0
+  800d4d:	6a 00                	push   $0x0
+  800d4f:	e8 e3 fc ff ff       	call   800a37 <sys_wait>
+  800d54:	83 c4 10             	add    $0x10,%esp
+}
+  800d57:	c9                   	leave
+  800d58:	c3                   	ret
+
+00800d59 <waitpid>:
+
+int
+waitpid(int pid, int *store) {
+  800d59:	55                   	push   %ebp
+  800d5a:	89 e5                	mov    %esp,%ebp
+  800d5c:	83 ec 08             	sub    $0x8,%esp
+    return sys_wait(pid, store);
+  800d5f:	83 ec 08             	sub    $0x8,%esp
+  800d62:	ff 75 0c             	push   0xc(%ebp)
+  800d65:	ff 75 08             	push   0x8(%ebp)
+  800d68:	e8 ca fc ff ff       	call   800a37 <sys_wait>
+  800d6d:	83 c4 10             	add    $0x10,%esp
+}
+  800d70:	c9                   	leave
+  800d71:	c3                   	ret
+
+00800d72 <yield>:
+
+void
+yield(void) {
+  800d72:	55                   	push   %ebp
+  800d73:	89 e5                	mov    %esp,%ebp
+  800d75:	83 ec 08             	sub    $0x8,%esp
+    sys_yield();
+  800d78:	e8 cf fc ff ff       	call   800a4c <sys_yield>
+}
+  800d7d:	90                   	nop
+  800d7e:	c9                   	leave
+  800d7f:	c3                   	ret
+
+00800d80 <kill>:
+
+int
+kill(int pid) {
+  800d80:	55                   	push   %ebp
+  800d81:	89 e5                	mov    %esp,%ebp
+  800d83:	83 ec 08             	sub    $0x8,%esp
+    return sys_kill(pid);
+  800d86:	83 ec 0c             	sub    $0xc,%esp
+  800d89:	ff 75 08             	push   0x8(%ebp)
+  800d8c:	e8 ca fc ff ff       	call   800a5b <sys_kill>
+  800d91:	83 c4 10             	add    $0x10,%esp
+}
+  800d94:	c9                   	leave
+  800d95:	c3                   	ret
+
+00800d96 <getpid>:
+
+int
+getpid(void) {
+  800d96:	55                   	push   %ebp
+  800d97:	89 e5                	mov    %esp,%ebp
+  800d99:	83 ec 08             	sub    $0x8,%esp
+    return sys_getpid();
+  800d9c:	e8 cc fc ff ff       	call   800a6d <sys_getpid>
+}
+  800da1:	c9                   	leave
+  800da2:	c3                   	ret
+
+00800da3 <print_pgdir>:
+
+//print_pgdir - print the PDT&PT
+void
+print_pgdir(void) {
+  800da3:	55                   	push   %ebp
+  800da4:	89 e5                	mov    %esp,%ebp
+  800da6:	83 ec 08             	sub    $0x8,%esp
+    sys_pgdir();
+  800da9:	e8 e0 fc ff ff       	call   800a8e <sys_pgdir>
+}
+  800dae:	90                   	nop
+  800daf:	c9                   	leave
+  800db0:	c3                   	ret
+
+00800db1 <lab6_set_priority>:
+
+void
+lab6_set_priority(uint32_t priority)
+{
+  800db1:	55                   	push   %ebp
+  800db2:	89 e5                	mov    %esp,%ebp
+  800db4:	83 ec 08             	sub    $0x8,%esp
+    sys_lab6_set_priority(priority);
+  800db7:	83 ec 0c             	sub    $0xc,%esp
+  800dba:	ff 75 08             	push   0x8(%ebp)
+  800dbd:	e8 db fc ff ff       	call   800a9d <sys_lab6_set_priority>
+  800dc2:	83 c4 10             	add    $0x10,%esp
+}
+  800dc5:	90                   	nop
+  800dc6:	c9                   	leave
+  800dc7:	c3                   	ret
+
+00800dc8 <sleep>:
+
+int
+sleep(unsigned int time) {
+  800dc8:	55                   	push   %ebp
+  800dc9:	89 e5                	mov    %esp,%ebp
+  800dcb:	83 ec 08             	sub    $0x8,%esp
+    return sys_sleep(time);
+  800dce:	83 ec 0c             	sub    $0xc,%esp
+  800dd1:	ff 75 08             	push   0x8(%ebp)
+  800dd4:	e8 da fc ff ff       	call   800ab3 <sys_sleep>
+  800dd9:	83 c4 10             	add    $0x10,%esp
+}
+  800ddc:	c9                   	leave
+  800ddd:	c3                   	ret
+
+00800dde <gettime_msec>:
+
+unsigned int
+gettime_msec(void) {
+  800dde:	55                   	push   %ebp
+  800ddf:	89 e5                	mov    %esp,%ebp
+  800de1:	83 ec 08             	sub    $0x8,%esp
+    return (unsigned int)sys_gettime();
+  800de4:	e8 dc fc ff ff       	call   800ac5 <sys_gettime>
+}
+  800de9:	c9                   	leave
+  800dea:	c3                   	ret
+
+00800deb <mmap>:
+
+// mmap - 建立映射, addr 为 NULL 时由内核选择地址; fd < 0 为匿名映射. 失败返回 NULL
+void *
+mmap(void *addr, size_t len, uint32_t mmap_flags, int fd, off_t offset) {
+  800deb:	55                   	push   %ebp
+  800dec:	89 e5                	mov    %esp,%ebp
+  800dee:	83 ec 18             	sub    $0x18,%esp
+    uintptr_t addr_store = (uintptr_t)addr;
+  800df1:	8b 45 08             	mov    0x8(%ebp),%eax
+  800df4:	89 45 f4             	mov    %eax,-0xc(%ebp)
+    if (sys_mmap(&addr_store, len, mmap_flags, fd, offset) != 0) {
+  800df7:	83 ec 0c             	sub    $0xc,%esp
+  800dfa:	ff 75 18             	push   0x18(%ebp)
+  800dfd:	ff 75 14             	push   0x14(%ebp)
+  800e00:	ff 75 10             	push   0x10(%ebp)
+  800e03:	ff 75 0c             	push   0xc(%ebp)
+  800e06:	8d 45 f4             	lea    -0xc(%ebp),%eax
+  800e09:	50                   	push   %eax
+  800e0a:	e8 c5 fc ff ff       	call   800ad4 <sys_mmap>
+  800e0f:	83 c4 20             	add    $0x20,%esp
+  800e12:	85 c0                	test   %eax,%eax
+  800e14:	74 07                	je     800e1d <mmap+0x32>
+        return NULL;
+  800e16:	b8 00 00 00 00       	mov    $0x0,%eax
+  800e1b:	eb 03                	jmp    800e20 <mmap+0x35>
+    }
+    return (void *)addr_store;
+  800e1d:	8b 45 f4             	mov    -0xc(%ebp),%eax
+}
+  800e20:	c9                   	leave
+  800e21:	c3                   	ret
+
+00800e22 <munmap>:
+
+int
+munmap(void *addr, size_t len) {
+  800e22:	55                   	push   %ebp
+  800e23:	89 e5                	mov    %esp,%ebp
+  800e25:	83 ec 08             	sub    $0x8,%esp
+    return sys_munmap((uintptr_t)addr, len);
+  800e28:	8b 45 08             	mov    0x8(%ebp),%eax
+  800e2b:	83 ec 08             	sub    $0x8,%esp
+  800e2e:	ff 75 0c             	push   0xc(%ebp)
+  800e31:	50                   	push   %eax
+  800e32:	e8 bb fc ff ff       	call   800af2 <sys_munmap>
+  800e37:	83 c4 10             	add    $0x10,%esp
+}
+  800e3a:	c9                   	leave
+  800e3b:	c3                   	ret
+
+00800e3c <brk>:
+
+// brk - 把堆的末尾设为 addr(内核按页向上取整)
+int
+brk(void *addr) {
+  800e3c:	55                   	push   %ebp
+  800e3d:	89 e5                	mov    %esp,%ebp
+  800e3f:	83 ec 18             	sub    $0x18,%esp
+    uintptr_t brk_store = (uintptr_t)addr;
+  800e42:	8b 45 08             	mov    0x8(%ebp),%eax
+  800e45:	89 45 f4             	mov    %eax,-0xc(%ebp)
+    return sys_brk(&brk_store);
+  800e48:	83 ec 0c             	sub    $0xc,%esp
+  800e4b:	8d 45 f4             	lea    -0xc(%ebp),%eax
+  800e4e:	50                   	push   %eax
+  800e4f:	e8 ce fc ff ff       	call   800b22 <sys_brk>
+  800e54:	83 c4 10             	add    $0x10,%esp
+}
+  800e57:	c9                   	leave
+  800e58:	c3                   	ret
+
+00800e59 <sbrk>:
+
+// sbrk - 把堆的末尾移动 increment 字节(按页取整), 返回原来的末尾; 失败返回 (void *)-1
+void *
+sbrk(intptr_t increment) {
+  800e59:	55                   	push   %ebp
+  800e5a:	89 e5                	mov    %esp,%ebp
+  800e5c:	83 ec 18             	sub    $0x18,%esp
+    uintptr_t old = 0, brk_store;
+  800e5f:	c7 45 f4 00 00 00 00 	movl   $0x0,-0xc(%ebp)
+    if (sys_brk(&old) != 0) {
+  800e66:	83 ec 0c             	sub    $0xc,%esp
+  800e69:	8d 45 f4             	lea    -0xc(%ebp),%eax
+  800e6c:	50                   	push   %eax
+  800e6d:	e8 b0 fc ff ff       	call   800b22 <sys_brk>
+  800e72:	83 c4 10             	add    $0x10,%esp
+  800e75:	85 c0                	test   %eax,%eax
+  800e77:	74 07                	je     800e80 <sbrk+0x27>
+        return (void *)-1;
+  800e79:	b8 ff ff ff ff       	mov    $0xffffffff,%eax
+  800e7e:	eb 2e                	jmp    800eae <sbrk+0x55>
+    }
+    if (increment != 0) {
+  800e80:	83 7d 08 00          	cmpl   $0x0,0x8(%ebp)
+  800e84:	74 25                	je     800eab <sbrk+0x52>
+        brk_store = old + increment;
+  800e86:	8b 55 f4             	mov    -0xc(%ebp),%edx
+  800e89:	8b 45 08             	mov    0x8(%ebp),%eax
+  800e8c:	01 d0                	add    %edx,%eax
+  800e8e:	89 45 f0             	mov    %eax,-0x10(%ebp)
+        if (sys_brk(&brk_store) != 0) {
+  800e91:	83 ec 0c             	sub    $0xc,%esp
+  800e94:	8d 45 f0             	lea    -0x10(%ebp),%eax
+  800e97:	50                   	push   %eax
+  800e98:	e8 85 fc ff ff       	call   800b22 <sys_brk>
+  800e9d:	83 c4 10             	add    $0x10,%esp
+  800ea0:	85 c0                	test   %eax,%eax
+  800ea2:	74 07                	je     800eab <sbrk+0x52>
+            return (void *)-1;
+  800ea4:	b8 ff ff ff ff       	mov    $0xffffffff,%eax
+  800ea9:	eb 03                	jmp    800eae <sbrk+0x55>
+        }
+    }
+    return (void *)old;
+  800eab:	8b 45 f4             	mov    -0xc(%ebp),%eax
+}
+  800eae:	c9                   	leave
+  800eaf:	c3                   	ret
+
+00800eb0 <ksm>:
+
+int
+ksm(int op) {
+  800eb0:	55                   	push   %ebp
+  800eb1:	89 e5                	mov    %esp,%ebp
+  800eb3:	83 ec 08             	sub    $0x8,%esp
+    return sys_ksm(op);
+  800eb6:	83 ec 0c             	sub    $0xc,%esp
+  800eb9:	ff 75 08             	push   0x8(%ebp)
+  800ebc:	e8 73 fc ff ff       	call   800b34 <sys_ksm>
+  800ec1:	83 c4 10             	add    $0x10,%esp
+}
+  800ec4:	c9                   	leave
+  800ec5:	c3                   	ret
+
+00800ec6 <__exec>:
+
+int
+__exec(const char *name, const char **argv) {
+  800ec6:	55                   	push   %ebp
+  800ec7:	89 e5                	mov    %esp,%ebp
+  800ec9:	83 ec 18             	sub    $0x18,%esp
+    int argc = 0;
+  800ecc:	c7 45 f4 00 00 00 00 	movl   $0x0,-0xc(%ebp)
+    while (argv[argc] != NULL) {
+  800ed3:	eb 04                	jmp    800ed9 <__exec+0x13>
+        argc ++;
+  800ed5:	83 45 f4 01          	addl   $0x1,-0xc(%ebp)
+    while (argv[argc] != NULL) {
+  800ed9:	8b 45 f4             	mov    -0xc(%ebp),%eax
+  800edc:	8d 14 85 00 00 00 00 	lea    0x0(,%eax,4),%edx
+  800ee3:	8b 45 0c             	mov    0xc(%ebp),%eax
+  800ee6:	01 d0                	add    %edx,%eax
+  800ee8:	8b 00                	mov    (%eax),%eax
+  800eea:	85 c0                	test   %eax,%eax
+  800eec:	75 e7                	jne    800ed5 <__exec+0xf>
+    }
+    return sys_exec(name, argc, argv);
+  800eee:	83 ec 04             	sub    $0x4,%esp
+  800ef1:	ff 75 0c             	push   0xc(%ebp)
+  800ef4:	ff 75 f4             	push   -0xc(%ebp)
+  800ef7:	ff 75 08             	push   0x8(%ebp)
+  800efa:	e8 47 fc ff ff       	call   800b46 <sys_exec>
+  800eff:	83 c4 10             	add    $0x10,%esp
+}
+  800f02:	c9                   	leave
+  800f03:	c3                   	ret
+
+00800f04 <initfd>:
+#include <stat.h>
+
+int main(int argc, char *argv[]);
+
+static int
+initfd(int fd2, const char *path, uint32_t open_flags) {
+  800f04:	55                   	push   %ebp
+  800f05:	89 e5                	mov    %esp,%ebp
+  800f07:	83 ec 18             	sub    $0x18,%esp
+    int fd1, ret;
+    if ((fd1 = open(path, open_flags)) < 0) {
+  800f0a:	83 ec 08             	sub    $0x8,%esp
+  800f0d:	ff 75 10             	push   0x10(%ebp)
+  800f10:	ff 75 0c             	push   0xc(%ebp)
+  800f13:	e8 e3 f1 ff ff       	call   8000fb <open>
+  800f18:	83 c4 10             	add    $0x10,%esp
+  800f1b:	89 45 f0             	mov    %eax,-0x10(%ebp)
+  800f1e:	83 7d f0 00          	cmpl   $0x0,-0x10(%ebp)
+  800f22:	79 05                	jns    800f29 <initfd+0x25>
+        return fd1;
+  800f24:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  800f27:	eb 3b                	jmp    800f64 <initfd+0x60>
+    }
+    if (fd1 != fd2) {
+  800f29:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  800f2c:	3b 45 08             	cmp    0x8(%ebp),%eax
+  800f2f:	74 30                	je     800f61 <initfd+0x5d>
+        close(fd2);
+  800f31:	83 ec 0c             	sub    $0xc,%esp
+  800f34:	ff 75 08             	push   0x8(%ebp)
+  800f37:	e8 d8 f1 ff ff       	call   800114 <close>
+  800f3c:	83 c4 10             	add    $0x10,%esp
+        ret = dup2(fd1, fd2);
+  800f3f:	83 ec 08             	sub    $0x8,%esp
+  800f42:	ff 75 08             	push   0x8(%ebp)
+  800f45:	ff 75 f0             	push   -0x10(%ebp)
+  800f48:	e8 60 f2 ff ff       	call   8001ad <dup2>
+  800f4d:	83 c4 10             	add    $0x10,%esp
+  800f50:	89 45 f4             	mov    %eax,-0xc(%ebp)
+        close(fd1);
+  800f53:	83 ec 0c             	sub    $0xc,%esp
+  800f56:	ff 75 f0             	push   -0x10(%ebp)
+  800f59:	e8 b6 f1 ff ff       	call   800114 <close>
+  800f5e:	83 c4 10             	add    $0x10,%esp
+    }
+    return ret;
+  800f61:	8b 45 f4             	mov    -0xc(%ebp),%eax
+}
+  800f64:	c9                   	leave
+  800f65:	c3                   	ret
+
+00800f66 <umain>:
+
+void
+umain(int argc, char *argv[]) {
+  800f66:	55                   	push   %ebp
+  800f67:	89 e5                	mov    %esp,%ebp
+  800f69:	83 ec 18             	sub    $0x18,%esp
+    int fd;
+    if ((fd = initfd(0, "stdin:", O_RDONLY)) < 0) {
+  800f6c:	83 ec 04             	sub    $0x4,%esp
+  800f6f:	6a 00                	push   $0x0
+  800f71:	68 e1 1d 80 00       	push   $0x801de1
+  800f76:	6a 00                	push   $0x0
+  800f78:	e8 87 ff ff ff       	call   800f04 <initfd>
+  800f7d:	83 c4 10             	add    $0x10,%esp
+  800f80:	89 45 f4             	mov    %eax,-0xc(%ebp)
+  800f83:	83 7d f4 00          	cmpl   $0x0,-0xc(%ebp)
+  800f87:	79 17                	jns    800fa0 <umain+0x3a>
+        warn("open <stdin> failed: %e.\n", fd);
+  800f89:	ff 75 f4             	push   -0xc(%ebp)
+  800f8c:	68 e8 1d 80 00       	push   $0x801de8
+  800f91:	6a 1a                	push   $0x1a
+  800f93:	68 02 1e 80 00       	push   $0x801e02
+  800f98:	e8 3f f8 ff ff       	call   8007dc <__warn>
+  800f9d:	83 c4 10             	add    $0x10,%esp
+    }
+    if ((fd = initfd(1, "stdout:", O_WRONLY)) < 0) {
+  800fa0:	83 ec 04             	sub    $0x4,%esp
+  800fa3:	6a 01                	push   $0x1
+  800fa5:	68 14 1e 80 00       	push   $0x801e14
+  800faa:	6a 01                	push   $0x1
+  800fac:	e8 53 ff ff ff       	call   800f04 <initfd>
+  800fb1:	83 c4 10             	add    $0x10,%esp
+  800fb4:	89 45 f4             	mov    %eax,-0xc(%ebp)
+  800fb7:	83 7d f4 00          	cmpl   $0x0,-0xc(%ebp)
+  800fbb:	79 17                	jns    800fd4 <umain+0x6e>
+        warn("open <stdout> failed: %e.\n", fd);
+  800fbd:	ff 75 f4             	push   -0xc(%ebp)
+  800fc0:	68 1c 1e 80 00       	push   $0x801e1c
+  800fc5:	6a 1d                	push   $0x1d
+  800fc7:	68 02 1e 80 00       	push   $0x801e02
+  800fcc:	e8 0b f8 ff ff       	call   8007dc <__warn>
+  800fd1:	83 c4 10             	add    $0x10,%esp
+    }
+    int ret = main(argc, argv);
+  800fd4:	83 ec 08             	sub    $0x8,%esp
+  800fd7:	ff 75 0c             	push   0xc(%ebp)
+  800fda:	ff 75 08             	push   0x8(%ebp)
+  800fdd:	e8 40 0c 00 00       	call   801c22 <main>
+  800fe2:	83 c4 10             	add    $0x10,%esp
+  800fe5:	89 45 f0             	mov    %eax,-0x10(%ebp)
+    exit(ret);
+  800fe8:	83 ec 0c             	sub    $0xc,%esp
+  800feb:	ff 75 f0             	push   -0x10(%ebp)
+  800fee:	e8 1b fd ff ff       	call   800d0e <exit>
+
+00800ff3 <vfork>:
+# 所以返回地址保存在 ecx 中(系统调用保留所有通用寄存器, 子进程复制了父进程的寄存器),
+# 两个进程各自从 ecx 取回返回地址, 不依赖栈上的内容.
+.text
+.globl vfork
+vfork:
+    popl %ecx
+  800ff3:	59                   	pop    %ecx
+    movl $SYS_vfork, %eax
+  800ff4:	b8 06 00 00 00       	mov    $0x6,%eax
+    int $T_SYSCALL
+  800ff9:	cd 80                	int    $0x80
+    pushl %ecx
+  800ffb:	51                   	push   %ecx
+    ret
+  800ffc:	c3                   	ret
+
+00800ffd <hash32>:
+ * @bits:   the number of bits in a return value
+ *
+ * High bits are more random, so we use them.
+ * */
+uint32_t
+hash32(uint32_t val, unsigned int bits) {
+  800ffd:	55                   	push   %ebp
+  800ffe:	89 e5                	mov    %esp,%ebp
+  801000:	83 ec 10             	sub    $0x10,%esp
+    uint32_t hash = val * GOLDEN_RATIO_PRIME_32;
+  801003:	8b 45 08             	mov    0x8(%ebp),%eax
+  801006:	69 c0 01 00 37 9e    	imul   $0x9e370001,%eax,%eax
+  80100c:	89 45 fc             	mov    %eax,-0x4(%ebp)
+    return (hash >> (32 - bits));
+  80100f:	b8 20 00 00 00       	mov    $0x20,%eax
+  801014:	2b 45 0c             	sub    0xc(%ebp),%eax
+  801017:	8b 55 fc             	mov    -0x4(%ebp),%edx
+  80101a:	89 c1                	mov    %eax,%ecx
+  80101c:	d3 ea                	shr    %cl,%edx
+  80101e:	89 d0                	mov    %edx,%eax
+}
+  801020:	c9                   	leave
+  801021:	c3                   	ret
+
+00801022 <printnum>:
+ * @width:      maximum number of digits, if the actual width is less than @width, use @padc instead
+ * @padc:       character that padded on the left if the actual width is less than @width
+ * */
+static void
+printnum(void (*putch)(int, void*, int), int fd, void *putdat,
+        unsigned long long num, unsigned base, int width, int padc) {
+  801022:	55                   	push   %ebp
+  801023:	89 e5                	mov    %esp,%ebp
+  801025:	83 ec 38             	sub    $0x38,%esp
+  801028:	8b 45 14             	mov    0x14(%ebp),%eax
+  80102b:	89 45 d0             	mov    %eax,-0x30(%ebp)
+  80102e:	8b 45 18             	mov    0x18(%ebp),%eax
+  801031:	89 45 d4             	mov    %eax,-0x2c(%ebp)
+    unsigned long long result = num;
+  801034:	8b 45 d0             	mov    -0x30(%ebp),%eax
+  801037:	8b 55 d4             	mov    -0x2c(%ebp),%edx
+  80103a:	89 45 e8             	mov    %eax,-0x18(%ebp)
+  80103d:	89 55 ec             	mov    %edx,-0x14(%ebp)
+    unsigned mod = do_div(result, base);
+  801040:	8b 45 1c             	mov    0x1c(%ebp),%eax
+  801043:	89 45 e4             	mov    %eax,-0x1c(%ebp)
+  801046:	8b 45 e8             	mov    -0x18(%ebp),%eax
+  801049:	8b 55 ec             	mov    -0x14(%ebp),%edx
+  80104c:	89 45 e0             	mov    %eax,-0x20(%ebp)
+  80104f:	89 55 f0             	mov    %edx,-0x10(%ebp)
+  801052:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  801055:	89 45 f4             	mov    %eax,-0xc(%ebp)
+  801058:	83 7d f0 00          	cmpl   $0x0,-0x10(%ebp)
+  80105c:	74 1c                	je     80107a <printnum+0x58>
+  80105e:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  801061:	ba 00 00 00 00       	mov    $0x0,%edx
+  801066:	f7 75 e4             	divl   -0x1c(%ebp)
+  801069:	89 55 f4             	mov    %edx,-0xc(%ebp)
+  80106c:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  80106f:	ba 00 00 00 00       	mov    $0x0,%edx
+  801074:	f7 75 e4             	divl   -0x1c(%ebp)
+  801077:	89 45 f0             	mov    %eax,-0x10(%ebp)
+  80107a:	8b 45 e0             	mov    -0x20(%ebp),%eax
+  80107d:	8b 55 f4             	mov    -0xc(%ebp),%edx
+  801080:	f7 75 e4             	divl   -0x1c(%ebp)
+  801083:	89 45 e0             	mov    %eax,-0x20(%ebp)
+  801086:	89 55 dc             	mov    %edx,-0x24(%ebp)
+  801089:	8b 45 e0             	mov    -0x20(%ebp),%eax
+  80108c:	8b 55 f0             	mov    -0x10(%ebp),%edx
+  80108f:	89 45 e8             	mov    %eax,-0x18(%ebp)
+  801092:	89 55 ec             	mov    %edx,-0x14(%ebp)
+  801095:	8b 45 dc             	mov    -0x24(%ebp),%eax
+  801098:	89 45 d8             	mov    %eax,-0x28(%ebp)
+
+    // first recursively print all preceding (more significant) digits
+    if (num >= base) {
+  80109b:	8b 45 1c             	mov    0x1c(%ebp),%eax
+  80109e:	ba 00 00 00 00       	mov    $0x0,%edx
+  8010a3:	8b 4d d4             	mov    -0x2c(%ebp),%ecx
+  8010a6:	39 45 d0             	cmp    %eax,-0x30(%ebp)
+  8010a9:	19 d1                	sbb    %edx,%ecx
+  8010ab:	72 3a                	jb     8010e7 <printnum+0xc5>
+        printnum(putch, fd, putdat, result, base, width - 1, padc);
+  8010ad:	8b 45 20             	mov    0x20(%ebp),%eax
+  8010b0:	83 e8 01             	sub    $0x1,%eax
+  8010b3:	ff 75 24             	push   0x24(%ebp)
+  8010b6:	50                   	push   %eax
+  8010b7:	ff 75 1c             	push   0x1c(%ebp)
+  8010ba:	ff 75 ec             	push   -0x14(%ebp)
+  8010bd:	ff 75 e8             	push   -0x18(%ebp)
+  8010c0:	ff 75 10             	push   0x10(%ebp)
+  8010c3:	ff 75 0c             	push   0xc(%ebp)
+  8010c6:	ff 75 08             	push   0x8(%ebp)
+  8010c9:	e8 54 ff ff ff       	call   801022 <printnum>
+  8010ce:	83 c4 20             	add    $0x20,%esp
+  8010d1:	eb 1e                	jmp    8010f1 <printnum+0xcf>
+    } else {
+        // print any needed pad characters before first digit
+        while (-- width > 0)
+            putch(padc, putdat, fd);
+  8010d3:	83 ec 04             	sub    $0x4,%esp
+  8010d6:	ff 75 0c             	push   0xc(%ebp)
+  8010d9:	ff 75 10             	push   0x10(%ebp)
+  8010dc:	ff 75 24             	push   0x24(%ebp)
+  8010df:	8b 45 08             	mov    0x8(%ebp),%eax
+  8010e2:	ff d0                	call   *%eax
+  8010e4:	83 c4 10             	add    $0x10,%esp
+        while (-- width > 0)
+  8010e7:	83 6d 20 01          	subl   $0x1,0x20(%ebp)
+  8010eb:	83 7d 20 00          	cmpl   $0x0,0x20(%ebp)
+  8010ef:	7f e2                	jg     8010d3 <printnum+0xb1>
+    }
+    // then print this (the least significant) digit
+    putch("0123456789abcdef"[mod], putdat, fd);
+  8010f1:	8b 45 d8             	mov    -0x28(%ebp),%eax
+  8010f4:	05 44 20 80 00       	add    $0x802044,%eax
+  8010f9:	0f b6 00             	movzbl (%eax),%eax
+  8010fc:	0f be c0             	movsbl %al,%eax
+  8010ff:	83 ec 04             	sub    $0x4,%esp
+  801102:	ff 75 0c             	push   0xc(%ebp)
+  801105:	ff 75 10             	push   0x10(%ebp)
+  801108:	50                   	push   %eax
+  801109:	8b 45 08             	mov    0x8(%ebp),%eax
+  80110c:	ff d0                	call   *%eax
+  80110e:	83 c4 10             	add    $0x10,%esp
+}
+  801111:	90                   	nop
+  801112:	c9                   	leave
+  801113:	c3                   	ret
+
+00801114 <getuint>:
+ * getuint - get an unsigned int of various possible sizes from a varargs list
+ * @ap:         a varargs list pointer
+ * @lflag:      determines the size of the vararg that @ap points to
+ * */
+static unsigned long long
+getuint(va_list *ap, int lflag) {
+  801114:	55                   	push   %ebp
+  801115:	89 e5                	mov    %esp,%ebp
+    if (lflag >= 2) {
+  801117:	83 7d 0c 01          	cmpl   $0x1,0xc(%ebp)
+  80111b:	7e 14                	jle    801131 <getuint+0x1d>
+        return va_arg(*ap, unsigned long long);
+  80111d:	8b 45 08             	mov    0x8(%ebp),%eax
+  801120:	8b 00                	mov    (%eax),%eax
+  801122:	8d 48 08             	lea    0x8(%eax),%ecx
+  801125:	8b 55 08             	mov    0x8(%ebp),%edx
+  801128:	89 0a                	mov    %ecx,(%edx)
+  80112a:	8b 50 04             	mov    0x4(%eax),%edx
+  80112d:	8b 00                	mov    (%eax),%eax
+  80112f:	eb 30                	jmp    801161 <getuint+0x4d>
+    }
+    else if (lflag) {
+  801131:	83 7d 0c 00          	cmpl   $0x0,0xc(%ebp)
+  801135:	74 16                	je     80114d <getuint+0x39>
+        return va_arg(*ap, unsigned long);
+  801137:	8b 45 08             	mov    0x8(%ebp),%eax
+  80113a:	8b 00                	mov    (%eax),%eax
+  80113c:	8d 48 04             	lea    0x4(%eax),%ecx
+  80113f:	8b 55 08             	mov    0x8(%ebp),%edx
+  801142:	89 0a                	mov    %ecx,(%edx)
+  801144:	8b 00                	mov    (%eax),%eax
+  801146:	ba 00 00 00 00       	mov    $0x0,%edx
+  80114b:	eb 14                	jmp    801161 <getuint+0x4d>
+    }
+    else {
+        return va_arg(*ap, unsigned int);
+  80114d:	8b 45 08             	mov    0x8(%ebp),%eax
+  801150:	8b 00                	mov    (%eax),%eax
+  801152:	8d 48 04             	lea    0x4(%eax),%ecx
+  801155:	8b 55 08             	mov    0x8(%ebp),%edx
+  801158:	89 0a                	mov    %ecx,(%edx)
+  80115a:	8b 00                	mov    (%eax),%eax
+  80115c:	ba 00 00 00 00       	mov    $0x0,%edx
+    }
+}
+  801161:	5d                   	pop    %ebp
+  801162:	c3                   	ret
+
+00801163 <getint>:
+ * getint - same as getuint but signed, we can't use getuint because of sign extension
+ * @ap:         a varargs list pointer
+ * @lflag:      determines the size of the vararg that @ap points to
+ * */
+static long long
+getint(va_list *ap, int lflag) {
+  801163:	55                   	push   %ebp
+  801164:	89 e5                	mov    %esp,%ebp
+    if (lflag >= 2) {
+  801166:	83 7d 0c 01          	cmpl   $0x1,0xc(%ebp)
+  80116a:	7e 14                	jle    801180 <getint+0x1d>
+        return va_arg(*ap, long long);
+  80116c:	8b 45 08             	mov    0x8(%ebp),%eax
+  80116f:	8b 00                	mov    (%eax),%eax
+  801171:	8d 48 08             	lea    0x8(%eax),%ecx
+  801174:	8b 55 08             	mov    0x8(%ebp),%edx
+  801177:	89 0a                	mov    %ecx,(%edx)
+  801179:	8b 50 04             	mov    0x4(%eax),%edx
+  80117c:	8b 00                	mov    (%eax),%eax
+  80117e:	eb 28                	jmp    8011a8 <getint+0x45>
+    }
+    else if (lflag) {
+  801180:	83 7d 0c 00          	cmpl   $0x0,0xc(%ebp)
+  801184:	74 12                	je     801198 <getint+0x35>
+        return va_arg(*ap, long);
+  801186:	8b 45 08             	mov    0x8(%ebp),%eax
+  801189:	8b 00                	mov    (%eax),%eax
+  80118b:	8d 48 04             	lea    0x4(%eax),%ecx
+  80118e:	8b 55 08             	mov    0x8(%ebp),%edx
+  801191:	89 0a                	mov    %ecx,(%edx)
+  801193:	8b 00                	mov    (%eax),%eax
+  801195:	99                   	cltd
+  801196:	eb 10                	jmp    8011a8 <getint+0x45>
+    }
+    else {
+        return va_arg(*ap, int);
+  801198:	8b 45 08             	mov    0x8(%ebp),%eax
+  80119b:	8b 00                	mov    (%eax),%eax
+  80119d:	8d 48 04             	lea    0x4(%eax),%ecx
+  8011a0:	8b 55 08             	mov    0x8(%ebp),%edx
+  8011a3:	89 0a                	mov    %ecx,(%edx)
+  8011a5:	8b 00                	mov    (%eax),%eax
+  8011a7:	99                   	cltd
+    }
+}
+  8011a8:	5d                   	pop    %ebp
+  8011a9:	c3                   	ret
+
+008011aa <printfmt>:
+ * @fd:         file descriptor
+ * @putdat:     used by @putch function
+ * @fmt:        the format string to use
+ * */
+void
+printfmt(void (*putch)(int, void*, int), int fd, void *putdat, const char *fmt, ...) {
+  8011aa:	55                   	push   %ebp
+  8011ab:	89 e5                	mov    %esp,%ebp
+  8011ad:	83 ec 18             	sub    $0x18,%esp
+    va_list ap;
+
+    va_start(ap, fmt);
+  8011b0:	8d 45 18             	lea    0x18(%ebp),%eax
+  8011b3:	89 45 f4             	mov    %eax,-0xc(%ebp)
+    vprintfmt(putch, fd, putdat, fmt, ap);
+  8011b6:	8b 45 f4             	mov    -0xc(%ebp),%eax
+  8011b9:	83 ec 0c             	sub    $0xc,%esp
+  8011bc:	50                   	push   %eax
+  8011bd:	ff 75 14             	push   0x14(%ebp)
+  8011c0:	ff 75 10             	push   0x10(%ebp)
+  8011c3:	ff 75 0c             	push   0xc(%ebp)
+  8011c6:	ff 75 08             	push   0x8(%ebp)
+  8011c9:	e8 06 00 00 00       	call   8011d4 <vprintfmt>
+  8011ce:	83 c4 20             	add    $0x20,%esp
+    va_end(ap);
+}
+  8011d1:	90                   	nop
+  8011d2:	c9                   	leave
+  8011d3:	c3                   	ret
+
+008011d4 <vprintfmt>:
+ *
+ * Call this function if you are already dealing with a va_list.
+ * Or you probably want printfmt() instead.
+ * */
+void
+vprintfmt(void (*putch)(int, void*, int), int fd, void *putdat, const char *fmt, va_list ap) {
+  8011d4:	55                   	push   %ebp
+  8011d5:	89 e5                	mov    %esp,%ebp
+  8011d7:	56                   	push   %esi
+  8011d8:	53                   	push   %ebx
+  8011d9:	83 ec 20             	sub    $0x20,%esp
+    register int ch, err;
+    unsigned long long num;
+    int base, width, precision, lflag, altflag;
+
+    while (1) {
+        while ((ch = *(unsigned char *)fmt ++) != '%') {
+  8011dc:	eb 1a                	jmp    8011f8 <vprintfmt+0x24>
+            if (ch == '\0') {
+  8011de:	85 db                	test   %ebx,%ebx
+  8011e0:	0f 84 c2 03 00 00    	je     8015a8 <vprintfmt+0x3d4>
+                return;
+            }
+            putch(ch, putdat, fd);
+  8011e6:	83 ec 04             	sub    $0x4,%esp
+  8011e9:	ff 75 0c             	push   0xc(%ebp)
+  8011ec:	ff 75 10             	push   0x10(%ebp)
+  8011ef:	53                   	push   %ebx
+  8011f0:	8b 45 08             	mov    0x8(%ebp),%eax
+  8011f3:	ff d0                	call   *%eax
+  8011f5:	83 c4 10             	add    $0x10,%esp
+        while ((ch = *(unsigned char *)fmt ++) != '%') {
+  8011f8:	8b 45 14             	mov    0x14(%ebp),%eax
+  8011fb:	8d 50 01             	lea    0x1(%eax),%edx
+  8011fe:	89 55 14             	mov    %edx,0x14(%ebp)
+  801201:	0f b6 00             	movzbl (%eax),%eax
+  801204:	0f b6 d8             	movzbl %al,%ebx
+  801207:	83 fb 25             	cmp    $0x25,%ebx
+  80120a:	75 d2                	jne    8011de <vprintfmt+0xa>
+        }
+
+        // Process a %-escape sequence
+        char padc = ' ';
+  80120c:	c6 45 db 20          	movb   $0x20,-0x25(%ebp)
+        width = precision = -1;
+  801210:	c7 45 e4 ff ff ff ff 	movl   $0xffffffff,-0x1c(%ebp)
+  801217:	8b 45 e4             	mov    -0x1c(%ebp),%eax
+  80121a:	89 45 e8             	mov    %eax,-0x18(%ebp)
+        lflag = altflag = 0;
+  80121d:	c7 45 dc 00 00 00 00 	movl   $0x0,-0x24(%ebp)
+  801224:	8b 45 dc             	mov    -0x24(%ebp),%eax
+  801227:	89 45 e0             	mov    %eax,-0x20(%ebp)
+  80122a:	eb 04                	jmp    801230 <vprintfmt+0x5c>
+            goto process_precision;
+
+        case '.':
+            if (width < 0)
+                width = 0;
+            goto reswitch;
+  80122c:	90                   	nop
+  80122d:	eb 01                	jmp    801230 <vprintfmt+0x5c>
+            goto reswitch;
+
+        process_precision:
+            if (width < 0)
+                width = precision, precision = -1;
+            goto reswitch;
+  80122f:	90                   	nop
+        switch (ch = *(unsigned char *)fmt ++) {
+  801230:	8b 45 14             	mov    0x14(%ebp),%eax
+  801233:	8d 50 01             	lea    0x1(%eax),%edx
+  801236:	89 55 14             	mov    %edx,0x14(%ebp)
+  801239:	0f b6 00             	movzbl (%eax),%eax
+  80123c:	0f b6 d8             	movzbl %al,%ebx
+  80123f:	8d 43 dd             	lea    -0x23(%ebx),%eax
+  801242:	83 f8 55             	cmp    $0x55,%eax
+  801245:	0f 87 2d 03 00 00    	ja     801578 <vprintfmt+0x3a4>
+  80124b:	8b 04 85 68 20 80 00 	mov    0x802068(,%eax,4),%eax
+  801252:	ff e0                	jmp    *%eax
+            padc = '-';
+  801254:	c6 45 db 2d          	movb   $0x2d,-0x25(%ebp)
+            goto reswitch;
+  801258:	eb d6                	jmp    801230 <vprintfmt+0x5c>
+            padc = '0';
+  80125a:	c6 45 db 30          	movb   $0x30,-0x25(%ebp)
+            goto reswitch;
+  80125e:	eb d0                	jmp    801230 <vprintfmt+0x5c>
+            for (precision = 0; ; ++ fmt) {
+  801260:	c7 45 e4 00 00 00 00 	movl   $0x0,-0x1c(%ebp)
+                precision = precision * 10 + ch - '0';
+  801267:	8b 55 e4             	mov    -0x1c(%ebp),%edx
+  80126a:	89 d0                	mov    %edx,%eax
+  80126c:	c1 e0 02             	shl    $0x2,%eax
+  80126f:	01 d0                	add    %edx,%eax
+  801271:	01 c0                	add    %eax,%eax
+  801273:	01 d8                	add    %ebx,%eax
+  801275:	83 e8 30             	sub    $0x30,%eax
+  801278:	89 45 e4             	mov    %eax,-0x1c(%ebp)
+                ch = *fmt;
+  80127b:	8b 45 14             	mov    0x14(%ebp),%eax
+  80127e:	0f b6 00             	movzbl (%eax),%eax
+  801281:	0f be d8             	movsbl %al,%ebx
+                if (ch < '0' || ch > '9') {
+  801284:	83 fb 2f             	cmp    $0x2f,%ebx
+  801287:	7e 39                	jle    8012c2 <vprintfmt+0xee>
+  801289:	83 fb 39             	cmp    $0x39,%ebx
+  80128c:	7f 34                	jg     8012c2 <vprintfmt+0xee>
+            for (precision = 0; ; ++ fmt) {
+  80128e:	83 45 14 01          	addl   $0x1,0x14(%ebp)
+                precision = precision * 10 + ch - '0';
+  801292:	eb d3                	jmp    801267 <vprintfmt+0x93>
+            precision = va_arg(ap, int);
+  801294:	8b 45 18             	mov    0x18(%ebp),%eax
+  801297:	8d 50 04             	lea    0x4(%eax),%edx
+  80129a:	89 55 18             	mov    %edx,0x18(%ebp)
+  80129d:	8b 00                	mov    (%eax),%eax
+  80129f:	89 45 e4             	mov    %eax,-0x1c(%ebp)
+            goto process_precision;
+  8012a2:	eb 1f                	jmp    8012c3 <vprintfmt+0xef>
+            if (width < 0)
+  8012a4:	83 7d e8 00          	cmpl   $0x0,-0x18(%ebp)
+  8012a8:	79 82                	jns    80122c <vprintfmt+0x58>
+                width = 0;
+  8012aa:	c7 45 e8 00 00 00 00 	movl   $0x0,-0x18(%ebp)
+            goto reswitch;
+  8012b1:	e9 76 ff ff ff       	jmp    80122c <vprintfmt+0x58>
+            altflag = 1;
+  8012b6:	c7 45 dc 01 00 00 00 	movl   $0x1,-0x24(%ebp)
+            goto reswitch;
+  8012bd:	e9 6e ff ff ff       	jmp    801230 <vprintfmt+0x5c>
+            goto process_precision;
+  8012c2:	90                   	nop
+            if (width < 0)
+  8012c3:	83 7d e8 00          	cmpl   $0x0,-0x18(%ebp)
+  8012c7:	0f 89 62 ff ff ff    	jns    80122f <vprintfmt+0x5b>
+                width = precision, precision = -1;
+  8012cd:	8b 45 e4             	mov    -0x1c(%ebp),%eax
+  8012d0:	89 45 e8             	mov    %eax,-0x18(%ebp)
+  8012d3:	c7 45 e4 ff ff ff ff 	movl   $0xffffffff,-0x1c(%ebp)
+            goto reswitch;
+  8012da:	e9 50 ff ff ff       	jmp    80122f <vprintfmt+0x5b>
+
+        // long flag (doubled for long long)
+        case 'l':
+            lflag ++;
+  8012df:	83 45 e0 01          	addl   $0x1,-0x20(%ebp)
+            goto reswitch;
+  8012e3:	e9 48 ff ff ff       	jmp    801230 <vprintfmt+0x5c>
+
+        // character
+        case 'c':
+            putch(va_arg(ap, int), putdat, fd);
+  8012e8:	8b 45 18             	mov    0x18(%ebp),%eax
+  8012eb:	8d 50 04             	lea    0x4(%eax),%edx
+  8012ee:	89 55 18             	mov    %edx,0x18(%ebp)
+  8012f1:	8b 00                	mov    (%eax),%eax
+  8012f3:	83 ec 04             	sub    $0x4,%esp
+  8012f6:	ff 75 0c             	push   0xc(%ebp)
+  8012f9:	ff 75 10             	push   0x10(%ebp)
+  8012fc:	50                   	push   %eax
+  8012fd:	8b 45 08             	mov    0x8(%ebp),%eax
+  801300:	ff d0                	call   *%eax
+  801302:	83 c4 10             	add    $0x10,%esp
+            break;
+  801305:	e9 99 02 00 00       	jmp    8015a3 <vprintfmt+0x3cf>
+
+        // error message
+        case 'e':
+            err = va_arg(ap, int);
+  80130a:	8b 45 18             	mov    0x18(%ebp),%eax
+  80130d:	8d 50 04             	lea    0x4(%eax),%edx
+  801310:	89 55 18             	mov    %edx,0x18(%ebp)
+  801313:	8b 18                	mov    (%eax),%ebx
+            if (err < 0) {
+  801315:	85 db                	test   %ebx,%ebx
+  801317:	79 02                	jns    80131b <vprintfmt+0x147>
+                err = -err;
+  801319:	f7 db                	neg    %ebx
+            }
+            if (err > MAXERROR || (p = error_string[err]) == NULL) {
+  80131b:	83 fb 18             	cmp    $0x18,%ebx
+  80131e:	7f 0b                	jg     80132b <vprintfmt+0x157>
+  801320:	8b 34 9d e0 1f 80 00 	mov    0x801fe0(,%ebx,4),%esi
+  801327:	85 f6                	test   %esi,%esi
+  801329:	75 1f                	jne    80134a <vprintfmt+0x176>
+                printfmt(putch, fd, putdat, "error %d", err);
+  80132b:	83 ec 0c             	sub    $0xc,%esp
+  80132e:	53                   	push   %ebx
+  80132f:	68 55 20 80 00       	push   $0x802055
+  801334:	ff 75 10             	push   0x10(%ebp)
+  801337:	ff 75 0c             	push   0xc(%ebp)
+  80133a:	ff 75 08             	push   0x8(%ebp)
+  80133d:	e8 68 fe ff ff       	call   8011aa <printfmt>
+  801342:	83 c4 20             	add    $0x20,%esp
+            }
+            else {
+                printfmt(putch, fd, putdat, "%s", p);
+            }
+            break;
+  801345:	e9 59 02 00 00       	jmp    8015a3 <vprintfmt+0x3cf>
+                printfmt(putch, fd, putdat, "%s", p);
+  80134a:	83 ec 0c             	sub    $0xc,%esp
+  80134d:	56                   	push   %esi
+  80134e:	68 5e 20 80 00       	push   $0x80205e
+  801353:	ff 75 10             	push   0x10(%ebp)
+  801356:	ff 75 0c             	push   0xc(%ebp)
+  801359:	ff 75 08             	push   0x8(%ebp)
+  80135c:	e8 49 fe ff ff       	call   8011aa <printfmt>
+  801361:	83 c4 20             	add    $0x20,%esp
+            break;
+  801364:	e9 3a 02 00 00       	jmp    8015a3 <vprintfmt+0x3cf>
+
+        // string
+        case 's':
+            if ((p = va_arg(ap, char *)) == NULL) {
+  801369:	8b 45 18             	mov    0x18(%ebp),%eax
+  80136c:	8d 50 04             	lea    0x4(%eax),%edx
+  80136f:	89 55 18             	mov    %edx,0x18(%ebp)
+  801372:	8b 30                	mov    (%eax),%esi
+  801374:	85 f6                	test   %esi,%esi
+  801376:	75 05                	jne    80137d <vprintfmt+0x1a9>
+                p = "(null)";
+  801378:	be 61 20 80 00       	mov    $0x802061,%esi
+            }
+            if (width > 0 && padc != '-') {
+  80137d:	83 7d e8 00          	cmpl   $0x0,-0x18(%ebp)
+  801381:	7e 7d                	jle    801400 <vprintfmt+0x22c>
+  801383:	80 7d db 2d          	cmpb   $0x2d,-0x25(%ebp)
+  801387:	74 77                	je     801400 <vprintfmt+0x22c>
+                for (width -= strnlen(p, precision); width > 0; width --) {
+  801389:	8b 45 e4             	mov    -0x1c(%ebp),%eax
+  80138c:	83 ec 08             	sub    $0x8,%esp
+  80138f:	50                   	push   %eax
+  801390:	56                   	push   %esi
+  801391:	e8 d6 03 00 00       	call   80176c <strnlen>
+  801396:	83 c4 10             	add    $0x10,%esp
+  801399:	8b 55 e8             	mov    -0x18(%ebp),%edx
+  80139c:	29 c2                	sub    %eax,%edx
+  80139e:	89 55 e8             	mov    %edx,-0x18(%ebp)
+  8013a1:	eb 1a                	jmp    8013bd <vprintfmt+0x1e9>
+                    putch(padc, putdat, fd);
+  8013a3:	0f be 45 db          	movsbl -0x25(%ebp),%eax
+  8013a7:	83 ec 04             	sub    $0x4,%esp
+  8013aa:	ff 75 0c             	push   0xc(%ebp)
+  8013ad:	ff 75 10             	push   0x10(%ebp)
+  8013b0:	50                   	push   %eax
+  8013b1:	8b 45 08             	mov    0x8(%ebp),%eax
+  8013b4:	ff d0                	call   *%eax
+  8013b6:	83 c4 10             	add    $0x10,%esp
+                for (width -= strnlen(p, precision); width > 0; width --) {
+  8013b9:	83 6d e8 01          	subl   $0x1,-0x18(%ebp)
+  8013bd:	83 7d e8 00          	cmpl   $0x0,-0x18(%ebp)
+  8013c1:	7f e0                	jg     8013a3 <vprintfmt+0x1cf>
+                }
+            }
+            for (; (ch = *p ++) != '\0' && (precision < 0 || -- precision >= 0); width --) {
+  8013c3:	eb 3b                	jmp    801400 <vprintfmt+0x22c>
+                if (altflag && (ch < ' ' || ch > '~')) {
+  8013c5:	83 7d dc 00          	cmpl   $0x0,-0x24(%ebp)
+  8013c9:	74 1f                	je     8013ea <vprintfmt+0x216>
+  8013cb:	83 fb 1f             	cmp    $0x1f,%ebx
+  8013ce:	7e 05                	jle    8013d5 <vprintfmt+0x201>
+  8013d0:	83 fb 7e             	cmp    $0x7e,%ebx
+  8013d3:	7e 15                	jle    8013ea <vprintfmt+0x216>
+                    putch('?', putdat, fd);
+  8013d5:	83 ec 04             	sub    $0x4,%esp
+  8013d8:	ff 75 0c             	push   0xc(%ebp)
+  8013db:	ff 75 10             	push   0x10(%ebp)
+  8013de:	6a 3f                	push   $0x3f
+  8013e0:	8b 45 08             	mov    0x8(%ebp),%eax
+  8013e3:	ff d0                	call   *%eax
+  8013e5:	83 c4 10             	add    $0x10,%esp
+  8013e8:	eb 12                	jmp    8013fc <vprintfmt+0x228>
+                }
+                else {
+                    putch(ch, putdat, fd);
+  8013ea:	83 ec 04             	sub    $0x4,%esp
+  8013ed:	ff 75 0c             	push   0xc(%ebp)
+  8013f0:	ff 75 10             	push   0x10(%ebp)
+  8013f3:	53                   	push   %ebx
+  8013f4:	8b 45 08             	mov    0x8(%ebp),%eax
+  8013f7:	ff d0                	call   *%eax
+  8013f9:	83 c4 10             	add    $0x10,%esp
+            for (; (ch = *p ++) != '\0' && (precision < 0 || -- precision >= 0); width --) {
+  8013fc:	83 6d e8 01          	subl   $0x1,-0x18(%ebp)
+  801400:	89 f0                	mov    %esi,%eax
+  801402:	8d 70 01             	lea    0x1(%eax),%esi
+  801405:	0f b6 00             	movzbl (%eax),%eax
+  801408:	0f be d8             	movsbl %al,%ebx
+  80140b:	85 db                	test   %ebx,%ebx
+  80140d:	74 29                	je     801438 <vprintfmt+0x264>
+  80140f:	83 7d e4 00          	cmpl   $0x0,-0x1c(%ebp)
+  801413:	78 b0                	js     8013c5 <vprintfmt+0x1f1>
+  801415:	83 6d e4 01          	subl   $0x1,-0x1c(%ebp)
+  801419:	83 7d e4 00          	cmpl   $0x0,-0x1c(%ebp)
+  80141d:	79 a6                	jns    8013c5 <vprintfmt+0x1f1>
+                }
+            }
+            for (; width > 0; width --) {
+  80141f:	eb 17                	jmp    801438 <vprintfmt+0x264>
+                putch(' ', putdat, fd);
+  801421:	83 ec 04             	sub    $0x4,%esp
+  801424:	ff 75 0c             	push   0xc(%ebp)
+  801427:	ff 75 10             	push   0x10(%ebp)
+  80142a:	6a 20                	push   $0x20
+  80142c:	8b 45 08             	mov    0x8(%ebp),%eax
+  80142f:	ff d0                	call   *%eax
+  801431:	83 c4 10             	add    $0x10,%esp
+            for (; width > 0; width --) {
+  801434:	83 6d e8 01          	subl   $0x1,-0x18(%ebp)
+  801438:	83 7d e8 00          	cmpl   $0x0,-0x18(%ebp)
+  80143c:	7f e3                	jg     801421 <vprintfmt+0x24d>
+            }
+            break;
+  80143e:	e9 60 01 00 00       	jmp    8015a3 <vprintfmt+0x3cf>
+
+        // (signed) decimal
+        case 'd':
+            num = getint(&ap, lflag);
+  801443:	83 ec 08             	sub    $0x8,%esp
+  801446:	ff 75 e0             	push   -0x20(%ebp)
+  801449:	8d 45 18             	lea    0x18(%ebp),%eax
+  80144c:	50                   	push   %eax
+  80144d:	e8 11 fd ff ff       	call   801163 <getint>
+  801452:	83 c4 10             	add    $0x10,%esp
+  801455:	89 45 f0             	mov    %eax,-0x10(%ebp)
+  801458:	89 55 f4             	mov    %edx,-0xc(%ebp)
+            if ((long long)num < 0) {
+  80145b:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  80145e:	8b 55 f4             	mov    -0xc(%ebp),%edx
+  801461:	85 d2                	test   %edx,%edx
+  801463:	79 26                	jns    80148b <vprintfmt+0x2b7>
+                putch('-', putdat, fd);
+  801465:	83 ec 04             	sub    $0x4,%esp
+  801468:	ff 75 0c             	push   0xc(%ebp)
+  80146b:	ff 75 10             	push   0x10(%ebp)
+  80146e:	6a 2d                	push   $0x2d
+  801470:	8b 45 08             	mov    0x8(%ebp),%eax
+  801473:	ff d0                	call   *%eax
+  801475:	83 c4 10             	add    $0x10,%esp
+                num = -(long long)num;
+  801478:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  80147b:	8b 55 f4             	mov    -0xc(%ebp),%edx
+  80147e:	f7 d8                	neg    %eax
+  801480:	83 d2 00             	adc    $0x0,%edx
+  801483:	f7 da                	neg    %edx
+  801485:	89 45 f0             	mov    %eax,-0x10(%ebp)
+  801488:	89 55 f4             	mov    %edx,-0xc(%ebp)
+            }
+            base = 10;
+  80148b:	c7 45 ec 0a 00 00 00 	movl   $0xa,-0x14(%ebp)
+            goto number;
+  801492:	e9 a8 00 00 00       	jmp    80153f <vprintfmt+0x36b>
+
+        // unsigned decimal
+        case 'u':
+            num = getuint(&ap, lflag);
+  801497:	83 ec 08             	sub    $0x8,%esp
+  80149a:	ff 75 e0             	push   -0x20(%ebp)
+  80149d:	8d 45 18             	lea    0x18(%ebp),%eax
+  8014a0:	50                   	push   %eax
+  8014a1:	e8 6e fc ff ff       	call   801114 <getuint>
+  8014a6:	83 c4 10             	add    $0x10,%esp
+  8014a9:	89 45 f0             	mov    %eax,-0x10(%ebp)
+  8014ac:	89 55 f4             	mov    %edx,-0xc(%ebp)
+            base = 10;
+  8014af:	c7 45 ec 0a 00 00 00 	movl   $0xa,-0x14(%ebp)
+            goto number;
+  8014b6:	e9 84 00 00 00       	jmp    80153f <vprintfmt+0x36b>
+
+        // (unsigned) octal
+        case 'o':
+            num = getuint(&ap, lflag);
+  8014bb:	83 ec 08             	sub    $0x8,%esp
+  8014be:	ff 75 e0             	push   -0x20(%ebp)
+  8014c1:	8d 45 18             	lea    0x18(%ebp),%eax
+  8014c4:	50                   	push   %eax
+  8014c5:	e8 4a fc ff ff       	call   801114 <getuint>
+  8014ca:	83 c4 10             	add    $0x10,%esp
+  8014cd:	89 45 f0             	mov    %eax,-0x10(%ebp)
+  8014d0:	89 55 f4             	mov    %edx,-0xc(%ebp)
+            base = 8;
+  8014d3:	c7 45 ec 08 00 00 00 	movl   $0x8,-0x14(%ebp)
+            goto number;
+  8014da:	eb 63                	jmp    80153f <vprintfmt+0x36b>
+
+        // pointer
+        case 'p':
+            putch('0', putdat, fd);
+  8014dc:	83 ec 04             	sub    $0x4,%esp
+  8014df:	ff 75 0c             	push   0xc(%ebp)
+  8014e2:	ff 75 10             	push   0x10(%ebp)
+  8014e5:	6a 30                	push   $0x30
+  8014e7:	8b 45 08             	mov    0x8(%ebp),%eax
+  8014ea:	ff d0                	call   *%eax
+  8014ec:	83 c4 10             	add    $0x10,%esp
+            putch('x', putdat, fd);
+  8014ef:	83 ec 04             	sub    $0x4,%esp
+  8014f2:	ff 75 0c             	push   0xc(%ebp)
+  8014f5:	ff 75 10             	push   0x10(%ebp)
+  8014f8:	6a 78                	push   $0x78
+  8014fa:	8b 45 08             	mov    0x8(%ebp),%eax
+  8014fd:	ff d0                	call   *%eax
+  8014ff:	83 c4 10             	add    $0x10,%esp
+            num = (unsigned long long)(uintptr_t)va_arg(ap, void *);
+  801502:	8b 45 18             	mov    0x18(%ebp),%eax
+  801505:	8d 50 04             	lea    0x4(%eax),%edx
+  801508:	89 55 18             	mov    %edx,0x18(%ebp)
+  80150b:	8b 00                	mov    (%eax),%eax
+  80150d:	89 45 f0             	mov    %eax,-0x10(%ebp)
+  801510:	c7 45 f4 00 00 00 00 	movl   $0x0,-0xc(%ebp)
+            base = 16;
+  801517:	c7 45 ec 10 00 00 00 	movl   $0x10,-0x14(%ebp)
+            goto number;
+  80151e:	eb 1f                	jmp    80153f <vprintfmt+0x36b>
+
+        // (unsigned) hexadecimal
+        case 'x':
+            num = getuint(&ap, lflag);
+  801520:	83 ec 08             	sub    $0x8,%esp
+  801523:	ff 75 e0             	push   -0x20(%ebp)
+  801526:	8d 45 18             	lea    0x18(%ebp),%eax
+  801529:	50                   	push   %eax
+  80152a:	e8 e5 fb ff ff       	call   801114 <getuint>
+  80152f:	83 c4 10             	add    $0x10,%esp
+  801532:	89 45 f0             	mov    %eax,-0x10(%ebp)
+  801535:	89 55 f4             	mov    %edx,-0xc(%ebp)
+            base = 16;
+  801538:	c7 45 ec 10 00 00 00 	movl   $0x10,-0x14(%ebp)
+        number:
+            printnum(putch, fd, putdat, num, base, width, padc);
+  80153f:	0f be 55 db          	movsbl -0x25(%ebp),%edx
+  801543:	8b 45 ec             	mov    -0x14(%ebp),%eax
+  801546:	52                   	push   %edx
+  801547:	ff 75 e8             	push   -0x18(%ebp)
+  80154a:	50                   	push   %eax
+  80154b:	ff 75 f4             	push   -0xc(%ebp)
+  80154e:	ff 75 f0             	push   -0x10(%ebp)
+  801551:	ff 75 10             	push   0x10(%ebp)
+  801554:	ff 75 0c             	push   0xc(%ebp)
+  801557:	ff 75 08             	push   0x8(%ebp)
+  80155a:	e8 c3 fa ff ff       	call   801022 <printnum>
+  80155f:	83 c4 20             	add    $0x20,%esp
+            break;
+  801562:	eb 3f                	jmp    8015a3 <vprintfmt+0x3cf>
+
+        // escaped '%' character
+        case '%':
+            putch(ch, putdat, fd);
+  801564:	83 ec 04             	sub    $0x4,%esp
+  801567:	ff 75 0c             	push   0xc(%ebp)
+  80156a:	ff 75 10             	push   0x10(%ebp)
+  80156d:	53                   	push   %ebx
+  80156e:	8b 45 08             	mov    0x8(%ebp),%eax
+  801571:	ff d0                	call   *%eax
+  801573:	83 c4 10             	add    $0x10,%esp
+            break;
+  801576:	eb 2b                	jmp    8015a3 <vprintfmt+0x3cf>
+
+        // unrecognized escape sequence - just print it literally
+        default:
+            putch('%', putdat, fd);
+  801578:	83 ec 04             	sub    $0x4,%esp
+  80157b:	ff 75 0c             	push   0xc(%ebp)
+  80157e:	ff 75 10             	push   0x10(%ebp)
+  801581:	6a 25                	push   $0x25
+  801583:	8b 45 08             	mov    0x8(%ebp),%eax
+  801586:	ff d0                	call   *%eax
+  801588:	83 c4 10             	add    $0x10,%esp
+            for (fmt --; fmt[-1] != '%'; fmt --)
+  80158b:	83 6d 14 01          	subl   $0x1,0x14(%ebp)
+  80158f:	eb 04                	jmp    801595 <vprintfmt+0x3c1>
+  801591:	83 6d 14 01          	subl   $0x1,0x14(%ebp)
+  801595:	8b 45 14             	mov    0x14(%ebp),%eax
+  801598:	83 e8 01             	sub    $0x1,%eax
+  80159b:	0f b6 00             	movzbl (%eax),%eax
+  80159e:	3c 25                	cmp    $0x25,%al
+  8015a0:	75 ef                	jne    801591 <vprintfmt+0x3bd>
+                /* do nothing */;
+            break;
+  8015a2:	90                   	nop
+    while (1) {
+  8015a3:	e9 34 fc ff ff       	jmp    8011dc <vprintfmt+0x8>
+                return;
+  8015a8:	90                   	nop
+        }
+    }
+}
+  8015a9:	8d 65 f8             	lea    -0x8(%ebp),%esp
+  8015ac:	5b                   	pop    %ebx
+  8015ad:	5e                   	pop    %esi
+  8015ae:	5d                   	pop    %ebp
+  8015af:	c3                   	ret
+
+008015b0 <sprintputch>:
+ * sprintputch - 'print' a single character in a buffer
+ * @ch:         the character will be printed
+ * @b:          the buffer to place the character @ch
+ * */
+static void
+sprintputch(int ch, struct sprintbuf *b) {
+  8015b0:	55                   	push   %ebp
+  8015b1:	89 e5                	mov    %esp,%ebp
+    b->cnt ++;
+  8015b3:	8b 45 0c             	mov    0xc(%ebp),%eax
+  8015b6:	8b 40 08             	mov    0x8(%eax),%eax
+  8015b9:	8d 50 01             	lea    0x1(%eax),%edx
+  8015bc:	8b 45 0c             	mov    0xc(%ebp),%eax
+  8015bf:	89 50 08             	mov    %edx,0x8(%eax)
+    if (b->buf < b->ebuf) {
+  8015c2:	8b 45 0c             	mov    0xc(%ebp),%eax
+  8015c5:	8b 10                	mov    (%eax),%edx
+  8015c7:	8b 45 0c             	mov    0xc(%ebp),%eax
+  8015ca:	8b 40 04             	mov    0x4(%eax),%eax
+  8015cd:	39 c2                	cmp    %eax,%edx
+  8015cf:	73 12                	jae    8015e3 <sprintputch+0x33>
+        *b->buf ++ = ch;
+  8015d1:	8b 45 0c             	mov    0xc(%ebp),%eax
+  8015d4:	8b 00                	mov    (%eax),%eax
+  8015d6:	8d 48 01             	lea    0x1(%eax),%ecx
+  8015d9:	8b 55 0c             	mov    0xc(%ebp),%edx
+  8015dc:	89 0a                	mov    %ecx,(%edx)
+  8015de:	8b 55 08             	mov    0x8(%ebp),%edx
+  8015e1:	88 10                	mov    %dl,(%eax)
+    }
+}
+  8015e3:	90                   	nop
+  8015e4:	5d                   	pop    %ebp
+  8015e5:	c3                   	ret
+
+008015e6 <snprintf>:
+ * @str:        the buffer to place the result into
+ * @size:       the size of buffer, including the trailing null space
+ * @fmt:        the format string to use
+ * */
+int
+snprintf(char *str, size_t size, const char *fmt, ...) {
+  8015e6:	55                   	push   %ebp
+  8015e7:	89 e5                	mov    %esp,%ebp
+  8015e9:	83 ec 18             	sub    $0x18,%esp
+    va_list ap;
+    int cnt;
+    va_start(ap, fmt);
+  8015ec:	8d 45 14             	lea    0x14(%ebp),%eax
+  8015ef:	89 45 f0             	mov    %eax,-0x10(%ebp)
+    cnt = vsnprintf(str, size, fmt, ap);
+  8015f2:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  8015f5:	50                   	push   %eax
+  8015f6:	ff 75 10             	push   0x10(%ebp)
+  8015f9:	ff 75 0c             	push   0xc(%ebp)
+  8015fc:	ff 75 08             	push   0x8(%ebp)
+  8015ff:	e8 0b 00 00 00       	call   80160f <vsnprintf>
+  801604:	83 c4 10             	add    $0x10,%esp
+  801607:	89 45 f4             	mov    %eax,-0xc(%ebp)
+    va_end(ap);
+    return cnt;
+  80160a:	8b 45 f4             	mov    -0xc(%ebp),%eax
+}
+  80160d:	c9                   	leave
+  80160e:	c3                   	ret
+
+0080160f <vsnprintf>:
+ *
+ * Call this function if you are already dealing with a va_list.
+ * Or you probably want snprintf() instead.
+ * */
+int
+vsnprintf(char *str, size_t size, const char *fmt, va_list ap) {
+  80160f:	55                   	push   %ebp
+  801610:	89 e5                	mov    %esp,%ebp
+  801612:	83 ec 18             	sub    $0x18,%esp
+    struct sprintbuf b = {str, str + size - 1, 0};
+  801615:	8b 45 08             	mov    0x8(%ebp),%eax
+  801618:	89 45 ec             	mov    %eax,-0x14(%ebp)
+  80161b:	8b 45 0c             	mov    0xc(%ebp),%eax
+  80161e:	8d 50 ff             	lea    -0x1(%eax),%edx
+  801621:	8b 45 08             	mov    0x8(%ebp),%eax
+  801624:	01 d0                	add    %edx,%eax
+  801626:	89 45 f0             	mov    %eax,-0x10(%ebp)
+  801629:	c7 45 f4 00 00 00 00 	movl   $0x0,-0xc(%ebp)
+    if (str == NULL || b.buf > b.ebuf) {
+  801630:	83 7d 08 00          	cmpl   $0x0,0x8(%ebp)
+  801634:	74 0a                	je     801640 <vsnprintf+0x31>
+  801636:	8b 45 ec             	mov    -0x14(%ebp),%eax
+  801639:	8b 55 f0             	mov    -0x10(%ebp),%edx
+  80163c:	39 c2                	cmp    %eax,%edx
+  80163e:	73 07                	jae    801647 <vsnprintf+0x38>
+        return -E_INVAL;
+  801640:	b8 fd ff ff ff       	mov    $0xfffffffd,%eax
+  801645:	eb 28                	jmp    80166f <vsnprintf+0x60>
+    }
+    // print the string to the buffer
+    vprintfmt((void*)sprintputch, NO_FD, &b, fmt, ap);
+  801647:	83 ec 0c             	sub    $0xc,%esp
+  80164a:	ff 75 14             	push   0x14(%ebp)
+  80164d:	ff 75 10             	push   0x10(%ebp)
+  801650:	8d 45 ec             	lea    -0x14(%ebp),%eax
+  801653:	50                   	push   %eax
+  801654:	68 d9 6a ff ff       	push   $0xffff6ad9
+  801659:	68 b0 15 80 00       	push   $0x8015b0
+  80165e:	e8 71 fb ff ff       	call   8011d4 <vprintfmt>
+  801663:	83 c4 20             	add    $0x20,%esp
+    // null terminate the buffer
+    *b.buf = '\0';
+  801666:	8b 45 ec             	mov    -0x14(%ebp),%eax
+  801669:	c6 00 00             	movb   $0x0,(%eax)
+    return b.cnt;
+  80166c:	8b 45 f4             	mov    -0xc(%ebp),%eax
+}
+  80166f:	c9                   	leave
+  801670:	c3                   	ret
+
+00801671 <rand>:
+ * rand - returns a pseudo-random integer
+ *
+ * The rand() function return a value in the range [0, RAND_MAX].
+ * */
+int
+rand(void) {
+  801671:	55                   	push   %ebp
+  801672:	89 e5                	mov    %esp,%ebp
+  801674:	57                   	push   %edi
+  801675:	56                   	push   %esi
+  801676:	53                   	push   %ebx
+  801677:	83 ec 24             	sub    $0x24,%esp
+    next = (next * 0x5DEECE66DLL + 0xBLL) & ((1LL << 48) - 1);
+  80167a:	a1 08 30 80 00       	mov    0x803008,%eax
+  80167f:	8b 15 0c 30 80 00    	mov    0x80300c,%edx
+  801685:	69 fa 6d e6 ec de    	imul   $0xdeece66d,%edx,%edi
+  80168b:	6b f0 05             	imul   $0x5,%eax,%esi
+  80168e:	01 fe                	add    %edi,%esi
+  801690:	bf 6d e6 ec de       	mov    $0xdeece66d,%edi
+  801695:	f7 e7                	mul    %edi
+  801697:	01 d6                	add    %edx,%esi
+  801699:	89 f2                	mov    %esi,%edx
+  80169b:	83 c0 0b             	add    $0xb,%eax
+  80169e:	83 d2 00             	adc    $0x0,%edx
+  8016a1:	89 c1                	mov    %eax,%ecx
+  8016a3:	0f b7 da             	movzwl %dx,%ebx
+  8016a6:	89 0d 08 30 80 00    	mov    %ecx,0x803008
+  8016ac:	89 1d 0c 30 80 00    	mov    %ebx,0x80300c
+    unsigned long long result = (next >> 12);
+  8016b2:	a1 08 30 80 00       	mov    0x803008,%eax
+  8016b7:	8b 15 0c 30 80 00    	mov    0x80300c,%edx
+  8016bd:	0f ac d0 0c          	shrd   $0xc,%edx,%eax
+  8016c1:	c1 ea 0c             	shr    $0xc,%edx
+  8016c4:	89 45 e0             	mov    %eax,-0x20(%ebp)
+  8016c7:	89 55 e4             	mov    %edx,-0x1c(%ebp)
+    return (int)do_div(result, RAND_MAX + 1);
+  8016ca:	c7 45 dc 00 00 00 80 	movl   $0x80000000,-0x24(%ebp)
+  8016d1:	8b 45 e0             	mov    -0x20(%ebp),%eax
+  8016d4:	8b 55 e4             	mov    -0x1c(%ebp),%edx
+  8016d7:	89 45 d8             	mov    %eax,-0x28(%ebp)
+  8016da:	89 55 e8             	mov    %edx,-0x18(%ebp)
+  8016dd:	8b 45 e8             	mov    -0x18(%ebp),%eax
+  8016e0:	89 45 ec             	mov    %eax,-0x14(%ebp)
+  8016e3:	83 7d e8 00          	cmpl   $0x0,-0x18(%ebp)
+  8016e7:	74 1c                	je     801705 <rand+0x94>
+  8016e9:	8b 45 e8             	mov    -0x18(%ebp),%eax
+  8016ec:	ba 00 00 00 00       	mov    $0x0,%edx
+  8016f1:	f7 75 dc             	divl   -0x24(%ebp)
+  8016f4:	89 55 ec             	mov    %edx,-0x14(%ebp)
+  8016f7:	8b 45 e8             	mov    -0x18(%ebp),%eax
+  8016fa:	ba 00 00 00 00       	mov    $0x0,%edx
+  8016ff:	f7 75 dc             	divl   -0x24(%ebp)
+  801702:	89 45 e8             	mov    %eax,-0x18(%ebp)
+  801705:	8b 45 d8             	mov    -0x28(%ebp),%eax
+  801708:	8b 55 ec             	mov    -0x14(%ebp),%edx
+  80170b:	f7 75 dc             	divl   -0x24(%ebp)
+  80170e:	89 45 d8             	mov    %eax,-0x28(%ebp)
+  801711:	89 55 d4             	mov    %edx,-0x2c(%ebp)
+  801714:	8b 45 d8             	mov    -0x28(%ebp),%eax
+  801717:	8b 55 e8             	mov    -0x18(%ebp),%edx
+  80171a:	89 45 e0             	mov    %eax,-0x20(%ebp)
+  80171d:	89 55 e4             	mov    %edx,-0x1c(%ebp)
+  801720:	8b 45 d4             	mov    -0x2c(%ebp),%eax
+}
+  801723:	83 c4 24             	add    $0x24,%esp
+  801726:	5b                   	pop    %ebx
+  801727:	5e                   	pop    %esi
+  801728:	5f                   	pop    %edi
+  801729:	5d                   	pop    %ebp
+  80172a:	c3                   	ret
+
+0080172b <srand>:
+/* *
+ * srand - seed the random number generator with the given number
+ * @seed:   the required seed number
+ * */
+void
+srand(unsigned int seed) {
+  80172b:	55                   	push   %ebp
+  80172c:	89 e5                	mov    %esp,%ebp
+    next = seed;
+  80172e:	8b 45 08             	mov    0x8(%ebp),%eax
+  801731:	ba 00 00 00 00       	mov    $0x0,%edx
+  801736:	a3 08 30 80 00       	mov    %eax,0x803008
+  80173b:	89 15 0c 30 80 00    	mov    %edx,0x80300c
+}
+  801741:	90                   	nop
+  801742:	5d                   	pop    %ebp
+  801743:	c3                   	ret
+
+00801744 <strlen>:
+ * @s:      the input string
+ *
+ * The strlen() function returns the length of string @s.
+ * */
+size_t
+strlen(const char *s) {
+  801744:	55                   	push   %ebp
+  801745:	89 e5                	mov    %esp,%ebp
+  801747:	83 ec 10             	sub    $0x10,%esp
+    size_t cnt = 0;
+  80174a:	c7 45 fc 00 00 00 00 	movl   $0x0,-0x4(%ebp)
+    while (*s ++ != '\0') {
+  801751:	eb 04                	jmp    801757 <strlen+0x13>
+        cnt ++;
+  801753:	83 45 fc 01          	addl   $0x1,-0x4(%ebp)
+    while (*s ++ != '\0') {
+  801757:	8b 45 08             	mov    0x8(%ebp),%eax
+  80175a:	8d 50 01             	lea    0x1(%eax),%edx
+  80175d:	89 55 08             	mov    %edx,0x8(%ebp)
+  801760:	0f b6 00             	movzbl (%eax),%eax
+  801763:	84 c0                	test   %al,%al
+  801765:	75 ec                	jne    801753 <strlen+0xf>
+    }
+    return cnt;
+  801767:	8b 45 fc             	mov    -0x4(%ebp),%eax
+}
+  80176a:	c9                   	leave
+  80176b:	c3                   	ret
+
+0080176c <strnlen>:
+ * The return value is strlen(s), if that is less than @len, or
+ * @len if there is no '\0' character among the first @len characters
+ * pointed by @s.
+ * */
+size_t
+strnlen(const char *s, size_t len) {
+  80176c:	55                   	push   %ebp
+  80176d:	89 e5                	mov    %esp,%ebp
+  80176f:	83 ec 10             	sub    $0x10,%esp
+    size_t cnt = 0;
+  801772:	c7 45 fc 00 00 00 00 	movl   $0x0,-0x4(%ebp)
+    while (cnt < len && *s ++ != '\0') {
+  801779:	eb 04                	jmp    80177f <strnlen+0x13>
+        cnt ++;
+  80177b:	83 45 fc 01          	addl   $0x1,-0x4(%ebp)
+    while (cnt < len && *s ++ != '\0') {
+  80177f:	8b 45 fc             	mov    -0x4(%ebp),%eax
+  801782:	3b 45 0c             	cmp    0xc(%ebp),%eax
+  801785:	73 10                	jae    801797 <strnlen+0x2b>
+  801787:	8b 45 08             	mov    0x8(%ebp),%eax
+  80178a:	8d 50 01             	lea    0x1(%eax),%edx
+  80178d:	89 55 08             	mov    %edx,0x8(%ebp)
+  801790:	0f b6 00             	movzbl (%eax),%eax
+  801793:	84 c0                	test   %al,%al
+  801795:	75 e4                	jne    80177b <strnlen+0xf>
+    }
+    return cnt;
+  801797:	8b 45 fc             	mov    -0x4(%ebp),%eax
+}
+  80179a:	c9                   	leave
+  80179b:	c3                   	ret
+
+0080179c <strcat>:
+ * @dst:    pointer to the @dst array, which should be large enough to contain the concatenated
+ *          resulting string.
+ * @src:    string to be appended, this should not overlap @dst
+ * */
+char *
+strcat(char *dst, const char *src) {
+  80179c:	55                   	push   %ebp
+  80179d:	89 e5                	mov    %esp,%ebp
+  80179f:	83 ec 08             	sub    $0x8,%esp
+    return strcpy(dst + strlen(dst), src);
+  8017a2:	ff 75 08             	push   0x8(%ebp)
+  8017a5:	e8 9a ff ff ff       	call   801744 <strlen>
+  8017aa:	83 c4 04             	add    $0x4,%esp
+  8017ad:	8b 55 08             	mov    0x8(%ebp),%edx
+  8017b0:	01 d0                	add    %edx,%eax
+  8017b2:	83 ec 08             	sub    $0x8,%esp
+  8017b5:	ff 75 0c             	push   0xc(%ebp)
+  8017b8:	50                   	push   %eax
+  8017b9:	e8 05 00 00 00       	call   8017c3 <strcpy>
+  8017be:	83 c4 10             	add    $0x10,%esp
+}
+  8017c1:	c9                   	leave
+  8017c2:	c3                   	ret
+
+008017c3 <strcpy>:
+ * To avoid overflows, the size of array pointed by @dst should be long enough to
+ * contain the same string as @src (including the terminating null character), and
+ * should not overlap in memory with @src.
+ * */
+char *
+strcpy(char *dst, const char *src) {
+  8017c3:	55                   	push   %ebp
+  8017c4:	89 e5                	mov    %esp,%ebp
+  8017c6:	57                   	push   %edi
+  8017c7:	56                   	push   %esi
+  8017c8:	83 ec 20             	sub    $0x20,%esp
+  8017cb:	8b 45 08             	mov    0x8(%ebp),%eax
+  8017ce:	89 45 f4             	mov    %eax,-0xc(%ebp)
+  8017d1:	8b 45 0c             	mov    0xc(%ebp),%eax
+  8017d4:	89 45 f0             	mov    %eax,-0x10(%ebp)
+#ifndef __HAVE_ARCH_STRCPY
+#define __HAVE_ARCH_STRCPY
+static inline char *
+__strcpy(char *dst, const char *src) {
+    int d0, d1, d2;
+    asm volatile (
+  8017d7:	8b 55 f0             	mov    -0x10(%ebp),%edx
+  8017da:	8b 45 f4             	mov    -0xc(%ebp),%eax
+  8017dd:	89 d1                	mov    %edx,%ecx
+  8017df:	89 c2                	mov    %eax,%edx
+  8017e1:	89 ce                	mov    %ecx,%esi
+  8017e3:	89 d7                	mov    %edx,%edi
+  8017e5:	ac                   	lods   %ds:(%esi),%al
+  8017e6:	aa                   	stos   %al,%es:(%edi)
+  8017e7:	84 c0                	test   %al,%al
+  8017e9:	75 fa                	jne    8017e5 <strcpy+0x22>
+  8017eb:	89 fa                	mov    %edi,%edx
+  8017ed:	89 f1                	mov    %esi,%ecx
+  8017ef:	89 4d ec             	mov    %ecx,-0x14(%ebp)
+  8017f2:	89 55 e8             	mov    %edx,-0x18(%ebp)
+  8017f5:	89 45 e4             	mov    %eax,-0x1c(%ebp)
+        "stosb;"
+        "testb %%al, %%al;"
+        "jne 1b;"
+        : "=&S" (d0), "=&D" (d1), "=&a" (d2)
+        : "0" (src), "1" (dst) : "memory");
+    return dst;
+  8017f8:	8b 45 f4             	mov    -0xc(%ebp),%eax
+    char *p = dst;
+    while ((*p ++ = *src ++) != '\0')
+        /* nothing */;
+    return dst;
+#endif /* __HAVE_ARCH_STRCPY */
+}
+  8017fb:	83 c4 20             	add    $0x20,%esp
+  8017fe:	5e                   	pop    %esi
+  8017ff:	5f                   	pop    %edi
+  801800:	5d                   	pop    %ebp
+  801801:	c3                   	ret
+
+00801802 <strncpy>:
+ * @len:    maximum number of characters to be copied from @src
+ *
+ * The return value is @dst
+ * */
+char *
+strncpy(char *dst, const char *src, size_t len) {
+  801802:	55                   	push   %ebp
+  801803:	89 e5                	mov    %esp,%ebp
+  801805:	83 ec 10             	sub    $0x10,%esp
+    char *p = dst;
+  801808:	8b 45 08             	mov    0x8(%ebp),%eax
+  80180b:	89 45 fc             	mov    %eax,-0x4(%ebp)
+    while (len > 0) {
+  80180e:	eb 21                	jmp    801831 <strncpy+0x2f>
+        if ((*p = *src) != '\0') {
+  801810:	8b 45 0c             	mov    0xc(%ebp),%eax
+  801813:	0f b6 10             	movzbl (%eax),%edx
+  801816:	8b 45 fc             	mov    -0x4(%ebp),%eax
+  801819:	88 10                	mov    %dl,(%eax)
+  80181b:	8b 45 fc             	mov    -0x4(%ebp),%eax
+  80181e:	0f b6 00             	movzbl (%eax),%eax
+  801821:	84 c0                	test   %al,%al
+  801823:	74 04                	je     801829 <strncpy+0x27>
+            src ++;
+  801825:	83 45 0c 01          	addl   $0x1,0xc(%ebp)
+        }
+        p ++, len --;
+  801829:	83 45 fc 01          	addl   $0x1,-0x4(%ebp)
+  80182d:	83 6d 10 01          	subl   $0x1,0x10(%ebp)
+    while (len > 0) {
+  801831:	83 7d 10 00          	cmpl   $0x0,0x10(%ebp)
+  801835:	75 d9                	jne    801810 <strncpy+0xe>
+    }
+    return dst;
+  801837:	8b 45 08             	mov    0x8(%ebp),%eax
+}
+  80183a:	c9                   	leave
+  80183b:	c3                   	ret
+
+0080183c <strcmp>:
+ * - A value greater than zero indicates that the first character that does
+ *   not match has a greater value in @s1 than in @s2;
+ * - And a value less than zero indicates the opposite.
+ * */
+int
+strcmp(const char *s1, const char *s2) {
+  80183c:	55                   	push   %ebp
+  80183d:	89 e5                	mov    %esp,%ebp
+  80183f:	57                   	push   %edi
+  801840:	56                   	push   %esi
+  801841:	83 ec 20             	sub    $0x20,%esp
+  801844:	8b 45 08             	mov    0x8(%ebp),%eax
+  801847:	89 45 f4             	mov    %eax,-0xc(%ebp)
+  80184a:	8b 45 0c             	mov    0xc(%ebp),%eax
+  80184d:	89 45 f0             	mov    %eax,-0x10(%ebp)
+    asm volatile (
+  801850:	8b 55 f4             	mov    -0xc(%ebp),%edx
+  801853:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  801856:	89 d1                	mov    %edx,%ecx
+  801858:	89 c2                	mov    %eax,%edx
+  80185a:	89 ce                	mov    %ecx,%esi
+  80185c:	89 d7                	mov    %edx,%edi
+  80185e:	ac                   	lods   %ds:(%esi),%al
+  80185f:	ae                   	scas   %es:(%edi),%al
+  801860:	75 08                	jne    80186a <strcmp+0x2e>
+  801862:	84 c0                	test   %al,%al
+  801864:	75 f8                	jne    80185e <strcmp+0x22>
+  801866:	31 c0                	xor    %eax,%eax
+  801868:	eb 04                	jmp    80186e <strcmp+0x32>
+  80186a:	19 c0                	sbb    %eax,%eax
+  80186c:	0c 01                	or     $0x1,%al
+  80186e:	89 fa                	mov    %edi,%edx
+  801870:	89 f1                	mov    %esi,%ecx
+  801872:	89 45 ec             	mov    %eax,-0x14(%ebp)
+  801875:	89 4d e8             	mov    %ecx,-0x18(%ebp)
+  801878:	89 55 e4             	mov    %edx,-0x1c(%ebp)
+    return ret;
+  80187b:	8b 45 ec             	mov    -0x14(%ebp),%eax
+    while (*s1 != '\0' && *s1 == *s2) {
+        s1 ++, s2 ++;
+    }
+    return (int)((unsigned char)*s1 - (unsigned char)*s2);
+#endif /* __HAVE_ARCH_STRCMP */
+}
+  80187e:	83 c4 20             	add    $0x20,%esp
+  801881:	5e                   	pop    %esi
+  801882:	5f                   	pop    %edi
+  801883:	5d                   	pop    %ebp
+  801884:	c3                   	ret
+
+00801885 <strncmp>:
+ * they are equal to each other, it continues with the following pairs until
+ * the characters differ, until a terminating null-character is reached, or
+ * until @n characters match in both strings, whichever happens first.
+ * */
+int
+strncmp(const char *s1, const char *s2, size_t n) {
+  801885:	55                   	push   %ebp
+  801886:	89 e5                	mov    %esp,%ebp
+    while (n > 0 && *s1 != '\0' && *s1 == *s2) {
+  801888:	eb 0c                	jmp    801896 <strncmp+0x11>
+        n --, s1 ++, s2 ++;
+  80188a:	83 6d 10 01          	subl   $0x1,0x10(%ebp)
+  80188e:	83 45 08 01          	addl   $0x1,0x8(%ebp)
+  801892:	83 45 0c 01          	addl   $0x1,0xc(%ebp)
+    while (n > 0 && *s1 != '\0' && *s1 == *s2) {
+  801896:	83 7d 10 00          	cmpl   $0x0,0x10(%ebp)
+  80189a:	74 1a                	je     8018b6 <strncmp+0x31>
+  80189c:	8b 45 08             	mov    0x8(%ebp),%eax
+  80189f:	0f b6 00             	movzbl (%eax),%eax
+  8018a2:	84 c0                	test   %al,%al
+  8018a4:	74 10                	je     8018b6 <strncmp+0x31>
+  8018a6:	8b 45 08             	mov    0x8(%ebp),%eax
+  8018a9:	0f b6 10             	movzbl (%eax),%edx
+  8018ac:	8b 45 0c             	mov    0xc(%ebp),%eax
+  8018af:	0f b6 00             	movzbl (%eax),%eax
+  8018b2:	38 c2                	cmp    %al,%dl
+  8018b4:	74 d4                	je     80188a <strncmp+0x5>
+    }
+    return (n == 0) ? 0 : (int)((unsigned char)*s1 - (unsigned char)*s2);
+  8018b6:	83 7d 10 00          	cmpl   $0x0,0x10(%ebp)
+  8018ba:	74 16                	je     8018d2 <strncmp+0x4d>
+  8018bc:	8b 45 08             	mov    0x8(%ebp),%eax
+  8018bf:	0f b6 00             	movzbl (%eax),%eax
+  8018c2:	0f b6 d0             	movzbl %al,%edx
+  8018c5:	8b 45 0c             	mov    0xc(%ebp),%eax
+  8018c8:	0f b6 00             	movzbl (%eax),%eax
+  8018cb:	0f b6 c0             	movzbl %al,%eax
+  8018ce:	29 c2                	sub    %eax,%edx
+  8018d0:	eb 05                	jmp    8018d7 <strncmp+0x52>
+  8018d2:	ba 00 00 00 00       	mov    $0x0,%edx
+  8018d7:	89 d0                	mov    %edx,%eax
+}
+  8018d9:	5d                   	pop    %ebp
+  8018da:	c3                   	ret
+
+008018db <strchr>:
+ *
+ * The strchr() function returns a pointer to the first occurrence of
+ * character in @s. If the value is not found, the function returns 'NULL'.
+ * */
+char *
+strchr(const char *s, char c) {
+  8018db:	55                   	push   %ebp
+  8018dc:	89 e5                	mov    %esp,%ebp
+  8018de:	83 ec 04             	sub    $0x4,%esp
+  8018e1:	8b 45 0c             	mov    0xc(%ebp),%eax
+  8018e4:	88 45 fc             	mov    %al,-0x4(%ebp)
+    while (*s != '\0') {
+  8018e7:	eb 14                	jmp    8018fd <strchr+0x22>
+        if (*s == c) {
+  8018e9:	8b 45 08             	mov    0x8(%ebp),%eax
+  8018ec:	0f b6 00             	movzbl (%eax),%eax
+  8018ef:	38 45 fc             	cmp    %al,-0x4(%ebp)
+  8018f2:	75 05                	jne    8018f9 <strchr+0x1e>
+            return (char *)s;
+  8018f4:	8b 45 08             	mov    0x8(%ebp),%eax
+  8018f7:	eb 13                	jmp    80190c <strchr+0x31>
+        }
+        s ++;
+  8018f9:	83 45 08 01          	addl   $0x1,0x8(%ebp)
+    while (*s != '\0') {
+  8018fd:	8b 45 08             	mov    0x8(%ebp),%eax
+  801900:	0f b6 00             	movzbl (%eax),%eax
+  801903:	84 c0                	test   %al,%al
+  801905:	75 e2                	jne    8018e9 <strchr+0xe>
+    }
+    return NULL;
+  801907:	b8 00 00 00 00       	mov    $0x0,%eax
+}
+  80190c:	c9                   	leave
+  80190d:	c3                   	ret
+
+0080190e <strfind>:
+ * The strfind() function is like strchr() except that if @c is
+ * not found in @s, then it returns a pointer to the null byte at the
+ * end of @s, rather than 'NULL'.
+ * */
+char *
+strfind(const char *s, char c) {
+  80190e:	55                   	push   %ebp
+  80190f:	89 e5                	mov    %esp,%ebp
+  801911:	83 ec 04             	sub    $0x4,%esp
+  801914:	8b 45 0c             	mov    0xc(%ebp),%eax
+  801917:	88 45 fc             	mov    %al,-0x4(%ebp)
+    while (*s != '\0') {
+  80191a:	eb 0f                	jmp    80192b <strfind+0x1d>
+        if (*s == c) {
+  80191c:	8b 45 08             	mov    0x8(%ebp),%eax
+  80191f:	0f b6 00             	movzbl (%eax),%eax
+  801922:	38 45 fc             	cmp    %al,-0x4(%ebp)
+  801925:	74 10                	je     801937 <strfind+0x29>
+            break;
+        }
+        s ++;
+  801927:	83 45 08 01          	addl   $0x1,0x8(%ebp)
+    while (*s != '\0') {
+  80192b:	8b 45 08             	mov    0x8(%ebp),%eax
+  80192e:	0f b6 00             	movzbl (%eax),%eax
+  801931:	84 c0                	test   %al,%al
+  801933:	75 e7                	jne    80191c <strfind+0xe>
+  801935:	eb 01                	jmp    801938 <strfind+0x2a>
+            break;
+  801937:	90                   	nop
+    }
+    return (char *)s;
+  801938:	8b 45 08             	mov    0x8(%ebp),%eax
+}
+  80193b:	c9                   	leave
+  80193c:	c3                   	ret
+
+0080193d <strtol>:
+ * an optional "0x" or "0X" prefix.
+ *
+ * The strtol() function returns the converted integral number as a long int value.
+ * */
+long
+strtol(const char *s, char **endptr, int base) {
+  80193d:	55                   	push   %ebp
+  80193e:	89 e5                	mov    %esp,%ebp
+  801940:	83 ec 10             	sub    $0x10,%esp
+    int neg = 0;
+  801943:	c7 45 fc 00 00 00 00 	movl   $0x0,-0x4(%ebp)
+    long val = 0;
+  80194a:	c7 45 f8 00 00 00 00 	movl   $0x0,-0x8(%ebp)
+
+    // gobble initial whitespace
+    while (*s == ' ' || *s == '\t') {
+  801951:	eb 04                	jmp    801957 <strtol+0x1a>
+        s ++;
+  801953:	83 45 08 01          	addl   $0x1,0x8(%ebp)
+    while (*s == ' ' || *s == '\t') {
+  801957:	8b 45 08             	mov    0x8(%ebp),%eax
+  80195a:	0f b6 00             	movzbl (%eax),%eax
+  80195d:	3c 20                	cmp    $0x20,%al
+  80195f:	74 f2                	je     801953 <strtol+0x16>
+  801961:	8b 45 08             	mov    0x8(%ebp),%eax
+  801964:	0f b6 00             	movzbl (%eax),%eax
+  801967:	3c 09                	cmp    $0x9,%al
+  801969:	74 e8                	je     801953 <strtol+0x16>
+    }
+
+    // plus/minus sign
+    if (*s == '+') {
+  80196b:	8b 45 08             	mov    0x8(%ebp),%eax
+  80196e:	0f b6 00             	movzbl (%eax),%eax
+  801971:	3c 2b                	cmp    $0x2b,%al
+  801973:	75 06                	jne    80197b <strtol+0x3e>
+        s ++;
+  801975:	83 45 08 01          	addl   $0x1,0x8(%ebp)
+  801979:	eb 15                	jmp    801990 <strtol+0x53>
+    }
+    else if (*s == '-') {
+  80197b:	8b 45 08             	mov    0x8(%ebp),%eax
+  80197e:	0f b6 00             	movzbl (%eax),%eax
+  801981:	3c 2d                	cmp    $0x2d,%al
+  801983:	75 0b                	jne    801990 <strtol+0x53>
+        s ++, neg = 1;
+  801985:	83 45 08 01          	addl   $0x1,0x8(%ebp)
+  801989:	c7 45 fc 01 00 00 00 	movl   $0x1,-0x4(%ebp)
+    }
+
+    // hex or octal base prefix
+    if ((base == 0 || base == 16) && (s[0] == '0' && s[1] == 'x')) {
+  801990:	83 7d 10 00          	cmpl   $0x0,0x10(%ebp)
+  801994:	74 06                	je     80199c <strtol+0x5f>
+  801996:	83 7d 10 10          	cmpl   $0x10,0x10(%ebp)
+  80199a:	75 24                	jne    8019c0 <strtol+0x83>
+  80199c:	8b 45 08             	mov    0x8(%ebp),%eax
+  80199f:	0f b6 00             	movzbl (%eax),%eax
+  8019a2:	3c 30                	cmp    $0x30,%al
+  8019a4:	75 1a                	jne    8019c0 <strtol+0x83>
+  8019a6:	8b 45 08             	mov    0x8(%ebp),%eax
+  8019a9:	83 c0 01             	add    $0x1,%eax
+  8019ac:	0f b6 00             	movzbl (%eax),%eax
+  8019af:	3c 78                	cmp    $0x78,%al
+  8019b1:	75 0d                	jne    8019c0 <strtol+0x83>
+        s += 2, base = 16;
+  8019b3:	83 45 08 02          	addl   $0x2,0x8(%ebp)
+  8019b7:	c7 45 10 10 00 00 00 	movl   $0x10,0x10(%ebp)
+  8019be:	eb 2a                	jmp    8019ea <strtol+0xad>
+    }
+    else if (base == 0 && s[0] == '0') {
+  8019c0:	83 7d 10 00          	cmpl   $0x0,0x10(%ebp)
+  8019c4:	75 17                	jne    8019dd <strtol+0xa0>
+  8019c6:	8b 45 08             	mov    0x8(%ebp),%eax
+  8019c9:	0f b6 00             	movzbl (%eax),%eax
+  8019cc:	3c 30                	cmp    $0x30,%al
+  8019ce:	75 0d                	jne    8019dd <strtol+0xa0>
+        s ++, base = 8;
+  8019d0:	83 45 08 01          	addl   $0x1,0x8(%ebp)
+  8019d4:	c7 45 10 08 00 00 00 	movl   $0x8,0x10(%ebp)
+  8019db:	eb 0d                	jmp    8019ea <strtol+0xad>
+    }
+    else if (base == 0) {
+  8019dd:	83 7d 10 00          	cmpl   $0x0,0x10(%ebp)
+  8019e1:	75 07                	jne    8019ea <strtol+0xad>
+        base = 10;
+  8019e3:	c7 45 10 0a 00 00 00 	movl   $0xa,0x10(%ebp)
+
+    // digits
+    while (1) {
+        int dig;
+
+        if (*s >= '0' && *s <= '9') {
+  8019ea:	8b 45 08             	mov    0x8(%ebp),%eax
+  8019ed:	0f b6 00             	movzbl (%eax),%eax
+  8019f0:	3c 2f                	cmp    $0x2f,%al
+  8019f2:	7e 1b                	jle    801a0f <strtol+0xd2>
+  8019f4:	8b 45 08             	mov    0x8(%ebp),%eax
+  8019f7:	0f b6 00             	movzbl (%eax),%eax
+  8019fa:	3c 39                	cmp    $0x39,%al
+  8019fc:	7f 11                	jg     801a0f <strtol+0xd2>
+            dig = *s - '0';
+  8019fe:	8b 45 08             	mov    0x8(%ebp),%eax
+  801a01:	0f b6 00             	movzbl (%eax),%eax
+  801a04:	0f be c0             	movsbl %al,%eax
+  801a07:	83 e8 30             	sub    $0x30,%eax
+  801a0a:	89 45 f4             	mov    %eax,-0xc(%ebp)
+  801a0d:	eb 48                	jmp    801a57 <strtol+0x11a>
+        }
+        else if (*s >= 'a' && *s <= 'z') {
+  801a0f:	8b 45 08             	mov    0x8(%ebp),%eax
+  801a12:	0f b6 00             	movzbl (%eax),%eax
+  801a15:	3c 60                	cmp    $0x60,%al
+  801a17:	7e 1b                	jle    801a34 <strtol+0xf7>
+  801a19:	8b 45 08             	mov    0x8(%ebp),%eax
+  801a1c:	0f b6 00             	movzbl (%eax),%eax
+  801a1f:	3c 7a                	cmp    $0x7a,%al
+  801a21:	7f 11                	jg     801a34 <strtol+0xf7>
+            dig = *s - 'a' + 10;
+  801a23:	8b 45 08             	mov    0x8(%ebp),%eax
+  801a26:	0f b6 00             	movzbl (%eax),%eax
+  801a29:	0f be c0             	movsbl %al,%eax
+  801a2c:	83 e8 57             	sub    $0x57,%eax
+  801a2f:	89 45 f4             	mov    %eax,-0xc(%ebp)
+  801a32:	eb 23                	jmp    801a57 <strtol+0x11a>
+        }
+        else if (*s >= 'A' && *s <= 'Z') {
+  801a34:	8b 45 08             	mov    0x8(%ebp),%eax
+  801a37:	0f b6 00             	movzbl (%eax),%eax
+  801a3a:	3c 40                	cmp    $0x40,%al
+  801a3c:	7e 3c                	jle    801a7a <strtol+0x13d>
+  801a3e:	8b 45 08             	mov    0x8(%ebp),%eax
+  801a41:	0f b6 00             	movzbl (%eax),%eax
+  801a44:	3c 5a                	cmp    $0x5a,%al
+  801a46:	7f 32                	jg     801a7a <strtol+0x13d>
+            dig = *s - 'A' + 10;
+  801a48:	8b 45 08             	mov    0x8(%ebp),%eax
+  801a4b:	0f b6 00             	movzbl (%eax),%eax
+  801a4e:	0f be c0             	movsbl %al,%eax
+  801a51:	83 e8 37             	sub    $0x37,%eax
+  801a54:	89 45 f4             	mov    %eax,-0xc(%ebp)
+        }
+        else {
+            break;
+        }
+        if (dig >= base) {
+  801a57:	8b 45 f4             	mov    -0xc(%ebp),%eax
+  801a5a:	3b 45 10             	cmp    0x10(%ebp),%eax
+  801a5d:	7d 1a                	jge    801a79 <strtol+0x13c>
+            break;
+        }
+        s ++, val = (val * base) + dig;
+  801a5f:	83 45 08 01          	addl   $0x1,0x8(%ebp)
+  801a63:	8b 45 f8             	mov    -0x8(%ebp),%eax
+  801a66:	0f af 45 10          	imul   0x10(%ebp),%eax
+  801a6a:	89 c2                	mov    %eax,%edx
+  801a6c:	8b 45 f4             	mov    -0xc(%ebp),%eax
+  801a6f:	01 d0                	add    %edx,%eax
+  801a71:	89 45 f8             	mov    %eax,-0x8(%ebp)
+    while (1) {
+  801a74:	e9 71 ff ff ff       	jmp    8019ea <strtol+0xad>
+            break;
+  801a79:	90                   	nop
+        // we don't properly detect overflow!
+    }
+
+    if (endptr) {
+  801a7a:	83 7d 0c 00          	cmpl   $0x0,0xc(%ebp)
+  801a7e:	74 08                	je     801a88 <strtol+0x14b>
+        *endptr = (char *) s;
+  801a80:	8b 45 0c             	mov    0xc(%ebp),%eax
+  801a83:	8b 55 08             	mov    0x8(%ebp),%edx
+  801a86:	89 10                	mov    %edx,(%eax)
+    }
+    return (neg ? -val : val);
+  801a88:	83 7d fc 00          	cmpl   $0x0,-0x4(%ebp)
+  801a8c:	74 07                	je     801a95 <strtol+0x158>
+  801a8e:	8b 45 f8             	mov    -0x8(%ebp),%eax
+  801a91:	f7 d8                	neg    %eax
+  801a93:	eb 03                	jmp    801a98 <strtol+0x15b>
+  801a95:	8b 45 f8             	mov    -0x8(%ebp),%eax
+}
+  801a98:	c9                   	leave
+  801a99:	c3                   	ret
+
+00801a9a <memset>:
+ * @n:      number of bytes to be set to the value
+ *
+ * The memset() function returns @s.
+ * */
+void *
+memset(void *s, char c, size_t n) {
+  801a9a:	55                   	push   %ebp
+  801a9b:	89 e5                	mov    %esp,%ebp
+  801a9d:	57                   	push   %edi
+  801a9e:	83 ec 24             	sub    $0x24,%esp
+  801aa1:	8b 45 0c             	mov    0xc(%ebp),%eax
+  801aa4:	88 45 d8             	mov    %al,-0x28(%ebp)
+#ifdef __HAVE_ARCH_MEMSET
+    return __memset(s, c, n);
+  801aa7:	0f be 45 d8          	movsbl -0x28(%ebp),%eax
+  801aab:	8b 55 08             	mov    0x8(%ebp),%edx
+  801aae:	89 55 f8             	mov    %edx,-0x8(%ebp)
+  801ab1:	88 45 f7             	mov    %al,-0x9(%ebp)
+  801ab4:	8b 45 10             	mov    0x10(%ebp),%eax
+  801ab7:	89 45 f0             	mov    %eax,-0x10(%ebp)
+#ifndef __HAVE_ARCH_MEMSET
+#define __HAVE_ARCH_MEMSET
+static inline void *
+__memset(void *s, char c, size_t n) {
+    int d0, d1;
+    asm volatile (
+  801aba:	8b 4d f0             	mov    -0x10(%ebp),%ecx
+  801abd:	0f b6 45 f7          	movzbl -0x9(%ebp),%eax
+  801ac1:	8b 55 f8             	mov    -0x8(%ebp),%edx
+  801ac4:	89 d7                	mov    %edx,%edi
+  801ac6:	f3 aa                	rep stos %al,%es:(%edi)
+  801ac8:	89 fa                	mov    %edi,%edx
+  801aca:	89 4d ec             	mov    %ecx,-0x14(%ebp)
+  801acd:	89 55 e8             	mov    %edx,-0x18(%ebp)
+        "rep; stosb;"
+        : "=&c" (d0), "=&D" (d1)
+        : "0" (n), "a" (c), "1" (s)
+        : "memory");
+    return s;
+  801ad0:	8b 45 f8             	mov    -0x8(%ebp),%eax
+    while (n -- > 0) {
+        *p ++ = c;
+    }
+    return s;
+#endif /* __HAVE_ARCH_MEMSET */
+}
+  801ad3:	8b 7d fc             	mov    -0x4(%ebp),%edi
+  801ad6:	c9                   	leave
+  801ad7:	c3                   	ret
+
+00801ad8 <memmove>:
+ * @n:      number of bytes to copy
+ *
+ * The memmove() function returns @dst.
+ * */
+void *
+memmove(void *dst, const void *src, size_t n) {
+  801ad8:	55                   	push   %ebp
+  801ad9:	89 e5                	mov    %esp,%ebp
+  801adb:	57                   	push   %edi
+  801adc:	56                   	push   %esi
+  801add:	53                   	push   %ebx
+  801ade:	83 ec 30             	sub    $0x30,%esp
+  801ae1:	8b 45 08             	mov    0x8(%ebp),%eax
+  801ae4:	89 45 f0             	mov    %eax,-0x10(%ebp)
+  801ae7:	8b 45 0c             	mov    0xc(%ebp),%eax
+  801aea:	89 45 ec             	mov    %eax,-0x14(%ebp)
+  801aed:	8b 45 10             	mov    0x10(%ebp),%eax
+  801af0:	89 45 e8             	mov    %eax,-0x18(%ebp)
+
+#ifndef __HAVE_ARCH_MEMMOVE
+#define __HAVE_ARCH_MEMMOVE
+static inline void *
+__memmove(void *dst, const void *src, size_t n) {
+    if (dst < src) {
+  801af3:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  801af6:	3b 45 ec             	cmp    -0x14(%ebp),%eax
+  801af9:	73 42                	jae    801b3d <memmove+0x65>
+  801afb:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  801afe:	89 45 e4             	mov    %eax,-0x1c(%ebp)
+  801b01:	8b 45 ec             	mov    -0x14(%ebp),%eax
+  801b04:	89 45 e0             	mov    %eax,-0x20(%ebp)
+  801b07:	8b 45 e8             	mov    -0x18(%ebp),%eax
+  801b0a:	89 45 dc             	mov    %eax,-0x24(%ebp)
+        "andl $3, %%ecx;"
+        "jz 1f;"
+        "rep; movsb;"
+        "1:"
+        : "=&c" (d0), "=&D" (d1), "=&S" (d2)
+        : "0" (n / 4), "g" (n), "1" (dst), "2" (src)
+  801b0d:	8b 45 dc             	mov    -0x24(%ebp),%eax
+  801b10:	c1 e8 02             	shr    $0x2,%eax
+  801b13:	89 c1                	mov    %eax,%ecx
+    asm volatile (
+  801b15:	8b 55 e4             	mov    -0x1c(%ebp),%edx
+  801b18:	8b 45 e0             	mov    -0x20(%ebp),%eax
+  801b1b:	89 d7                	mov    %edx,%edi
+  801b1d:	89 c6                	mov    %eax,%esi
+  801b1f:	f3 a5                	rep movsl %ds:(%esi),%es:(%edi)
+  801b21:	8b 4d dc             	mov    -0x24(%ebp),%ecx
+  801b24:	83 e1 03             	and    $0x3,%ecx
+  801b27:	74 02                	je     801b2b <memmove+0x53>
+  801b29:	f3 a4                	rep movsb %ds:(%esi),%es:(%edi)
+  801b2b:	89 f0                	mov    %esi,%eax
+  801b2d:	89 fa                	mov    %edi,%edx
+  801b2f:	89 4d d8             	mov    %ecx,-0x28(%ebp)
+  801b32:	89 55 d4             	mov    %edx,-0x2c(%ebp)
+  801b35:	89 45 d0             	mov    %eax,-0x30(%ebp)
+        : "memory");
+    return dst;
+  801b38:	8b 45 e4             	mov    -0x1c(%ebp),%eax
+        return __memcpy(dst, src, n);
+  801b3b:	eb 36                	jmp    801b73 <memmove+0x9b>
+        : "0" (n), "1" (n - 1 + src), "2" (n - 1 + dst)
+  801b3d:	8b 45 e8             	mov    -0x18(%ebp),%eax
+  801b40:	8d 50 ff             	lea    -0x1(%eax),%edx
+  801b43:	8b 45 ec             	mov    -0x14(%ebp),%eax
+  801b46:	01 c2                	add    %eax,%edx
+  801b48:	8b 45 e8             	mov    -0x18(%ebp),%eax
+  801b4b:	8d 48 ff             	lea    -0x1(%eax),%ecx
+  801b4e:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  801b51:	8d 1c 01             	lea    (%ecx,%eax,1),%ebx
+    asm volatile (
+  801b54:	8b 45 e8             	mov    -0x18(%ebp),%eax
+  801b57:	89 c1                	mov    %eax,%ecx
+  801b59:	89 d8                	mov    %ebx,%eax
+  801b5b:	89 d6                	mov    %edx,%esi
+  801b5d:	89 c7                	mov    %eax,%edi
+  801b5f:	fd                   	std
+  801b60:	f3 a4                	rep movsb %ds:(%esi),%es:(%edi)
+  801b62:	fc                   	cld
+  801b63:	89 f8                	mov    %edi,%eax
+  801b65:	89 f2                	mov    %esi,%edx
+  801b67:	89 4d cc             	mov    %ecx,-0x34(%ebp)
+  801b6a:	89 55 c8             	mov    %edx,-0x38(%ebp)
+  801b6d:	89 45 c4             	mov    %eax,-0x3c(%ebp)
+    return dst;
+  801b70:	8b 45 f0             	mov    -0x10(%ebp),%eax
+            *d ++ = *s ++;
+        }
+    }
+    return dst;
+#endif /* __HAVE_ARCH_MEMMOVE */
+}
+  801b73:	83 c4 30             	add    $0x30,%esp
+  801b76:	5b                   	pop    %ebx
+  801b77:	5e                   	pop    %esi
+  801b78:	5f                   	pop    %edi
+  801b79:	5d                   	pop    %ebp
+  801b7a:	c3                   	ret
+
+00801b7b <memcpy>:
+ * it always copies exactly @n bytes. To avoid overflows, the size of arrays pointed
+ * by both @src and @dst, should be at least @n bytes, and should not overlap
+ * (for overlapping memory area, memmove is a safer approach).
+ * */
+void *
+memcpy(void *dst, const void *src, size_t n) {
+  801b7b:	55                   	push   %ebp
+  801b7c:	89 e5                	mov    %esp,%ebp
+  801b7e:	57                   	push   %edi
+  801b7f:	56                   	push   %esi
+  801b80:	83 ec 20             	sub    $0x20,%esp
+  801b83:	8b 45 08             	mov    0x8(%ebp),%eax
+  801b86:	89 45 f4             	mov    %eax,-0xc(%ebp)
+  801b89:	8b 45 0c             	mov    0xc(%ebp),%eax
+  801b8c:	89 45 f0             	mov    %eax,-0x10(%ebp)
+  801b8f:	8b 45 10             	mov    0x10(%ebp),%eax
+  801b92:	89 45 ec             	mov    %eax,-0x14(%ebp)
+        : "0" (n / 4), "g" (n), "1" (dst), "2" (src)
+  801b95:	8b 45 ec             	mov    -0x14(%ebp),%eax
+  801b98:	c1 e8 02             	shr    $0x2,%eax
+  801b9b:	89 c1                	mov    %eax,%ecx
+    asm volatile (
+  801b9d:	8b 55 f4             	mov    -0xc(%ebp),%edx
+  801ba0:	8b 45 f0             	mov    -0x10(%ebp),%eax
+  801ba3:	89 d7                	mov    %edx,%edi
+  801ba5:	89 c6                	mov    %eax,%esi
+  801ba7:	f3 a5                	rep movsl %ds:(%esi),%es:(%edi)
+  801ba9:	8b 4d ec             	mov    -0x14(%ebp),%ecx
+  801bac:	83 e1 03             	and    $0x3,%ecx
+  801baf:	74 02                	je     801bb3 <memcpy+0x38>
+  801bb1:	f3 a4                	rep movsb %ds:(%esi),%es:(%edi)
+  801bb3:	89 f0                	mov    %esi,%eax
+  801bb5:	89 fa                	mov    %edi,%edx
+  801bb7:	89 4d e8             	mov    %ecx,-0x18(%ebp)
+  801bba:	89 55 e4             	mov    %edx,-0x1c(%ebp)
+  801bbd:	89 45 e0             	mov    %eax,-0x20(%ebp)
+    return dst;
+  801bc0:	8b 45 f4             	mov    -0xc(%ebp),%eax
+    while (n -- > 0) {
+        *d ++ = *s ++;
+    }
+    return dst;
+#endif /* __HAVE_ARCH_MEMCPY */
+}
+  801bc3:	83 c4 20             	add    $0x20,%esp
+  801bc6:	5e                   	pop    %esi
+  801bc7:	5f                   	pop    %edi
+  801bc8:	5d                   	pop    %ebp
+  801bc9:	c3                   	ret
+
+00801bca <memcmp>:
+ *   match in both memory blocks has a greater value in @v1 than in @v2
+ *   as if evaluated as unsigned char values;
+ * - And a value less than zero indicates the opposite.
+ * */
+int
+memcmp(const void *v1, const void *v2, size_t n) {
+  801bca:	55                   	push   %ebp
+  801bcb:	89 e5                	mov    %esp,%ebp
+  801bcd:	83 ec 10             	sub    $0x10,%esp
+    const char *s1 = (const char *)v1;
+  801bd0:	8b 45 08             	mov    0x8(%ebp),%eax
+  801bd3:	89 45 fc             	mov    %eax,-0x4(%ebp)
+    const char *s2 = (const char *)v2;
+  801bd6:	8b 45 0c             	mov    0xc(%ebp),%eax
+  801bd9:	89 45 f8             	mov    %eax,-0x8(%ebp)
+    while (n -- > 0) {
+  801bdc:	eb 2e                	jmp    801c0c <memcmp+0x42>
+        if (*s1 != *s2) {
+  801bde:	8b 45 fc             	mov    -0x4(%ebp),%eax
+  801be1:	0f b6 10             	movzbl (%eax),%edx
+  801be4:	8b 45 f8             	mov    -0x8(%ebp),%eax
+  801be7:	0f b6 00             	movzbl (%eax),%eax
+  801bea:	38 c2                	cmp    %al,%dl
+  801bec:	74 16                	je     801c04 <memcmp+0x3a>
+            return (int)((unsigned char)*s1 - (unsigned char)*s2);
+  801bee:	8b 45 fc             	mov    -0x4(%ebp),%eax
+  801bf1:	0f b6 00             	movzbl (%eax),%eax
+  801bf4:	0f b6 d0             	movzbl %al,%edx
+  801bf7:	8b 45 f8             	mov    -0x8(%ebp),%eax
+  801bfa:	0f b6 00             	movzbl (%eax),%eax
+  801bfd:	0f b6 c0             	movzbl %al,%eax
+  801c00:	29 c2                	sub    %eax,%edx
+  801c02:	eb 1a                	jmp    801c1e <memcmp+0x54>
+        }
+        s1 ++, s2 ++;
+  801c04:	83 45 fc 01          	addl   $0x1,-0x4(%ebp)
+  801c08:	83 45 f8 01          	addl   $0x1,-0x8(%ebp)
+    while (n -- > 0) {
+  801c0c:	8b 45 10             	mov    0x10(%ebp),%eax
+  801c0f:	8d 50 ff             	lea    -0x1(%eax),%edx
+  801c12:	89 55 10             	mov    %edx,0x10(%ebp)
+  801c15:	85 c0                	test   %eax,%eax
+  801c17:	75 c5                	jne    801bde <memcmp+0x14>
+    }
+    return 0;
+  801c19:	ba 00 00 00 00       	mov    $0x0,%edx
+}
+  801c1e:	89 d0                	mov    %edx,%eax
+  801c20:	c9                   	leave
+  801c21:	c3                   	ret
+
+00801c22 <main>:
+#include <stdio.h>
+#include <ulib.h>
+
+int
+main(void) {
+  801c22:	8d 4c 24 04          	lea    0x4(%esp),%ecx
+  801c26:	83 e4 f0             	and    $0xfffffff0,%esp
+  801c29:	ff 71 fc             	push   -0x4(%ecx)
+  801c2c:	55                   	push   %ebp
+  801c2d:	89 e5                	mov    %esp,%ebp
+  801c2f:	51                   	push   %ecx
+  801c30:	83 ec 14             	sub    $0x14,%esp
+    int pid, exit_code;
+    if ((pid = fork()) == 0) {
+  801c33:	e8 fd f0 ff ff       	call   800d35 <fork>
+  801c38:	89 45 f0             	mov    %eax,-0x10(%ebp)
+  801c3b:	83 7d f0 00          	cmpl   $0x0,-0x10(%ebp)
+  801c3f:	75 35                	jne    801c76 <main+0x54>
+        cprintf("fork ok.\n");
+  801c41:	83 ec 0c             	sub    $0xc,%esp
+  801c44:	68 c0 21 80 00       	push   $0x8021c0
+  801c49:	e8 76 ec ff ff       	call   8008c4 <cprintf>
+  801c4e:	83 c4 10             	add    $0x10,%esp
+        int i;
+        for (i = 0; i < 10; i ++) {
+  801c51:	c7 45 f4 00 00 00 00 	movl   $0x0,-0xc(%ebp)
+  801c58:	eb 09                	jmp    801c63 <main+0x41>
+            yield();
+  801c5a:	e8 13 f1 ff ff       	call   800d72 <yield>
+        for (i = 0; i < 10; i ++) {
+  801c5f:	83 45 f4 01          	addl   $0x1,-0xc(%ebp)
+  801c63:	83 7d f4 09          	cmpl   $0x9,-0xc(%ebp)
+  801c67:	7e f1                	jle    801c5a <main+0x38>
+        }
+        exit(0xbeaf);
+  801c69:	83 ec 0c             	sub    $0xc,%esp
+  801c6c:	68 af be 00 00       	push   $0xbeaf
+  801c71:	e8 98 f0 ff ff       	call   800d0e <exit>
+    }
+    assert(pid > 0);
+  801c76:	83 7d f0 00          	cmpl   $0x0,-0x10(%ebp)
+  801c7a:	7f 16                	jg     801c92 <main+0x70>
+  801c7c:	68 ca 21 80 00       	push   $0x8021ca
+  801c81:	68 d2 21 80 00       	push   $0x8021d2
+  801c86:	6a 0f                	push   $0xf
+  801c88:	68 e7 21 80 00       	push   $0x8021e7
+  801c8d:	e8 fc ea ff ff       	call   80078e <__panic>
+    assert(waitpid(-1, NULL) != 0);
+  801c92:	83 ec 08             	sub    $0x8,%esp
+  801c95:	6a 00                	push   $0x0
+  801c97:	6a ff                	push   $0xffffffff
+  801c99:	e8 bb f0 ff ff       	call   800d59 <waitpid>
+  801c9e:	83 c4 10             	add    $0x10,%esp
+  801ca1:	85 c0                	test   %eax,%eax
+  801ca3:	75 16                	jne    801cbb <main+0x99>
+  801ca5:	68 f5 21 80 00       	push   $0x8021f5
+  801caa:	68 d2 21 80 00       	push   $0x8021d2
+  801caf:	6a 10                	push   $0x10
+  801cb1:	68 e7 21 80 00       	push   $0x8021e7
+  801cb6:	e8 d3 ea ff ff       	call   80078e <__panic>
+    assert(waitpid(pid, (void *)0xC0000000) != 0);
+  801cbb:	83 ec 08             	sub    $0x8,%esp
+  801cbe:	68 00 00 00 c0       	push   $0xc0000000
+  801cc3:	ff 75 f0             	push   -0x10(%ebp)
+  801cc6:	e8 8e f0 ff ff       	call   800d59 <waitpid>
+  801ccb:	83 c4 10             	add    $0x10,%esp
+  801cce:	85 c0                	test   %eax,%eax
+  801cd0:	75 16                	jne    801ce8 <main+0xc6>
+  801cd2:	68 0c 22 80 00       	push   $0x80220c
+  801cd7:	68 d2 21 80 00       	push   $0x8021d2
+  801cdc:	6a 11                	push   $0x11
+  801cde:	68 e7 21 80 00       	push   $0x8021e7
+  801ce3:	e8 a6 ea ff ff       	call   80078e <__panic>
+    assert(waitpid(pid, &exit_code) == 0 && exit_code == 0xbeaf);
+  801ce8:	83 ec 08             	sub    $0x8,%esp
+  801ceb:	8d 45 ec             	lea    -0x14(%ebp),%eax
+  801cee:	50                   	push   %eax
+  801cef:	ff 75 f0             	push   -0x10(%ebp)
+  801cf2:	e8 62 f0 ff ff       	call   800d59 <waitpid>
+  801cf7:	83 c4 10             	add    $0x10,%esp
+  801cfa:	85 c0                	test   %eax,%eax
+  801cfc:	75 0a                	jne    801d08 <main+0xe6>
+  801cfe:	8b 45 ec             	mov    -0x14(%ebp),%eax
+  801d01:	3d af be 00 00       	cmp    $0xbeaf,%eax
+  801d06:	74 16                	je     801d1e <main+0xfc>
+  801d08:	68 34 22 80 00       	push   $0x802234
+  801d0d:	68 d2 21 80 00       	push   $0x8021d2
+  801d12:	6a 12                	push   $0x12
+  801d14:	68 e7 21 80 00       	push   $0x8021e7
+  801d19:	e8 70 ea ff ff       	call   80078e <__panic>
+    cprintf("badarg pass.\n");
+  801d1e:	83 ec 0c             	sub    $0xc,%esp
+  801d21:	68 69 22 80 00       	push   $0x802269
+  801d26:	e8 99 eb ff ff       	call   8008c4 <cprintf>
+  801d2b:	83 c4 10             	add    $0x10,%esp
+    return 0;
+  801d2e:	b8 00 00 00 00       	mov    $0x0,%eax
+}
+  801d33:	8b 4d fc             	mov    -0x4(%ebp),%ecx
+  801d36:	c9                   	leave
+  801d37:	8d 61 fc             	lea    -0x4(%ecx),%esp
+  801d3a:	c3                   	ret
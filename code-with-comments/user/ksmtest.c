@@ -0,0 +1,78 @@
+#include <ulib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define PGSIZE          4096
+#define NPAGES          8
+#define NCHILD          8
+#define MAX_WAIT        30              // 最多等待的时钟 tick 数, sleep(1) 睡一个 tick
+
+// 子进程各自写入相同的内容, 等 ksmproc 把它们合并后检查内容, 再写一页确认写时复制不影响其他进程
+static volatile int *done;
+static char *buf;
+
+static void
+fill(char *page, int i) {
+    memset(page, 'a' + i % 2, PGSIZE);
+}
+
+static void
+check(char *page, int i) {
+    int j;
+    for (j = 0; j < PGSIZE; j ++) {
+        assert(page[j] == 'a' + i % 2);
+    }
+}
+
+static void
+child(void) {
+    int i;
+    for (i = 0; i < NPAGES; i ++) {
+        fill(buf + i * PGSIZE, i);
+    }
+    while (!*done) {
+        sleep(1);
+    }
+    for (i = 0; i < NPAGES; i ++) {
+        check(buf + i * PGSIZE, i);
+    }
+    *(int *)buf = getpid();
+    sleep(1);
+    assert(*(int *)buf == getpid());
+    check(buf + PGSIZE, 1);
+    exit(0);
+}
+
+int
+main(void) {
+    assert(ksm(KSM_ENABLE) == 0);
+    done = mmap(NULL, PGSIZE, MMAP_WRITE | MMAP_SHARED, -1, 0);
+    buf = mmap(NULL, NPAGES * PGSIZE, MMAP_WRITE, -1, 0);
+    assert(done != NULL && buf != NULL);
+
+    int i, pids[NCHILD];
+    for (i = 0; i < NCHILD; i ++) {
+        if ((pids[i] = fork()) == 0) {
+            child();
+        }
+        assert(pids[i] > 0);
+    }
+
+    // 所有子进程的 NCHILD * NPAGES 页只有两种内容
+    int saved, expect = NCHILD * NPAGES - 2, wait = 0;
+    while ((saved = ksm(KSM_SAVED)) < expect && wait ++ < MAX_WAIT) {
+        sleep(1);
+    }
+    cprintf("ksm saved %d pages after %d ticks.\n", saved, wait);
+    assert(saved >= expect);
+    *done = 1;
+
+    for (i = 0; i < NCHILD; i ++) {
+        assert(waitpid(pids[i], NULL) == 0);
+    }
+    assert(ksm(KSM_DISABLE) == 0);
+    cprintf("ksmtest pass.\n");
+    return 0;
+}
+
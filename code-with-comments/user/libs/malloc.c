@@ -0,0 +1,192 @@
+#include <defs.h>
+#include <string.h>
+#include <ulib.h>
+#include <malloc.h>
+
+/* *
+ * 每块前有 8 字节的头部, 记录块的大小(含头部), 空闲时还记录链表中的下一块.
+ *  - 小块(含头部不超过 MAX_SMALL 字节)按 2 的幂分为 NCLASS 个大小类, 每类一个空闲链表.
+ *    链表为空时从当前的 arena 中顺序切出; arena 不够时把剩下的部分切成各类的块挂到链表上,
+ *    再用 sbrk 取 ARENA_SIZE 字节. 释放的小块挂回所属类的链表, 不合并.
+ *  - 大块按页取整, 直接从 brk 取得. 释放后挂在大块链表上, 按首次适配复用(多出整页时拆分),
+ *    位于堆顶的空闲大块交还给内核.
+ * */
+#define PGSIZE          4096
+#define MIN_SHIFT       4                               // 最小的类: 16 字节
+#define NCLASS          8                               // 16, 32, ..., 2048 字节
+#define MAX_SMALL       (1 << (MIN_SHIFT + NCLASS - 1))
+#define ARENA_SIZE      (4 * PGSIZE)
+
+typedef union header {
+    struct {
+        size_t size;            // 块大小(含头部)
+        union header *next;     // 空闲链表中的下一块
+    } s;
+    uint64_t align;
+} header_t;
+
+#define class_size(c)           (1 << (MIN_SHIFT + (c)))
+
+static header_t *free_list[NCLASS];
+static header_t *large_list;
+static char *arena_ptr, *arena_end;
+
+static int
+size_class(size_t size) {
+    int c = 0;
+    while (class_size(c) < size) {
+        c ++;
+    }
+    return c;
+}
+
+static void
+push_free(header_t *h, int c) {
+    h->s.size = class_size(c);
+    h->s.next = free_list[c];
+    free_list[c] = h;
+}
+
+// 小块: 优先取空闲链表, 否则从 arena 中切出
+static header_t *
+small_alloc(int c) {
+    header_t *h;
+    if ((h = free_list[c]) != NULL) {
+        free_list[c] = h->s.next;
+        return h;
+    }
+    size_t size = class_size(c);
+    if (arena_end - arena_ptr < size) {
+        // arena 剩下的部分总是 16 字节的整数倍, 可以完全切成各类的块
+        int i;
+        for (i = NCLASS - 1; i >= 0; i --) {
+            while (arena_end - arena_ptr >= class_size(i)) {
+                push_free((header_t *)arena_ptr, i);
+                arena_ptr += class_size(i);
+            }
+        }
+        char *p = sbrk(ARENA_SIZE);
+        if (p == (char *)-1) {
+            return NULL;
+        }
+        arena_ptr = p, arena_end = p + ARENA_SIZE;
+    }
+    h = (header_t *)arena_ptr;
+    arena_ptr += size;
+    h->s.size = size;
+    return h;
+}
+
+// 大块: 首次适配复用空闲的大块, 没有则扩展堆
+static header_t *
+large_alloc(size_t size) {
+    header_t **pp, *h;
+    for (pp = &large_list; (h = *pp) != NULL; pp = &(h->s.next)) {
+        if (h->s.size >= size) {
+            *pp = h->s.next;
+            if (h->s.size > size) {
+                header_t *rest = (header_t *)((char *)h + size);
+                rest->s.size = h->s.size - size;
+                rest->s.next = large_list;
+                large_list = rest;
+                h->s.size = size;
+            }
+            return h;
+        }
+    }
+    char *p = sbrk(size);
+    if (p == (char *)-1) {
+        return NULL;
+    }
+    h = (header_t *)p;
+    h->s.size = size;
+    return h;
+}
+
+// 把位于堆顶的空闲大块交还给内核, 直到堆顶不再是空闲的大块
+static void
+large_trim(void) {
+    header_t **pp, *h;
+    char *top = sbrk(0);
+    for (pp = &large_list; (h = *pp) != NULL; ) {
+        if ((char *)h + h->s.size == top) {
+            *pp = h->s.next;
+            if (sbrk(-(intptr_t)h->s.size) == (char *)-1) {
+                return ;
+            }
+            top = (char *)h;
+            pp = &large_list;   // 新的堆顶之下可能还有空闲的大块
+            continue;
+        }
+        pp = &(h->s.next);
+    }
+}
+
+void *
+malloc(size_t size) {
+    size_t total = size + sizeof(header_t);
+    if (size == 0 || total < size) {
+        return NULL;
+    }
+    header_t *h;
+    if (total <= MAX_SMALL) {
+        h = small_alloc(size_class(total));
+    }
+    else {
+        if ((total = ROUNDUP(total, PGSIZE)) < size) {
+            return NULL;
+        }
+        h = large_alloc(total);
+    }
+    return (h != NULL) ? (void *)(h + 1) : NULL;
+}
+
+void
+free(void *ptr) {
+    if (ptr == NULL) {
+        return ;
+    }
+    header_t *h = (header_t *)ptr - 1;
+    if (h->s.size <= MAX_SMALL) {
+        push_free(h, size_class(h->s.size));
+    }
+    else {
+        h->s.next = large_list;
+        large_list = h;
+        large_trim();
+    }
+}
+
+void *
+calloc(size_t nmemb, size_t size) {
+    if (size != 0 && nmemb > (size_t)-1 / size) {
+        return NULL;
+    }
+    void *ptr;
+    if ((ptr = malloc(nmemb * size)) != NULL) {
+        memset(ptr, 0, nmemb * size);
+    }
+    return ptr;
+}
+
+void *
+realloc(void *ptr, size_t size) {
+    if (ptr == NULL) {
+        return malloc(size);
+    }
+    if (size == 0) {
+        free(ptr);
+        return NULL;
+    }
+    size_t old = ((header_t *)ptr - 1)->s.size - sizeof(header_t);
+    if (size <= old) {
+        return ptr;
+    }
+    void *nptr;
+    if ((nptr = malloc(size)) != NULL) {
+        memcpy(nptr, ptr, old);
+        free(ptr);
+    }
+    return nptr;
+}
+
@@ -0,0 +1,16 @@
+#ifndef __USER_LIBS_MALLOC_H__
+#define __USER_LIBS_MALLOC_H__
+
+#include <defs.h>
+
+/**
+ * 用户态内存分配器, 内存来自 SYS_brk 扩展的堆(见 malloc.c).
+ * 返回的地址按 8 字节对齐, 失败返回 NULL. fork 后父子进程各有一份堆.
+ */
+void *malloc(size_t size);
+void *calloc(size_t nmemb, size_t size);
+void *realloc(void *ptr, size_t size);
+void free(void *ptr);
+
+#endif /* !__USER_LIBS_MALLOC_H__ */
+
@@ -0,0 +1,22 @@
+#include <defs.h>
+#include <syscall.h>
+#include <shmem.h>
+
+/**
+ * shmem_open - 映射名为 name 的段, 不存在时按 len 字节创建. 段已存在时 len 为 0 表示映射整个段.
+ * mmap_flags 可为 MMAP_WRITE. 返回映射的起始地址, 失败返回 NULL.
+ */
+void *
+shmem_open(const char *name, size_t len, uint32_t mmap_flags) {
+    uintptr_t addr_store = 0;
+    if (sys_shmem(name, len, mmap_flags, &addr_store) != 0) {
+        return NULL;
+    }
+    return (void *)addr_store;
+}
+
+int
+shmem_close(void *addr, size_t len) {
+    return sys_munmap((uintptr_t)addr, len);
+}
+
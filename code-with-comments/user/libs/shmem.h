@@ -0,0 +1,16 @@
+#ifndef __USER_LIBS_SHMEM_H__
+#define __USER_LIBS_SHMEM_H__
+
+#include <defs.h>
+
+/**
+ * 共享内存段(SYS_shmem).
+ * 同名的段在所有进程中是同一组物理页, 读写不经过文件系统; 匿名段(name 为 NULL)只能经 fork 共享.
+ * fork 时段不做写时复制, 父子进程始终看到同一份内容.
+ * 段在最后一个映射解除(shmem_close 或进程退出)时销毁.
+ */
+void *shmem_open(const char *name, size_t len, uint32_t mmap_flags);
+int shmem_close(void *addr, size_t len);
+
+#endif /* !__USER_LIBS_SHMEM_H__ */
+
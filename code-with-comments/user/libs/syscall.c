@@ -89,6 +89,31 @@ sys_gettime(void) {
     return syscall(SYS_gettime);
 }
 
+int
+sys_mmap(uintptr_t *addr_store, size_t len, uint32_t mmap_flags, int fd, off_t offset) {
+    return syscall(SYS_mmap, addr_store, len, mmap_flags, fd, offset);
+}
+
+int
+sys_munmap(uintptr_t addr, size_t len) {
+    return syscall(SYS_munmap, addr, len);
+}
+
+int
+sys_shmem(const char *name, size_t len, uint32_t mmap_flags, uintptr_t *addr_store) {
+    return syscall(SYS_shmem, name, len, mmap_flags, addr_store);
+}
+
+int
+sys_brk(uintptr_t *brk_store) {
+    return syscall(SYS_brk, brk_store);
+}
+
+int
+sys_ksm(int op) {
+    return syscall(SYS_ksm, op);
+}
+
 int
 sys_exec(const char *name, int argc, const char **argv) {
     return syscall(SYS_exec, name, argc, argv);
@@ -16,6 +16,13 @@ int sys_pgdir(void);
 int sys_sleep(unsigned int time);
 size_t sys_gettime(void);
 
+// 内存映射相关的系统调用
+int sys_mmap(uintptr_t *addr_store, size_t len, uint32_t mmap_flags, int fd, off_t offset);
+int sys_munmap(uintptr_t addr, size_t len);
+int sys_shmem(const char *name, size_t len, uint32_t mmap_flags, uintptr_t *addr_store);
+int sys_brk(uintptr_t *brk_store);
+int sys_ksm(int op);
+
 struct stat;
 struct dirent;
 
@@ -77,6 +77,49 @@ gettime_msec(void) {
     return (unsigned int)sys_gettime();
 }
 
+// mmap - 建立映射, addr 为 NULL 时由内核选择地址; fd < 0 为匿名映射. 失败返回 NULL
+void *
+mmap(void *addr, size_t len, uint32_t mmap_flags, int fd, off_t offset) {
+    uintptr_t addr_store = (uintptr_t)addr;
+    if (sys_mmap(&addr_store, len, mmap_flags, fd, offset) != 0) {
+        return NULL;
+    }
+    return (void *)addr_store;
+}
+
+int
+munmap(void *addr, size_t len) {
+    return sys_munmap((uintptr_t)addr, len);
+}
+
+// brk - 把堆的末尾设为 addr(内核按页向上取整)
+int
+brk(void *addr) {
+    uintptr_t brk_store = (uintptr_t)addr;
+    return sys_brk(&brk_store);
+}
+
+// sbrk - 把堆的末尾移动 increment 字节(按页取整), 返回原来的末尾; 失败返回 (void *)-1
+void *
+sbrk(intptr_t increment) {
+    uintptr_t old = 0, brk_store;
+    if (sys_brk(&old) != 0) {
+        return (void *)-1;
+    }
+    if (increment != 0) {
+        brk_store = old + increment;
+        if (sys_brk(&brk_store) != 0) {
+            return (void *)-1;
+        }
+    }
+    return (void *)old;
+}
+
+int
+ksm(int op) {
+    return sys_ksm(op);
+}
+
 int
 __exec(const char *name, const char **argv) {
     int argc = 0;
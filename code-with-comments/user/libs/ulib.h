@@ -27,6 +27,7 @@ int fprintf(int fd, const char *fmt, ...);
 
 void __noreturn exit(int error_code);
 int fork(void);
+int vfork(void);    // 见 vfork.S, 子进程只能调用 exec 或 exit
 int wait(void);
 int waitpid(int pid, int *store);
 void yield(void);
@@ -36,6 +37,11 @@ void print_pgdir(void);
 int sleep(unsigned int time);
 unsigned int gettime_msec(void);
 int __exec(const char *name, const char **argv);
+void *mmap(void *addr, size_t len, uint32_t mmap_flags, int fd, off_t offset);
+int munmap(void *addr, size_t len);
+int brk(void *addr);
+void *sbrk(intptr_t increment);
+int ksm(int op);    // op 见 unistd.h 中的 KSM_*
 
 #define __exec0(name, path, ...)                \
 ({ const char *argv[] = {path, ##__VA_ARGS__, NULL}; __exec(name, argv); })
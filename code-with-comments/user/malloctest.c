@@ -0,0 +1,128 @@
+#include <ulib.h>
+#include <stdio.h>
+#include <string.h>
+#include <malloc.h>
+
+#define PGSIZE          4096
+#define NNODES          1000
+
+// 用 malloc 建立的链表, 不需要预先定好大小的静态数组
+struct node {
+    int value;
+    struct node *next;
+};
+
+static void
+test_list(void) {
+    struct node *head = NULL, *n;
+    int i, sum = 0;
+    for (i = 0; i < NNODES; i ++) {
+        assert((n = malloc(sizeof(struct node))) != NULL);
+        n->value = i, n->next = head, head = n;
+    }
+    for (n = head; n != NULL; n = n->next) {
+        sum += n->value;
+    }
+    assert(sum == NNODES * (NNODES - 1) / 2);
+    // 释放后再分配同样大小的块: 复用刚释放的块, 堆不再增长
+    char *top = sbrk(0);
+    while ((n = head) != NULL) {
+        head = n->next;
+        free(n);
+    }
+    for (i = 0; i < NNODES; i ++) {
+        assert((n = malloc(sizeof(struct node))) != NULL);
+        n->value = i, n->next = head, head = n;
+    }
+    assert(sbrk(0) == top);
+    while ((n = head) != NULL) {
+        head = n->next;
+        free(n);
+    }
+    cprintf("linked list ok.\n");
+}
+
+// 各种大小的块互不重叠, 地址按 8 字节对齐
+static void
+test_sizes(void) {
+    static const size_t sizes[] = {1, 7, 8, 9, 24, 100, 500, 1000, 2040, 2041, 5000, 3 * PGSIZE};
+    const int n = sizeof(sizes) / sizeof(sizes[0]);
+    char *ptrs[n];
+    int i, j;
+    for (i = 0; i < n; i ++) {
+        assert((ptrs[i] = malloc(sizes[i])) != NULL && (uintptr_t)ptrs[i] % 8 == 0);
+        memset(ptrs[i], i, sizes[i]);
+    }
+    for (i = 0; i < n; i ++) {
+        for (j = 0; j < sizes[i]; j ++) {
+            assert(ptrs[i][j] == (char)i);
+        }
+        free(ptrs[i]);
+    }
+    int *zeros = calloc(100, sizeof(int));
+    assert(zeros != NULL);
+    for (i = 0; i < 100; i ++) {
+        assert(zeros[i] == 0);
+        zeros[i] = i;
+    }
+    // realloc 保留原来的内容
+    assert((zeros = realloc(zeros, 10000 * sizeof(int))) != NULL);
+    for (i = 0; i < 100; i ++) {
+        assert(zeros[i] == i);
+    }
+    free(zeros);
+    assert(malloc(0) == NULL);
+    cprintf("sizes ok.\n");
+}
+
+// 大块直接从 brk 取得, 释放位于堆顶的大块时堆收缩
+static void
+test_large(void) {
+    char *top = sbrk(0);
+    char *p = malloc(4 * PGSIZE);
+    assert(p != NULL && (char *)sbrk(0) >= top + 4 * PGSIZE);
+    p[0] = p[4 * PGSIZE - 9] = 'x';
+    free(p);
+    assert(sbrk(0) == top);
+
+    // 堆中间的空闲大块被复用
+    char *a = malloc(2 * PGSIZE), *b = malloc(PGSIZE);
+    assert(a != NULL && b != NULL);
+    free(a);
+    assert(malloc(PGSIZE) == a);
+    free(a);
+    free(b);
+    assert(sbrk(0) == top);
+    cprintf("large blocks ok.\n");
+}
+
+// fork 后子进程的堆是一份写时复制的拷贝
+static void
+test_fork(void) {
+    int *p = malloc(sizeof(int)), pid;
+    assert(p != NULL);
+    *p = 1;
+    if ((pid = fork()) == 0) {
+        *p = 2;
+        int *q = malloc(PGSIZE * 2);
+        assert(q != NULL);
+        q[0] = *p;
+        exit(q[0] == 2 ? 0 : -1);
+    }
+    int code;
+    assert(pid > 0 && waitpid(pid, &code) == 0 && code == 0);
+    assert(*p == 1);
+    free(p);
+    cprintf("fork ok.\n");
+}
+
+int
+main(void) {
+    test_list();
+    test_sizes();
+    test_large();
+    test_fork();
+    cprintf("malloctest pass.\n");
+    return 0;
+}
+
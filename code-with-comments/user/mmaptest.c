@@ -0,0 +1,102 @@
+#include <ulib.h>
+#include <stdio.h>
+#include <string.h>
+#include <file.h>
+#include <unistd.h>
+
+#define PGSIZE          4096
+#define NPAGES          4
+
+// sfs 不能创建文件, mmapfile 由 Makefile 预先放入 disk0
+static const char *path = "mmapfile";
+
+// 匿名私有映射: 内容清零, fork 后各写各的
+static void
+test_anon_private(void) {
+    int *buf = mmap(NULL, NPAGES * PGSIZE, MMAP_WRITE, -1, 0);
+    assert(buf != NULL);
+    int i, n = NPAGES * PGSIZE / sizeof(int);
+    for (i = 0; i < n; i ++) {
+        assert(buf[i] == 0);
+        buf[i] = i;
+    }
+    int pid;
+    if ((pid = fork()) == 0) {
+        buf[0] = -1;
+        exit(0);
+    }
+    assert(pid > 0 && waitpid(pid, NULL) == 0);
+    assert(buf[0] == 0 && buf[n - 1] == n - 1);
+
+    // 给出的起始地址在空隙中, 但范围跨过已有的映射: 失败, 原映射不变
+    assert(mmap((char *)buf - PGSIZE, 2 * PGSIZE, MMAP_WRITE, -1, 0) == NULL);
+    assert(buf[0] == 0);
+
+    // 解除中间两页, 两端仍可访问
+    assert(munmap(buf + PGSIZE / sizeof(int), 2 * PGSIZE) == 0);
+    assert(buf[0] == 0 && buf[n - 1] == n - 1);
+    assert(munmap(buf, NPAGES * PGSIZE) == 0);
+    cprintf("anonymous private mapping ok.\n");
+}
+
+// 匿名共享映射: 子进程的写入父进程可见
+static void
+test_anon_shared(void) {
+    volatile int *buf = mmap(NULL, PGSIZE, MMAP_WRITE | MMAP_SHARED, -1, 0);
+    assert(buf != NULL);
+    int pid;
+    if ((pid = fork()) == 0) {
+        buf[0] = 0x5a5a;
+        exit(0);
+    }
+    assert(pid > 0 && waitpid(pid, NULL) == 0);
+    assert(buf[0] == 0x5a5a);
+    assert(munmap((void *)buf, PGSIZE) == 0);
+    cprintf("anonymous shared mapping ok.\n");
+}
+
+// 文件映射: 私有映射的写入不影响文件, 共享映射的写入在解除映射后写回文件
+static void
+test_file(void) {
+    static char data[NPAGES * PGSIZE];
+    int fd, i;
+    assert((fd = open(path, O_RDWR | O_TRUNC)) >= 0);
+    for (i = 0; i < sizeof(data); i ++) {
+        data[i] = (char)i;
+    }
+    assert(write(fd, data, sizeof(data)) == sizeof(data));
+
+    char *priv = mmap(NULL, (NPAGES + 1) * PGSIZE, MMAP_WRITE, fd, PGSIZE);
+    assert(priv != NULL);
+    assert(memcmp(priv, data + PGSIZE, (NPAGES - 1) * PGSIZE) == 0);
+    for (i = 0; i < 2 * PGSIZE; i ++) {
+        assert(priv[(NPAGES - 1) * PGSIZE + i] == 0);
+    }
+    priv[0] = ~priv[0];
+
+    char *shared = mmap(NULL, NPAGES * PGSIZE, MMAP_WRITE | MMAP_SHARED, fd, 0);
+    assert(shared != NULL && memcmp(shared, data, sizeof(data)) == 0);
+    int pid;
+    if ((pid = fork()) == 0) {
+        shared[PGSIZE] = 'm';
+        exit(0);
+    }
+    assert(pid > 0 && waitpid(pid, NULL) == 0);
+    assert(shared[PGSIZE] == 'm' && priv[0] == (char)~data[PGSIZE]);
+    assert(munmap(shared, NPAGES * PGSIZE) == 0);
+    assert(munmap(priv, (NPAGES + 1) * PGSIZE) == 0);
+
+    char c;
+    assert(seek(fd, PGSIZE, LSEEK_SET) == 0 && read(fd, &c, 1) == 1 && c == 'm');
+    close(fd);
+    cprintf("file mapping ok.\n");
+}
+
+int
+main(void) {
+    test_anon_private();
+    test_anon_shared();
+    test_file();
+    cprintf("mmaptest pass.\n");
+    return 0;
+}
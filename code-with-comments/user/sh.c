@@ -5,6 +5,7 @@
 #include <file.h>
 #include <error.h>
 #include <unistd.h>
+#include <malloc.h>
 
 #define printf(...)                     fprintf(1, __VA_ARGS__)
 #define putc(c)                         printf("%c", c)
@@ -13,7 +14,7 @@
 #define WHITESPACE                      " \t\r\n"
 #define SYMBOLS                         "<|>&;"
 
-char shcwd[BUFSIZE];
+char *shcwd;
 
 int
 gettoken(char **p1, char **p2) {
@@ -229,14 +230,15 @@ main(int argc, char **argv) {
         usage();
         return -1;
     }
-    //shcwd = malloc(BUFSIZE);
+    shcwd = malloc(BUFSIZE);
     assert(shcwd != NULL);
 
     char *buffer;
     while ((buffer = readline((interactive) ? "$ " : NULL)) != NULL) {
         shcwd[0] = '\0';
         int pid;
-        if ((pid = fork()) == 0) {
+        // 子进程解析命令后马上 exec, 用 vfork 省去复制地址空间. 子进程不从 main 返回, 只 exec 或 exit
+        if ((pid = vfork()) == 0) {
             ret = runcmd(buffer);
             exit(ret);
         }
@@ -0,0 +1,80 @@
+#include <ulib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <shmem.h>
+
+#define ROUNDS          64
+#define NWORDS          1024
+
+// 生产者/消费者之间的通道: 生产者填好 data 后递增 seq, 消费者处理完后把 ack 置为 seq
+struct channel {
+    volatile int seq;
+    volatile int ack;
+    volatile int sum;
+    int data[NWORDS];
+};
+
+static void
+consumer(void) {
+    // 不用 fork 继承的映射, 按名字重新打开: 与不相关的进程一样找到同一个段
+    struct channel *chan = shmem_open("shmemtest", 0, MMAP_WRITE);
+    assert(chan != NULL);
+    int round, i;
+    for (round = 1; round <= ROUNDS; round ++) {
+        while (chan->seq != round) {
+            yield();
+        }
+        int sum = 0;
+        for (i = 0; i < NWORDS; i ++) {
+            sum += chan->data[i];
+        }
+        chan->sum = sum;
+        chan->ack = round;
+    }
+    exit(0);
+}
+
+int
+main(void) {
+    struct channel *chan = shmem_open("shmemtest", sizeof(struct channel), MMAP_WRITE);
+    assert(chan != NULL && chan->seq == 0);
+
+    // 匿名段: fork 后不做写时复制, 子进程的写入父进程可见
+    volatile int *anon = shmem_open(NULL, sizeof(int), MMAP_WRITE);
+    assert(anon != NULL);
+
+    int pid;
+    if ((pid = fork()) == 0) {
+        *anon = 0x5a5a;
+        assert(shmem_close(chan, sizeof(struct channel)) == 0);
+        consumer();
+    }
+    assert(pid > 0);
+
+    int round, i;
+    for (round = 1; round <= ROUNDS; round ++) {
+        int sum = 0;
+        for (i = 0; i < NWORDS; i ++) {
+            chan->data[i] = round * i;
+            sum += round * i;
+        }
+        chan->seq = round;
+        while (chan->ack != round) {
+            yield();
+        }
+        assert(chan->sum == sum);
+    }
+    assert(waitpid(pid, NULL) == 0);
+    assert(*anon == 0x5a5a);
+
+    // 只读打开已存在的段, 长度不能超过段的长度
+    assert(shmem_open("shmemtest", 2 * sizeof(struct channel) + 4096, 0) == NULL);
+    const struct channel *ro = shmem_open("shmemtest", 0, 0);
+    assert(ro != NULL && ro != chan && ro->seq == ROUNDS);
+    assert(shmem_close((void *)ro, sizeof(struct channel)) == 0);
+    assert(shmem_close(chan, sizeof(struct channel)) == 0);
+    assert(shmem_close((void *)anon, sizeof(int)) == 0);
+
+    cprintf("shmemtest pass.\n");
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include <ulib.h>
+#include <stdio.h>
+#include <string.h>
+#include <file.h>
+#include <unistd.h>
+
+#define NLAUNCH         20
+
+static volatile int shared;
+
+// 子进程与父进程共享内存, 父进程在子进程退出后才返回
+static void
+test_share(void) {
+    int pid, code;
+    shared = 0;
+    if ((pid = vfork()) == 0) {
+        shared = getpid();
+        exit(0x5a);
+    }
+    assert(pid > 0 && shared == pid);
+    assert(waitpid(pid, &code) == 0 && code == 0x5a);
+    cprintf("vfork shares memory ok.\n");
+}
+
+// 文件表不共享: 子进程关闭的文件在父进程中仍然打开. vforkfile 由 Makefile 预先放入 disk0
+static void
+test_files(void) {
+    int fd, pid;
+    assert((fd = open("vforkfile", O_RDWR | O_TRUNC)) >= 0);
+    if ((pid = vfork()) == 0) {
+        close(fd);
+        exit(0);
+    }
+    assert(pid > 0 && waitpid(pid, NULL) == 0);
+    assert(write(fd, "x", 1) == 1);
+    close(fd);
+    cprintf("vfork copies files ok.\n");
+}
+
+// 启动 NLAUNCH 个子进程, 每个都 exec 本程序后立即退出, 返回所用的时间
+static unsigned int
+launch(const char *path, bool use_vfork) {
+    unsigned int start = gettime_msec();
+    int i, pid, code;
+    for (i = 0; i < NLAUNCH; i ++) {
+        if ((pid = (use_vfork ? vfork() : fork())) == 0) {
+            exec(path, "child");
+            exit(-1);
+        }
+        assert(pid > 0 && waitpid(pid, &code) == 0 && code == 0);
+    }
+    return gettime_msec() - start;
+}
+
+int
+main(int argc, char **argv) {
+    if (argc == 2 && strcmp(argv[1], "child") == 0) {
+        return 0;
+    }
+    test_share();
+    test_files();
+    unsigned int t_fork = launch(argv[0], 0);
+    unsigned int t_vfork = launch(argv[0], 1);
+    cprintf("launch %d commands: fork+exec %d ms, vfork+exec %d ms.\n", NLAUNCH, t_fork, t_vfork);
+    cprintf("vforktest pass.\n");
+    return 0;
+}